@@ -0,0 +1,152 @@
+#ifndef AWGN_H
+#define AWGN_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+#include "philox.h"
+
+// =============================================================================
+// RANDOM SOURCES FOR BITS AND AWGN
+// =============================================================================
+//
+// Every simulation path draws its payload bits and Gaussian noise from an
+// "AWGN source" exposing two operations:
+//   uint64_t next_bits()                      -> 64 uniform bits
+//   void fill_normal(double *out, size_t n)   -> n i.i.d. N(0,1) samples
+//
+// Two engines are available, selected at run time (ber_set_rng_engine):
+//   BER_RNG_STD  mt19937_64 + std::normal_distribution. Slow; kept so golden
+//                results from earlier builds can be reproduced.
+//   BER_RNG_FAST xoshiro256++ + 256-layer ziggurat filling whole blocks.
+//                Default.
+//   BER_RNG_PHILOX Philox4x32-10 counters + Box-Muller (philox.h). Every
+//                word and normal is addressable, which is what the GPU
+//                backend needs; slower than BER_RNG_FAST on the CPU.
+
+// SplitMix64 finalizer (Steele et al.), used to expand and decorrelate seeds
+constexpr uint64_t splitmix64(uint64_t x) noexcept {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+// xoshiro256++ (Blackman & Vigna): 256-bit state, period 2^256 - 1.
+// Satisfies UniformRandomBitGenerator.
+class Xoshiro256pp {
+public:
+  using result_type = uint64_t;
+
+  explicit Xoshiro256pp(uint64_t seed) noexcept {
+    for (int k = 0; k < 4; ++k)
+      s_[k] = splitmix64(seed + static_cast<uint64_t>(k) * 0x9E3779B97F4A7C15ULL);
+  }
+
+  static constexpr result_type min() noexcept { return 0; }
+  static constexpr result_type max() noexcept { return ~result_type{0}; }
+
+  result_type operator()() noexcept {
+    const uint64_t result = rotl(s_[0] + s_[3], 23) + s_[0];
+    const uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = rotl(s_[3], 45);
+    return result;
+  }
+
+private:
+  static constexpr uint64_t rotl(uint64_t x, int k) noexcept {
+    return (x << k) | (x >> (64 - k));
+  }
+  std::array<uint64_t, 4> s_{};
+};
+
+// Block ziggurat sampler for N(0,1) (Marsaglia & Tsang, 256 layers)
+void fill_normal_ziggurat(Xoshiro256pp &gen, double *out, size_t n);
+
+// Reference engine: reproduces the std::normal_distribution streams
+class StdAwgnSource {
+public:
+  explicit StdAwgnSource(uint64_t seed) : gen_(seed) {}
+  uint64_t next_bits() { return gen_(); }
+  void fill_normal(double *out, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+      out[i] = normal_(gen_);
+  }
+
+private:
+  std::mt19937_64 gen_;
+  std::normal_distribution<double> normal_{0.0, 1.0};
+};
+
+class FastAwgnSource {
+public:
+  explicit FastAwgnSource(uint64_t seed) noexcept : gen_(seed) {}
+  uint64_t next_bits() noexcept { return gen_(); }
+  void fill_normal(double *out, size_t n) {
+    fill_normal_ziggurat(gen_, out, n);
+  }
+
+private:
+  Xoshiro256pp gen_;
+};
+
+// Counter-based engine: word w and normal j of the stream depend only on
+// (seed, w) and (seed, j), never on how the draws are grouped
+class PhiloxAwgnSource {
+public:
+  explicit PhiloxAwgnSource(uint64_t seed) noexcept : key_(seed) {}
+  uint64_t next_bits() noexcept { return philox_word(key_, word_++); }
+  void fill_normal(double *out, size_t n) noexcept {
+    for (size_t i = 0; i < n; ++i, ++normal_) {
+      if ((normal_ >> 1) != pair_) {
+        pair_ = normal_ >> 1;
+        philox_normal_pair(key_, pair_, z_[0], z_[1]);
+      }
+      out[i] = z_[normal_ & 1];
+    }
+  }
+
+private:
+  uint64_t key_;
+  uint64_t word_ = 0;
+  uint64_t normal_ = 0;
+  uint64_t pair_ = ~uint64_t{0};
+  double z_[2] = {0.0, 0.0};
+};
+
+// Engine ids (mirrored by the BER_RNG_* constants in ber.h)
+constexpr int RNG_ENGINE_STD = 0;
+constexpr int RNG_ENGINE_FAST = 1;
+constexpr int RNG_ENGINE_PHILOX = 2;
+
+constexpr bool is_valid_rng_engine(int engine) noexcept {
+  return engine == RNG_ENGINE_STD || engine == RNG_ENGINE_FAST ||
+         engine == RNG_ENGINE_PHILOX;
+}
+
+// Currently selected engine (process-wide, read once per simulation call)
+int current_rng_engine() noexcept;
+
+// Construct the source for `engine` from `seed` and invoke fn(source)
+template <typename Fn>
+decltype(auto) with_awgn_source(int engine, uint64_t seed, Fn &&fn) {
+  if (engine == RNG_ENGINE_STD) {
+    StdAwgnSource source(seed);
+    return fn(source);
+  }
+  if (engine == RNG_ENGINE_PHILOX) {
+    PhiloxAwgnSource source(seed);
+    return fn(source);
+  }
+  FastAwgnSource source(seed);
+  return fn(source);
+}
+
+#endif // AWGN_H
@@ -0,0 +1,322 @@
+// Native per-stage benchmarks (Google Benchmark)
+//
+// Every stage of the simulation pipeline is timed on its own buffers, so the
+// numbers exclude ctypes overhead and each other. Arguments are the
+// modulation order and the block size in bits (info bits for the coding
+// stages); every benchmark reports ns_per_bit and Mbit_s (the console adds
+// "s" and "/s" suffixes to these rate counters; the JSON holds plain numbers).
+//
+//   make bench-native                      -> console table + bench_native.json
+//   ./bench_ber --benchmark_filter=Viterbi -> one stage
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "awgn.h"
+#include "ber.h"
+#include "coding.h"
+#include "modem.h"
+
+using namespace std;
+
+namespace {
+
+constexpr double BENCH_EBNO_DB = 6.0;
+
+const char *mod_name(int mod_order) {
+  switch (mod_order) {
+  case 2: return "BPSK";
+  case 4: return "QPSK";
+  case 16: return "16-QAM";
+  case 64: return "64-QAM";
+  case 256: return "256-QAM";
+  default: return "?";
+  }
+}
+
+const char *simd_name(int level) {
+  switch (level) {
+  case SIMD_LEVEL_AVX2: return "avx2";
+  case SIMD_LEVEL_AVX512: return "avx512";
+  case SIMD_LEVEL_NEON: return "neon";
+  default: return "scalar";
+  }
+}
+
+// ns_per_bit and Mbit_s from the bits processed per iteration
+void set_bit_counters(benchmark::State &state, long long bits) {
+  using benchmark::Counter;
+  const double b = static_cast<double>(bits);
+  state.counters["ns_per_bit"] =
+      Counter(b * 1e-9, Counter::kIsIterationInvariantRate | Counter::kInvert);
+  state.counters["Mbit_s"] = Counter(b * 1e-6, Counter::kIsIterationInvariantRate);
+  state.SetItemsProcessed(state.iterations() * bits);
+}
+
+// =============================================================================
+// UNCODED STAGES
+// =============================================================================
+
+// One block of the uncoded pipeline: payload, clean symbols, unit noise,
+// received symbols and decisions, all prepared in SetUp so each benchmark
+// touches only its own stage
+class UncodedStage : public benchmark::Fixture {
+public:
+  void SetUp(const benchmark::State &state) override {
+    mod = static_cast<int>(state.range(0));
+    bits = state.range(1);
+    num_sym = static_cast<size_t>(bits / bits_per_symbol(mod));
+    const double esno = bits_per_symbol(mod) * pow(10.0, BENCH_EBNO_DB / 10.0);
+    sigma = sqrt(1.0 / esno / 2.0);
+
+    FastAwgnSource src(42);
+    tx.resize(words_for_bits(static_cast<size_t>(bits)));
+    rx.resize(tx.size());
+    for (auto &w : tx) w = src.next_bits();
+    re.resize(num_sym);
+    im.resize(num_sym);
+    noise.resize(2 * num_sym);
+    modulate_soa(tx.data(), num_sym, mod, re.data(), im.data());
+    src.fill_normal(noise.data(), noise.size());
+    rx_re = re;
+    rx_im = im;
+    for (size_t i = 0; i < num_sym; ++i) {
+      rx_re[i] += sigma * noise[2 * i];
+      rx_im[i] += sigma * noise[2 * i + 1];
+    }
+    demodulate_soa(rx_re.data(), rx_im.data(), num_sym, mod, rx.data());
+    llr.resize(static_cast<size_t>(bits));
+  }
+
+  void TearDown(const benchmark::State &) override {}
+
+  int mod = 2;
+  long long bits = 0;
+  size_t num_sym = 0;
+  double sigma = 0.0;
+  vector<uint64_t> tx, rx;
+  vector<double> re, im, noise, rx_re, rx_im, llr;
+};
+
+// Payload bits (xoshiro256++, 64 per draw)
+BENCHMARK_DEFINE_F(UncodedStage, RngBits)(benchmark::State &state) {
+  Xoshiro256pp gen(7);
+  for (auto _ : state) {
+    for (auto &w : tx) w = gen();
+    benchmark::DoNotOptimize(tx.data());
+    benchmark::ClobberMemory();
+  }
+  set_bit_counters(state, bits);
+  state.SetLabel(mod_name(mod));
+}
+
+BENCHMARK_DEFINE_F(UncodedStage, Modulate)(benchmark::State &state) {
+  for (auto _ : state) {
+    modulate_soa(tx.data(), num_sym, mod, re.data(), im.data());
+    benchmark::DoNotOptimize(re.data());
+    benchmark::ClobberMemory();
+  }
+  set_bit_counters(state, bits);
+  state.SetLabel(string(mod_name(mod)) + " " + simd_name(current_simd_level()));
+}
+
+// Ziggurat unit normals for I and Q, scaled and added to the symbols
+BENCHMARK_DEFINE_F(UncodedStage, Awgn)(benchmark::State &state) {
+  FastAwgnSource src(9);
+  for (auto _ : state) {
+    src.fill_normal(noise.data(), noise.size());
+    for (size_t i = 0; i < num_sym; ++i) {
+      rx_re[i] = re[i] + sigma * noise[2 * i];
+      rx_im[i] = im[i] + sigma * noise[2 * i + 1];
+    }
+    benchmark::DoNotOptimize(rx_re.data());
+    benchmark::DoNotOptimize(rx_im.data());
+    benchmark::ClobberMemory();
+  }
+  set_bit_counters(state, bits);
+  state.SetLabel(mod_name(mod));
+}
+
+BENCHMARK_DEFINE_F(UncodedStage, Demodulate)(benchmark::State &state) {
+  for (auto _ : state) {
+    demodulate_soa(rx_re.data(), rx_im.data(), num_sym, mod, rx.data());
+    benchmark::DoNotOptimize(rx.data());
+    benchmark::ClobberMemory();
+  }
+  set_bit_counters(state, bits);
+  state.SetLabel(string(mod_name(mod)) + " " + simd_name(current_simd_level()));
+}
+
+BENCHMARK_DEFINE_F(UncodedStage, ErrorCount)(benchmark::State &state) {
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        count_bit_errors(tx.data(), rx.data(), static_cast<size_t>(bits)));
+  set_bit_counters(state, bits);
+  state.SetLabel(mod_name(mod));
+}
+
+// Soft demapper; range(2) is the LLR mode (only 16-QAM depends on it)
+BENCHMARK_DEFINE_F(UncodedStage, Llr)(benchmark::State &state) {
+  const int mode = static_cast<int>(state.range(2));
+  const double n0 = 2.0 * sigma * sigma;
+  for (auto _ : state) {
+    llr_soa(mode, rx_re.data(), rx_im.data(), num_sym, mod, n0, llr.data());
+    benchmark::DoNotOptimize(llr.data());
+    benchmark::ClobberMemory();
+  }
+  set_bit_counters(state, bits);
+  static const char *const modes[] = {"exact", "max-log", "max-log f32"};
+  state.SetLabel(string(mod_name(mod)) + " " + modes[mode]);
+}
+
+// The whole uncoded path through the public entry point, for comparison
+// with the sum of the stages
+BENCHMARK_DEFINE_F(UncodedStage, EndToEnd)(benchmark::State &state) {
+  unsigned long long seed = 1;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(compute_ber_seeded(mod, BENCH_EBNO_DB, bits, seed++));
+  set_bit_counters(state, bits);
+  state.SetLabel(mod_name(mod));
+}
+
+void uncoded_args(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"mod", "bits"});
+  for (int mod : modulation_orders)
+    for (long long bits : {4096LL, 65536LL, 1LL << 20})
+      b->Args({mod, bits});
+}
+
+void llr_args(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"mod", "bits", "mode"});
+  for (long long bits : {4096LL, 65536LL, 1LL << 20}) {
+    for (int mod : {2, 4})
+      b->Args({mod, bits, LLR_MODE_EXACT});
+    for (int mode : {LLR_MODE_EXACT, LLR_MODE_MAXLOG, LLR_MODE_MAXLOG_F32})
+      b->Args({16, bits, mode});
+  }
+}
+
+BENCHMARK_REGISTER_F(UncodedStage, RngBits)->Apply(uncoded_args);
+BENCHMARK_REGISTER_F(UncodedStage, Modulate)->Apply(uncoded_args);
+BENCHMARK_REGISTER_F(UncodedStage, Awgn)->Apply(uncoded_args);
+BENCHMARK_REGISTER_F(UncodedStage, Demodulate)->Apply(uncoded_args);
+BENCHMARK_REGISTER_F(UncodedStage, ErrorCount)->Apply(uncoded_args);
+BENCHMARK_REGISTER_F(UncodedStage, Llr)->Apply(llr_args);
+BENCHMARK_REGISTER_F(UncodedStage, EndToEnd)->Apply(uncoded_args);
+
+// =============================================================================
+// CODING STAGES
+// =============================================================================
+
+// Info bits, their rate-1/2 codeword and noiseless +-1 LLRs; range(0) is
+// the info length in bits
+class CodingStage : public benchmark::Fixture {
+public:
+  void SetUp(const benchmark::State &state) override {
+    bits = state.range(0);
+    const size_t coded_len = 2 * (static_cast<size_t>(bits) + 6);
+    FastAwgnSource src(5);
+    info_words.resize(words_for_bits(static_cast<size_t>(bits)));
+    for (auto &w : info_words) w = src.next_bits();
+    info.reset(new bool[bits]);
+    for (long long i = 0; i < bits; ++i)
+      info[i] = (info_words[i >> 6] >> (i & 63)) & 1;
+    coded.reset(new bool[coded_len]);
+    coded_words.resize(words_for_bits(coded_len));
+    decoded.reset(new bool[bits]);
+    decoded_words.resize(info_words.size());
+    int len = 0;
+    convolutional_encode(info.get(), static_cast<int>(bits), coded.get(), &len);
+    llr.resize(coded_len);
+    for (size_t i = 0; i < coded_len; ++i) llr[i] = coded[i] ? 1.0 : -1.0;
+  }
+
+  void TearDown(const benchmark::State &) override {
+    info.reset();
+    coded.reset();
+    decoded.reset();
+  }
+
+  long long bits = 0;
+  vector<uint64_t> info_words, coded_words, decoded_words;
+  unique_ptr<bool[]> info, coded, decoded;
+  vector<double> llr;
+};
+
+// C API on bool arrays
+BENCHMARK_DEFINE_F(CodingStage, ConvEncode)(benchmark::State &state) {
+  int len = 0;
+  for (auto _ : state) {
+    convolutional_encode(info.get(), static_cast<int>(bits), coded.get(), &len);
+    benchmark::DoNotOptimize(coded.get());
+    benchmark::ClobberMemory();
+  }
+  set_bit_counters(state, bits);
+}
+
+// Packed encoder used by the fused coded pipeline
+BENCHMARK_DEFINE_F(CodingStage, ConvEncodePacked)(benchmark::State &state) {
+  for (auto _ : state) {
+    convolutional_encode_packed(info_words.data(), bits, coded_words.data());
+    benchmark::DoNotOptimize(coded_words.data());
+    benchmark::ClobberMemory();
+  }
+  set_bit_counters(state, bits);
+}
+
+BENCHMARK_DEFINE_F(CodingStage, ViterbiDecode)(benchmark::State &state) {
+  int len = 0;
+  for (auto _ : state) {
+    viterbi_decode(llr.data(), static_cast<int>(llr.size()), decoded.get(), &len);
+    benchmark::DoNotOptimize(decoded.get());
+    benchmark::ClobberMemory();
+  }
+  set_bit_counters(state, bits);
+}
+
+// Incremental decoder of the fused pipeline, fed one 8192-bit tile at a time
+BENCHMARK_DEFINE_F(CodingStage, ViterbiBlock)(benchmark::State &state) {
+  ViterbiBlockDecoder decoder;
+  const long long stages = static_cast<long long>(llr.size() / 2);
+  for (auto _ : state) {
+    decoder.reset(stages);
+    for (long long s = 0; s < stages; s += 4096)
+      decoder.push(llr.data() + 2 * s, std::min<long long>(4096, stages - s));
+    benchmark::DoNotOptimize(decoder.finish_packed(decoded_words.data()));
+    benchmark::ClobberMemory();
+  }
+  set_bit_counters(state, bits);
+}
+
+// The whole coded path (BPSK) through the workspace entry point
+BENCHMARK_DEFINE_F(CodingStage, CodedEndToEnd)(benchmark::State &state) {
+  ber_coded_workspace_t *ws = ber_coded_workspace_create();
+  int seed = 1;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        compute_ber_coded_ws(ws, 2, BENCH_EBNO_DB, bits, seed++));
+  ber_coded_workspace_free(ws);
+  set_bit_counters(state, bits);
+}
+
+void coding_args(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"bits"});
+  for (long long bits : {4096LL, 65536LL, 262144LL})
+    b->Arg(bits);
+}
+
+BENCHMARK_REGISTER_F(CodingStage, ConvEncode)->Apply(coding_args);
+BENCHMARK_REGISTER_F(CodingStage, ConvEncodePacked)->Apply(coding_args);
+BENCHMARK_REGISTER_F(CodingStage, ViterbiDecode)->Apply(coding_args)->Unit(benchmark::kMicrosecond);
+BENCHMARK_REGISTER_F(CodingStage, ViterbiBlock)->Apply(coding_args)->Unit(benchmark::kMicrosecond);
+BENCHMARK_REGISTER_F(CodingStage, CodedEndToEnd)->Apply(coding_args)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
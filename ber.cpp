@@ -1,28 +1,41 @@
 #include <algorithm> // STL algorithms
 #include <array>     // std::array
+#include <atomic>    // chunk work counter
+#include <bit>       // std::popcount
 #include <cmath>
 #include <complex>
+#include <condition_variable>
+#include <cstdint>
 #include <cstring>    // For strcpy in error buffer
 #include <functional> // std::function
+#include <map>
+#include <memory>
+#include <mutex>
 #include <numeric>    // transform_reduce
 #include <optional>   // std::optional
 #include <random>
+#include <thread>
 #include <utility> // For std::pair
 #include <vector>
 
+#include "awgn.h"
+#include "ber.h"
+#include "cache.h"
+#include "channel.h"
 #include "coding.h"
+#include "job_sched.h"
+#include "modem.h"
+#include "stats.h"
 
+#ifdef BER_GPU
+#include "gpu.h"
+#endif
 
 
 using namespace std;
 
 using cdouble = complex<double>;
 
-// Use mathematical constants (C++20 style but with fallback)
-constexpr double M_SQRT2_INV = 0.7071067811865476;   // 1.0 / sqrt(2.0)
-constexpr double M_SQRT10_INV = 0.31622776601683794; // 1.0 / sqrt(10.0)
-constexpr double scale_qpsk = M_SQRT2_INV;
-constexpr double scale_16qam = M_SQRT10_INV;
 constexpr int MAX_ERR_MSG = 256;
 
 // Reintroduce traits instead of concepts for wider compiler compatibility
@@ -32,51 +45,9 @@ using is_numeric = std::enable_if_t<std::is_arithmetic_v<T>, int>;
 // Forward declarations
 vector<cdouble> modulate_impl(const vector<bool> &bits, int mod_order);
 
-// 16-QAM Gray mapping (per component, treated as a 4-PAM with Gray code)
-// Adjacent amplitude levels must differ by exactly one bit to minimize the
-// bit error impact of small symbol decision errors.
-// Conventional Gray-ordered amplitude sequence (from +3 to -3) is:
-//   +3   +1   -1   -3
-//  bits: 00   01   11   10   (each neighbor differs by 1 bit)
-// Our lookup uses the bit-pair (msb, lsb) combined as index = (msb<<1)|lsb.
-// Index enumeration order is therefore: 00, 01, 10, 11
-// To preserve the Gray relationships we intentionally store the table in this
-// index order (NOT in amplitude order). That means:
-//   index 0 (00) -> +3
-//   index 1 (01) -> +1
-//   index 2 (10) -> -3  (note: amplitude order would expect -1 here; this is
-//                        why the array looks "unsorted")
-//   index 3 (11) -> -1
-// This still implements the correct Gray mapping because demodulation maps the
-// quantized amplitude levels back to the same bit pairs:
-//   +3 -> 00, +1 -> 01, -1 -> 11, -3 -> 10
-// The apparent “out of order” placement of -3 and -1 in the lookup array is
-// deliberate and NOT a bug.
-constexpr std::array<double, 4> qam_levels = {3.0, 1.0, -3.0, -1.0};
-
-constexpr double get_level(bool msb, bool lsb) noexcept {
-  // Convert bool pair to index: 00->0, 01->1, 10->2, 11->3
-  const size_t index =
-      (static_cast<size_t>(msb) << 1) | static_cast<size_t>(lsb);
-  return qam_levels[index];
-}
-
-// Compile-time validation of Gray mapping
-static_assert(get_level(false, false) == 3.0, "16QAM Gray mapping error (00)");
-static_assert(get_level(false, true) == 1.0, "16QAM Gray mapping error (01)");
-static_assert(get_level(true, false) == -3.0, "16QAM Gray mapping error (10)");
-static_assert(get_level(true, true) == -1.0, "16QAM Gray mapping error (11)");
-
-constexpr double demod_level(double val) noexcept {
-  return (val > 2.0) ? 3.0 : (val > 0.0) ? 1.0 : (val > -2.0) ? -1.0 : -3.0;
-}
-
-// Modern validation with constexpr array
-constexpr std::array<int, 3> valid_mod_orders = {2, 4, 16};
-
+// Supported orders are the Modulator<M> instantiations (modem.h)
 constexpr bool is_valid_mod_order(int mod_order) noexcept {
-  return std::find(valid_mod_orders.begin(), valid_mod_orders.end(),
-                   mod_order) != valid_mod_orders.end();
+  return modulation_index(mod_order) >= 0;
 }
 
 // Modern error handling approach
@@ -87,7 +58,7 @@ constexpr bool is_valid_mod_order(int mod_order) noexcept {
     return std::nullopt;
   }
 
-  int bits_per_sym = static_cast<int>(log2(mod_order));
+  int bits_per_sym = bits_per_symbol(mod_order);
   if (bits.size() < static_cast<size_t>(bits_per_sym)) [[unlikely]] {
     return std::nullopt;
   }
@@ -101,9 +72,29 @@ constexpr bool is_valid_mod_order(int mod_order) noexcept {
   return result ? *result : vector<cdouble>{};
 }
 
+// =============================================================================
+// PACKED BIT HELPERS
+// =============================================================================
+// Layout, the modulate/demodulate kernels and count_bit_errors live in
+// modem.h.
+
+vector<uint64_t> pack_bits(const vector<bool> &bits, size_t num_bits) {
+  vector<uint64_t> words(words_for_bits(num_bits), 0);
+  for (size_t i = 0; i < num_bits; ++i)
+    words[i >> 6] |= static_cast<uint64_t>(bits[i]) << (i & 63);
+  return words;
+}
+
+vector<bool> unpack_bits(const vector<uint64_t> &words, size_t num_bits) {
+  vector<bool> bits(num_bits);
+  for (size_t i = 0; i < num_bits; ++i)
+    bits[i] = (words[i >> 6] >> (i & 63)) & 1;
+  return bits;
+}
+
 [[nodiscard]] vector<cdouble> modulate_impl(const vector<bool> &bits,
                                            int mod_order) {
-  int bits_per_sym = static_cast<int>(log2(mod_order));
+  int bits_per_sym = bits_per_symbol(mod_order);
   size_t num_sym = bits.size() / bits_per_sym;
   vector<cdouble> symbols(num_sym);
 
@@ -111,86 +102,32 @@ constexpr bool is_valid_mod_order(int mod_order) noexcept {
     return symbols;
   }
 
-  if (mod_order == 2) {
-    for (size_t i = 0; i < num_sym; ++i) {
-      symbols[i] = bits[i] ? cdouble(-1.0) : cdouble(1.0);
-    }
-  } else if (mod_order == 4) {
-    for (size_t i = 0; i < num_sym; ++i) {
-      // Add bounds checking
-      if (2 * i + 1 >= bits.size())
-        break;
-      double re = bits[2 * i] ? -1.0 : 1.0;
-      double im = bits[2 * i + 1] ? -1.0 : 1.0;
-      symbols[i] = cdouble(re, im) * scale_qpsk;
-    }
-  } else if (mod_order == 16) {
-    for (size_t i = 0; i < num_sym; ++i) {
-      // Add bounds checking
-      if (4 * i + 3 >= bits.size())
-        break;
-      double re = get_level(bits[4 * i], bits[4 * i + 2]);
-      double im = get_level(bits[4 * i + 1], bits[4 * i + 3]);
-      symbols[i] = cdouble(re, im) * scale_16qam;
-    }
-  }
+  const auto words = pack_bits(bits, num_sym * bits_per_sym);
+  vector<double> re(num_sym), im(num_sym);
+  modulate_soa(words.data(), num_sym, mod_order, re.data(), im.data());
+  for (size_t i = 0; i < num_sym; ++i)
+    symbols[i] = cdouble(re[i], im[i]);
   return symbols;
 }
 
 [[nodiscard]] vector<bool> demodulate(const vector<cdouble> &symbols,
                                      int mod_order) {
-  int bits_per_sym = static_cast<int>(log2(mod_order));
+  int bits_per_sym = bits_per_symbol(mod_order);
   size_t num_sym = symbols.size();
-  vector<bool> bits(num_sym * bits_per_sym);
 
   if (num_sym == 0) {
-    return bits; // Return empty vector if no symbols
-  }
-
-  if (mod_order == 2) {
-    for (size_t i = 0; i < num_sym; ++i) {
-      bits[i] = (real(symbols[i]) < 0.0);
-    }
-  } else if (mod_order == 4) {
-    for (size_t i = 0; i < num_sym; ++i) {
-      // Add bounds checking
-      if (2 * i + 1 >= bits.size())
-        break;
-      cdouble y = symbols[i] / scale_qpsk;
-      bits[2 * i] = (real(y) < 0.0);
-      bits[2 * i + 1] = (imag(y) < 0.0);
-    }
-  } else if (mod_order == 16) {
-    for (size_t i = 0; i < num_sym; ++i) {
-      // Add bounds checking
-      if (4 * i + 3 >= bits.size())
-        break;
-      cdouble z = symbols[i] / scale_16qam;
-      double re_level = demod_level(real(z));
-      double im_level = demod_level(imag(z));
-      // Modern lookup approach with constexpr mapping
-      constexpr auto level_to_bits = [](double level) -> pair<bool, bool> {
-        switch (static_cast<int>(level)) {
-        case 3:
-          return {false, false};
-        case 1:
-          return {false, true};
-        case -1:
-          return {true, true};
-        case -3:
-        default:
-          return {true, false};
-        }
-      };
-      auto [msb_re, lsb_re] = level_to_bits(re_level);
-      bits[4 * i] = msb_re;
-      bits[4 * i + 2] = lsb_re;
-      auto [msb_im, lsb_im] = level_to_bits(im_level);
-      bits[4 * i + 1] = msb_im;
-      bits[4 * i + 3] = lsb_im;
-    }
+    return vector<bool>(); // Return empty vector if no symbols
   }
-  return bits;
+
+  vector<double> re(num_sym), im(num_sym);
+  for (size_t i = 0; i < num_sym; ++i) {
+    re[i] = real(symbols[i]);
+    im[i] = imag(symbols[i]);
+  }
+  const size_t num_bits = num_sym * bits_per_sym;
+  vector<uint64_t> words(words_for_bits(num_bits));
+  demodulate_soa(re.data(), im.data(), num_sym, mod_order, words.data());
+  return unpack_bits(words, num_bits);
 }
 
 // Modern utility functions
@@ -204,129 +141,1211 @@ template <typename T, typename = is_numeric<T>>
   return T{10.0} * std::log10(linear_value);
 }
 
-// Modern random bit generator
-class BitGenerator {
-private:
-  std::mt19937 gen_;
-  std::uniform_int_distribution<int> dist_;
+// =============================================================================
+// STREAMING CHUNKED SIMULATION
+// =============================================================================
+
+// The bit budget is cut into chunks of a fixed number of symbols. Each chunk
+// owns an independent generator seeded from (seed, chunk index), so the error
+// count is a pure function of the inputs no matter how chunks are scheduled.
+constexpr long long CHUNK_SYMBOLS = 1LL << 16;
+
+// Chunks are processed in cache-sized tiles (generate -> modulate -> AWGN ->
+// demodulate -> count) through per-thread buffers, so memory stays flat
+// whatever the bit count.
+constexpr size_t TILE_SYMBOLS = 4096;
+
+constexpr uint64_t chunk_seed(uint64_t seed, uint64_t chunk) noexcept {
+  return splitmix64(splitmix64(seed) ^ chunk);
+}
+
+// Reusable per-thread tile storage
+struct TileBuffers {
+  static constexpr size_t WORDS = TILE_SYMBOLS * MAX_BITS_PER_SYMBOL / 64;
+  array<uint64_t, WORDS> tx_words;
+  array<uint64_t, WORDS> rx_words;
+  array<double, TILE_SYMBOLS> re; // Symbols, split real/imag
+  array<double, TILE_SYMBOLS> im;
+  array<double, 2 * TILE_SYMBOLS> noise; // Unit-variance I/Q pairs
+  array<double, TILE_SYMBOLS> rx_re;     // Noisy copies (SNR sweeps only)
+  array<double, TILE_SYMBOLS> rx_im;
+  array<double, TILE_SYMBOLS> weight_re; // Likelihood ratios (IS only)
+  array<double, TILE_SYMBOLS> weight_im;
+};
 
+// Tiles of the ber_workspace_t bound to this thread by a *_ws entry point
+thread_local TileBuffers *bound_tiles = nullptr;
+
+TileBuffers &thread_tile_buffers() {
+  if (bound_tiles)
+    return *bound_tiles;
+  thread_local auto buffers = [] {
+    BER_STATS_ALLOC(sizeof(TileBuffers));
+    return std::make_unique<TileBuffers>();
+  }();
+  return *buffers;
+}
+
+// Routes this thread's tile work to caller-owned buffers for one scope
+class ScopedTiles {
 public:
-  BitGenerator() : gen_(std::random_device{}()), dist_(0, 1) {}
+  explicit ScopedTiles(TileBuffers &tiles) noexcept : saved_(bound_tiles) {
+    bound_tiles = &tiles;
+  }
+  ~ScopedTiles() { bound_tiles = saved_; }
+  ScopedTiles(const ScopedTiles &) = delete;
+  ScopedTiles &operator=(const ScopedTiles &) = delete;
 
-  bool operator()() { return static_cast<bool>(dist_(gen_)); }
+private:
+  TileBuffers *saved_;
 };
 
-extern "C" double compute_ber(int mod_order, double snr_db,
-                              long long num_bits) {
-  // Validate modulation order
-  if (mod_order != 2 && mod_order != 4 && mod_order != 16) [[unlikely]]
-    return -1.0;
+// Counts a workspace vector's reallocation before it grows to n elements
+template <typename T>
+inline void note_growth([[maybe_unused]] const vector<T> &v,
+                        [[maybe_unused]] size_t n) noexcept {
+  if (n > v.capacity())
+    BER_STATS_ALLOC(n * sizeof(T));
+}
 
-  // Validate SNR range (reasonable bounds)
-  if (snr_db < -50.0 || snr_db > 50.0) [[unlikely]]
-    return -1.0;
+// Simulate one chunk of num_sym symbols and return its bit error count.
+// Per tile the source supplies the payload words first, then 2n unit normals
+// (I before Q per symbol) scaled by sigma. If tile_errors is given it
+// receives the error count of every tile. With a fading channel the noise is
+// equalized first; symbol i of the chunk sits at channel time t0 + i.
+template <typename Source>
+long long simulate_chunk_errors(Source &src, int mod_order, double sigma,
+                                long long num_sym,
+                                long long *tile_errors = nullptr,
+                                const FadingChannel *fading = nullptr,
+                                uint64_t t0 = 0) {
+  const int bits_per_sym = bits_per_symbol(mod_order);
+  TileBuffers &buf = thread_tile_buffers();
+
+  long long errors = 0;
+  for (long long done = 0; done < num_sym;) {
+    const size_t n = static_cast<size_t>(
+        std::min<long long>(TILE_SYMBOLS, num_sym - done));
+    const size_t n_bits = n * static_cast<size_t>(bits_per_sym);
+
+    // Each 64-bit draw supplies 64 uniform bits
+    const size_t n_words = words_for_bits(n_bits);
+    {
+      BER_STAGE_TIMER(BER_STAGE_RNG, 8 * n_words);
+      for (size_t w = 0; w < n_words; ++w)
+        buf.tx_words[w] = src.next_bits();
+    }
+    {
+      BER_STAGE_TIMER(BER_STAGE_MODULATE, 16 * n);
+      modulate_soa(buf.tx_words.data(), n, mod_order, buf.re.data(), buf.im.data());
+    }
+    {
+      BER_STAGE_TIMER(BER_STAGE_AWGN, 16 * n);
+      src.fill_normal(buf.noise.data(), 2 * n);
+      if (fading)
+        fading->equalize_noise(t0 + static_cast<uint64_t>(done), buf.noise.data(), n);
+      for (size_t i = 0; i < n; ++i) {
+        buf.re[i] += sigma * buf.noise[2 * i];
+        buf.im[i] += sigma * buf.noise[2 * i + 1];
+      }
+    }
+    {
+      BER_STAGE_TIMER(BER_STAGE_DEMODULATE, 8 * n_words);
+      demodulate_soa(buf.re.data(), buf.im.data(), n, mod_order, buf.rx_words.data());
+    }
+    long long tile;
+    {
+      BER_STAGE_TIMER(BER_STAGE_ERROR_COUNT, 0);
+      tile = count_bit_errors(buf.tx_words.data(), buf.rx_words.data(), n_bits);
+    }
+    if (tile_errors)
+      *tile_errors++ = tile;
+    errors += tile;
+    done += static_cast<long long>(n);
+  }
+  return errors;
+}
 
-  int bits_per_sym = static_cast<int>(log2(mod_order));
+// Simulate one chunk at several noise levels. The payload, the clean symbols
+// and the unit noise are drawn exactly as in simulate_chunk_errors and reused
+// for every sigma, so errors[k] equals simulate_chunk_errors(..., sigmas[k]).
+template <typename Source>
+void simulate_chunk_sweep(Source &src, int mod_order, const double *sigmas,
+                          int n_snr, long long num_sym, long long *errors,
+                          const FadingChannel *fading = nullptr, uint64_t t0 = 0) {
+  const int bits_per_sym = bits_per_symbol(mod_order);
+  TileBuffers &buf = thread_tile_buffers();
+
+  for (long long done = 0; done < num_sym;) {
+    const size_t n = static_cast<size_t>(
+        std::min<long long>(TILE_SYMBOLS, num_sym - done));
+    const size_t n_bits = n * static_cast<size_t>(bits_per_sym);
+
+    const size_t n_words = words_for_bits(n_bits);
+    {
+      BER_STAGE_TIMER(BER_STAGE_RNG, 8 * n_words);
+      for (size_t w = 0; w < n_words; ++w)
+        buf.tx_words[w] = src.next_bits();
+    }
+    {
+      BER_STAGE_TIMER(BER_STAGE_MODULATE, 16 * n);
+      modulate_soa(buf.tx_words.data(), n, mod_order, buf.re.data(), buf.im.data());
+    }
+    {
+      BER_STAGE_TIMER(BER_STAGE_AWGN, 16 * n);
+      src.fill_normal(buf.noise.data(), 2 * n);
+      if (fading)
+        fading->equalize_noise(t0 + static_cast<uint64_t>(done), buf.noise.data(), n);
+    }
+    for (int k = 0; k < n_snr; ++k) {
+      const double sigma = sigmas[k];
+      {
+        BER_STAGE_TIMER(BER_STAGE_AWGN, 16 * n);
+        for (size_t i = 0; i < n; ++i) {
+          buf.rx_re[i] = buf.re[i] + sigma * buf.noise[2 * i];
+          buf.rx_im[i] = buf.im[i] + sigma * buf.noise[2 * i + 1];
+        }
+      }
+      {
+        BER_STAGE_TIMER(BER_STAGE_DEMODULATE, 8 * n_words);
+        demodulate_soa(buf.rx_re.data(), buf.rx_im.data(), n, mod_order,
+                       buf.rx_words.data());
+      }
+      BER_STAGE_TIMER(BER_STAGE_ERROR_COUNT, 0);
+      errors[k] += count_bit_errors(buf.tx_words.data(), buf.rx_words.data(), n_bits);
+    }
+    done += static_cast<long long>(n);
+  }
+}
 
-  // Adjust num_bits to be divisible by bits_per_sym
-  if (num_bits % bits_per_sym != 0)
-    num_bits -= num_bits % bits_per_sym;
+// Run fn(item) for item in [0, num_items) on up to `threads` workers. Workers
+// pull indices from a shared counter; the calling thread works too.
+template <typename ItemFn>
+void parallel_for_items(long long num_items, int threads, ItemFn &&fn) {
+  if (threads <= 0)
+    threads = static_cast<int>(std::max(1u, thread::hardware_concurrency()));
+  const int workers =
+      static_cast<int>(std::min<long long>(threads, std::max(1LL, num_items)));
+
+  atomic<long long> next_item{0};
+  auto worker = [&]() {
+    for (long long i = next_item.fetch_add(1); i < num_items;
+         i = next_item.fetch_add(1)) {
+      fn(i);
+    }
+  };
+
+  vector<thread> pool;
+  pool.reserve(static_cast<size_t>(workers - 1));
+  for (int t = 1; t < workers; ++t)
+    pool.emplace_back(worker);
+  worker();
+  for (auto &t : pool)
+    t.join();
+}
 
-  // Return 0 BER for non-positive number of bits
-  if (num_bits <= 0) [[unlikely]]
-    return 0.0;
+// Run fn(chunk) for every chunk in parallel and sum the results. Integer
+// addition is order independent, so the sum is deterministic.
+template <typename ChunkFn>
+long long parallel_chunk_sum(long long num_chunks, int threads, ChunkFn &&fn) {
+  atomic<long long> total{0};
+  parallel_for_items(num_chunks, threads,
+                     [&](long long c) { total.fetch_add(fn(c)); });
+  return total.load();
+}
 
-  // Reasonable upper limit for number of bits to prevent excessive memory usage
-  if (num_bits > 100000000LL) [[unlikely]]
-    return -1.0;
-  // Modern STL approach for bit generation
-  random_device rd;
-  mt19937 gen(rd());
-  vector<bool> bits(static_cast<size_t>(num_bits));
-  // Use modern generator directly
-  BitGenerator bit_gen;
-  std::generate(bits.begin(), bits.end(), std::ref(bit_gen));
-
-  vector<cdouble> symbols = modulate(bits, mod_order);
-  double ebno_lin = db_to_linear(snr_db);
-  double esno_lin = static_cast<double>(bits_per_sym) * ebno_lin;
-  double n0 = 1.0 / esno_lin;
-  double sigma = sqrt(n0 / 2.0);
-  normal_distribution<double> noise_dist(0.0, sigma);
+// Errors of chunk c of a num_sym-symbol uncoded stream
+long long uncoded_chunk_errors(int engine, int mod_order, double sigma,
+                               long long num_sym, uint64_t seed, long long c,
+                               const FadingChannel *fading = nullptr) {
+  const long long len = std::min(CHUNK_SYMBOLS, num_sym - c * CHUNK_SYMBOLS);
+  return with_awgn_source(engine, chunk_seed(seed, static_cast<uint64_t>(c)),
+                          [&](auto &src) {
+                            return simulate_chunk_errors(
+                                src, mod_order, sigma, len, nullptr, fading,
+                                static_cast<uint64_t>(c * CHUNK_SYMBOLS));
+                          });
+}
 
-  // Modern STL approach with algorithm
-  std::for_each(symbols.begin(), symbols.end(), [&](cdouble &s) {
-    s += cdouble(noise_dist(gen), noise_dist(gen));
+// Pointer view of an optional fading channel (nullptr for AWGN)
+inline const FadingChannel *fading_ptr(const std::optional<FadingChannel> &f) noexcept {
+  return f ? &*f : nullptr;
+}
+
+// Noise standard deviation per I/Q component for unit-energy symbols
+double uncoded_sigma(int mod_order, double snr_db) {
+  const int bits_per_sym = bits_per_symbol(mod_order);
+  const double ebno_lin = db_to_linear(snr_db);
+  const double esno_lin = static_cast<double>(bits_per_sym) * ebno_lin;
+  return sqrt(1.0 / esno_lin / 2.0);
+}
+
+// =============================================================================
+// EXECUTION BACKEND
+// =============================================================================
+
+// log2(CHUNK_SYMBOLS), for the device's chunk indexing
+constexpr int CHUNK_SHIFT = 16;
+static_assert(CHUNK_SYMBOLS == 1LL << CHUNK_SHIFT, "chunk shift out of date");
+
+atomic<int> g_backend{BER_BACKEND_CPU};
+
+bool gpu_available() noexcept {
+#ifdef BER_GPU
+  return gpu_backend_available();
+#else
+  return false;
+#endif
+}
+
+// Errors of the whole num_sym-symbol uncoded stream: on the device when the
+// GPU backend is selected, the engine is Philox and the channel is AWGN,
+// else chunk-parallel on the CPU (also the fallback when the device fails)
+long long uncoded_stream_errors(int engine, int mod_order, double sigma,
+                                long long num_sym, uint64_t seed, int threads,
+                                const FadingChannel *fading) {
+#ifdef BER_GPU
+  long long gpu_errors = 0;
+  if (engine == RNG_ENGINE_PHILOX && !fading &&
+      g_backend.load(memory_order_relaxed) == BER_BACKEND_GPU &&
+      gpu_uncoded_errors(bits_per_symbol(mod_order), sigma, num_sym,
+                         CHUNK_SHIFT, seed, &gpu_errors))
+    return gpu_errors;
+#endif
+  const long long num_chunks = (num_sym + CHUNK_SYMBOLS - 1) / CHUNK_SYMBOLS;
+  return parallel_chunk_sum(num_chunks, threads, [&](long long c) {
+    return uncoded_chunk_errors(engine, mod_order, sigma, num_sym, seed, c, fading);
   });
+}
 
-  vector<bool> rx_bits = demodulate(symbols, mod_order);
+extern "C" int ber_set_backend(int backend) {
+  if (backend != BER_BACKEND_CPU && (backend != BER_BACKEND_GPU || !gpu_available()))
+    return -1;
+  g_backend.store(backend, memory_order_relaxed);
+  return 0;
+}
 
-  // Modern STL approach for error counting
-  const auto errors =
-      std::transform_reduce(bits.begin(), bits.end(), rx_bits.begin(), 0LL,
-                            std::plus<>{},        // reduction operation
-                            std::not_equal_to<>{} // transform operation
-      );
+extern "C" int ber_get_backend() { return g_backend.load(memory_order_relaxed); }
+
+extern "C" int ber_gpu_available() { return gpu_available() ? 1 : 0; }
+
+// Philox4x32-10 must reproduce the Random123 known-answer vectors, and the
+// fused per-symbol kernel (what each GPU thread runs) must count exactly the
+// errors of the BER_RNG_PHILOX tile loop, including a partial last chunk.
+extern "C" int run_philox_kernel_test(char *err_msg) {
+  struct Kat {
+    Philox4x32 ctr;
+    uint32_t k0, k1;
+    Philox4x32 expect;
+  };
+  static const Kat kats[] = {
+      {{{0, 0, 0, 0}}, 0, 0, {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}}},
+      {{{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}},
+       0xffffffff,
+       0xffffffff,
+       {{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}}},
+      {{{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+       0xa4093822,
+       0x299f31d0,
+       {{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}}};
+  for (size_t i = 0; i < sizeof(kats) / sizeof(kats[0]); ++i) {
+    const Philox4x32 got = philox4x32_10(kats[i].ctr, kats[i].k0, kats[i].k1);
+    if (memcmp(got.v, kats[i].expect.v, sizeof(got.v)) != 0) {
+      snprintf(err_msg, MAX_ERR_MSG, "Philox4x32-10 known-answer vector %zu mismatch", i);
+      return 1;
+    }
+  }
 
-  return static_cast<double>(errors) / static_cast<double>(num_bits);
+  // The stateful source must be addressable: odd-sized draws equal the
+  // per-element helpers
+  PhiloxAwgnSource src(0xC0FFEEULL);
+  double z[7];
+  src.fill_normal(z, 3);
+  src.fill_normal(z + 3, 4);
+  for (uint64_t p = 0; p < 3; ++p) {
+    double z0, z1;
+    philox_normal_pair(0xC0FFEEULL, p, z0, z1);
+    if (z[2 * p] != z0 || z[2 * p + 1] != z1) {
+      snprintf(err_msg, MAX_ERR_MSG, "PhiloxAwgnSource normal %llu out of sequence",
+               static_cast<unsigned long long>(2 * p));
+      return 1;
+    }
+  }
+  for (uint64_t w = 0; w < 5; ++w)
+    if (src.next_bits() != philox_word(0xC0FFEEULL, w)) {
+      snprintf(err_msg, MAX_ERR_MSG, "PhiloxAwgnSource word %llu out of sequence",
+               static_cast<unsigned long long>(w));
+      return 1;
+    }
+
+  const long long num_sym = CHUNK_SYMBOLS + 3001; // One full and one partial chunk
+  for (int mod : modulation_orders) {
+    const int bits_per_sym = bits_per_symbol(mod);
+    for (double snr : {0.0, 6.0}) {
+      const uint64_t seed = 0x9E37ULL + static_cast<uint64_t>(mod);
+      const double sigma = uncoded_sigma(mod, snr);
+      long long tiled = 0, fused = 0;
+      for (long long c = 0; c * CHUNK_SYMBOLS < num_sym; ++c)
+        tiled += uncoded_chunk_errors(RNG_ENGINE_PHILOX, mod, sigma, num_sym, seed, c);
+      for (long long g = 0; g < num_sym; ++g)
+        fused += philox_symbol_errors(chunk_seed(seed, static_cast<uint64_t>(g >> CHUNK_SHIFT)),
+                                      static_cast<uint64_t>(g & (CHUNK_SYMBOLS - 1)),
+                                      bits_per_sym, sigma);
+      if (tiled != fused || tiled == 0) {
+        snprintf(err_msg, MAX_ERR_MSG,
+                 "Fused Philox kernel mismatch (mod %d, %.1f dB): %lld vs %lld", mod,
+                 snr, fused, tiled);
+        return 1;
+      }
+#ifdef BER_GPU
+      long long device = 0;
+      if (gpu_available() &&
+          (!gpu_uncoded_errors(bits_per_sym, sigma, num_sym, CHUNK_SHIFT, seed, &device) ||
+           device != tiled)) {
+        snprintf(err_msg, MAX_ERR_MSG,
+                 "GPU Philox kernel mismatch (mod %d, %.1f dB): %lld vs %lld", mod, snr,
+                 device, tiled);
+        return 1;
+      }
+#endif
+    }
+  }
+  snprintf(err_msg, MAX_ERR_MSG, "Philox KAT and fused kernel match tile loop (GPU: %s)",
+           gpu_available() ? "checked" : "not available");
+  return 0;
 }
 
-// Deterministic (seeded) BER computation for reproducible simulation sequences
-extern "C" double compute_ber_seeded(int mod_order, double snr_db,
-                                     long long num_bits,
-                                     unsigned long long seed) {
-  if (mod_order != 2 && mod_order != 4 && mod_order != 16) [[unlikely]]
+// Shared body of the uncoded entry points (validation + chunked simulation).
+// There is no upper cap on num_bits: memory is one tile per worker. The
+// error and bit counts are also stored through out_errors/out_bits if given.
+double simulate_uncoded_ber(int mod_order, double snr_db, long long num_bits,
+                            uint64_t seed, int threads,
+                            long long *out_errors = nullptr,
+                            long long *out_bits = nullptr) {
+  if (!is_valid_mod_order(mod_order)) [[unlikely]]
     return -1.0;
+  // Validate SNR range (reasonable bounds)
   if (snr_db < -50.0 || snr_db > 50.0) [[unlikely]]
     return -1.0;
-  int bits_per_sym = static_cast<int>(log2(mod_order));
-  if (num_bits % bits_per_sym != 0)
-    num_bits -= num_bits % bits_per_sym;
+  const int bits_per_sym = bits_per_symbol(mod_order);
+  // Adjust num_bits to be divisible by bits_per_sym
+  num_bits -= num_bits % bits_per_sym;
+  num_bits = std::max(num_bits, 0LL);
+  if (out_bits)
+    *out_bits = num_bits;
+  if (out_errors)
+    *out_errors = 0;
+  // Return 0 BER for non-positive number of bits
   if (num_bits <= 0) [[unlikely]]
     return 0.0;
-  if (num_bits > 100000000LL) [[unlikely]]
+
+  const double sigma = uncoded_sigma(mod_order, snr_db);
+
+  const long long num_sym = num_bits / bits_per_sym;
+  const int engine = current_rng_engine(); // One engine for the whole call
+  const auto fading = current_fading(seed);
+  const long long errors = uncoded_stream_errors(engine, mod_order, sigma, num_sym,
+                                                 seed, threads, fading_ptr(fading));
+  if (out_errors)
+    *out_errors = errors;
+  return static_cast<double>(errors) / static_cast<double>(num_bits);
+}
+
+extern "C" double compute_ber(int mod_order, double snr_db,
+                              long long num_bits) {
+  random_device rd;
+  const uint64_t seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+  return simulate_uncoded_ber(mod_order, snr_db, num_bits, seed, 1);
+}
+
+// Deterministic (seeded) BER computation for reproducible simulation sequences
+extern "C" double compute_ber_seeded(int mod_order, double snr_db,
+                                     long long num_bits,
+                                     unsigned long long seed) {
+  return simulate_uncoded_ber(mod_order, snr_db, num_bits, seed, 1);
+}
+
+extern "C" double compute_ber_parallel(int mod_order, double snr_db,
+                                       long long num_bits,
+                                       unsigned long long seed, int threads) {
+  return simulate_uncoded_ber(mod_order, snr_db, num_bits, seed, threads);
+}
+
+// Error counts of num_sym symbols at every SNR point (inputs already
+// validated). Work items are (chunk, SNR group) pairs; SNR points are split
+// into groups only when there are fewer chunks than threads, trading a
+// regenerated tile for parallelism on short runs. Group assignment never
+// changes the streams, so the counts are deterministic.
+vector<long long> sweep_errors(int mod_order, const double *snrs_db, int n_snr,
+                               long long num_sym, uint64_t seed, int threads) {
+  vector<double> sigmas(static_cast<size_t>(n_snr));
+  for (int k = 0; k < n_snr; ++k)
+    sigmas[k] = uncoded_sigma(mod_order, snrs_db[k]);
+
+  const long long num_chunks = (num_sym + CHUNK_SYMBOLS - 1) / CHUNK_SYMBOLS;
+  const int groups = static_cast<int>(std::min<long long>(
+      n_snr, (threads + num_chunks - 1) / num_chunks));
+  const int per_group = (n_snr + groups - 1) / groups;
+
+  vector<atomic<long long>> errors(static_cast<size_t>(n_snr));
+  const int engine = current_rng_engine();
+  const auto fading = current_fading(seed);
+  parallel_for_items(num_chunks * groups, threads, [&](long long item) {
+    const long long c = item / groups;
+    const int first = static_cast<int>(item % groups) * per_group;
+    const int count = std::min(per_group, n_snr - first);
+    if (count <= 0)
+      return;
+    const long long len = std::min(CHUNK_SYMBOLS, num_sym - c * CHUNK_SYMBOLS);
+    vector<long long> local(static_cast<size_t>(count), 0);
+    with_awgn_source(engine, chunk_seed(seed, static_cast<uint64_t>(c)),
+                     [&](auto &src) {
+                       simulate_chunk_sweep(src, mod_order, sigmas.data() + first,
+                                            count, len, local.data(), fading_ptr(fading),
+                                            static_cast<uint64_t>(c * CHUNK_SYMBOLS));
+                     });
+    for (int k = 0; k < count; ++k)
+      errors[first + k].fetch_add(local[k]);
+  });
+
+  vector<long long> counts(static_cast<size_t>(n_snr));
+  for (int k = 0; k < n_snr; ++k)
+    counts[k] = errors[k].load();
+  return counts;
+}
+
+// Whole uncoded curve in one pass: every SNR point sees the same payload and
+// unit noise (common random numbers), only the noise scale differs.
+extern "C" int compute_ber_sweep(int mod_order, const double *snrs_db,
+                                 int n_snr, long long num_bits,
+                                 unsigned long long seed, double *out_ber,
+                                 long long *out_errors) {
+  if (!is_valid_mod_order(mod_order) || !snrs_db || n_snr <= 0 || !out_ber)
+      [[unlikely]]
+    return -1;
+  for (int k = 0; k < n_snr; ++k) {
+    if (!(snrs_db[k] >= -50.0 && snrs_db[k] <= 50.0)) [[unlikely]]
+      return -1;
+  }
+  const int bits_per_sym = bits_per_symbol(mod_order);
+  num_bits -= num_bits % bits_per_sym;
+  if (num_bits <= 0) [[unlikely]] {
+    fill(out_ber, out_ber + n_snr, 0.0);
+    if (out_errors)
+      fill(out_errors, out_errors + n_snr, 0LL);
+    return 0;
+  }
+
+  const vector<long long> errors = sweep_errors(
+      mod_order, snrs_db, n_snr, num_bits / bits_per_sym, seed,
+      static_cast<int>(std::max(1u, thread::hardware_concurrency())));
+  for (int k = 0; k < n_snr; ++k) {
+    const long long e = errors[k];
+    out_ber[k] = static_cast<double>(e) / static_cast<double>(num_bits);
+    if (out_errors)
+      out_errors[k] = e;
+  }
+  return 0;
+}
+
+// 95% Wilson score interval for errors / bits (finite also at zero errors)
+constexpr double CI_Z = 1.959963984540054;
+
+void wilson_interval(long long errors, long long bits, double &lo, double &hi) {
+  const double n = static_cast<double>(bits);
+  const double p = static_cast<double>(errors) / n;
+  const double z2n = CI_Z * CI_Z / n;
+  const double center = (p + z2n / 2.0) / (1.0 + z2n);
+  const double half =
+      CI_Z * sqrt(p * (1.0 - p) / n + z2n / (4.0 * n)) / (1.0 + z2n);
+  lo = errors == 0 ? 0.0 : std::max(0.0, center - half);
+  hi = errors == bits ? 1.0 : std::min(1.0, center + half);
+}
+
+// Validated compute_ber_until arguments and its stop rule, shared with the
+// job scheduler so both produce the same answer for the same point
+struct UntilRule {
+  int mod_order = 0;
+  int bits_per_sym = 0;
+  double sigma = 0.0;
+  long long min_errors = 0;
+  long long max_bits = 0; // Multiple of bits_per_sym
+  double rel_ci = 0.0;
+
+  long long max_sym() const noexcept { return max_bits / bits_per_sym; }
+  long long num_chunks() const noexcept {
+    return (max_sym() + CHUNK_SYMBOLS - 1) / CHUNK_SYMBOLS;
+  }
+  long long chunk_len(long long c) const noexcept {
+    return std::min(CHUNK_SYMBOLS, max_sym() - c * CHUNK_SYMBOLS);
+  }
+
+  // BER_STOP_* once the estimate after `bits` is good enough, else 0
+  int stop_reason(long long errors, long long bits) const {
+    if (min_errors > 0 && errors >= min_errors)
+      return BER_STOP_MIN_ERRORS;
+    if (rel_ci > 0.0 && errors > 0) {
+      double lo = 0.0, hi = 0.0;
+      wilson_interval(errors, bits, lo, hi);
+      const double ber = static_cast<double>(errors) / static_cast<double>(bits);
+      if ((hi - lo) / 2.0 <= rel_ci * ber)
+        return BER_STOP_CI;
+    }
+    return bits >= max_bits ? BER_STOP_MAX_BITS : 0;
+  }
+};
+
+constexpr long long TILES_PER_CHUNK = CHUNK_SYMBOLS / TILE_SYMBOLS;
+
+[[nodiscard]] std::optional<UntilRule> make_until_rule(int mod_order,
+                                                       double snr_db,
+                                                       long long min_errors,
+                                                       long long max_bits,
+                                                       double rel_ci) {
+  if (!is_valid_mod_order(mod_order)) [[unlikely]]
+    return std::nullopt;
+  if (snr_db < -50.0 || snr_db > 50.0 || min_errors < 0 || !(rel_ci >= 0.0))
+      [[unlikely]]
+    return std::nullopt;
+  UntilRule rule;
+  rule.mod_order = mod_order;
+  rule.bits_per_sym = bits_per_symbol(mod_order);
+  rule.max_bits = max_bits - max_bits % rule.bits_per_sym;
+  if (rule.max_bits <= 0) [[unlikely]]
+    return std::nullopt;
+  rule.sigma = uncoded_sigma(mod_order, snr_db);
+  rule.min_errors = min_errors;
+  rule.rel_ci = rel_ci;
+  return rule;
+}
+
+// Replays one chunk's tile errors after the tiles before it; returns the stop
+// reason (0 to keep going)
+int replay_tiles(const UntilRule &rule, long long chunk, const long long *tiles,
+                 long long &errors, long long &sym_done) {
+  const long long len = rule.chunk_len(chunk);
+  for (long long t = 0; t * static_cast<long long>(TILE_SYMBOLS) < len; ++t) {
+    errors += tiles[t];
+    sym_done += std::min<long long>(TILE_SYMBOLS, len - t * TILE_SYMBOLS);
+    if (const int reason =
+            rule.stop_reason(errors, sym_done * rule.bits_per_sym))
+      return reason;
+  }
+  return 0;
+}
+
+void fill_until_stats(const UntilRule &rule, long long errors,
+                      long long sym_done, int reason,
+                      ber_until_stats_t *out_stats) {
+  out_stats->errors = errors;
+  out_stats->bits = sym_done * rule.bits_per_sym;
+  out_stats->ber = static_cast<double>(errors) / static_cast<double>(out_stats->bits);
+  wilson_interval(errors, out_stats->bits, out_stats->ci_low, out_stats->ci_high);
+  out_stats->stop_reason = reason;
+}
+
+// Early-terminating estimate. The stream is the compute_ber_seeded one and
+// the stop rule is evaluated after every tile in stream order, so the result
+// equals compute_ber_seeded(mod_order, snr_db, out_stats->bits, seed).
+// Chunks are simulated in parallel rounds (one chunk first, then one per
+// core) with per-tile error counts, then replayed in order to find the stop
+// tile; work past it is discarded, which keeps the answer deterministic.
+extern "C" int compute_ber_until(int mod_order, double snr_db,
+                                 long long min_errors, long long max_bits,
+                                 double rel_ci, unsigned long long seed,
+                                 ber_until_stats_t *out_stats) {
+  if (!out_stats) [[unlikely]]
+    return -1;
+  const auto rule = make_until_rule(mod_order, snr_db, min_errors, max_bits, rel_ci);
+  if (!rule) [[unlikely]]
+    return -1;
+
+  const long long num_chunks = rule->num_chunks();
+  const int workers =
+      static_cast<int>(std::max(1u, thread::hardware_concurrency()));
+  const int engine = current_rng_engine();
+  const auto fading = current_fading(seed);
+
+  vector<long long> tile_errors;
+  long long errors = 0;
+  long long sym_done = 0;
+  int reason = 0;
+  long long round = 1;
+  for (long long first = 0; first < num_chunks && reason == 0; first += round) {
+    round = std::min<long long>(first == 0 ? 1 : workers, num_chunks - first);
+    tile_errors.assign(static_cast<size_t>(round * TILES_PER_CHUNK), 0);
+    parallel_for_items(round, workers, [&](long long i) {
+      const long long c = first + i;
+      with_awgn_source(engine, chunk_seed(seed, static_cast<uint64_t>(c)),
+                       [&](auto &src) {
+                         simulate_chunk_errors(src, mod_order, rule->sigma,
+                                               rule->chunk_len(c),
+                                               &tile_errors[i * TILES_PER_CHUNK],
+                                               fading_ptr(fading),
+                                               static_cast<uint64_t>(c * CHUNK_SYMBOLS));
+                       });
+    });
+
+    for (long long i = 0; i < round && reason == 0; ++i)
+      reason = replay_tiles(*rule, first + i, &tile_errors[i * TILES_PER_CHUNK],
+                            errors, sym_done);
+  }
+
+  fill_until_stats(*rule, errors, sym_done, reason, out_stats);
+  return 0;
+}
+
+// =============================================================================
+// MONTE CARLO JOB SCHEDULER
+// =============================================================================
+//
+// ber_submit_jobs turns every point into chunk tasks on the shared
+// work-stealing pool. A task claims the point's next chunk, simulates it
+// with per-tile error counts and merges it under the point's lock; chunks
+// that finish out of order wait until the prefix before them is complete,
+// then the prefix is replayed tile by tile through the compute_ber_until
+// stop rule. Each point starts with one task in flight and every completion
+// queues up to two more (capped at one per worker), so cheap points stay
+// cheap while expensive ones fan out over idle workers. Once a point stops,
+// its queued tasks return without simulating: that is the cancellation.
+// Results equal compute_ber_until for the same point and seed.
+
+struct PointJob {
+  UntilRule rule;
+  unsigned long long seed = 0;
+  std::optional<FadingChannel> fading; // Channel captured at submission
+  atomic<long long> next_chunk{0};
+  atomic<bool> stopped{false};
+
+  mutex lock; // Guards everything below
+  map<long long, array<long long, TILES_PER_CHUNK>> finished; // Out of order
+  long long replayed = 0; // Chunks merged into errors / sym_done
+  long long errors = 0;
+  long long sym_done = 0;
+  int reason = 0;
+  int in_flight = 0;
+};
+
+struct ber_jobs {
+  vector<unique_ptr<PointJob>> points;
+  int engine = BER_RNG_FAST;
+  int max_in_flight = 1;
+
+  mutex lock;
+  condition_variable idle;
+  long long pending = 0; // Tasks queued or running
+};
+
+namespace {
+
+void run_point_task(ber_jobs *job, PointJob *pt);
+
+void queue_point_tasks(ber_jobs *job, PointJob *pt, int count) {
+  if (count <= 0)
+    return;
+  {
+    lock_guard<mutex> g(job->lock);
+    job->pending += count;
+  }
+  for (int i = 0; i < count; ++i)
+    ber_thread_pool().submit([job, pt] { run_point_task(job, pt); });
+}
+
+void run_point_task(ber_jobs *job, PointJob *pt) {
+  const UntilRule &rule = pt->rule;
+  const long long c =
+      pt->stopped.load(memory_order_acquire) ? -1 : pt->next_chunk.fetch_add(1);
+  int spawn = 0;
+  if (c >= 0 && c < rule.num_chunks()) {
+    array<long long, TILES_PER_CHUNK> tiles{};
+    with_awgn_source(job->engine, chunk_seed(pt->seed, static_cast<uint64_t>(c)),
+                     [&](auto &src) {
+                       simulate_chunk_errors(src, rule.mod_order, rule.sigma,
+                                             rule.chunk_len(c), tiles.data(),
+                                             fading_ptr(pt->fading),
+                                             static_cast<uint64_t>(c * CHUNK_SYMBOLS));
+                     });
+
+    lock_guard<mutex> g(pt->lock);
+    --pt->in_flight;
+    if (pt->reason == 0) {
+      pt->finished.emplace(c, tiles);
+      for (auto it = pt->finished.begin();
+           it != pt->finished.end() && it->first == pt->replayed && pt->reason == 0;
+           it = pt->finished.erase(it), ++pt->replayed)
+        pt->reason = replay_tiles(rule, it->first, it->second.data(),
+                                  pt->errors, pt->sym_done);
+      if (pt->reason != 0) {
+        pt->finished.clear();
+        pt->stopped.store(true, memory_order_release);
+      } else {
+        const long long left = rule.num_chunks() - pt->next_chunk.load();
+        spawn = static_cast<int>(std::min<long long>(
+            {2, left - pt->in_flight, job->max_in_flight - pt->in_flight}));
+        spawn = std::max(spawn, 0);
+        pt->in_flight += spawn;
+      }
+    }
+  } else {
+    lock_guard<mutex> g(pt->lock);
+    --pt->in_flight;
+  }
+  queue_point_tasks(job, pt, spawn);
+
+  lock_guard<mutex> g(job->lock);
+  if (--job->pending == 0)
+    job->idle.notify_all();
+}
+
+} // namespace
+
+extern "C" ber_jobs_t *ber_submit_jobs(const ber_point_t *points, int n_points) {
+  if (!points || n_points <= 0) [[unlikely]]
+    return nullptr;
+  auto job = make_unique<ber_jobs>();
+  job->points.reserve(static_cast<size_t>(n_points));
+  const ber_channel_t channel = current_channel();
+  for (int i = 0; i < n_points; ++i) {
+    const ber_point_t &p = points[i];
+    const auto rule =
+        make_until_rule(p.mod_order, p.snr_db, p.min_errors, p.max_bits, p.rel_ci);
+    if (!rule) [[unlikely]]
+      return nullptr;
+    auto pt = make_unique<PointJob>();
+    pt->rule = *rule;
+    pt->seed = p.seed;
+    pt->fading = FadingChannel::make(channel, p.seed);
+    pt->in_flight = 1;
+    job->points.push_back(std::move(pt));
+  }
+  job->engine = current_rng_engine();
+  job->max_in_flight = ber_thread_pool().size();
+
+  ber_jobs *handle = job.release();
+  for (auto &pt : handle->points)
+    queue_point_tasks(handle, pt.get(), 1);
+  return handle;
+}
+
+extern "C" int ber_wait(ber_jobs_t *jobs, ber_until_stats_t *out_stats) {
+  if (!jobs) [[unlikely]]
+    return -1;
+  unique_ptr<ber_jobs> job(jobs);
+  {
+    unique_lock<mutex> g(job->lock);
+    job->idle.wait(g, [&] { return job->pending == 0; });
+  }
+  if (out_stats)
+    for (size_t i = 0; i < job->points.size(); ++i) {
+      const PointJob &pt = *job->points[i];
+      fill_until_stats(pt.rule, pt.errors, pt.sym_done, pt.reason, &out_stats[i]);
+    }
+  return 0;
+}
+
+// =============================================================================
+// CHECKPOINTED ACCUMULATION
+// =============================================================================
+//
+// ber_accum_t is compute_ber_seeded unrolled: the same chunks, summed by the
+// caller in as many ber_accum_advance calls (and processes) as it likes.
+// Chunk c's generator is seeded from (seed, c), so saving the next chunk
+// index is enough to resume the stream exactly.
+
+namespace {
+
+constexpr char ACCUM_MAGIC[8] = {'B', 'E', 'R', 'A', 'C', 'C', 'U', 'M'};
+
+long long accum_num_sym(const ber_accum_t &a) {
+  return a.num_bits / static_cast<long long>(bits_per_symbol(a.mod_order));
+}
+
+long long accum_total_chunks(const ber_accum_t &a) {
+  return (accum_num_sym(a) + CHUNK_SYMBOLS - 1) / CHUNK_SYMBOLS;
+}
+
+// Bits in chunks [first, last) of the run
+long long accum_range_bits(const ber_accum_t &a, long long first, long long last) {
+  const long long num_sym = accum_num_sym(a);
+  const long long sym = std::min(last * CHUNK_SYMBOLS, num_sym) -
+                        std::min(first * CHUNK_SYMBOLS, num_sym);
+  return sym * static_cast<long long>(bits_per_symbol(a.mod_order));
+}
+
+// Full consistency check, so a loaded or caller-edited state cannot index
+// past the run or report impossible counts
+bool accum_valid(const ber_accum_t &a) {
+  if (!is_valid_mod_order(a.mod_order) || !(a.snr_db >= -50.0 && a.snr_db <= 50.0) ||
+      !is_valid_rng_engine(a.rng_engine) ||
+      a.num_bits < 0 || a.num_bits % static_cast<long long>(bits_per_symbol(a.mod_order)) != 0)
+    return false;
+  return 0 <= a.chunk_begin && a.chunk_begin <= a.next_chunk &&
+         a.next_chunk <= a.chunk_end && a.chunk_end <= accum_total_chunks(a) &&
+         a.bits == accum_range_bits(a, a.chunk_begin, a.next_chunk) &&
+         0 <= a.errors && a.errors <= a.bits;
+}
+
+bool same_run(const ber_accum_t &a, const ber_accum_t &b) {
+  return a.mod_order == b.mod_order && a.rng_engine == b.rng_engine &&
+         a.snr_db == b.snr_db && a.seed == b.seed && a.num_bits == b.num_bits;
+}
+
+void put_u64(unsigned char *&p, uint64_t v) {
+  for (int i = 0; i < 8; ++i)
+    *p++ = static_cast<unsigned char>(v >> (8 * i));
+}
+
+void put_u32(unsigned char *&p, uint32_t v) {
+  for (int i = 0; i < 4; ++i)
+    *p++ = static_cast<unsigned char>(v >> (8 * i));
+}
+
+uint64_t get_u64(const unsigned char *&p) {
+  uint64_t v = 0;
+  for (int i = 0; i < 8; ++i)
+    v |= static_cast<uint64_t>(*p++) << (8 * i);
+  return v;
+}
+
+uint32_t get_u32(const unsigned char *&p) {
+  uint32_t v = 0;
+  for (int i = 0; i < 4; ++i)
+    v |= static_cast<uint32_t>(*p++) << (8 * i);
+  return v;
+}
+
+uint64_t blob_check(const unsigned char *buf, size_t n) {
+  uint64_t h = 0x13198A2E03707344ULL;
+  for (size_t i = 0; i < n; ++i)
+    h = splitmix64(h ^ buf[i]);
+  return h;
+}
+
+} // namespace
+
+extern "C" int ber_accum_init(ber_accum_t *acc, int mod_order, double snr_db,
+                              long long num_bits, unsigned long long seed) {
+  if (!acc || !is_valid_mod_order(mod_order) || snr_db < -50.0 || snr_db > 50.0) [[unlikely]]
+    return -1;
+  if (current_channel().model != BER_CHANNEL_AWGN) [[unlikely]]
+    return -1; // The blob has no channel state
+  const long long bits_per_sym = static_cast<long long>(bits_per_symbol(mod_order));
+  ber_accum_t a{};
+  a.mod_order = mod_order;
+  a.rng_engine = current_rng_engine();
+  a.snr_db = snr_db;
+  a.seed = seed;
+  a.num_bits = std::max(num_bits - num_bits % bits_per_sym, 0LL);
+  a.chunk_end = accum_total_chunks(a);
+  *acc = a;
+  return 0;
+}
+
+extern "C" long long ber_accum_advance(ber_accum_t *acc, long long max_chunks,
+                                       int threads) {
+  if (!acc || max_chunks < 0 || !accum_valid(*acc)) [[unlikely]]
+    return -1;
+  const long long first = acc->next_chunk;
+  const long long last = first + std::min(max_chunks, acc->chunk_end - first);
+  const double sigma = uncoded_sigma(acc->mod_order, acc->snr_db);
+  const long long num_sym = accum_num_sym(*acc);
+  const ber_accum_t &a = *acc;
+  acc->errors += parallel_chunk_sum(last - first, threads, [&](long long i) {
+    return uncoded_chunk_errors(a.rng_engine, a.mod_order, sigma, num_sym, a.seed,
+                                first + i);
+  });
+  acc->bits += accum_range_bits(*acc, first, last);
+  acc->next_chunk = last;
+  return acc->chunk_end - last;
+}
+
+extern "C" int ber_accum_split(const ber_accum_t *acc, int n_parts,
+                               ber_accum_t *out) {
+  if (!acc || !out || n_parts <= 0 || !accum_valid(*acc)) [[unlikely]]
+    return -1;
+  const ber_accum_t a = *acc; // out may alias acc
+  const long long remaining = a.chunk_end - a.next_chunk;
+  long long start = a.next_chunk;
+  for (int k = 0; k < n_parts; ++k) {
+    const long long len = remaining / n_parts + (k < remaining % n_parts ? 1 : 0);
+    ber_accum_t part = a;
+    if (k > 0) {
+      part.chunk_begin = part.next_chunk = start;
+      part.errors = part.bits = 0;
+    }
+    part.chunk_end = start + len;
+    start += len;
+    out[k] = part;
+  }
+  return 0;
+}
+
+extern "C" int ber_accum_merge(ber_accum_t *dst, const ber_accum_t *src) {
+  if (!dst || !src || !accum_valid(*dst) || !accum_valid(*src) ||
+      !same_run(*dst, *src) || dst->next_chunk != dst->chunk_end ||
+      src->chunk_begin != dst->chunk_end) [[unlikely]]
+    return -1;
+  dst->chunk_end = src->chunk_end;
+  dst->next_chunk = src->next_chunk;
+  dst->errors += src->errors;
+  dst->bits += src->bits;
+  return 0;
+}
+
+extern "C" double ber_accum_ber(const ber_accum_t *acc) {
+  if (!acc) [[unlikely]]
     return -1.0;
-  
+  return acc->bits > 0 ? static_cast<double>(acc->errors) / static_cast<double>(acc->bits)
+                       : 0.0;
+}
 
-  mt19937_64 gen(seed);
-  uniform_int_distribution<int> bit_dist(0, 1);
-  vector<bool> bits(static_cast<size_t>(num_bits));
-  for (size_t i = 0; i < bits.size(); ++i)
-    bits[i] = static_cast<bool>(bit_dist(gen));
+// Blob: magic, kernel version, mod, engine, 0, then snr..bits as 64-bit
+// little-endian words, then a checksum of everything before it
+extern "C" int ber_accum_save(const ber_accum_t *acc, unsigned char *buf,
+                              int size) {
+  if (!acc || !buf || size < BER_ACCUM_BLOB_BYTES || !accum_valid(*acc)) [[unlikely]]
+    return -1;
+  unsigned char *p = buf;
+  memcpy(p, ACCUM_MAGIC, sizeof(ACCUM_MAGIC));
+  p += sizeof(ACCUM_MAGIC);
+  put_u32(p, CACHE_KERNEL_VERSION);
+  put_u32(p, static_cast<uint32_t>(acc->mod_order));
+  put_u32(p, static_cast<uint32_t>(acc->rng_engine));
+  put_u32(p, 0);
+  uint64_t snr_bits;
+  memcpy(&snr_bits, &acc->snr_db, sizeof(snr_bits));
+  for (uint64_t v : {snr_bits, static_cast<uint64_t>(acc->seed),
+                     static_cast<uint64_t>(acc->num_bits),
+                     static_cast<uint64_t>(acc->chunk_begin),
+                     static_cast<uint64_t>(acc->chunk_end),
+                     static_cast<uint64_t>(acc->next_chunk),
+                     static_cast<uint64_t>(acc->errors),
+                     static_cast<uint64_t>(acc->bits)})
+    put_u64(p, v);
+  put_u64(p, blob_check(buf, static_cast<size_t>(p - buf)));
+  return static_cast<int>(p - buf);
+}
 
-  vector<cdouble> symbols = modulate(bits, mod_order);
-  double ebno_lin = db_to_linear(snr_db);
-  double esno_lin = static_cast<double>(bits_per_sym) * ebno_lin;
-  double n0 = 1.0 / esno_lin;
-  double sigma = sqrt(n0 / 2.0);
-  normal_distribution<double> noise_dist(0.0, sigma);
-  for (auto &s : symbols) {
-    s += cdouble(noise_dist(gen), noise_dist(gen));
+extern "C" int ber_accum_load(ber_accum_t *acc, const unsigned char *buf,
+                              int size) {
+  if (!acc || !buf || size < BER_ACCUM_BLOB_BYTES ||
+      memcmp(buf, ACCUM_MAGIC, sizeof(ACCUM_MAGIC)) != 0) [[unlikely]]
+    return -1;
+  const unsigned char *p = buf + sizeof(ACCUM_MAGIC);
+  const uint32_t version = get_u32(p);
+  ber_accum_t a{};
+  a.mod_order = static_cast<int>(get_u32(p));
+  a.rng_engine = static_cast<int>(get_u32(p));
+  const uint32_t reserved = get_u32(p);
+  const uint64_t snr_bits = get_u64(p);
+  memcpy(&a.snr_db, &snr_bits, sizeof(snr_bits));
+  a.seed = get_u64(p);
+  a.num_bits = static_cast<long long>(get_u64(p));
+  a.chunk_begin = static_cast<long long>(get_u64(p));
+  a.chunk_end = static_cast<long long>(get_u64(p));
+  a.next_chunk = static_cast<long long>(get_u64(p));
+  a.errors = static_cast<long long>(get_u64(p));
+  a.bits = static_cast<long long>(get_u64(p));
+  const size_t body = static_cast<size_t>(p - buf);
+  // Older kernels drew different streams, so their positions are meaningless
+  if (get_u64(p) != blob_check(buf, body) || version != CACHE_KERNEL_VERSION ||
+      reserved != 0 || !accum_valid(a)) [[unlikely]]
+    return -1;
+  *acc = a;
+  return 0;
+}
+
+// =============================================================================
+// IMPORTANCE SAMPLING
+// =============================================================================
+//
+// Per axis the noise n is drawn from N(d*mu, sigma^2) instead of N(0, sigma^2),
+// where mu is the distance from a level to its nearest decision boundary and
+// d points at that boundary. The likelihood ratio of a sample is then
+//   w = exp((mu^2 - 2*n*d*mu) / (2*sigma^2)).
+// Inner 16-QAM levels have a boundary on both sides; they draw d = +-1 with
+// equal probability, giving w = exp(mu^2 / (2*sigma^2)) / cosh(n*mu/sigma^2).
+// Bits demodulated from the I axis are weighted by the I ratio only (and Q by
+// Q), which keeps the estimator unbiased and its variance bounded.
+
+struct IsSums {
+  double sum = 0.0;    // Sum over symbols of weighted bit errors
+  double sum_sq = 0.0; // ... and of their squares
+  long long hits = 0;
+};
+
+// Half the minimum distance of the unit-energy constellation
+constexpr double is_shift(int mod_order) noexcept {
+  return symbol_scale(mod_order);
+}
+
+inline double log_cosh(double t) noexcept {
+  const double a = std::abs(t);
+  return a + log1p(exp(-2.0 * a)) - M_LN2;
+}
+
+// Bias one axis: x clean level, z unit normal, flip chooses the side for
+// inner levels. Returns the received value and stores the likelihood ratio.
+inline double is_axis(double x, double z, bool flip, double sigma, double mu,
+                      double inner_limit, double &weight) noexcept {
+  const double inv_two_var = 1.0 / (2.0 * sigma * sigma);
+  if (std::abs(x) < inner_limit) {
+    const double n = sigma * z + (flip ? mu : -mu);
+    weight = exp(mu * mu * inv_two_var - log_cosh(2.0 * n * mu * inv_two_var));
+    return x + n;
   }
-  vector<bool> rx_bits = demodulate(symbols, mod_order);
-  const auto errors = std::transform_reduce(
-      bits.begin(), bits.end(), rx_bits.begin(), 0LL, std::plus<>{},
-      std::not_equal_to<>{});
-  return static_cast<double>(errors) / static_cast<double>(num_bits);
+  const double d = x > 0.0 ? -1.0 : 1.0;
+  const double n = sigma * z + d * mu;
+  weight = exp((mu * mu - 2.0 * n * d * mu) * inv_two_var);
+  return x + n;
+}
+
+// One chunk of the importance-sampled stream. Per tile the source supplies
+// the payload words, 2n unit normals (I before Q) and then one side bit per
+// axis for inner levels.
+template <typename Source>
+IsSums simulate_chunk_is(Source &src, int mod_order, double sigma,
+                         long long num_sym) {
+  const int bits_per_sym = bits_per_symbol(mod_order);
+  const double mu = is_shift(mod_order);
+  // Levels below inner_limit have a decision boundary on both sides
+  const double inner_limit =
+      with_modulator(mod_order, [](auto mod) { return decltype(mod)::inner_limit; });
+  const uint64_t field_mask = (uint64_t{1} << bits_per_sym) - 1;
+  // Bits taken from the I axis within a symbol (see Modulator<M>)
+  const uint64_t i_mask =
+      with_modulator(mod_order, [](auto mod) { return decltype(mod)::i_mask; });
+  const uint64_t q_mask = field_mask & ~i_mask;
+  TileBuffers &buf = thread_tile_buffers();
+  array<uint64_t, 2 * TILE_SYMBOLS / 64> side_words;
+
+  IsSums sums;
+  for (long long done = 0; done < num_sym;) {
+    const size_t n = static_cast<size_t>(
+        std::min<long long>(TILE_SYMBOLS, num_sym - done));
+    const size_t n_bits = n * static_cast<size_t>(bits_per_sym);
+
+    const size_t n_words = words_for_bits(n_bits);
+    {
+      BER_STAGE_TIMER(BER_STAGE_RNG, 8 * n_words);
+      for (size_t w = 0; w < n_words; ++w)
+        buf.tx_words[w] = src.next_bits();
+    }
+    {
+      BER_STAGE_TIMER(BER_STAGE_MODULATE, 16 * n);
+      modulate_soa(buf.tx_words.data(), n, mod_order, buf.re.data(), buf.im.data());
+    }
+    {
+      BER_STAGE_TIMER(BER_STAGE_AWGN, 32 * n); // Biased noise and its weights
+      src.fill_normal(buf.noise.data(), 2 * n);
+      for (size_t w = 0; w < words_for_bits(2 * n); ++w)
+        side_words[w] = src.next_bits();
+
+      for (size_t i = 0; i < n; ++i) {
+        const size_t k = 2 * i;
+        buf.rx_re[i] = is_axis(buf.re[i], buf.noise[k], (side_words[k >> 6] >> (k & 63)) & 1,
+                               sigma, mu, inner_limit, buf.weight_re[i]);
+        buf.rx_im[i] = is_axis(buf.im[i], buf.noise[k + 1],
+                               (side_words[(k + 1) >> 6] >> ((k + 1) & 63)) & 1,
+                               sigma, mu, inner_limit, buf.weight_im[i]);
+      }
+    }
+    {
+      BER_STAGE_TIMER(BER_STAGE_DEMODULATE, 8 * n_words);
+      demodulate_soa(buf.rx_re.data(), buf.rx_im.data(), n, mod_order,
+                     buf.rx_words.data());
+    }
+
+    BER_STAGE_TIMER(BER_STAGE_ERROR_COUNT, 0);
+    for (size_t i = 0; i < n; ++i) {
+      const size_t bit = i * static_cast<size_t>(bits_per_sym);
+      const uint64_t diff = packed_field(buf.tx_words.data(), bit, bits_per_sym) ^
+                            packed_field(buf.rx_words.data(), bit, bits_per_sym);
+      if (diff == 0)
+        continue;
+      const double x = std::popcount(diff & i_mask) * buf.weight_re[i] +
+                       std::popcount(diff & q_mask) * buf.weight_im[i];
+      sums.sum += x;
+      sums.sum_sq += x * x;
+      ++sums.hits;
+    }
+    done += static_cast<long long>(n);
+  }
+  return sums;
 }
 
-vector<cdouble> generate_pilots(size_t num_pilots) {
-  // Direct initialization is already optimal, but we can make it more explicit
-  return vector<cdouble>(num_pilots, cdouble(1.0, 0.0));
+extern "C" int compute_ber_is(int mod_order, double snr_db,
+                              long long num_symbols, unsigned long long seed,
+                              ber_is_stats_t *out_stats) {
+  if (!out_stats || !is_valid_mod_order(mod_order)) [[unlikely]]
+    return -1;
+  if (snr_db < -50.0 || snr_db > 50.0 || num_symbols < 2) [[unlikely]]
+    return -1;
+  if (current_channel().model != BER_CHANNEL_AWGN) [[unlikely]]
+    return -1; // The mean shift is derived for AWGN only
+
+  const double sigma = uncoded_sigma(mod_order, snr_db);
+  const long long num_chunks = (num_symbols + CHUNK_SYMBOLS - 1) / CHUNK_SYMBOLS;
+  const int engine = current_rng_engine();
+  vector<IsSums> chunk_sums(static_cast<size_t>(num_chunks));
+  parallel_for_items(
+      num_chunks, static_cast<int>(std::max(1u, thread::hardware_concurrency())),
+      [&](long long c) {
+        const long long len =
+            std::min(CHUNK_SYMBOLS, num_symbols - c * CHUNK_SYMBOLS);
+        chunk_sums[c] = with_awgn_source(
+            engine, chunk_seed(seed, static_cast<uint64_t>(c)),
+            [&](auto &src) {
+              return simulate_chunk_is(src, mod_order, sigma, len);
+            });
+      });
+
+  IsSums total; // Reduced in chunk order, so the sums are deterministic
+  for (const IsSums &cs : chunk_sums) {
+    total.sum += cs.sum;
+    total.sum_sq += cs.sum_sq;
+    total.hits += cs.hits;
+  }
+  const double n = static_cast<double>(num_symbols);
+  const double bits_per_sym = bits_per_symbol(mod_order);
+  const double mean = total.sum / n;
+  const double var = std::max(0.0, (total.sum_sq - total.sum * mean) / (n - 1.0));
+  out_stats->ber = mean / bits_per_sym;
+  out_stats->std_err = sqrt(var / n) / bits_per_sym;
+  out_stats->ci_low = std::max(0.0, out_stats->ber - CI_Z * out_stats->std_err);
+  out_stats->ci_high = out_stats->ber + CI_Z * out_stats->std_err;
+  out_stats->symbols = num_symbols;
+  out_stats->hits = total.hits;
+  return 0;
 }
 
-void add_awgn(vector<cdouble> &symbols, double esno_lin, mt19937 &gen) {
+// Pilot storage of one SNR estimate; reused when it lives in a workspace
+struct PilotBuffers {
+  vector<cdouble> tx;
+  vector<cdouble> rx;
+  vector<double> noise; // Unit-variance I/Q pairs
+};
+
+void generate_pilots(vector<cdouble> &pilots, size_t num_pilots) {
+  note_growth(pilots, num_pilots);
+  pilots.assign(num_pilots, cdouble(1.0, 0.0));
+}
+
+template <typename Source>
+void add_awgn(vector<cdouble> &symbols, double esno_lin, Source &src,
+              vector<double> &noise) {
   const double n0 = 1.0 / esno_lin;
   const double sigma = sqrt(n0 / 2.0);
-  normal_distribution<double> noise_dist(0.0, sigma);
+  note_growth(noise, 2 * symbols.size());
+  noise.resize(2 * symbols.size());
+  src.fill_normal(noise.data(), noise.size());
 
-  // Use STL algorithm for consistency
-  std::for_each(symbols.begin(), symbols.end(), [&](cdouble &s) {
-    s += cdouble(noise_dist(gen), noise_dist(gen));
-  });
+  for (size_t i = 0; i < symbols.size(); ++i)
+    symbols[i] += cdouble(sigma * noise[2 * i], sigma * noise[2 * i + 1]);
 }
 
-extern "C" double estimate_snr(double true_snr_db, long long num_pilots) {
+// Shared body of estimate_snr / estimate_snr_ws
+double snr_estimate(double true_snr_db, long long num_pilots, PilotBuffers &buf) {
   // Validate inputs
   if (num_pilots <= 0) [[unlikely]]
     return -999.0; // Return error value instead of 0
@@ -334,13 +1353,18 @@ extern "C" double estimate_snr(double true_snr_db, long long num_pilots) {
     return -999.0;
   if (num_pilots > 1000000LL) [[unlikely]]
     return -999.0; // Reasonable upper limit
+  BER_STAGE_TIMER(BER_STAGE_SNR_EST, 0);
   random_device rd;
-  mt19937 gen(rd());
-  vector<cdouble> tx_pilots = generate_pilots(static_cast<size_t>(num_pilots));
+  const uint64_t seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+  vector<cdouble> &tx_pilots = buf.tx;
+  vector<cdouble> &rx_pilots = buf.rx;
+  generate_pilots(tx_pilots, static_cast<size_t>(num_pilots));
   double ebno_lin = db_to_linear(true_snr_db);
   double esno_lin = ebno_lin; // 1 bit/sym
-  vector<cdouble> rx_pilots = tx_pilots;
-  add_awgn(rx_pilots, esno_lin, gen);
+  note_growth(rx_pilots, tx_pilots.size());
+  rx_pilots.assign(tx_pilots.begin(), tx_pilots.end());
+  with_awgn_source(current_rng_engine(), seed,
+                   [&](auto &src) { add_awgn(rx_pilots, esno_lin, src, buf.noise); });
 
   // Modern STL approach for noise variance calculation
   const double noise_var =
@@ -355,6 +1379,108 @@ extern "C" double estimate_snr(double true_snr_db, long long num_pilots) {
   return linear_to_db(est_ebno_lin);
 }
 
+extern "C" double estimate_snr(double true_snr_db, long long num_pilots) {
+  PilotBuffers buf; // Freed on return; loops should use estimate_snr_ws
+  return snr_estimate(true_snr_db, num_pilots, buf);
+}
+
+// =============================================================================
+// BATCHED SNR ESTIMATION
+// =============================================================================
+//
+// The pilots are all 1+0j, so rx - tx is the noise itself: a trial only
+// draws 2 * num_pilots unit normals and their sum of squares S, streamed
+// through a tile buffer, so there is no pilot buffer and no pilot cap. The
+// estimate is estimate_snr's, linear_to_db(1 / noise_var) with noise_var =
+// sigma^2 * S / num_pilots. Every SNR point reuses the trial's S (common
+// random numbers, as in compute_ber_sweep). Trials are drawn in blocks with
+// their own streams and the block sums are reduced in block order, round by
+// round, so the result does not depend on the thread count.
+
+constexpr long long SNR_BLOCK_NORMALS = 1LL << 20; // Work per block
+constexpr long long SNR_MAX_BLOCK_TRIALS = 1024;
+constexpr long long SNR_ROUND_BLOCKS = 256; // Blocks reduced per round
+
+// Sum of squares of the next `normals` unit normals of src, streamed through
+// the thread's noise tile
+template <typename Source>
+double pilot_noise_energy(Source &src, long long normals) {
+  double *noise = thread_tile_buffers().noise.data();
+  constexpr long long TILE = 2 * static_cast<long long>(TILE_SYMBOLS);
+  double sq = 0.0;
+  for (long long done = 0; done < normals; done += TILE) {
+    const size_t n = static_cast<size_t>(std::min(TILE, normals - done));
+    src.fill_normal(noise, n);
+    sq += sum_squares(noise, n);
+  }
+  return sq;
+}
+
+extern "C" int estimate_snr_batch(const double *true_snrs_db, int n_snr,
+                                  long long num_pilots, long long trials,
+                                  unsigned long long seed, double *out_mean_db,
+                                  double *out_std_db) {
+  if (!true_snrs_db || !out_mean_db || n_snr <= 0 || num_pilots <= 0 ||
+      trials <= 0 || num_pilots > (1LL << 40)) [[unlikely]]
+    return -1;
+  for (int k = 0; k < n_snr; ++k)
+    if (!(true_snrs_db[k] >= -50.0 && true_snrs_db[k] <= 50.0)) [[unlikely]]
+      return -1;
+
+  // Noise power per I/Q component at each point (1 bit/sym, as estimate_snr)
+  vector<double> sigma2(static_cast<size_t>(n_snr));
+  for (int k = 0; k < n_snr; ++k)
+    sigma2[k] = 1.0 / db_to_linear(true_snrs_db[k]) / 2.0;
+
+  const long long normals = 2 * num_pilots;
+  const long long block_trials =
+      std::clamp(SNR_BLOCK_NORMALS / normals, 1LL, SNR_MAX_BLOCK_TRIALS);
+  const long long num_blocks = (trials + block_trials - 1) / block_trials;
+  const int engine = current_rng_engine();
+
+  // Per point: sum of (estimate - true) and of its square, for one block
+  const size_t stride = 2 * static_cast<size_t>(n_snr);
+  vector<double> block_sums(static_cast<size_t>(SNR_ROUND_BLOCKS) * stride);
+  vector<double> totals(stride, 0.0);
+  for (long long first = 0; first < num_blocks; first += SNR_ROUND_BLOCKS) {
+    const long long round = std::min(SNR_ROUND_BLOCKS, num_blocks - first);
+    parallel_for_items(round, 0, [&](long long i) {
+      const long long b = first + i;
+      const long long count = std::min(block_trials, trials - b * block_trials);
+      double *sums = &block_sums[static_cast<size_t>(i) * stride];
+      std::fill(sums, sums + stride, 0.0);
+      BER_STAGE_TIMER(BER_STAGE_SNR_EST, 8 * count * normals);
+      with_awgn_source(engine, chunk_seed(seed, static_cast<uint64_t>(b)),
+                       [&](auto &src) {
+        for (long long t = 0; t < count; ++t) {
+          const double sq = pilot_noise_energy(src, normals);
+          for (int k = 0; k < n_snr; ++k) {
+            const double noise_var =
+                sigma2[k] * sq / static_cast<double>(num_pilots);
+            const double err = linear_to_db(1.0 / noise_var) - true_snrs_db[k];
+            sums[2 * k] += err;
+            sums[2 * k + 1] += err * err;
+          }
+        }
+      });
+    });
+    for (long long i = 0; i < round; ++i)
+      for (size_t j = 0; j < stride; ++j)
+        totals[j] += block_sums[static_cast<size_t>(i) * stride + j];
+  }
+
+  const double n = static_cast<double>(trials);
+  for (int k = 0; k < n_snr; ++k) {
+    const double mean_err = totals[2 * k] / n;
+    out_mean_db[k] = true_snrs_db[k] + mean_err;
+    if (out_std_db) {
+      const double ss = totals[2 * k + 1] - n * mean_err * mean_err;
+      out_std_db[k] = trials > 1 ? sqrt(std::max(0.0, ss) / (n - 1.0)) : 0.0;
+    }
+  }
+  return 0;
+}
+
 // Internal theoretical helpers (not exposed)
 inline double qfunc(double x) { return 0.5 * erfc(x / sqrt(2.0)); }
 
@@ -363,10 +1489,333 @@ inline double theor_ber_bpsk_qpsk(double ebno_db) {
   return qfunc(sqrt(2.0 * ebno_lin));
 }
 
+// Exact Gray 16-QAM BER: per-axis 4-PAM with half-spacing x = sqrt(0.8 Eb/N0)
 inline double theor_ber_16qam(double ebno_db) {
   double ebno_lin = pow(10.0, ebno_db / 10.0);
-  double sqrt_term = sqrt(2.0 * ebno_lin / 5.0);
-  return (1.0 / 4.0) * (3.0 * qfunc(sqrt_term) + qfunc(3.0 * sqrt_term));
+  double x = sqrt(0.8 * ebno_lin);
+  return (1.0 / 4.0) * (3.0 * qfunc(x) + 2.0 * qfunc(3.0 * x) - qfunc(5.0 * x));
+}
+
+// Exact Gray square M-QAM BER: each axis is a Gray N-PAM with half-spacing
+// x = sqrt(3 log2(M) Eb/N0 / (M - 1)); a sent level l lands in the decision
+// cell [lo, hi) of level l' with probability Q((lo - l) x) - Q((hi - l) x),
+// costing the Hamming distance of their fields
+template <int M>
+double theor_ber_square_qam(double ebno_db) {
+  using Mod = Modulator<M>;
+  constexpr int N = Mod::axis_levels;
+  const double ebno_lin = pow(10.0, ebno_db / 10.0);
+  const double x = sqrt(3.0 * Mod::bits_per_sym * ebno_lin / (M - 1.0));
+  double errors = 0.0;
+  for (int k = 0; k < N; ++k) {
+    const double l = 2.0 * k - (N - 1);
+    for (int kr = 0; kr < N; ++kr) {
+      if (kr == k) continue;
+      const double lo = kr == 0 ? -INFINITY : 2.0 * kr - N;
+      const double hi = kr == N - 1 ? INFINITY : 2.0 * kr - N + 2.0;
+      const double p = (isinf(lo) ? 1.0 : qfunc((lo - l) * x)) -
+                       (isinf(hi) ? 0.0 : qfunc((hi - l) * x));
+      errors += p * std::popcount(Mod::index_field(static_cast<unsigned>(k)) ^
+                                  Mod::index_field(static_cast<unsigned>(kr)));
+    }
+  }
+  return errors / (N * Mod::axis_bits); // Average over levels and axis bits
+}
+
+// =============================================================================
+// AMC THRESHOLD SEARCH
+// =============================================================================
+// The bracket starts +/-THRESH_BRACKET_DB around the theoretical crossing and
+// is widened only if simulation disagrees. Each refinement pass evaluates
+// THRESH_SECTIONS - 1 interior points in one sweep, so bits and unit noise
+// are generated once per pass and every probe of the search uses the same
+// random stream (common random numbers), which keeps BER(snr) consistent
+// between probes.
+
+constexpr double THRESH_BRACKET_DB = 1.0;
+constexpr int THRESH_SECTIONS = 8;
+
+double theor_ber(int mod_order, double ebno_db) {
+  switch (mod_order) {
+  case 16: return theor_ber_16qam(ebno_db);
+  case 64: return theor_ber_square_qam<64>(ebno_db);
+  case 256: return theor_ber_square_qam<256>(ebno_db);
+  default: return theor_ber_bpsk_qpsk(ebno_db);
+  }
+}
+
+// Theoretical Eb/N0 where BER falls to target (BER is decreasing in SNR)
+double theor_threshold_db(int mod_order, double target_ber) {
+  double lo = -50.0, hi = 50.0;
+  for (int it = 0; it < 100; ++it) {
+    const double mid = 0.5 * (lo + hi);
+    (theor_ber(mod_order, mid) <= target_ber ? hi : lo) = mid;
+  }
+  return hi;
+}
+
+// Smallest probed Eb/N0 with simulated BER <= target, to within tol_db.
+// Returns -2 if even 50 dB does not reach the target.
+int search_threshold(int mod_order, double target_ber, long long num_bits,
+                     double tol_db, uint64_t seed, int threads,
+                     double &out_snr_db, long long &bits_spent) {
+  const int bits_per_sym = bits_per_symbol(mod_order);
+  const long long num_sym = num_bits / bits_per_sym;
+  const double used_bits = static_cast<double>(num_sym * bits_per_sym);
+  auto ber_at = [&](const vector<double> &snrs) {
+    const vector<long long> errors = sweep_errors(
+        mod_order, snrs.data(), static_cast<int>(snrs.size()), num_sym, seed,
+        threads);
+    bits_spent += num_sym * bits_per_sym * static_cast<long long>(snrs.size());
+    vector<double> ber(errors.size());
+    for (size_t k = 0; k < errors.size(); ++k)
+      ber[k] = static_cast<double>(errors[k]) / used_bits;
+    return ber;
+  };
+
+  // Bracket: BER(lo) > target >= BER(hi)
+  const double guess = theor_threshold_db(mod_order, target_ber);
+  double lo = std::max(-50.0, guess - THRESH_BRACKET_DB);
+  double hi = std::min(50.0, guess + THRESH_BRACKET_DB);
+  for (double widen = 2.0 * THRESH_BRACKET_DB;; widen *= 2.0) {
+    const vector<double> ends = ber_at({lo, hi});
+    if (ends[0] <= target_ber) {
+      if (lo <= -50.0) {
+        out_snr_db = lo;
+        return 0;
+      }
+      hi = lo;
+      lo = std::max(-50.0, lo - widen);
+    } else if (ends[1] > target_ber) {
+      if (hi >= 50.0)
+        return -2;
+      lo = hi;
+      hi = std::min(50.0, hi + widen);
+    } else {
+      break;
+    }
+  }
+
+  while (hi - lo > tol_db) {
+    vector<double> probes(THRESH_SECTIONS - 1);
+    for (int j = 1; j < THRESH_SECTIONS; ++j)
+      probes[j - 1] = lo + (hi - lo) * j / THRESH_SECTIONS;
+    const vector<double> ber = ber_at(probes);
+    const auto first_ok = std::find_if(ber.begin(), ber.end(),
+                                       [&](double b) { return b <= target_ber; });
+    const size_t j = static_cast<size_t>(first_ok - ber.begin());
+    if (j < probes.size())
+      hi = probes[j];
+    if (j > 0)
+      lo = probes[j - 1];
+  }
+  out_snr_db = hi;
+  return 0;
+}
+
+extern "C" int find_snr_threshold(int mod_order, double target_ber,
+                                  long long bits_per_probe, double tol_db,
+                                  unsigned long long seed, double *out_snr_db,
+                                  long long *out_bits_spent) {
+  if (!is_valid_mod_order(mod_order) || !out_snr_db) [[unlikely]]
+    return -1;
+  if (!(target_ber > 0.0 && target_ber < 0.5) || !(tol_db > 0.0)) [[unlikely]]
+    return -1;
+  const int bits_per_sym = bits_per_symbol(mod_order);
+  if (bits_per_probe < bits_per_sym) [[unlikely]]
+    return -1;
+
+  long long spent = 0;
+  const int threads =
+      static_cast<int>(std::max(1u, thread::hardware_concurrency()));
+  const int status = search_threshold(mod_order, target_ber, bits_per_probe,
+                                      tol_db, seed, threads, *out_snr_db, spent);
+  if (out_bits_spent)
+    *out_bits_spent = spent;
+  return status;
+}
+
+// QPSK and 16-QAM searches run concurrently on two threads, each with half of
+// the cores for its sweeps (results do not depend on the split)
+extern "C" int find_amc_thresholds(double target_ber, long long bits_per_probe,
+                                   double tol_db, unsigned long long seed,
+                                   double *out_thresh_qpsk,
+                                   double *out_thresh_16qam,
+                                   long long *out_bits_spent) {
+  if (!out_thresh_qpsk || !out_thresh_16qam) [[unlikely]]
+    return -1;
+  if (!(target_ber > 0.0 && target_ber < 0.5) || !(tol_db > 0.0) ||
+      bits_per_probe < 4) [[unlikely]]
+    return -1;
+
+  const int threads = static_cast<int>(
+      std::max(1u, thread::hardware_concurrency() / 2));
+  long long spent_qpsk = 0, spent_16qam = 0;
+  int status_16qam = 0;
+  thread worker([&]() {
+    status_16qam = search_threshold(16, target_ber, bits_per_probe, tol_db,
+                                    seed, threads, *out_thresh_16qam, spent_16qam);
+  });
+  const int status_qpsk = search_threshold(4, target_ber, bits_per_probe, tol_db,
+                                           seed, threads, *out_thresh_qpsk,
+                                           spent_qpsk);
+  worker.join();
+  if (out_bits_spent)
+    *out_bits_spent = spent_qpsk + spent_16qam;
+  return status_qpsk != 0 ? status_qpsk : status_16qam;
+}
+
+// =============================================================================
+// AMC LINK SIMULATION
+// =============================================================================
+//
+// The run_amc.py frame loop (estimate SNR, choose_mod, send, count) without a
+// ctypes round trip per frame. Frame f draws from its own stream
+// chunk_seed(seed, f): first its pilot noise, giving estimate_snr_batch's
+// estimate, then, if a mode was chosen, frame_symbols symbols of payload and
+// noise exactly as simulate_chunk_errors. Frames are summed per block and
+// blocks are reduced in order, so the stats do not depend on the threads.
+//
+// Under a fading channel frame f occupies channel times
+// f * (num_pilots + frame_symbols) onwards, pilots first. The pilots then see
+// h too, so the estimate becomes |mean r|^2 / (sample variance of r), i.e.
+// the instantaneous SNR the AMC decision is meant to track.
+
+constexpr long long LINK_BLOCK_FRAMES = 256;
+constexpr long long LINK_ROUND_BLOCKS = 256; // Blocks reduced per round
+constexpr int LINK_MOD_ORDER[BER_AMC_MODES] = {0, 4, 16};
+
+struct LinkSums {
+  long long mode_frames[BER_AMC_MODES];
+  long long bits;
+  long long errors;
+  double est_error_db;
+};
+
+// Pilot SNR estimate (linear) of num_pilots faded pilots r = h + sigma n at
+// channel times t0 onwards, streamed through the thread's noise tile
+template <typename Source>
+double faded_pilot_snr(Source &src, const FadingChannel &fading, uint64_t t0,
+                       long long num_pilots, double sigma) {
+  double *noise = thread_tile_buffers().noise.data();
+  constexpr long long TILE = static_cast<long long>(TILE_SYMBOLS);
+  double sum_re = 0.0, sum_im = 0.0, sum_sq = 0.0;
+  for (long long done = 0; done < num_pilots; done += TILE) {
+    const size_t n = static_cast<size_t>(std::min(TILE, num_pilots - done));
+    src.fill_normal(noise, 2 * n);
+    fading.for_each_coefficient(t0 + static_cast<uint64_t>(done), n,
+                                [&](size_t i, double h_re, double h_im) {
+      const double re = h_re + sigma * noise[2 * i];
+      const double im = h_im + sigma * noise[2 * i + 1];
+      sum_re += re;
+      sum_im += im;
+      sum_sq += re * re + im * im;
+    });
+  }
+  const double p = static_cast<double>(num_pilots);
+  const double mean_sq = (sum_re * sum_re + sum_im * sum_im) / (p * p);
+  return mean_sq / std::max((sum_sq - p * mean_sq) / (p - 1.0), DBL_MIN);
+}
+
+// choose_mod of run_amc.py
+constexpr int amc_mode(double est_db, double thresh_qpsk, double thresh_16qam) noexcept {
+  return est_db < thresh_qpsk ? BER_AMC_NONE
+         : est_db < thresh_16qam ? BER_AMC_QPSK
+                                 : BER_AMC_16QAM;
+}
+
+extern "C" int run_amc_link(long long frames, long long frame_symbols,
+                            long long num_pilots, const double *snr_trace,
+                            long long trace_len, double thresh_qpsk,
+                            double thresh_16qam, unsigned long long seed,
+                            int threads, ber_link_stats_t *out_stats) {
+  if (!snr_trace || !out_stats || frames <= 0 || frame_symbols <= 0 ||
+      num_pilots <= 0 || trace_len <= 0 || num_pilots > (1LL << 40) ||
+      frame_symbols > (1LL << 40) || frames > (1LL << 58) / frame_symbols ||
+      !(thresh_qpsk <= thresh_16qam)) [[unlikely]]
+    return -1;
+  for (long long k = 0; k < trace_len; ++k)
+    if (!(snr_trace[k] >= -50.0 && snr_trace[k] <= 50.0)) [[unlikely]]
+      return -1;
+
+  // Pilot noise power per I/Q component (1 bit/sym) and data sigma per mode
+  vector<double> pilot_sigma2(static_cast<size_t>(trace_len));
+  vector<double> sigma(static_cast<size_t>(trace_len) * BER_AMC_MODES, 0.0);
+  for (long long k = 0; k < trace_len; ++k) {
+    pilot_sigma2[k] = 1.0 / db_to_linear(snr_trace[k]) / 2.0;
+    for (int mode : {BER_AMC_QPSK, BER_AMC_16QAM})
+      sigma[k * BER_AMC_MODES + mode] = uncoded_sigma(LINK_MOD_ORDER[mode], snr_trace[k]);
+  }
+
+  const auto fading = current_fading(seed);
+  if (fading && num_pilots < 2) [[unlikely]]
+    return -1; // The faded estimate needs a sample variance
+  const uint64_t frame_slots = static_cast<uint64_t>(num_pilots + frame_symbols);
+
+  const long long num_blocks = (frames + LINK_BLOCK_FRAMES - 1) / LINK_BLOCK_FRAMES;
+  const int engine = current_rng_engine();
+  vector<LinkSums> block_sums(static_cast<size_t>(LINK_ROUND_BLOCKS));
+  LinkSums total{};
+  for (long long first = 0; first < num_blocks; first += LINK_ROUND_BLOCKS) {
+    const long long round = std::min(LINK_ROUND_BLOCKS, num_blocks - first);
+    parallel_for_items(round, threads, [&](long long i) {
+      LinkSums &sums = block_sums[static_cast<size_t>(i)];
+      sums = LinkSums{};
+      const long long begin = (first + i) * LINK_BLOCK_FRAMES;
+      const long long end = std::min(frames, begin + LINK_BLOCK_FRAMES);
+      for (long long f = begin; f < end; ++f) {
+        const long long k = f % trace_len;
+        const uint64_t t0 = static_cast<uint64_t>(f) * frame_slots;
+        with_awgn_source(engine, chunk_seed(seed, static_cast<uint64_t>(f)),
+                         [&](auto &src) {
+          double est_db;
+          {
+            BER_STAGE_TIMER(BER_STAGE_SNR_EST, 16 * num_pilots);
+            if (fading) {
+              est_db = linear_to_db(faded_pilot_snr(src, *fading, t0, num_pilots,
+                                                    sqrt(pilot_sigma2[k])));
+            } else {
+              const double sq = pilot_noise_energy(src, 2 * num_pilots);
+              est_db = linear_to_db(1.0 / (pilot_sigma2[k] * sq /
+                                           static_cast<double>(num_pilots)));
+            }
+          }
+          sums.est_error_db += est_db - snr_trace[k];
+          const int mode = amc_mode(est_db, thresh_qpsk, thresh_16qam);
+          ++sums.mode_frames[mode];
+          if (mode == BER_AMC_NONE)
+            return;
+          const int mod_order = LINK_MOD_ORDER[mode];
+          sums.bits += frame_symbols * static_cast<long long>(bits_per_symbol(mod_order));
+          sums.errors += simulate_chunk_errors(
+              src, mod_order, sigma[k * BER_AMC_MODES + mode], frame_symbols,
+              nullptr, fading_ptr(fading), t0 + static_cast<uint64_t>(num_pilots));
+        });
+      }
+    });
+    for (long long i = 0; i < round; ++i) {
+      const LinkSums &sums = block_sums[static_cast<size_t>(i)];
+      for (int mode = 0; mode < BER_AMC_MODES; ++mode)
+        total.mode_frames[mode] += sums.mode_frames[mode];
+      total.bits += sums.bits;
+      total.errors += sums.errors;
+      total.est_error_db += sums.est_error_db;
+    }
+  }
+
+  const double slots = static_cast<double>(frames) * static_cast<double>(frame_symbols);
+  out_stats->frames = frames;
+  for (int mode = 0; mode < BER_AMC_MODES; ++mode)
+    out_stats->mode_frames[mode] = total.mode_frames[mode];
+  out_stats->bits = total.bits;
+  out_stats->errors = total.errors;
+  out_stats->ber = total.bits > 0 ? static_cast<double>(total.errors) /
+                                        static_cast<double>(total.bits)
+                                  : 0.0;
+  out_stats->spectral_efficiency = static_cast<double>(total.bits) / slots;
+  out_stats->goodput = static_cast<double>(total.bits - total.errors) / slots;
+  out_stats->mean_est_error_db = total.est_error_db / static_cast<double>(frames);
+  return 0;
 }
 
 // Test Functions (extern "C" for Python calling)
@@ -395,6 +1844,20 @@ extern "C" int run_mod_demod_test(char *err_msg) {
     strcpy(err_msg, "Mod/Demod 16QAM failed");
     return 1;
   }
+  // Every constellation point, repeated so the packed words span several
+  // 64-bit boundaries
+  for (int m : modulation_orders) {
+    const int bits_per_sym = bits_per_symbol(m);
+    vector<bool> pattern;
+    for (int rep = 0; rep < 5; ++rep)
+      for (int sym = 0; sym < m; ++sym)
+        for (int b = 0; b < bits_per_sym; ++b)
+          pattern.push_back((sym >> b) & 1);
+    if (demodulate(modulate(pattern, m), m) != pattern) {
+      snprintf(err_msg, MAX_ERR_MSG, "Mod/Demod full constellation failed (M=%d)", m);
+      return 1;
+    }
+  }
   strcpy(err_msg, "All mod/demod tests passed");
   return 0;
 }
@@ -522,157 +1985,780 @@ extern "C" int run_all_tests(char *overall_msg) {
 }
 
 // Convolutional coding-enabled BER computation
-extern "C" double compute_ber_coded(int mod_order, double snr_db, long long num_bits, int seed) {
-  // Support BPSK (2), QPSK (4), and 16-QAM (16) coded paths.
-  if (mod_order != 2 && mod_order != 4 && mod_order != 16) {
-    return compute_ber(mod_order, snr_db, num_bits); // Fallback
+// =============================================================================
+// FUSED CODED PIPELINE
+// =============================================================================
+//
+// Info and coded bits live packed in the workspace (1/8 and 1/4 byte per info
+// bit); symbols, noise and LLRs only ever exist for one tile of coded bits,
+// which is modulated, noised, converted to LLRs and pushed into the
+// incremental Viterbi decoder before the next tile is touched. The random
+// streams, symbol mapping, noise and LLR arithmetic are exactly those of the
+// original whole-block implementation, so seeded results are unchanged.
+
+constexpr size_t CODED_TILE_BITS = 8192; // Multiple of 64 and of 4 bits/sym
+// Info bits decoded as one block; longer runs stream in CODED_SEGMENT_BITS
+// segments through viterbi_stream (a multiple of 64 whose coded length is a
+// multiple of 192 transmitted bits at every rate: words and 6/8-bit symbols)
+constexpr long long CODED_BLOCK_BITS = 1LL << 24;
+constexpr long long CODED_SEGMENT_BITS = 9LL << 16;
+
+struct ber_coded_workspace {
+  vector<uint64_t> info_words;
+  vector<uint64_t> coded_words;
+  vector<uint64_t> decoded_words;
+  array<double, CODED_TILE_BITS> re; // Symbols of one tile (<= 1 per bit)
+  array<double, CODED_TILE_BITS> im;
+  array<double, 2 * CODED_TILE_BITS> noise;
+  array<double, CODED_TILE_BITS> llr;
+  vector<uint64_t> tx_words;                 // Punctured stream (rates > 1/2)
+  array<double, 2 * CODED_TILE_BITS> mother_llr; // Depunctured tile
+  ViterbiBlockDecoder decoder;
+  // Streamed runs (beyond CODED_BLOCK_BITS)
+  vector<uint64_t> prev_info_words; // Segment before info_words
+  array<bool, CODED_TILE_BITS + 2 * VITERBI_DEFAULT_TRACEBACK> stream_bits; // Decoder output
+};
+
+extern "C" ber_coded_workspace_t *ber_coded_workspace_create(void) {
+  BER_STATS_ALLOC(sizeof(ber_coded_workspace));
+  return new (nothrow) ber_coded_workspace;
+}
+
+extern "C" void ber_coded_workspace_free(ber_coded_workspace_t *ws) {
+  delete ws;
+}
+
+// Tile of transmitted bits: whole puncturing periods, words and symbols
+constexpr size_t coded_tile_bits(const PuncturePattern &pattern, int bits_per_sym) {
+  const size_t step = std::lcm<size_t>(std::lcm<size_t>(64, static_cast<size_t>(pattern.kept)),
+                                       static_cast<size_t>(bits_per_sym));
+  return CODED_TILE_BITS - CODED_TILE_BITS % step;
+}
+
+const PuncturePattern *puncture_pattern(int rate_id) {
+  switch (rate_id) {
+  case BER_RATE_1_2: return &PUNCTURE_NONE;
+  case BER_RATE_2_3: return &PUNCTURE_2_3;
+  case BER_RATE_3_4: return &PUNCTURE_3_4;
+  default: return nullptr;
   }
+}
 
-  int info_bits_count = static_cast<int>(num_bits);
-  // For 16-QAM ensure coded length divisible by 4 (coded bits per symbol)
-  if (mod_order == 16 && info_bits_count % 2 != 0) {
-    --info_bits_count; // Make even so (info_bits+6) is even => coded_len multiple of 4
-    if (info_bits_count <= 0) return -0.15;
+// Settings of an asynchronous coded run (ber_job_start): the engine and LLR
+// mode captured at submission, and a hook called after every tile with the
+// info bits covered so far; returning false abandons the run
+struct CodedRunHooks {
+  int engine = RNG_ENGINE_FAST;
+  int llr_mode = LLR_MODE_EXACT;
+  function<bool(long long)> progress;
+};
+constexpr double CODED_CANCELLED = -0.4; // coded_ber result when abandoned
+
+// Error and decoded bit counts are also stored through out_errors/out_bits
+// (successful runs only)
+double coded_ber(ber_coded_workspace_t *ws, int mod_order, double snr_db,
+                 long long num_bits, int seed, const PuncturePattern &pattern,
+                 long long *out_errors = nullptr, long long *out_bits = nullptr,
+                 const CodedRunHooks *hooks = nullptr) {
+  if (!ws) return -1.0;
+  // Every Modulator<M> order has a coded path
+  if (!is_valid_mod_order(mod_order)) {
+    return compute_ber(mod_order, snr_db, num_bits); // Fallback
   }
-  if (info_bits_count <= 0) return -0.1;
 
+  // Range checks before narrowing, so no request can wrap into a valid size
+  if (num_bits <= 0) return -0.1;
+  if (num_bits > numeric_limits<int>::max()) return -0.25;
+  long long info_bits_count = num_bits;
+  const int coded_bits_per_symbol = bits_per_symbol(mod_order);
   // Rate 1/2 convolutional code with tail bits (K=7 => 6 tail bits)
   const int constraint_tail = 6;
-  int coded_len = 2 * (info_bits_count + constraint_tail);
-  if (coded_len <= 0) return -0.2;
-  if (coded_len > 200'000'000) return -0.25; // Safety cap
+  const bool punctured = pattern.period != PUNCTURE_NONE.period;
+  // Trim info bits until the transmitted length fills whole symbols (16-QAM
+  // at rate 1/2: info bits even, so coded_len is a multiple of 4)
+  if (punctured_length(pattern, 2 * (info_bits_count + constraint_tail)) %
+          coded_bits_per_symbol != 0) {
+    do {
+      --info_bits_count;
+    } while (info_bits_count > 0 &&
+             punctured_length(pattern, 2 * (info_bits_count + constraint_tail)) %
+                     coded_bits_per_symbol != 0);
+    if (info_bits_count <= 0) return -0.15;
+  }
+  const bool streamed = info_bits_count > CODED_BLOCK_BITS;
 
-  // Generate info bits
+  // BER_RNG_STD keeps the legacy mt19937 stream; BER_RNG_FAST and
+  // BER_RNG_PHILOX draw bits and noise from their AWGN sources
+  const int engine = hooks ? hooks->engine : current_rng_engine();
   mt19937 gen(seed);
-  uniform_int_distribution<int> bit_dist(0, 1);
-  vector<bool> orig_bits(info_bits_count);
-  for (int i = 0; i < info_bits_count; ++i) orig_bits[i] = bit_dist(gen);
-
-  // Encode
-  bool* info_arr = new bool[info_bits_count];
-  for (int i = 0; i < info_bits_count; ++i) info_arr[i] = orig_bits[i];
-  bool* coded_arr = new bool[coded_len];
-  int actual_coded_len = 0;
-  int enc_status = convolutional_encode(info_arr, info_bits_count, coded_arr, &actual_coded_len);
-  if (enc_status != 0 || actual_coded_len != coded_len) {
-    delete[] info_arr; delete[] coded_arr; return -1.0;
-  }
-
-  vector<bool> coded_bits(coded_len);
-  for (int i = 0; i < coded_len; ++i) coded_bits[i] = coded_arr[i];
-  delete[] info_arr; delete[] coded_arr;
-
-  // Map coded bits to symbols based on modulation
-  vector<cdouble> symbols;
-  if (mod_order == 2) {
-    symbols.reserve(coded_len);
-    for (int i = 0; i < coded_len; ++i) {
-      symbols.emplace_back(coded_bits[i] ? -1.0 : 1.0, 0.0);
-    }
-  } else if (mod_order == 4) {
-    symbols.reserve(coded_len / 2);
-    for (int i = 0; i < coded_len; i += 2) {
-      bool b0 = coded_bits[i];
-      bool b1 = coded_bits[i + 1];
-      double re = b0 ? -1.0 : 1.0;
-      double im = b1 ? -1.0 : 1.0;
-      symbols.emplace_back(re * scale_qpsk, im * scale_qpsk);
-    }
-  } else { // 16-QAM coded path (4 coded bits per symbol)
-    symbols.reserve(coded_len / 4);
-    // Mapping matches modulate_impl: (b0,b2) -> real, (b1,b3) -> imag via get_level
-    for (int i = 0; i < coded_len; i += 4) {
-      if (i + 3 >= coded_len) break; // Should not happen due to adjustment
-      bool b0 = coded_bits[i];
-      bool b1 = coded_bits[i + 1];
-      bool b2 = coded_bits[i + 2];
-      bool b3 = coded_bits[i + 3];
-      double re = get_level(b0, b2);
-      double im = get_level(b1, b3);
-      symbols.emplace_back(re * scale_16qam, im * scale_16qam);
+  FastAwgnSource fast(static_cast<uint64_t>(static_cast<unsigned>(seed)));
+  PhiloxAwgnSource philox(static_cast<uint64_t>(static_cast<unsigned>(seed)));
+  auto next_bits = [&] {
+    return engine == RNG_ENGINE_PHILOX ? philox.next_bits() : fast.next_bits();
+  };
+  auto fill_normal = [&](double *out, size_t n) {
+    if (engine == RNG_ENGINE_PHILOX)
+      philox.fill_normal(out, n);
+    else
+      fast.fill_normal(out, n);
+  };
+  // n info bits into words (zeroed first, unused bits stay zero)
+  auto generate_info = [&](vector<uint64_t> &words, long long n) {
+    const size_t n_words = words_for_bits(static_cast<size_t>(n));
+    note_growth(words, n_words);
+    words.assign(n_words, 0);
+    BER_STAGE_TIMER(BER_STAGE_RNG, 8 * n_words);
+    if (engine == RNG_ENGINE_STD) {
+      uniform_int_distribution<int> bit_dist(0, 1);
+      for (long long i = 0; i < n; ++i)
+        words[i >> 6] |= static_cast<uint64_t>(bit_dist(gen)) << (i & 63);
+    } else {
+      for (size_t w = 0; w < n_words; ++w) words[w] = next_bits();
+      if (const int tail = static_cast<int>(n % 64)) // Keep unused bits zero
+        words.back() &= (uint64_t{1} << tail) - 1;
     }
-  }
+  };
 
   // Noise scaling: esno_lin = R * k * ebno_lin, where k = coded bits per symbol
-  constexpr double code_rate = 0.5;
+  const double code_rate = static_cast<double>(pattern.rate_num) / pattern.rate_den;
   double ebno_lin = pow(10.0, snr_db / 10.0);
-  int coded_bits_per_symbol = (mod_order == 2) ? 1 : (mod_order == 4 ? 2 : 4);
   double esno_lin = ebno_lin * code_rate * coded_bits_per_symbol;
   double n0 = 1.0 / esno_lin;
-  normal_distribution<double> noise_dist(0.0, sqrt(n0 / 2.0));
-  for (auto &sym : symbols) {
-    sym += cdouble(noise_dist(gen), noise_dist(gen));
-  }
-
-  // Generate LLRs (order must match coded bit emission order)
-  vector<double> llr(coded_len);
-  double llr_scale = 2.0 / n0; // Base scale
-  if (mod_order == 2) {
-    for (int i = 0; i < coded_len; ++i) {
-      llr[i] = -real(symbols[i]) * llr_scale;
-    }
-  } else if (mod_order == 4) { // QPSK
-    int idx = 0;
-    for (auto &sym : symbols) {
-      llr[idx++] = -real(sym) * llr_scale;
-      llr[idx++] = -imag(sym) * llr_scale;
-    }
-  } else { // 16-QAM: compute two LLRs per dimension (msb, lsb) using exact log-sum-exp over 4-PAM levels
-    // Precompute intrinsic amplitude levels after scaling
-    constexpr array<double,4> pam_levels = {3.0,1.0,-3.0,-1.0}; // indices 0..3 correspond to bit pairs 00,01,10,11? (As defined in get_level)
-    // Need mapping consistent with get_level: index = (msb<<1)|lsb => levels {+3,+1,-3,-1}
-    constexpr array<double,4> levels = {3.0,1.0,-3.0,-1.0};
-    double two_sigma2 = n0; // since each complex dimension variance = n0/2 => 2*sigma^2 = n0
-    int idx = 0;
-    for (auto &sym : symbols) {
-      double rI = real(sym) / scale_16qam; // de-normalize
-      double rQ = imag(sym) / scale_16qam;
-      // Function to compute two LLRs for a real value over 4-PAM Gray mapping
-      auto fill_llrs = [&](double x, double &llr_msb, double &llr_lsb){
-        double metric[4];
-        for (int k=0;k<4;++k){
-          double d = x - levels[k];
-          metric[k] = - (d*d) / two_sigma2; // log-likelihood up to constant
+  const double sigma = sqrt(n0 / 2.0);
+  normal_distribution<double> noise_dist(0.0, sigma);
+  // One engine for the whole call
+  const int llr_mode = hooks ? hooks->llr_mode : current_llr_mode();
+
+  // One tile: modulate -> AWGN -> LLR (-> depuncture). Returns the rate-1/2
+  // LLRs and their count; mother_pos/mother_end as for depuncture_llr.
+  const size_t tile_bits = coded_tile_bits(pattern, coded_bits_per_symbol);
+  auto tile_llrs = [&](const uint64_t *tx_words, size_t n_bits, long long &mother_pos,
+                       long long mother_end, long long &n_llr) -> const double * {
+    const size_t n_sym = n_bits / coded_bits_per_symbol;
+    double *re = ws->re.data();
+    double *im = ws->im.data();
+    double *llr = ws->llr.data();
+    {
+      BER_STAGE_TIMER(BER_STAGE_MODULATE, 16 * n_sym);
+      modulate_soa(tx_words, n_sym, mod_order, re, im);
+    }
+
+    {
+      BER_STAGE_TIMER(BER_STAGE_AWGN, 16 * n_sym);
+      if (engine == RNG_ENGINE_STD) {
+        for (size_t i = 0; i < n_sym; ++i) {
+          const cdouble noise(noise_dist(gen), noise_dist(gen));
+          re[i] += real(noise);
+          im[i] += imag(noise);
+        }
+      } else {
+        fill_normal(ws->noise.data(), 2 * n_sym);
+        for (size_t i = 0; i < n_sym; ++i) {
+          re[i] += sigma * ws->noise[2 * i];
+          im[i] += sigma * ws->noise[2 * i + 1];
         }
-        // Gray mapping: indices -> bit pairs (msb,lsb): 0->(0,0),1->(0,1),2->(1,0),3->(1,1)
-        // Compute log-sum-exp for msb=0 (indices 0,1) and msb=1 (2,3)
-        auto lse2 = [](double a, double b){ double m = max(a,b); return m + log(exp(a-m)+exp(b-m)); };
-        double l_ms0 = lse2(metric[0], metric[1]);
-        double l_ms1 = lse2(metric[2], metric[3]);
-        // LLR = log P(bit=0) - log P(bit=1)
-        double llr_std_msb = l_ms0 - l_ms1;
-        // For lsb: indices with lsb=0 are 0 (00) and 2 (10); lsb=1 are 1 (01) and 3 (11)
-        double l_ls0 = lse2(metric[0], metric[2]);
-        double l_ls1 = lse2(metric[1], metric[3]);
-        double llr_std_lsb = l_ls0 - l_ls1;
-        // Invert sign to align with current decoder expectation
-        llr_msb = -llr_std_msb;
-        llr_lsb = -llr_std_lsb;
-      };
-      double llrI_msb, llrI_lsb, llrQ_msb, llrQ_lsb;
-      fill_llrs(rI, llrI_msb, llrI_lsb);
-      fill_llrs(rQ, llrQ_msb, llrQ_lsb);
-      // Order must match coded bit emission: (b0,b1,b2,b3) where get_level used (b0,b2) for I and (b1,b3) for Q
-      // Emission order from encoder is sequential; we mapped groups of 4 bits as b0,b1,b2,b3.
-      llr[idx++] = llrI_msb; // b0 (msb of I pair)
-      llr[idx++] = llrQ_msb; // b1 (msb of Q pair)
-      llr[idx++] = llrI_lsb; // b2 (lsb of I pair)
-      llr[idx++] = llrQ_lsb; // b3 (lsb of Q pair)
-    }
-  }
-
-  // Decode
-  bool* decoded_arr = new bool[info_bits_count];
-  int decoded_len = 0;
-  int dec_status = viterbi_decode(llr.data(), coded_len, decoded_arr, &decoded_len);
-  if (dec_status != 0) { delete[] decoded_arr; return -10.0 - dec_status; }
-  if (decoded_len <= 0 || decoded_len > info_bits_count) { delete[] decoded_arr; return -0.3; }
-
-  int bit_errors = 0;
-  int cmp_len = std::min(decoded_len, info_bits_count);
-  for (int i = 0; i < cmp_len; ++i) if (orig_bits[i] != decoded_arr[i]) ++bit_errors;
-  delete[] decoded_arr;
-  return static_cast<double>(bit_errors) / static_cast<double>(cmp_len);
+      }
+    }
+
+    // LLRs (order must match coded bit emission order)
+    {
+      BER_STAGE_TIMER(BER_STAGE_LLR, 8 * n_bits);
+      llr_soa(llr_mode, re, im, n_sym, mod_order, n0, llr);
+    }
+    n_llr = static_cast<long long>(n_bits);
+    if (!punctured)
+      return llr;
+    BER_STAGE_TIMER(BER_STAGE_LLR, 0); // Depuncturing
+    n_llr = depuncture_llr(pattern, llr, static_cast<long long>(n_bits), mother_pos,
+                           mother_end, ws->mother_llr.data());
+    return ws->mother_llr.data();
+  };
+  auto report = [&](long long info_done) {
+    return !hooks || !hooks->progress || hooks->progress(info_done);
+  };
+
+  long long bit_errors = 0, decoded_len = 0;
+  if (!streamed) {
+    const int info_len = static_cast<int>(info_bits_count);
+    const int coded_len = 2 * (info_len + constraint_tail);
+    const size_t tx_len = static_cast<size_t>(punctured_length(pattern, coded_len));
+    generate_info(ws->info_words, info_len);
+
+    // Encode
+    note_growth(ws->coded_words, words_for_bits(static_cast<size_t>(coded_len)));
+    ws->coded_words.resize(words_for_bits(static_cast<size_t>(coded_len)));
+    convolutional_encode_packed(ws->info_words.data(), info_len, ws->coded_words.data());
+    const uint64_t *tx_words = ws->coded_words.data();
+    if (punctured) {
+      note_growth(ws->tx_words, words_for_bits(tx_len));
+      ws->tx_words.resize(words_for_bits(tx_len));
+      puncture_packed(pattern, ws->coded_words.data(), coded_len, ws->tx_words.data());
+      tx_words = ws->tx_words.data();
+    }
+
+    // Tile loop: channel and LLRs, then ACS
+    ws->decoder.reset(coded_len / 2);
+    long long mother_pos = 0; // Depuncturing position in the rate-1/2 stream
+    for (size_t first = 0; first < tx_len; first += tile_bits) {
+      const size_t n_bits = std::min(tile_bits, tx_len - first);
+      long long n_llr = 0;
+      const double *llr = tile_llrs(tx_words + first / 64, n_bits, mother_pos, coded_len, n_llr);
+      ws->decoder.push(llr, n_llr / 2);
+      if (!report(static_cast<long long>((first + n_bits) * info_len / tx_len)))
+        return CODED_CANCELLED;
+    }
+
+    // Decode
+    note_growth(ws->decoded_words, ws->info_words.size());
+    ws->decoded_words.resize(ws->info_words.size());
+    decoded_len = ws->decoder.finish_packed(ws->decoded_words.data());
+    if (decoded_len < 0) return -10.0 - static_cast<double>(decoded_len);
+    if (decoded_len == 0 || decoded_len > info_len) return -0.3;
+    BER_STAGE_TIMER(BER_STAGE_ERROR_COUNT, 0);
+    bit_errors = count_bit_errors(ws->info_words.data(), ws->decoded_words.data(),
+                                  static_cast<size_t>(decoded_len));
+  } else {
+    // Long budgets: one continuously encoded, terminated stream, produced a
+    // segment at a time and decoded by the sliding-window viterbi_stream.
+    // Memory is a segment of info and coded bits plus the traceback window,
+    // whatever the budget. Decoded bits trail the input by at most
+    // 2 * VITERBI_DEFAULT_TRACEBACK stages, so they always fall in the
+    // current segment or the one before it (kept in prev_info_words).
+    const unique_ptr<viterbi_stream_t, void (*)(viterbi_stream_t *)> stream(
+        viterbi_stream_init(0), viterbi_stream_free);
+    if (!stream) return -0.3;
+    bool *bits = ws->stream_bits.data();
+    long long prev_first = 0; // First info bit of prev_info_words
+    auto count_errors = [&](int n) {
+      BER_STAGE_TIMER(BER_STAGE_ERROR_COUNT, 0);
+      for (int i = 0; i < n; ++i, ++decoded_len) {
+        const long long seg_first = decoded_len - decoded_len % CODED_SEGMENT_BITS;
+        const vector<uint64_t> &words =
+            seg_first == prev_first ? ws->prev_info_words : ws->info_words;
+        const long long j = decoded_len - seg_first;
+        bit_errors += static_cast<long long>((words[j >> 6] >> (j & 63)) & 1) != bits[i];
+      }
+    };
+    unsigned state = 0;
+    for (long long seg_first = 0; seg_first < info_bits_count;
+         seg_first += CODED_SEGMENT_BITS) {
+      const long long seg_len = std::min(CODED_SEGMENT_BITS, info_bits_count - seg_first);
+      const bool last = seg_first + seg_len == info_bits_count;
+      // Whole segments hold whole puncturing periods, words and symbols
+      const long long coded_len = 2 * (seg_len + (last ? constraint_tail : 0));
+      const size_t tx_len = static_cast<size_t>(punctured_length(pattern, coded_len));
+      swap(ws->prev_info_words, ws->info_words);
+      prev_first = seg_first - CODED_SEGMENT_BITS;
+      generate_info(ws->info_words, seg_len);
+
+      note_growth(ws->coded_words, words_for_bits(static_cast<size_t>(coded_len)));
+      ws->coded_words.resize(words_for_bits(static_cast<size_t>(coded_len)));
+      convolutional_encode_packed_segment(ws->info_words.data(), seg_len, state, last,
+                                          ws->coded_words.data());
+      const uint64_t *tx_words = ws->coded_words.data();
+      if (punctured) {
+        note_growth(ws->tx_words, words_for_bits(tx_len));
+        ws->tx_words.resize(words_for_bits(tx_len));
+        puncture_packed(pattern, ws->coded_words.data(), coded_len, ws->tx_words.data());
+        tx_words = ws->tx_words.data();
+      }
+
+      long long mother_pos = 0;
+      for (size_t first = 0; first < tx_len; first += tile_bits) {
+        const size_t n_bits = std::min(tile_bits, tx_len - first);
+        long long n_llr = 0;
+        const double *llr = tile_llrs(tx_words + first / 64, n_bits, mother_pos, coded_len, n_llr);
+        int n_out = 0;
+        if (viterbi_stream_push(stream.get(), llr, static_cast<int>(n_llr), bits, &n_out) != 0)
+          return -0.3;
+        count_errors(n_out);
+        if (!report(seg_first + static_cast<long long>((first + n_bits) * seg_len / tx_len)))
+          return CODED_CANCELLED;
+      }
+    }
+    int n_out = 0;
+    if (const int rc = viterbi_stream_flush(stream.get(), bits, &n_out); rc != 0)
+      return -10.0 - rc;
+    count_errors(n_out);
+    if (decoded_len != info_bits_count) return -0.3;
+  }
+
+  if (out_errors) *out_errors = bit_errors;
+  if (out_bits) *out_bits = decoded_len;
+  return static_cast<double>(bit_errors) / static_cast<double>(decoded_len);
+}
+
+extern "C" double compute_ber_coded_ws(ber_coded_workspace_t *ws, int mod_order,
+                                       double snr_db, long long num_bits,
+                                       int seed) {
+  return coded_ber(ws, mod_order, snr_db, num_bits, seed, PUNCTURE_NONE);
+}
+
+extern "C" double compute_ber_coded_rate(int mod_order, double snr_db,
+                                         long long num_bits, int seed,
+                                         int rate_id) {
+  const PuncturePattern *pattern = puncture_pattern(rate_id);
+  if (!pattern) return -1.0;
+  const unique_ptr<ber_coded_workspace_t> ws(ber_coded_workspace_create());
+  return coded_ber(ws.get(), mod_order, snr_db, num_bits, seed, *pattern);
+}
+
+extern "C" double compute_ber_coded(int mod_order, double snr_db, long long num_bits, int seed) {
+  // One workspace per call; callers that loop use compute_ber_coded_ws
+  const unique_ptr<ber_coded_workspace_t> ws(ber_coded_workspace_create());
+  return compute_ber_coded_ws(ws.get(), mod_order, snr_db, num_bits, seed);
+}
+
+// =============================================================================
+// WORKSPACE ARENA
+// =============================================================================
+//
+// One handle owning every buffer the single-threaded entry points need: the
+// uncoded tiles, the coded pipeline and the pilots. Vectors only grow, so
+// once a sweep has seen its largest point no call allocates. The *_ws entry
+// points run the same bodies as their plain versions and return the same
+// results; the uncoded ones bind the tiles to the calling thread for the
+// duration of the call.
+
+struct ber_workspace {
+  TileBuffers tiles;
+  ber_coded_workspace coded;
+  PilotBuffers pilots;
+  vector<uint64_t> decoded_words; // viterbi_decode_ws output before unpacking
+};
+
+extern "C" ber_workspace_t *ber_workspace_create(void) {
+  BER_STATS_ALLOC(sizeof(ber_workspace));
+  return new (nothrow) ber_workspace;
+}
+
+extern "C" void ber_workspace_destroy(ber_workspace_t *ws) { delete ws; }
+
+extern "C" double compute_ber_ws(ber_workspace_t *ws, int mod_order,
+                                 double snr_db, long long num_bits) {
+  if (!ws) [[unlikely]]
+    return -1.0;
+  random_device rd;
+  const uint64_t seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+  ScopedTiles bind(ws->tiles);
+  return simulate_uncoded_ber(mod_order, snr_db, num_bits, seed, 1);
+}
+
+extern "C" double compute_ber_seeded_ws(ber_workspace_t *ws, int mod_order,
+                                        double snr_db, long long num_bits,
+                                        unsigned long long seed) {
+  if (!ws) [[unlikely]]
+    return -1.0;
+  ScopedTiles bind(ws->tiles);
+  return simulate_uncoded_ber(mod_order, snr_db, num_bits, seed, 1);
+}
+
+extern "C" double estimate_snr_ws(ber_workspace_t *ws, double true_snr_db,
+                                  long long num_pilots) {
+  if (!ws) [[unlikely]]
+    return -999.0;
+  return snr_estimate(true_snr_db, num_pilots, ws->pilots);
+}
+
+extern "C" double compute_ber_coded_rate_ws(ber_workspace_t *ws, int mod_order,
+                                            double snr_db, long long num_bits,
+                                            int seed, int rate_id) {
+  const PuncturePattern *pattern = puncture_pattern(rate_id);
+  if (!ws || !pattern) [[unlikely]]
+    return -1.0;
+  return coded_ber(&ws->coded, mod_order, snr_db, num_bits, seed, *pattern);
+}
+
+// The workspace's block decoder decodes exactly like viterbi_decode, so only
+// the argument checks are repeated here
+extern "C" int viterbi_decode_ws(ber_workspace_t *ws, const double *received_llr,
+                                 int received_len, bool *decoded_bits,
+                                 int *decoded_len) {
+  if (!ws || !received_llr || !decoded_bits || !decoded_len || received_len <= 0)
+      [[unlikely]]
+    return -1;
+  if (received_len % 2 != 0) [[unlikely]]
+    return -2;
+  const long long num_stages = received_len / 2;
+  if (num_stages <= 6) [[unlikely]]
+    return -3;
+  ViterbiBlockDecoder &decoder = ws->coded.decoder;
+  decoder.reset(num_stages);
+  decoder.push(received_llr, num_stages);
+  const size_t words = words_for_bits(static_cast<size_t>(num_stages - 6));
+  note_growth(ws->decoded_words, words);
+  ws->decoded_words.resize(words);
+  const long long info_len = decoder.finish_packed(ws->decoded_words.data());
+  if (info_len < 0) [[unlikely]]
+    return -3;
+  for (long long i = 0; i < info_len; ++i)
+    decoded_bits[i] = (ws->decoded_words[i >> 6] >> (i & 63)) & 1;
+  *decoded_len = static_cast<int>(info_len);
+  return 0;
+}
+
+// =============================================================================
+// RESULT CACHE
+// =============================================================================
+//
+// With a cache open (ber_cache_open, cache.cpp), batch jobs and
+// compute_ber_cached look their stream up before simulating. An exact hit
+// returns the stored counts. An uncoded run with more bits than an earlier
+// one of the same stream only simulates the chunks past that run's
+// whole-chunk prefix. Results are those of the uncached call either way;
+// failed runs are never stored.
+
+ber_coded_workspace_t &thread_coded_workspace();
+
+// One compute_ber_batch job (code_rate already validated)
+double ber_job(int mod_order, double snr_db, long long num_bits, uint64_t seed,
+               int code_rate, int threads, long long *out_errors,
+               long long *out_bits) {
+  const PuncturePattern *pattern =
+      code_rate == BER_BATCH_UNCODED ? nullptr : puncture_pattern(code_rate);
+  // Keys carry no channel, so faded uncoded runs are never cached
+  if (!cache_active() || (!pattern && current_channel().model != BER_CHANNEL_AWGN)) {
+    if (pattern)
+      return coded_ber(&thread_coded_workspace(), mod_order, snr_db, num_bits,
+                       static_cast<int>(seed), *pattern, out_errors, out_bits);
+    return simulate_uncoded_ber(mod_order, snr_db, num_bits, seed, threads,
+                                out_errors, out_bits);
+  }
+
+  if (pattern) {
+    // Coded blocks end in a terminated trellis, so only exact hits apply
+    const uint64_t key = cache_stream_key(
+        mod_order, snr_db, seed, code_rate,
+        static_cast<uint32_t>(current_rng_engine() | current_llr_mode() << 8));
+    if (const auto hit = cache_find_exact(key, num_bits)) {
+      cache_note(CacheOutcome::Hit);
+      *out_errors = hit->errors;
+      *out_bits = hit->bits;
+      return static_cast<double>(hit->errors) / static_cast<double>(hit->bits);
+    }
+    const double ber = coded_ber(&thread_coded_workspace(), mod_order, snr_db,
+                                 num_bits, static_cast<int>(seed), *pattern,
+                                 out_errors, out_bits);
+    cache_note(CacheOutcome::Miss);
+    if (ber >= 0.0)
+      cache_append({key, seed, snr_db, mod_order, code_rate, num_bits,
+                    *out_errors, *out_bits, 0, 0, 0});
+    return ber;
+  }
+
+  // Invalid and empty runs keep the uncached return values
+  if (!is_valid_mod_order(mod_order) || snr_db < -50.0 || snr_db > 50.0 ||
+      num_bits < static_cast<long long>(bits_per_symbol(mod_order))) [[unlikely]]
+    return simulate_uncoded_ber(mod_order, snr_db, num_bits, seed, threads,
+                                out_errors, out_bits);
+  const int bits_per_sym = bits_per_symbol(mod_order);
+  num_bits -= num_bits % bits_per_sym;
+  *out_bits = num_bits;
+  const int engine = current_rng_engine();
+  const uint64_t key = cache_stream_key(mod_order, snr_db, seed, BER_BATCH_UNCODED,
+                                        static_cast<uint32_t>(engine));
+  if (const auto hit = cache_find_exact(key, num_bits)) {
+    cache_note(CacheOutcome::Hit);
+    *out_errors = hit->errors;
+    return static_cast<double>(hit->errors) / static_cast<double>(num_bits);
+  }
+
+  const long long num_sym = num_bits / bits_per_sym;
+  const long long full_chunks = num_sym / CHUNK_SYMBOLS;
+  const long long num_chunks = (num_sym + CHUNK_SYMBOLS - 1) / CHUNK_SYMBOLS;
+  long long first = 0, prefix_errors = 0;
+  if (const auto prefix = cache_find_prefix(key, num_sym)) {
+    first = prefix->prefix_sym / CHUNK_SYMBOLS;
+    prefix_errors = prefix->prefix_errors;
+  }
+  cache_note(first > 0 ? CacheOutcome::Extended : CacheOutcome::Miss);
+
+  const double sigma = uncoded_sigma(mod_order, snr_db);
+  atomic<long long> whole{0}, tail{0}; // Whole chunks / trailing partial one
+  parallel_for_items(num_chunks - first, threads, [&](long long i) {
+    const long long c = first + i;
+    const long long e = uncoded_chunk_errors(engine, mod_order, sigma, num_sym, seed, c);
+    (c < full_chunks ? whole : tail).fetch_add(e);
+  });
+  const long long whole_errors = prefix_errors + whole.load();
+  *out_errors = whole_errors + tail.load();
+  cache_append({key, seed, snr_db, mod_order, BER_BATCH_UNCODED, num_bits,
+                *out_errors, num_bits, full_chunks * CHUNK_SYMBOLS, whole_errors, 0});
+  return static_cast<double>(*out_errors) / static_cast<double>(num_bits);
+}
+
+extern "C" double compute_ber_cached(int mod_order, double snr_db,
+                                     long long num_bits,
+                                     unsigned long long seed, int code_rate,
+                                     int threads, long long *out_errors,
+                                     long long *out_bits) {
+  if (code_rate != BER_BATCH_UNCODED && !puncture_pattern(code_rate)) [[unlikely]]
+    return -1.0;
+  if (threads <= 0)
+    threads = static_cast<int>(std::max(1u, thread::hardware_concurrency()));
+  long long errors = 0, bits = 0;
+  const double ber = ber_job(mod_order, snr_db, num_bits, seed, code_rate,
+                             threads, &errors, &bits);
+  if (out_errors)
+    *out_errors = ber < 0.0 ? 0 : errors;
+  if (out_bits)
+    *out_bits = ber < 0.0 ? 0 : bits;
+  return ber;
+}
+
+// =============================================================================
+// BATCH API
+// =============================================================================
+//
+// One FFI call per sweep: jobs are spread over the workers, and each job runs
+// exactly the scalar entry point it stands for, so out_ber[k] does not depend
+// on the batch layout or the thread count. Jobs share the leftover threads
+// when there are fewer jobs than threads (uncoded only; the coded path is
+// single-threaded). Coded jobs reuse one workspace per worker thread.
+
+ber_coded_workspace_t &thread_coded_workspace() {
+  thread_local auto ws = std::make_unique<ber_coded_workspace>();
+  return *ws;
+}
+
+extern "C" int compute_ber_batch(int n_jobs, const int *mod_orders,
+                                 const double *snrs_db,
+                                 const long long *num_bits,
+                                 const unsigned long long *seeds, int code_rate,
+                                 int threads, double *out_ber,
+                                 long long *out_errors, long long *out_bits) {
+  if (n_jobs < 0 || (n_jobs > 0 && (!mod_orders || !snrs_db || !num_bits ||
+                                    !seeds || !out_ber))) [[unlikely]]
+    return -1;
+  if (code_rate != BER_BATCH_UNCODED && !puncture_pattern(code_rate)) [[unlikely]]
+    return -1;
+  if (threads <= 0)
+    threads = static_cast<int>(std::max(1u, thread::hardware_concurrency()));
+  const int job_threads = std::max(1, threads / std::max(1, n_jobs));
+
+  atomic<int> failed{0};
+  parallel_for_items(n_jobs, threads, [&](long long k) {
+    long long errors = 0, bits = 0;
+    const double ber = ber_job(mod_orders[k], snrs_db[k], num_bits[k], seeds[k],
+                               code_rate, job_threads, &errors, &bits);
+    if (ber < 0.0) {
+      errors = bits = 0;
+      failed.fetch_add(1);
+    }
+    out_ber[k] = ber;
+    if (out_errors)
+      out_errors[k] = errors;
+    if (out_bits)
+      out_bits[k] = bits;
+  });
+  return failed.load();
+}
+
+// =============================================================================
+// ASYNCHRONOUS JOBS
+// =============================================================================
+//
+// ber_job_start runs one seeded point on the shared work-stealing pool while
+// the caller carries on. An uncoded job is a stream of chunk tasks: a task
+// claims the next chunk, adds its errors to the job totals and re-queues
+// itself, with at most one task per worker in flight, so concurrent jobs
+// share the pool chunk by chunk. Chunk error counts are integers, so the
+// total does not depend on completion order and equals compute_ber_seeded.
+// A coded job is one task running coded_ber with a tile hook that publishes
+// progress and checks for cancellation. The last task to end reports the
+// final progress, records the state and wakes ber_job_result.
+
+constexpr long long JOB_CODED_REPORT_BITS = 1LL << 20; // Coded callback spacing
+
+struct ber_async_job {
+  ber_job_params_t params{};
+  ber_job_callback_t callback = nullptr;
+  void *user_data = nullptr;
+  int engine = RNG_ENGINE_FAST;
+  int llr_mode = LLR_MODE_EXACT;
+  UntilRule rule;                      // Uncoded runs
+  std::optional<FadingChannel> fading; // Channel captured at submission
+  atomic<long long> next_chunk{0};
+  atomic<bool> cancel{false};
+  mutex callback_lock; // Serialises callback calls
+
+  mutex lock; // Guards everything below
+  condition_variable ended;
+  ber_job_progress_t progress{};
+  int tasks = 0; // Tasks queued or running
+  int state = BER_JOB_RUNNING;
+  double coded_result = 0.0; // coded_ber return value
+};
+
+namespace {
+
+// Snapshot taken under callback_lock, so successive calls never go backwards
+void report_job_progress(ber_async_job *job) {
+  if (!job->callback)
+    return;
+  lock_guard<mutex> serial(job->callback_lock);
+  ber_job_progress_t snapshot;
+  {
+    lock_guard<mutex> g(job->lock);
+    snapshot = job->progress;
+  }
+  job->callback(&snapshot, job->user_data);
+}
+
+void end_job_task(ber_async_job *job) {
+  {
+    lock_guard<mutex> g(job->lock);
+    if (--job->tasks > 0)
+      return;
+  }
+  report_job_progress(job); // Last task: the counters are final
+  lock_guard<mutex> g(job->lock);
+  if (job->params.code_rate != BER_BATCH_UNCODED)
+    job->state = job->coded_result == CODED_CANCELLED ? BER_JOB_CANCELLED
+                 : job->coded_result < 0.0            ? BER_JOB_FAILED
+                                                      : BER_JOB_DONE;
+  else
+    job->state = job->progress.bits_done == job->progress.bits_total ? BER_JOB_DONE
+                                                                     : BER_JOB_CANCELLED;
+  job->ended.notify_all();
+}
+
+void run_uncoded_job_task(ber_async_job *job) {
+  const UntilRule &rule = job->rule;
+  const long long c =
+      job->cancel.load(memory_order_acquire) ? -1 : job->next_chunk.fetch_add(1);
+  if (c >= 0 && c < rule.num_chunks()) {
+    const long long errors = with_awgn_source(
+        job->engine, chunk_seed(job->params.seed, static_cast<uint64_t>(c)), [&](auto &src) {
+          return simulate_chunk_errors(src, rule.mod_order, rule.sigma, rule.chunk_len(c),
+                                       nullptr, fading_ptr(job->fading),
+                                       static_cast<uint64_t>(c * CHUNK_SYMBOLS));
+        });
+    {
+      lock_guard<mutex> g(job->lock);
+      job->progress.errors += errors;
+      job->progress.bits_done += rule.chunk_len(c) * rule.bits_per_sym;
+    }
+    report_job_progress(job);
+    if (!job->cancel.load(memory_order_acquire) &&
+        job->next_chunk.load() < rule.num_chunks()) {
+      ber_thread_pool().submit([job] { run_uncoded_job_task(job); }); // Keeps its slot
+      return;
+    }
+  }
+  end_job_task(job);
+}
+
+void run_coded_job_task(ber_async_job *job) {
+  const ber_job_params_t &p = job->params;
+  long long reported = 0;
+  CodedRunHooks hooks;
+  hooks.engine = job->engine;
+  hooks.llr_mode = job->llr_mode;
+  hooks.progress = [job, &reported](long long info_bits) {
+    {
+      lock_guard<mutex> g(job->lock);
+      job->progress.bits_done = info_bits;
+    }
+    if (info_bits - reported >= JOB_CODED_REPORT_BITS) {
+      reported = info_bits;
+      report_job_progress(job);
+    }
+    return !job->cancel.load(memory_order_acquire);
+  };
+  long long errors = 0, bits = 0;
+  const double ber = coded_ber(&thread_coded_workspace(), p.mod_order, p.snr_db, p.num_bits,
+                               static_cast<int>(p.seed), *puncture_pattern(p.code_rate),
+                               &errors, &bits, &hooks);
+  {
+    lock_guard<mutex> g(job->lock);
+    job->coded_result = ber;
+    if (ber >= 0.0)
+      job->progress = {bits, bits, errors};
+  }
+  end_job_task(job);
+}
+
+} // namespace
+
+extern "C" ber_job_t *ber_job_start(const ber_job_params_t *params,
+                                    ber_job_callback_t callback, void *user_data) {
+  if (!params) [[unlikely]]
+    return nullptr;
+  const ber_job_params_t &p = *params;
+  auto job = make_unique<ber_async_job>();
+  job->params = p;
+  job->callback = callback;
+  job->user_data = user_data;
+  job->engine = current_rng_engine();
+  job->llr_mode = current_llr_mode();
+  int tasks = 1;
+  if (p.code_rate == BER_BATCH_UNCODED) {
+    const auto rule = make_until_rule(p.mod_order, p.snr_db, 0, p.num_bits, 0.0);
+    if (!rule) [[unlikely]]
+      return nullptr;
+    job->rule = *rule;
+    job->fading = current_fading(p.seed);
+    job->progress.bits_total = rule->max_bits;
+    tasks = static_cast<int>(
+        std::min<long long>(ber_thread_pool().size(), rule->num_chunks()));
+  } else {
+    if (!puncture_pattern(p.code_rate) || !is_valid_mod_order(p.mod_order) ||
+        p.num_bits <= 0 || p.num_bits > numeric_limits<int>::max()) [[unlikely]]
+      return nullptr;
+    job->progress.bits_total = p.num_bits;
+  }
+  job->tasks = tasks;
+
+  ber_async_job *handle = job.release();
+  for (int i = 0; i < tasks; ++i)
+    ber_thread_pool().submit([handle] {
+      if (handle->params.code_rate == BER_BATCH_UNCODED)
+        run_uncoded_job_task(handle);
+      else
+        run_coded_job_task(handle);
+    });
+  return handle;
+}
+
+extern "C" int ber_job_poll(ber_job_t *job, ber_job_progress_t *out_progress) {
+  if (!job) [[unlikely]]
+    return -1;
+  lock_guard<mutex> g(job->lock);
+  if (out_progress)
+    *out_progress = job->progress;
+  return job->state;
+}
+
+extern "C" int ber_job_cancel(ber_job_t *job) {
+  if (!job) [[unlikely]]
+    return -1;
+  job->cancel.store(true, memory_order_release);
+  return 0;
+}
+
+extern "C" int ber_job_result(ber_job_t *job, double *out_ber, long long *out_errors,
+                              long long *out_bits) {
+  if (!job) [[unlikely]]
+    return -1;
+  unique_ptr<ber_async_job> owned(job);
+  unique_lock<mutex> g(job->lock);
+  job->ended.wait(g, [&] { return job->state != BER_JOB_RUNNING; });
+  const bool failed = job->state == BER_JOB_FAILED;
+  const bool empty = failed || job->progress.bits_done == 0 ||
+                     (job->state == BER_JOB_CANCELLED && job->params.code_rate != BER_BATCH_UNCODED);
+  if (out_ber)
+    *out_ber = failed  ? job->coded_result
+               : empty ? 0.0
+                       : static_cast<double>(job->progress.errors) /
+                             static_cast<double>(job->progress.bits_done);
+  if (out_errors)
+    *out_errors = empty ? 0 : job->progress.errors;
+  if (out_bits)
+    *out_bits = empty ? 0 : job->progress.bits_done;
+  const int state = job->state;
+  g.unlock();
+  return state;
 }
 
 // Extern C interface for Python
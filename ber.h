@@ -0,0 +1,771 @@
+#ifndef BER_H
+#define BER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Uncoded BER over AWGN (non-deterministic, seeded from std::random_device)
+ *
+ * Bits are streamed through fixed-size tiles, so memory use does not depend
+ * on num_bits and there is no upper limit on the bit budget.
+ * @param mod_order Modulation order (2=BPSK, 4=QPSK, 16/64/256=square Gray QAM)
+ * @param snr_db Eb/N0 in dB (valid range -50..50)
+ * @param num_bits Number of bits (truncated to a multiple of bits/symbol)
+ * @return BER in [0,1], 0.0 for non-positive num_bits, -1.0 on invalid input
+ */
+double compute_ber(int mod_order, double snr_db, long long num_bits);
+
+/**
+ * Deterministic uncoded BER for reproducible simulation sequences
+ * (single-threaded; equal to compute_ber_parallel with the same seed)
+ * @param seed Base seed of the random stream
+ * @return Same conventions as compute_ber
+ */
+double compute_ber_seeded(int mod_order, double snr_db, long long num_bits,
+                          unsigned long long seed);
+
+/**
+ * Multithreaded deterministic uncoded BER
+ *
+ * The bit budget is split into fixed-size chunks; chunk i draws from its own
+ * generator seeded from (seed, i), so the result depends only on
+ * (mod_order, snr_db, num_bits, seed) and is bit-identical for any thread
+ * count.
+ * @param threads Worker threads (<= 0 selects std::thread::hardware_concurrency)
+ * @return Same conventions as compute_ber
+ */
+double compute_ber_parallel(int mod_order, double snr_db, long long num_bits,
+                            unsigned long long seed, int threads);
+
+/**
+ * Uncoded BER curve in one call (multithreaded, deterministic)
+ *
+ * One payload and one unit-noise stream are generated and reused for every
+ * SNR point; only the noise scale changes. out_ber[k] is therefore identical
+ * to compute_ber_seeded(mod_order, snrs_db[k], num_bits, seed).
+ * @param snrs_db Eb/N0 points in dB (each in -50..50)
+ * @param n_snr Number of points
+ * @param out_ber BER per point (n_snr entries)
+ * @param out_errors Bit error count per point (n_snr entries, may be NULL)
+ * @return 0 on success, -1 on invalid input (outputs untouched)
+ */
+int compute_ber_sweep(int mod_order, const double *snrs_db, int n_snr,
+                      long long num_bits, unsigned long long seed,
+                      double *out_ber, long long *out_errors);
+
+// Why compute_ber_until stopped
+enum {
+  BER_STOP_MIN_ERRORS = 1, // Error count reached min_errors
+  BER_STOP_CI = 2,         // Relative CI half-width reached rel_ci
+  BER_STOP_MAX_BITS = 3    // Bit budget exhausted
+};
+
+typedef struct {
+  double ber;
+  double ci_low;   // 95% Wilson score interval
+  double ci_high;
+  long long errors;
+  long long bits;  // Bits actually simulated
+  int stop_reason; // BER_STOP_*
+} ber_until_stats_t;
+
+/**
+ * Uncoded BER with early termination (multithreaded, deterministic)
+ *
+ * Simulates the compute_ber_seeded stream tile by tile (4096 symbols) and
+ * stops after the first tile where errors >= min_errors, or the CI half-width
+ * is <= rel_ci * BER, or max_bits is reached. The result equals
+ * compute_ber_seeded(mod_order, snr_db, out_stats->bits, seed).
+ * @param min_errors Target error count (0 disables)
+ * @param max_bits Bit budget (truncated to a multiple of bits/symbol)
+ * @param rel_ci Target relative 95% CI half-width, e.g. 0.1 (0 disables)
+ * @return 0 on success, -1 on invalid input
+ */
+int compute_ber_until(int mod_order, double snr_db, long long min_errors,
+                      long long max_bits, double rel_ci,
+                      unsigned long long seed, ber_until_stats_t *out_stats);
+
+// One compute_ber_until point for ber_submit_jobs
+typedef struct {
+  int mod_order;
+  double snr_db;
+  long long max_bits;
+  long long min_errors; // 0 disables
+  double rel_ci;        // 0 disables
+  unsigned long long seed;
+} ber_point_t;
+
+typedef struct ber_jobs ber_jobs_t;
+
+/**
+ * Queue a grid of early-terminating points on the internal work-stealing pool
+ *
+ * Every point is split into 65536-symbol chunk tasks; chunk errors are merged
+ * per point and the point's remaining tasks are cancelled as soon as its stop
+ * rule fires, so cheap points free their workers for expensive ones. Returns
+ * immediately; collect the results with ber_wait.
+ * @param points Points to simulate (n_points entries, copied)
+ * @return Job handle, or NULL if any point is invalid (nothing queued)
+ */
+ber_jobs_t *ber_submit_jobs(const ber_point_t *points, int n_points);
+
+/**
+ * Block until every point of a job has stopped, then release the handle
+ *
+ * out_stats[i] equals compute_ber_until for points[i].
+ * @param out_stats Per-point results (n_points entries, may be NULL)
+ * @return 0 on success, -1 on a NULL handle
+ */
+int ber_wait(ber_jobs_t *jobs, ber_until_stats_t *out_stats);
+
+/**
+ * Resumable state of one compute_ber_seeded run
+ *
+ * The stream is a sequence of 65536-symbol chunks, each drawn from its own
+ * generator seeded from (seed, chunk), so the chunk index is the whole RNG
+ * position. An accumulator owns chunks [chunk_begin, chunk_end) and has
+ * counted [chunk_begin, next_chunk). Treat the fields as read-only.
+ */
+typedef struct {
+  int mod_order;
+  int rng_engine; // BER_RNG_* captured by ber_accum_init
+  double snr_db;
+  unsigned long long seed;
+  long long num_bits; // Whole run (truncated to a multiple of bits/symbol)
+  long long chunk_begin;
+  long long chunk_end;
+  long long next_chunk;
+  long long errors; // Over [chunk_begin, next_chunk)
+  long long bits;
+} ber_accum_t;
+
+// Size of a serialized ber_accum_t (ber_accum_save/ber_accum_load)
+enum { BER_ACCUM_BLOB_BYTES = 96 };
+
+/**
+ * Start an accumulator for compute_ber_seeded(mod_order, snr_db, num_bits,
+ * seed) under the current RNG engine (later engine changes do not affect it)
+ * @return 0 on success, -1 on invalid input
+ */
+int ber_accum_init(ber_accum_t *acc, int mod_order, double snr_db,
+                   long long num_bits, unsigned long long seed);
+
+/**
+ * Simulate up to max_chunks more chunks of the accumulator's range
+ *
+ * Once nothing remains, errors/bits equal the compute_ber_seeded counts (for
+ * a merged set of parts, see ber_accum_merge), however the work was chunked,
+ * checkpointed or threaded.
+ * @param threads Worker threads (<= 0 selects all cores)
+ * @return Chunks still to simulate (0 when done), -1 on invalid input
+ */
+long long ber_accum_advance(ber_accum_t *acc, long long max_chunks, int threads);
+
+/**
+ * Split the remaining chunks of acc into n_parts contiguous accumulators
+ * (out[0] keeps what acc already counted) that can run as separate jobs
+ * @param out n_parts entries; parts may be empty if chunks are scarce
+ * @return 0 on success, -1 on invalid input
+ */
+int ber_accum_split(const ber_accum_t *acc, int n_parts, ber_accum_t *out);
+
+/**
+ * Append src to dst: same run, dst finished, and src starting where dst ends
+ * (merge the parts of a split in order)
+ * @return 0 on success, -1 if the accumulators do not fit together
+ */
+int ber_accum_merge(ber_accum_t *dst, const ber_accum_t *src);
+
+/** @return errors / bits so far (0 before any chunk), -1 for NULL */
+double ber_accum_ber(const ber_accum_t *acc);
+
+/**
+ * Serialize to a portable little-endian blob with a version and checksum
+ * @param size Buffer size (at least BER_ACCUM_BLOB_BYTES)
+ * @return Bytes written (BER_ACCUM_BLOB_BYTES), -1 on invalid input
+ */
+int ber_accum_save(const ber_accum_t *acc, unsigned char *buf, int size);
+
+/**
+ * Restore an accumulator written by ber_accum_save
+ * @return 0 on success, -1 if the blob is short, corrupt, inconsistent or
+ *         from a build whose seeded streams differ (acc untouched)
+ */
+int ber_accum_load(ber_accum_t *acc, const unsigned char *buf, int size);
+
+typedef struct {
+  double ber;      // Unbiased importance-sampling estimate
+  double std_err;  // Standard error of ber
+  double ci_low;   // 95% normal interval, clamped at 0
+  double ci_high;
+  long long symbols;
+  long long hits;  // Symbols with at least one bit error under the biased noise
+} ber_is_stats_t;
+
+/**
+ * Uncoded BER by importance sampling, for the region plain Monte Carlo cannot
+ * reach (1e-8 and below)
+ *
+ * Each noise component is mean-shifted to the nearest decision boundary of
+ * its transmitted level (an equal mixture of both shifts for inner QAM
+ * levels) and every bit error is weighted by the likelihood ratio of its own
+ * axis. About 1e6 symbols give a few percent relative error at 1e-10.
+ * Multithreaded and deterministic for a given seed and noise engine.
+ * @param num_symbols Symbols to simulate (>= 2)
+ * @return 0 on success, -1 on invalid input
+ */
+int compute_ber_is(int mod_order, double snr_db, long long num_symbols,
+                   unsigned long long seed, ber_is_stats_t *out_stats);
+
+/**
+ * Smallest Eb/N0 whose simulated uncoded BER is <= target_ber
+ *
+ * Starts from a bracket around the theoretical crossing and refines it with
+ * 8-section sweeps. Every probe uses the same seeded bit/noise stream, so the
+ * result is deterministic.
+ * @param target_ber Target BER in (0, 0.5)
+ * @param bits_per_probe Bits simulated at each probed SNR
+ * @param tol_db Final bracket width in dB; the upper end is returned
+ * @param out_snr_db Threshold in dB
+ * @param out_bits_spent Total bits simulated over all probes (may be NULL)
+ * @return 0 on success, -1 invalid input, -2 target not reached by 50 dB
+ */
+int find_snr_threshold(int mod_order, double target_ber,
+                       long long bits_per_probe, double tol_db,
+                       unsigned long long seed, double *out_snr_db,
+                       long long *out_bits_spent);
+
+/**
+ * AMC switching points: the QPSK and 16-QAM thresholds, searched
+ * concurrently on two threads (each as find_snr_threshold)
+ * @param out_bits_spent Bits simulated by both searches (may be NULL)
+ * @return 0 on success, otherwise the first failing search's error code
+ */
+int find_amc_thresholds(double target_ber, long long bits_per_probe,
+                        double tol_db, unsigned long long seed,
+                        double *out_thresh_qpsk, double *out_thresh_16qam,
+                        long long *out_bits_spent);
+
+/**
+ * Estimate Eb/N0 from BPSK pilot symbols (all 1+0j) received over AWGN
+ * @return Estimated Eb/N0 in dB, -999.0 on invalid input
+ */
+double estimate_snr(double true_snr_db, long long num_pilots);
+
+/**
+ * Mean and spread of the pilot SNR estimator over many trials (multithreaded,
+ * deterministic)
+ *
+ * Each trial is one estimate_snr run; only the noise is generated and its
+ * energy is streamed, so num_pilots may go far beyond estimate_snr's 1e6.
+ * All SNR points share each trial's noise (common random numbers).
+ * @param true_snrs_db True Eb/N0 per point in dB (n_snr entries)
+ * @param num_pilots Pilots per trial (1 .. 2^40)
+ * @param trials Estimates per point
+ * @param out_mean_db Mean estimate per point in dB (n_snr entries)
+ * @param out_std_db Sample standard deviation per point in dB (may be NULL)
+ * @return 0 on success, -1 on invalid input
+ */
+int estimate_snr_batch(const double *true_snrs_db, int n_snr,
+                       long long num_pilots, long long trials,
+                       unsigned long long seed, double *out_mean_db,
+                       double *out_std_db);
+
+// Modes chosen by run_amc_link (index into ber_link_stats_t.mode_frames)
+enum {
+  BER_AMC_NONE = 0, // Estimate below the QPSK threshold: frame not sent
+  BER_AMC_QPSK = 1,
+  BER_AMC_16QAM = 2,
+  BER_AMC_MODES = 3
+};
+
+typedef struct {
+  long long frames;
+  long long mode_frames[BER_AMC_MODES]; // Frames sent in each mode
+  long long bits;                       // Payload bits sent
+  long long errors;                     // Bit errors in the sent frames
+  double ber;                           // errors / bits (0 if nothing sent)
+  double spectral_efficiency;           // Bits sent per symbol slot (b/s/Hz)
+  double goodput;                       // Correct bits per symbol slot
+  double mean_est_error_db;             // Mean pilot estimate minus true SNR
+} ber_link_stats_t;
+
+/**
+ * Link-level AMC simulation (multithreaded, deterministic)
+ *
+ * Every frame estimates Eb/N0 from num_pilots BPSK pilots (as
+ * estimate_snr_batch), picks NONE / QPSK / 16QAM against the two thresholds
+ * (choose_mod in run_amc.py; e.g. from find_amc_thresholds) and, unless
+ * NONE, sends frame_symbols symbols at that mode over AWGN. Frames have a
+ * fixed airtime, so spectral efficiency is bits sent over all symbol slots.
+ * Frame f has its own stream (seed, f) and sees snr_trace[f % trace_len].
+ * Under a fading channel (ber_set_channel) pilots and payload are faded too,
+ * the estimate tracks the instantaneous SNR and num_pilots must be >= 2.
+ * @param snr_trace True Eb/N0 per frame in dB (trace_len entries, repeated)
+ * @param threads Worker threads (0 = all cores)
+ * @return 0 on success, -1 on invalid input (thresh_qpsk > thresh_16qam
+ *         included)
+ */
+int run_amc_link(long long frames, long long frame_symbols,
+                 long long num_pilots, const double *snr_trace,
+                 long long trace_len, double thresh_qpsk, double thresh_16qam,
+                 unsigned long long seed, int threads,
+                 ber_link_stats_t *out_stats);
+
+/**
+ * Coded BER (K=7 rate 1/2 convolutional code, soft-decision Viterbi).
+ * Up to 2^24 info bits are decoded as one block; longer runs (up to INT_MAX
+ * bits) stream through viterbi_stream_* in constant memory, which is
+ * maximum-likelihood except for the sliding traceback window.
+ * @return BER in [0,1]; negative values are error codes (-0.25 beyond INT_MAX)
+ */
+double compute_ber_coded(int mod_order, double snr_db, long long num_bits,
+                         int seed);
+
+// Code rates for compute_ber_coded_rate (punctured K=7 mother code)
+enum {
+  BER_RATE_1_2 = 0, // Unpunctured
+  BER_RATE_2_3 = 1, // Sends 3 of every 4 coded bits
+  BER_RATE_3_4 = 2  // Sends 4 of every 6 coded bits
+};
+
+/**
+ * Coded BER at a punctured rate. Punctured bits are never transmitted
+ * (Es/N0 = R * bits/symbol * Eb/N0) and enter the decoder as zero LLRs.
+ * BER_RATE_1_2 equals compute_ber_coded.
+ * @param rate_id BER_RATE_* constant
+ * @return BER in [0,1]; -1.0 for an unknown rate_id, other negative values
+ *         as compute_ber_coded
+ */
+double compute_ber_coded_rate(int mod_order, double snr_db, long long num_bits,
+                              int seed, int rate_id);
+
+/**
+ * Reusable buffers for coded BER. Bits stay packed and symbols/LLRs exist one
+ * 8192-bit tile at a time, so a workspace holds about 8.4 bytes per info bit
+ * (mostly Viterbi survivors) up to the 2^24-bit block limit, and a fixed few
+ * MB for streamed runs. It reuses its allocations across calls.
+ * A workspace must not be used by two threads at once.
+ */
+typedef struct ber_coded_workspace ber_coded_workspace_t;
+
+/** @return New workspace, or NULL on allocation failure */
+ber_coded_workspace_t *ber_coded_workspace_create(void);
+
+void ber_coded_workspace_free(ber_coded_workspace_t *ws);
+
+/**
+ * compute_ber_coded on a caller-owned workspace (same results)
+ * @return Same conventions as compute_ber_coded; -1.0 for a NULL workspace
+ */
+double compute_ber_coded_ws(ber_coded_workspace_t *ws, int mod_order,
+                            double snr_db, long long num_bits, int seed);
+
+/**
+ * Arena for the single-threaded entry points: uncoded tiles, the coded
+ * pipeline, SNR pilots and decoder output. Buffers grow to the largest call
+ * seen and are then reused, so a steady-state sweep through the *_ws calls
+ * makes no heap allocations. Results equal those of the plain calls.
+ * A workspace must not be used by two threads at once.
+ */
+typedef struct ber_workspace ber_workspace_t;
+
+/** @return New workspace, or NULL on allocation failure */
+ber_workspace_t *ber_workspace_create(void);
+
+void ber_workspace_destroy(ber_workspace_t *ws);
+
+/** compute_ber on a workspace; -1.0 for a NULL workspace */
+double compute_ber_ws(ber_workspace_t *ws, int mod_order, double snr_db,
+                      long long num_bits);
+
+/** compute_ber_seeded on a workspace (same results); -1.0 for a NULL workspace */
+double compute_ber_seeded_ws(ber_workspace_t *ws, int mod_order, double snr_db,
+                             long long num_bits, unsigned long long seed);
+
+/** estimate_snr on a workspace; -999.0 for a NULL workspace */
+double estimate_snr_ws(ber_workspace_t *ws, double true_snr_db,
+                       long long num_pilots);
+
+/**
+ * compute_ber_coded_rate on a workspace (same results)
+ * @return Same conventions as compute_ber_coded_rate; -1.0 for a NULL workspace
+ */
+double compute_ber_coded_rate_ws(ber_workspace_t *ws, int mod_order,
+                                 double snr_db, long long num_bits, int seed,
+                                 int rate_id);
+
+/**
+ * viterbi_decode on a workspace (same bits and return codes; -1 for a NULL
+ * workspace). Survivor memory is kept in the workspace between calls.
+ */
+int viterbi_decode_ws(ber_workspace_t *ws, const double *received_llr,
+                      int received_len, bool *decoded_bits, int *decoded_len);
+
+// code_rate value of compute_ber_batch for uncoded jobs
+enum { BER_BATCH_UNCODED = -1 };
+
+/**
+ * Many BER points in one call, written straight into caller-owned arrays
+ * (e.g. NumPy buffers). Job k is (mod_orders[k], snrs_db[k], num_bits[k],
+ * seeds[k]); all jobs share code_rate. out_ber[k] equals
+ * compute_ber_parallel(mod, snr, bits, seed, any) for uncoded jobs, and
+ * compute_ber_coded_rate(mod, snr, bits, (int)seed, code_rate) for coded
+ * ones, whatever the batch size or thread count. Jobs go through the result
+ * cache while one is open (ber_cache_open).
+ * @param n_jobs Number of jobs (0 is a no-op)
+ * @param code_rate BER_BATCH_UNCODED or a BER_RATE_* constant
+ * @param threads Worker threads (<= 0 selects all cores)
+ * @param out_ber BER per job, or the scalar call's negative error code
+ * @param out_errors Bit errors per job (may be NULL; 0 for failed jobs)
+ * @param out_bits Bits counted per job (may be NULL; 0 for failed jobs)
+ * @return Number of failed jobs (0 when all succeeded), -1 on invalid
+ *         arguments (outputs untouched)
+ */
+int compute_ber_batch(int n_jobs, const int *mod_orders, const double *snrs_db,
+                      const long long *num_bits,
+                      const unsigned long long *seeds, int code_rate,
+                      int threads, double *out_ber, long long *out_errors,
+                      long long *out_bits);
+
+// Result cache counters since the last ber_cache_reset_stats
+typedef struct {
+  long long hits;     // Answered from a stored record
+  long long extended; // Continued from a shorter stored run of the same stream
+  long long misses;   // Simulated from scratch
+  long long records;  // Records in the open cache file
+} ber_cache_stats_t;
+
+/**
+ * Open (or create) a persistent result cache. While it is open,
+ * compute_ber_batch and compute_ber_cached answer seeded runs from it and
+ * append every new result. Records are keyed by mod, SNR, seed, code rate,
+ * RNG engine (and LLR mode for coded runs) and the kernel version, so a
+ * cached answer equals the uncached one. An uncoded run with more bits than
+ * a stored run of the same stream only simulates the extra chunks.
+ * @param path Cache file (created if missing; shared safely between processes)
+ * @return 0 on success, -1 if the file cannot be opened or is not a cache
+ */
+int ber_cache_open(const char *path);
+
+/** Close the result cache (later calls simulate everything again) */
+void ber_cache_close(void);
+
+/**
+ * @param out Counters and record count
+ * @return 0 on success, -1 for NULL
+ */
+int ber_cache_stats(ber_cache_stats_t *out);
+
+/** Zero the hit/extended/miss counters */
+void ber_cache_reset_stats(void);
+
+/**
+ * One compute_ber_batch job, through the result cache when it is open
+ * @param code_rate BER_BATCH_UNCODED or a BER_RATE_* constant (coded runs
+ *        use (int)seed, like compute_ber_coded_rate)
+ * @param threads Worker threads for uncoded runs (<= 0 selects all cores)
+ * @param out_errors Bit errors (may be NULL; 0 on failure)
+ * @param out_bits Bits counted (may be NULL; 0 on failure)
+ * @return BER, or the scalar call's negative error code (-1 for an unknown
+ *         code_rate)
+ */
+double compute_ber_cached(int mod_order, double snr_db, long long num_bits,
+                          unsigned long long seed, int code_rate, int threads,
+                          long long *out_errors, long long *out_bits);
+
+// One seeded run for ber_job_start
+typedef struct {
+  int mod_order;
+  double snr_db;
+  long long num_bits;
+  unsigned long long seed; // Coded runs use (int)seed
+  int code_rate;           // BER_BATCH_UNCODED or a BER_RATE_* constant
+} ber_job_params_t;
+
+// Progress of an asynchronous job
+typedef struct {
+  long long bits_done;  // Bits simulated so far (info bits for coded runs)
+  long long bits_total; // Bits of the whole run
+  long long errors;     // Bit errors so far (coded runs: known at the end)
+} ber_job_progress_t;
+
+// State of an asynchronous job (ber_job_poll, ber_job_result)
+enum {
+  BER_JOB_RUNNING = 0,
+  BER_JOB_DONE = 1,      // Every bit simulated
+  BER_JOB_CANCELLED = 2, // Stopped by ber_job_cancel before the end
+  BER_JOB_FAILED = 3     // The run returned an error code
+};
+
+/**
+ * Called from a pool worker as a job advances (after every 65536-symbol
+ * chunk of an uncoded run, about every 2^20 info bits of a coded one) and
+ * once more when it ends. Calls for one job never overlap. The callback may
+ * call ber_job_poll and ber_job_cancel but not ber_job_result.
+ */
+typedef void (*ber_job_callback_t)(const ber_job_progress_t *progress,
+                                   void *user_data);
+
+typedef struct ber_async_job ber_job_t;
+
+/**
+ * Start a run on the internal work-stealing pool and return at once
+ *
+ * Uncoded runs are split into chunk tasks that interleave with other jobs,
+ * so many points can be in flight together; a coded run occupies one worker.
+ * The RNG engine, LLR mode and channel are captured here. A finished job's
+ * result equals compute_ber_seeded (uncoded) or compute_ber_coded_rate
+ * (coded) for the same parameters. Every handle must be released with
+ * ber_job_result.
+ * @param params Run to simulate (copied)
+ * @param callback Progress callback (may be NULL)
+ * @param user_data Passed to every callback call
+ * @return Job handle, or NULL on invalid parameters (nothing started)
+ */
+ber_job_t *ber_job_start(const ber_job_params_t *params,
+                         ber_job_callback_t callback, void *user_data);
+
+/**
+ * Non-blocking status check
+ * @param out_progress Progress so far (may be NULL)
+ * @return BER_JOB_* state, -1 for a NULL handle
+ */
+int ber_job_poll(ber_job_t *job, ber_job_progress_t *out_progress);
+
+/**
+ * Ask a job to stop: no new chunks (or coded tiles) are started and the job
+ * ends as BER_JOB_CANCELLED unless it had already finished
+ * @return 0 on success, -1 for a NULL handle
+ */
+int ber_job_cancel(ber_job_t *job);
+
+/**
+ * Block until the job has ended, then release the handle
+ * @param out_ber BER of the bits simulated (may be NULL); for a cancelled
+ *        uncoded run the BER of its completed chunks (0 if none), for a
+ *        cancelled coded run 0 with no errors or bits, for a failed run the
+ *        negative error code
+ * @param out_errors Bit errors counted (may be NULL)
+ * @param out_bits Bits counted (may be NULL)
+ * @return Final BER_JOB_* state, -1 for a NULL handle
+ */
+int ber_job_result(ber_job_t *job, double *out_ber, long long *out_errors,
+                   long long *out_bits);
+
+// Random engines for payload bits and AWGN
+enum {
+  BER_RNG_STD = 0,   // mt19937_64 + std::normal_distribution (reference)
+  BER_RNG_FAST = 1,  // xoshiro256++ + ziggurat (default)
+  BER_RNG_PHILOX = 2 // Philox4x32-10 counters + Box-Muller (GPU-capable)
+};
+
+/**
+ * Select the random engine used by all subsequent simulation calls
+ *
+ * Seeded results are reproducible per engine; switching engines changes the
+ * streams. BER_RNG_STD reproduces the results of earlier builds.
+ * @param engine BER_RNG_STD, BER_RNG_FAST or BER_RNG_PHILOX
+ * @return 0 on success, -1 for an unknown engine
+ */
+int ber_set_rng_engine(int engine);
+
+/** @return The currently selected engine (BER_RNG_*) */
+int ber_get_rng_engine(void);
+
+// Execution backends for uncoded seeded runs
+enum {
+  BER_BACKEND_CPU = 0, // Default
+  BER_BACKEND_GPU = 1  // Needs a GPU build (make GPU=cuda|hip) and a device
+};
+
+/**
+ * Select where uncoded seeded runs (compute_ber_seeded, compute_ber_parallel,
+ * uncoded compute_ber_batch jobs) execute
+ *
+ * BER_BACKEND_GPU only applies while the engine is BER_RNG_PHILOX, the one
+ * stream a device can generate per symbol; other engines, the coded path and
+ * all other entry points keep running on the CPU. A device failure falls
+ * back to the CPU for that call. The GPU returns the CPU's counts for the
+ * same seed (barring last-ulp differences in the device math library).
+ * @param backend BER_BACKEND_CPU or BER_BACKEND_GPU
+ * @return 0 on success, -1 for an unknown or unavailable backend
+ */
+int ber_set_backend(int backend);
+
+/** @return The currently selected backend (BER_BACKEND_*) */
+int ber_get_backend(void);
+
+/** @return 1 if this build has the GPU backend and a device is present */
+int ber_gpu_available(void);
+
+// Channel models for uncoded runs (ber_set_channel)
+enum {
+  BER_CHANNEL_AWGN = 0,  // No fading (default)
+  BER_CHANNEL_BLOCK = 1, // One coefficient per block of block_symbols
+  BER_CHANNEL_JAKES = 2  // Sum-of-sinusoids Jakes Doppler spectrum
+};
+
+typedef struct {
+  int model;               // BER_CHANNEL_*
+  double doppler;          // Max Doppler shift x symbol time (JAKES), (0, 0.5]
+  long long block_symbols; // Coherence block length (BLOCK), >= 1
+  double k_factor;         // Rician K (LOS / scattered power); 0 = Rayleigh
+} ber_channel_t;
+
+/**
+ * Select the channel of the uncoded seeded paths (compute_ber,
+ * compute_ber_seeded/parallel, compute_ber_sweep, compute_ber_until,
+ * ber_submit_jobs, uncoded compute_ber_batch jobs and run_amc_link)
+ *
+ * Fading coefficients h (E|h|^2 = 1, so SNR is the average Eb/N0) are a
+ * function of the run seed and the symbol time only, so seeded results stay
+ * independent of the thread count. The receiver equalizes coherently with the
+ * true h. The result cache is bypassed and ber_accum_init and compute_ber_is
+ * refuse to run (-1) while a fading channel is selected; the coded path and
+ * the SNR estimators always use AWGN.
+ * @param channel Model and parameters (copied); NULL selects AWGN
+ * @return 0 on success, -1 for an unknown model or out-of-range parameter
+ */
+int ber_set_channel(const ber_channel_t *channel);
+
+/** @return 0 after copying the current channel to out, -1 if out is NULL */
+int ber_get_channel(ber_channel_t *out);
+
+// Modulate/demodulate kernel variants
+enum {
+  BER_SIMD_AUTO = -1, // Best variant supported by this CPU (default)
+  BER_SIMD_SCALAR = 0,
+  BER_SIMD_AVX2 = 1,
+  BER_SIMD_AVX512 = 2,
+  BER_SIMD_NEON = 3
+};
+
+/**
+ * Select the modulate/demodulate kernel variant. All variants give
+ * bit-identical results; this exists for benchmarking and testing.
+ * @param level BER_SIMD_* constant
+ * @return 0 on success, -1 if the variant is unknown or unsupported here
+ */
+int ber_set_simd_level(int level);
+
+/** @return The active kernel variant (BER_SIMD_SCALAR..BER_SIMD_NEON) */
+int ber_get_simd_level(void);
+
+// Soft demapper (LLR) engines for the coded 16-QAM path
+enum {
+  BER_LLR_EXACT = 0,     // log-sum-exp over the 4-PAM levels (default)
+  BER_LLR_MAXLOG = 1,    // closed-form max-log, double
+  BER_LLR_MAXLOG_F32 = 2 // max-log in float SIMD lanes
+};
+
+/**
+ * Select the LLR engine used by subsequent coded simulations. BPSK/QPSK
+ * LLRs are linear and identical in every mode; 64/256-QAM always use
+ * max-log in double.
+ * @param mode BER_LLR_* constant
+ * @return 0 on success, -1 for an unknown mode
+ */
+int ber_set_llr_mode(int mode);
+
+/** @return The active LLR engine (BER_LLR_*) */
+int ber_get_llr_mode(void);
+
+// Pipeline stages counted by the instrumentation layer
+enum {
+  BER_STAGE_RNG = 0,         // Payload bit generation
+  BER_STAGE_MODULATE = 1,
+  BER_STAGE_AWGN = 2,        // Unit normals, scaling and addition
+  BER_STAGE_DEMODULATE = 3,  // Hard decisions
+  BER_STAGE_ERROR_COUNT = 4, // Error reduction (and IS weighting)
+  BER_STAGE_LLR = 5,         // Soft demapping (coded paths)
+  BER_STAGE_ENCODE = 6,      // Convolutional encoding and puncturing
+  BER_STAGE_DECODE = 7,      // Viterbi forward pass and traceback
+  BER_STAGE_SNR_EST = 8,     // estimate_snr
+  BER_STAGE_COUNT = 9
+};
+
+typedef struct {
+  unsigned long long ns;     // Wall time inside the stage, summed over threads
+  unsigned long long cycles; // TSC cycles (0 where no cycle counter exists)
+  unsigned long long calls;  // Timed spans (one per tile or call)
+  unsigned long long bytes;  // Output bytes produced by the stage
+} ber_stage_stats_t;
+
+typedef struct {
+  ber_stage_stats_t stage[BER_STAGE_COUNT]; // Indexed by BER_STAGE_*
+  unsigned long long allocs;      // Heap allocations on simulation paths
+  unsigned long long alloc_bytes;
+  int enabled;                    // 0 if built without BER_STATS
+} ber_stats_t;
+
+/** @return 1 if the library was built with -DBER_STATS, else 0 */
+int ber_stats_enabled(void);
+
+/**
+ * Sum of the per-thread stage counters since the last reset (all zero when
+ * instrumentation is compiled out)
+ * @return 0 on success, -1 for a NULL pointer
+ */
+int ber_stats_snapshot(ber_stats_t *out);
+
+/** Zero all counters (spans still running on other threads may survive) */
+void ber_stats_reset(void);
+
+/** @return Short name of a BER_STAGE_* value, or NULL if out of range */
+const char *ber_stats_stage_name(int stage);
+
+// Self-tests (err_msg buffers must hold at least 256 chars)
+int run_mod_demod_test(char *err_msg);
+int run_ber_edge_test(char *err_msg);
+int run_ber_accuracy_test(double *out_avg_ber, double *out_theor,
+                          char *err_msg);
+int run_snr_estimation_test(double *out_avg_est, double *out_std_est,
+                            char *err_msg);
+int run_all_tests(char *overall_msg);
+
+/**
+ * Statistical quality test of an AWGN engine (moments, tail rates,
+ * histogram chi-square, bit balance over 2^23 samples)
+ * @param engine BER_RNG_STD or BER_RNG_FAST
+ * @return 0 on pass, 1 on failure (reason in err_msg)
+ */
+int run_awgn_quality_test(int engine, char *err_msg);
+
+/**
+ * Check the max-log LLRs against a brute-force nearest-level search and the
+ * exact demapper, and the float SIMD variants against each other
+ * @return 0 on pass, 1 on failure (details in err_msg)
+ */
+int run_llr_engine_test(char *err_msg);
+
+/**
+ * Check every supported vector kernel against the scalar reference
+ * (bit-exact, including threshold ties, signed zeros and NaN)
+ * @return 0 on pass, 1 on mismatch (details in err_msg)
+ */
+int run_simd_kernel_test(char *err_msg);
+
+/**
+ * Check Philox4x32-10 against the Random123 known-answer vectors and the
+ * fused per-symbol kernel of the GPU backend against the BER_RNG_PHILOX tile
+ * loop (and against the device itself when one is available)
+ * @return 0 on pass, 1 on mismatch (details in err_msg)
+ */
+int run_philox_kernel_test(char *err_msg);
+
+/**
+ * Check the fading generators: unit mean power, Rician LOS share, the Jakes
+ * autocorrelation against J0(2 pi fd tau), the in-tile phasor recurrence
+ * against direct evaluation and the fused equalized noise against n / h
+ * @return 0 on pass, 1 on mismatch (details in err_msg)
+ */
+int run_channel_test(char *err_msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BER_H
@@ -0,0 +1,121 @@
+// GPU backend: the uncoded BER_RNG_PHILOX pipeline on CUDA or HIP devices
+//
+// One thread per symbol (grid-stride): Philox payload bits and Box-Muller
+// noise, modulate, hard decision and popcount fused in registers
+// (philox_symbol_errors), with a shared-memory then global error reduction.
+// Nothing but the final count leaves the device.
+//
+//   make GPU=cuda shared   (nvcc; --fmad=false keeps the CPU rounding)
+//   make GPU=hip shared    (hipcc)
+
+#if defined(__HIPCC__)
+#include <hip/hip_runtime.h>
+#define gpuError_t hipError_t
+#define gpuSuccess hipSuccess
+#define gpuGetDeviceCount hipGetDeviceCount
+#define gpuGetDevice hipGetDevice
+#define gpuDeviceGetAttribute hipDeviceGetAttribute
+#define gpuDevAttrMultiProcessorCount hipDeviceAttributeMultiprocessorCount
+#define gpuMalloc hipMalloc
+#define gpuFree hipFree
+#define gpuMemset hipMemset
+#define gpuMemcpy hipMemcpy
+#define gpuMemcpyDeviceToHost hipMemcpyDeviceToHost
+#define gpuGetLastError hipGetLastError
+#else
+#include <cuda_runtime.h>
+#define gpuError_t cudaError_t
+#define gpuSuccess cudaSuccess
+#define gpuGetDeviceCount cudaGetDeviceCount
+#define gpuGetDevice cudaGetDevice
+#define gpuDeviceGetAttribute cudaDeviceGetAttribute
+#define gpuDevAttrMultiProcessorCount cudaDevAttrMultiProcessorCount
+#define gpuMalloc cudaMalloc
+#define gpuFree cudaFree
+#define gpuMemset cudaMemset
+#define gpuMemcpy cudaMemcpy
+#define gpuMemcpyDeviceToHost cudaMemcpyDeviceToHost
+#define gpuGetLastError cudaGetLastError
+#endif
+
+#include "awgn.h"
+#include "gpu.h"
+#include "philox.h"
+
+namespace {
+
+constexpr int GPU_THREADS = 256;
+constexpr int GPU_BLOCKS_PER_SM = 16;
+
+// splitmix64 of awgn.h, callable on the device
+__device__ inline uint64_t device_splitmix64(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+__global__ void uncoded_errors_kernel(int bits_per_sym, double sigma,
+                                      long long num_sym, int chunk_shift,
+                                      uint64_t seed_mix,
+                                      unsigned long long *errors) {
+  __shared__ unsigned long long block_errors;
+  if (threadIdx.x == 0)
+    block_errors = 0;
+  __syncthreads();
+  const uint64_t offset_mask = (uint64_t{1} << chunk_shift) - 1;
+  const long long stride = static_cast<long long>(gridDim.x) * blockDim.x;
+  unsigned long long mine = 0;
+  for (long long g = static_cast<long long>(blockIdx.x) * blockDim.x + threadIdx.x;
+       g < num_sym; g += stride) {
+    const uint64_t sym = static_cast<uint64_t>(g);
+    const uint64_t key = device_splitmix64(seed_mix ^ (sym >> chunk_shift));
+    mine += static_cast<unsigned long long>(
+        philox_symbol_errors(key, sym & offset_mask, bits_per_sym, sigma));
+  }
+  atomicAdd(&block_errors, mine);
+  __syncthreads();
+  if (threadIdx.x == 0)
+    atomicAdd(errors, block_errors);
+}
+
+} // namespace
+
+bool gpu_backend_available() noexcept {
+  static const bool available = [] {
+    int count = 0;
+    return gpuGetDeviceCount(&count) == gpuSuccess && count > 0;
+  }();
+  return available;
+}
+
+bool gpu_uncoded_errors(int bits_per_sym, double sigma, long long num_sym,
+                        int chunk_shift, uint64_t seed, long long *errors) noexcept {
+  if (!gpu_backend_available())
+    return false;
+  int device = 0, sms = 1;
+  if (gpuGetDevice(&device) != gpuSuccess ||
+      gpuDeviceGetAttribute(&sms, gpuDevAttrMultiProcessorCount, device) != gpuSuccess)
+    return false;
+  unsigned long long *d_errors = nullptr;
+  if (gpuMalloc(reinterpret_cast<void **>(&d_errors), sizeof(*d_errors)) != gpuSuccess)
+    return false;
+  unsigned long long host = 0;
+  bool ok = gpuMemset(d_errors, 0, sizeof(*d_errors)) == gpuSuccess;
+  if (ok && num_sym > 0) {
+    const long long wanted = (num_sym + GPU_THREADS - 1) / GPU_THREADS;
+    const int blocks = static_cast<int>(
+        wanted < static_cast<long long>(sms) * GPU_BLOCKS_PER_SM
+            ? wanted
+            : static_cast<long long>(sms) * GPU_BLOCKS_PER_SM);
+    uncoded_errors_kernel<<<blocks, GPU_THREADS>>>(bits_per_sym, sigma, num_sym,
+                                                   chunk_shift, splitmix64(seed),
+                                                   d_errors);
+    ok = gpuGetLastError() == gpuSuccess;
+  }
+  ok = ok && gpuMemcpy(&host, d_errors, sizeof(host), gpuMemcpyDeviceToHost) == gpuSuccess;
+  gpuFree(d_errors);
+  if (ok)
+    *errors = static_cast<long long>(host);
+  return ok;
+}
@@ -0,0 +1,331 @@
+// Multi-node BER sweep driver (MPI)
+//
+// Simulates the same grid as run_amc.py and writes the same CSV, but spreads
+// the work over MPI ranks:
+//
+// - Uncoded points: every (mod, SNR, run) point is a ber_accum_t whose
+//   65536-symbol chunks are split into one contiguous range per rank. Chunk c
+//   draws from its own counter-based substream chunk_seed(seed, c), so the
+//   ranges never overlap and their error counts, summed with MPI_Reduce,
+//   equal the single-node compute_ber_seeded run bit for bit.
+// - Coded points: a coded run is one terminated Viterbi block and cannot be
+//   cut, so whole (mod, SNR) points are dealt round-robin to the ranks.
+//
+// Run seeds, run averaging, the zero-BER floor and the number formatting all
+// follow run_amc.py, so for the same --seed the CSV is byte-identical to
+//   python3 run_amc.py --seed S --csv results.csv --no-plot ...
+//
+//   make ber_mpi && mpirun -np 4 ./ber_mpi --seed 7 --bits 50000000 --csv out.csv
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ber.h"
+
+using namespace std;
+
+namespace {
+
+struct Options {
+  vector<int> mods = {2, 4, 16};
+  double snr_start = 0.0, snr_stop = 20.0, snr_step = 1.0;
+  long long bits = 500000;
+  int runs = 2;
+  unsigned long long seed = 1;
+  bool coding = false, coded_only = false, quiet = false, gpu = false;
+  int code_rate = BER_RATE_1_2;
+  int threads = 0; // Per rank
+  int rng = BER_RNG_FAST;
+  string csv = "results_mpi.csv";
+};
+
+void usage() {
+  cout << "usage: ber_mpi [--mods 2,4,16] [--snr-start 0] [--snr-stop 20] [--snr-step 1]\n"
+          "               [--bits 500000] [--runs 2] [--seed 1] [--coding] [--coded-only]\n"
+          "               [--code-rate 1/2|2/3|3/4] [--threads 0]\n"
+          "               [--rng fast|std|philox] [--gpu] [--csv results_mpi.csv] [--quiet]\n";
+}
+
+// Returns an error message, or "" when the options are usable
+string parse_options(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    const string arg = argv[i];
+    auto value = [&]() -> string {
+      if (i + 1 >= argc)
+        throw string("missing value for " + arg);
+      return argv[++i];
+    };
+    try {
+      if (arg == "--mods") {
+        opt.mods.clear();
+        const string list = value();
+        for (size_t pos = 0; pos < list.size();) {
+          const size_t comma = std::min(list.find(',', pos), list.size());
+          if (comma > pos)
+            opt.mods.push_back(stoi(list.substr(pos, comma - pos)));
+          pos = comma + 1;
+        }
+      } else if (arg == "--snr-start") {
+        opt.snr_start = stod(value());
+      } else if (arg == "--snr-stop") {
+        opt.snr_stop = stod(value());
+      } else if (arg == "--snr-step") {
+        opt.snr_step = stod(value());
+      } else if (arg == "--bits") {
+        opt.bits = stoll(value());
+      } else if (arg == "--runs") {
+        opt.runs = stoi(value());
+      } else if (arg == "--seed") {
+        opt.seed = stoull(value());
+      } else if (arg == "--coding") {
+        opt.coding = true;
+      } else if (arg == "--coded-only") {
+        opt.coded_only = true;
+      } else if (arg == "--code-rate") {
+        const string r = value();
+        if (r == "1/2")
+          opt.code_rate = BER_RATE_1_2;
+        else if (r == "2/3")
+          opt.code_rate = BER_RATE_2_3;
+        else if (r == "3/4")
+          opt.code_rate = BER_RATE_3_4;
+        else
+          return "unknown code rate " + r + " (1/2, 2/3, 3/4)";
+      } else if (arg == "--threads") {
+        opt.threads = stoi(value());
+      } else if (arg == "--rng") {
+        const string r = value();
+        if (r != "fast" && r != "std" && r != "philox")
+          return "unknown RNG engine " + r + " (fast, std, philox)";
+        opt.rng = r == "std" ? BER_RNG_STD : r == "philox" ? BER_RNG_PHILOX : BER_RNG_FAST;
+      } else if (arg == "--gpu") {
+        opt.gpu = true;
+      } else if (arg == "--csv") {
+        opt.csv = value();
+      } else if (arg == "--quiet") {
+        opt.quiet = true;
+      } else if (arg == "--help" || arg == "-h") {
+        usage();
+        return "help";
+      } else {
+        return "unknown option " + arg;
+      }
+    } catch (const string &msg) {
+      return msg;
+    } catch (const std::exception &) {
+      return "bad value for " + arg;
+    }
+  }
+  for (int m : opt.mods)
+    if (m != 2 && m != 4 && m != 16 && m != 64 && m != 256)
+      return "Unsupported modulation order: " + to_string(m) +
+             ". Supported: 2, 4, 16, 64, 256";
+  if (opt.mods.empty())
+    return "no modulation orders given";
+  if (opt.bits <= 0)
+    return "Number of bits must be positive";
+  // Every uncoded run needs at least one whole symbol, or its BER is 0/0
+  for (int m : opt.mods)
+    if (opt.bits < countr_zero(static_cast<unsigned>(m)))
+      return "Number of bits must cover one symbol (" +
+             to_string(countr_zero(static_cast<unsigned>(m))) + " for mod " + to_string(m) + ")";
+  if (opt.runs <= 0)
+    return "Number of runs must be positive";
+  if (opt.snr_stop < opt.snr_start)
+    return "SNR stop must be >= SNR start";
+  if (opt.snr_step <= 0)
+    return "SNR step must be positive";
+  return "";
+}
+
+// np.arange(start, stop + 1e-9, step) exactly as NumPy fills it: the length
+// uses step, element 1 is start + step and element i >= 2 is
+// start + i * ((start + step) - start)
+vector<double> snr_grid(const Options &opt) {
+  const double stop = opt.snr_stop + 1e-9;
+  const long long n = static_cast<long long>(ceil((stop - opt.snr_start) / opt.snr_step));
+  const double second = opt.snr_start + opt.snr_step;
+  const double delta = second - opt.snr_start;
+  vector<double> snrs;
+  for (long long i = 0; i < n; ++i)
+    snrs.push_back(i == 0 ? opt.snr_start
+                   : i == 1 ? second
+                            : opt.snr_start + static_cast<double>(i) * delta);
+  return snrs;
+}
+
+// Python's repr(float): shortest round-trip digits, fixed notation for
+// decimal exponents in [-4, 16), otherwise d.ddde+XX
+string py_float(double x) {
+  if (x == 0.0)
+    return signbit(x) ? "-0.0" : "0.0";
+  char buf[64];
+  const auto res = to_chars(buf, buf + sizeof(buf), x, chars_format::scientific);
+  string s(buf, res.ptr);
+  string sign;
+  if (s[0] == '-') {
+    sign = "-";
+    s.erase(0, 1);
+  }
+  const size_t e_pos = s.find('e');
+  const int exp10 = stoi(s.substr(e_pos + 1));
+  string digits = s.substr(0, e_pos);
+  digits.erase(std::remove(digits.begin(), digits.end(), '.'), digits.end());
+  if (exp10 >= -4 && exp10 < 16) {
+    if (exp10 < 0)
+      return sign + "0." + string(static_cast<size_t>(-exp10 - 1), '0') + digits;
+    const size_t int_len = static_cast<size_t>(exp10) + 1;
+    if (digits.size() <= int_len)
+      return sign + digits + string(int_len - digits.size(), '0') + ".0";
+    return sign + digits.substr(0, int_len) + "." + digits.substr(int_len);
+  }
+  string out = sign + digits.substr(0, 1);
+  if (digits.size() > 1)
+    out += "." + digits.substr(1);
+  char exp_buf[16];
+  snprintf(exp_buf, sizeof(exp_buf), "e%c%02d", exp10 < 0 ? '-' : '+', std::abs(exp10));
+  return out + exp_buf;
+}
+
+// run_amc.py's write_csv layout (empty uncoded columns for --coded-only)
+bool write_csv(const string &path, const vector<double> &snrs, const Options &opt,
+               const vector<vector<double>> &uncoded, const vector<vector<double>> &coded) {
+  ofstream f(path, ios::binary | ios::trunc);
+  if (!f)
+    return false;
+  f << "SNR_dB";
+  for (int m : opt.mods)
+    f << ",BER_uncoded_mod" << m;
+  if (opt.coding)
+    for (int m : opt.mods)
+      f << ",BER_coded_mod" << m;
+  f << "\r\n";
+  for (size_t i = 0; i < snrs.size(); ++i) {
+    f << py_float(snrs[i]);
+    for (size_t k = 0; k < opt.mods.size(); ++k)
+      f << "," << (opt.coded_only ? "" : py_float(uncoded[k][i]));
+    if (opt.coding)
+      for (size_t k = 0; k < opt.mods.size(); ++k)
+        f << "," << py_float(coded[k][i]);
+    f << "\r\n";
+  }
+  return static_cast<bool>(f);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  MPI_Init(&argc, &argv);
+  int rank = 0, n_ranks = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &n_ranks);
+
+  Options opt;
+  const string err = parse_options(argc, argv, opt);
+  if (!err.empty()) {
+    if (rank == 0 && err != "help")
+      cerr << "Error: " << err << endl;
+    MPI_Finalize();
+    return err == "help" ? 0 : 2;
+  }
+  ber_set_rng_engine(opt.rng);
+  // Each rank drives its own device; counts equal the CPU's either way
+  if (opt.gpu && (opt.rng != BER_RNG_PHILOX || ber_set_backend(BER_BACKEND_GPU) != 0) &&
+      rank == 0)
+    cerr << "Warning: --gpu needs --rng philox and a GPU build with a device; "
+            "running on the CPU"
+         << endl;
+  const vector<double> snrs = snr_grid(opt);
+  const size_t n_mods = opt.mods.size(), n_snr = snrs.size();
+  const double t0 = MPI_Wtime();
+
+  // Uncoded: point (k, i, run) -> this rank's slice of its chunks
+  const size_t n_points = opt.coded_only ? 0 : n_mods * n_snr * static_cast<size_t>(opt.runs);
+  vector<long long> errors(n_points, 0), bits(n_points, 0);
+  for (size_t p = 0; p < n_points; ++p) {
+    const size_t k = p / (n_snr * opt.runs), i = p / opt.runs % n_snr, run = p % opt.runs;
+    const unsigned long long run_seed = opt.seed + 997ULL * run; // As simulate_ber
+    ber_accum_t whole;
+    vector<ber_accum_t> parts(static_cast<size_t>(n_ranks));
+    if (ber_accum_init(&whole, opt.mods[k], snrs[i], opt.bits, run_seed) != 0 ||
+        ber_accum_split(&whole, n_ranks, parts.data()) != 0) {
+      cerr << "Error: invalid point mod " << opt.mods[k] << " SNR " << snrs[i] << endl;
+      MPI_Abort(MPI_COMM_WORLD, 3);
+    }
+    ber_accum_t &mine = parts[static_cast<size_t>(rank)];
+    ber_accum_advance(&mine, mine.chunk_end - mine.next_chunk, opt.threads);
+    errors[p] = mine.errors;
+    bits[p] = mine.bits;
+  }
+  vector<long long> total_errors(n_points, 0), total_bits(n_points, 0);
+  if (n_points > 0) {
+    MPI_Reduce(errors.data(), total_errors.data(), static_cast<int>(n_points),
+               MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(bits.data(), total_bits.data(), static_cast<int>(n_points),
+               MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+  }
+
+  // Coded: whole (mod, SNR) points round-robin; every run uses seed 1 like
+  // run_amc.py, so one block per point stands for all runs. Ranks that do
+  // not own a point contribute 0, which leaves the owner's value exact.
+  const size_t n_coded = opt.coding ? n_mods * n_snr : 0;
+  vector<double> coded_ber(n_coded, 0.0), coded_total(n_coded, 0.0);
+  for (size_t q = static_cast<size_t>(rank); q < n_coded; q += static_cast<size_t>(n_ranks))
+    coded_ber[q] = compute_ber_coded_rate(opt.mods[q / n_snr], snrs[q % n_snr], opt.bits, 1,
+                                          opt.code_rate);
+  if (n_coded > 0)
+    MPI_Reduce(coded_ber.data(), coded_total.data(), static_cast<int>(n_coded), MPI_DOUBLE,
+               MPI_SUM, 0, MPI_COMM_WORLD);
+  const double elapsed = MPI_Wtime() - t0;
+
+  int status = 0;
+  if (rank == 0) {
+    // Run averages and the zero-BER floor exactly as run_amc.py computes them
+    const double floor_ber = 0.5 / static_cast<double>(opt.bits);
+    vector<vector<double>> uncoded(n_mods, vector<double>(n_snr, 0.0));
+    vector<vector<double>> coded(n_mods, vector<double>(n_snr, 0.0));
+    for (size_t k = 0; k < n_mods; ++k)
+      for (size_t i = 0; i < n_snr; ++i) {
+        if (!opt.coded_only) {
+          double total = 0.0;
+          for (int run = 0; run < opt.runs; ++run) {
+            const size_t p = (k * n_snr + i) * static_cast<size_t>(opt.runs) + run;
+            total += static_cast<double>(total_errors[p]) / static_cast<double>(total_bits[p]);
+          }
+          const double ber = total / opt.runs;
+          uncoded[k][i] = ber == 0.0 ? floor_ber : ber;
+        }
+        if (opt.coding) {
+          const double one = coded_total[k * n_snr + i];
+          double ber = one;
+          if (one >= 0.0) {
+            double total = 0.0;
+            for (int run = 0; run < opt.runs; ++run)
+              total += one;
+            ber = total / opt.runs;
+          }
+          coded[k][i] = ber == 0.0 ? floor_ber : ber;
+        }
+      }
+    if (!write_csv(opt.csv, snrs, opt, uncoded, coded)) {
+      cerr << "Error writing CSV file: " << opt.csv << endl;
+      status = 3;
+    } else if (!opt.quiet) {
+      cout << "Wrote CSV: " << opt.csv << " (" << n_ranks << " ranks, " << elapsed << " s)"
+           << endl;
+    }
+  }
+  MPI_Finalize();
+  return status;
+}
@@ -0,0 +1,267 @@
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "awgn.h"
+#include "ber.h"
+#include "cache.h"
+
+using namespace std;
+
+// =============================================================================
+// FILE LAYOUT
+// =============================================================================
+//
+// [CacheHeader][CacheRecord x capacity]. count records are valid; the file
+// grows in whole blocks so appends rarely remap. A record is written before
+// count is advanced, and appends hold an flock, so concurrent processes and
+// crashes never expose a half-written record.
+
+namespace {
+
+constexpr char CACHE_MAGIC[8] = {'B', 'E', 'R', 'C', 'A', 'C', 'H', '1'};
+constexpr uint64_t GROW_RECORDS = 4096;
+
+struct CacheHeader {
+  char magic[8];
+  uint32_t record_size;
+  uint32_t reserved0;
+  atomic<uint64_t> count;
+  uint64_t reserved[5];
+};
+static_assert(sizeof(CacheHeader) == 64, "cache header layout changed");
+
+uint64_t record_check(const CacheRecord &r) noexcept {
+  uint64_t words[sizeof(CacheRecord) / 8 - 1];
+  memcpy(words, &r, sizeof(words));
+  uint64_t h = 0x243F6A8885A308D3ULL;
+  for (uint64_t w : words)
+    h = splitmix64(h ^ w);
+  return h;
+}
+
+class ResultCache {
+public:
+  ~ResultCache() { close(); }
+
+  bool open(const char *path) {
+    close();
+    fd_ = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0)
+      return false;
+    flock(fd_, LOCK_EX);
+    struct stat st;
+    bool ok = fstat(fd_, &st) == 0;
+    if (ok && st.st_size == 0) {
+      CacheHeader h{};
+      memcpy(h.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+      h.record_size = sizeof(CacheRecord);
+      ok = pwrite(fd_, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h)) &&
+           grow_file(GROW_RECORDS);
+    }
+    ok = ok && map() && memcmp(header()->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+         header()->record_size == sizeof(CacheRecord);
+    if (ok)
+      index_new();
+    flock(fd_, LOCK_UN);
+    if (!ok)
+      close();
+    return ok;
+  }
+
+  void close() {
+    if (base_)
+      munmap(base_, mapped_);
+    if (fd_ >= 0)
+      ::close(fd_);
+    base_ = nullptr;
+    mapped_ = 0;
+    fd_ = -1;
+    indexed_ = 0;
+    by_stream_.clear();
+  }
+
+  bool active() const noexcept { return base_ != nullptr; }
+  uint64_t records() const noexcept { return indexed_; }
+
+  const CacheRecord *find_exact(uint64_t key, long long num_bits) const {
+    const auto it = by_stream_.find(key);
+    if (it == by_stream_.end())
+      return nullptr;
+    for (auto r = it->second.rbegin(); r != it->second.rend(); ++r)
+      if (record(*r).num_bits == num_bits)
+        return &record(*r);
+    return nullptr;
+  }
+
+  const CacheRecord *find_prefix(uint64_t key, long long max_sym) const {
+    const auto it = by_stream_.find(key);
+    if (it == by_stream_.end())
+      return nullptr;
+    const CacheRecord *best = nullptr;
+    for (uint64_t i : it->second) {
+      const CacheRecord &r = record(i);
+      if (r.prefix_sym > 0 && r.prefix_sym <= max_sym &&
+          (!best || r.prefix_sym >= best->prefix_sym))
+        best = &r;
+    }
+    return best;
+  }
+
+  void append(CacheRecord r) {
+    r.check = record_check(r);
+    flock(fd_, LOCK_EX);
+    // Pick up records (and growth) from other processes first
+    struct stat st;
+    const uint64_t count = header()->count.load(memory_order_acquire);
+    if (fstat(fd_, &st) == 0 && static_cast<size_t>(st.st_size) > mapped_)
+      map();
+    const bool room = count < capacity() || (grow_file(capacity() + GROW_RECORDS) && map());
+    if (base_ && room) {
+      index_new();
+      memcpy(&record_slot(count), &r, sizeof(r));
+      header()->count.store(count + 1, memory_order_release);
+      index_new();
+    }
+    flock(fd_, LOCK_UN);
+  }
+
+private:
+  CacheHeader *header() const noexcept { return static_cast<CacheHeader *>(base_); }
+  CacheRecord &record_slot(uint64_t i) const noexcept {
+    return reinterpret_cast<CacheRecord *>(static_cast<char *>(base_) + sizeof(CacheHeader))[i];
+  }
+  const CacheRecord &record(uint64_t i) const noexcept { return record_slot(i); }
+  uint64_t capacity() const noexcept {
+    return (mapped_ - sizeof(CacheHeader)) / sizeof(CacheRecord);
+  }
+
+  bool grow_file(uint64_t records) {
+    return ftruncate(fd_, static_cast<off_t>(sizeof(CacheHeader) +
+                                             records * sizeof(CacheRecord))) == 0;
+  }
+
+  bool map() {
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CacheHeader))
+      return false;
+    if (base_)
+      munmap(base_, mapped_);
+    mapped_ = static_cast<size_t>(st.st_size);
+    base_ = mmap(nullptr, mapped_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base_ == MAP_FAILED) {
+      base_ = nullptr;
+      mapped_ = 0;
+      return false;
+    }
+    return true;
+  }
+
+  // Index records [indexed_, count), skipping any that fail their check
+  void index_new() {
+    const uint64_t count = std::min(header()->count.load(memory_order_acquire), capacity());
+    for (; indexed_ < count; ++indexed_) {
+      const CacheRecord &r = record(indexed_);
+      if (r.check == record_check(r))
+        by_stream_[r.stream_key].push_back(indexed_);
+    }
+  }
+
+  int fd_ = -1;
+  void *base_ = nullptr;
+  size_t mapped_ = 0;
+  uint64_t indexed_ = 0;
+  unordered_map<uint64_t, vector<uint64_t>> by_stream_;
+};
+
+// Process-wide cache; lookups copy records out under the lock because an
+// append may remap the file
+mutex g_cache_lock;
+ResultCache g_cache;
+atomic<bool> g_cache_active{false};
+atomic<long long> g_hits{0}, g_extended{0}, g_misses{0};
+
+} // namespace
+
+uint64_t cache_stream_key(int mod_order, double snr_db, uint64_t seed,
+                          int code_rate, uint32_t tag) noexcept {
+  uint64_t snr_bits;
+  memcpy(&snr_bits, &snr_db, sizeof(snr_bits));
+  uint64_t h = splitmix64(static_cast<uint64_t>(CACHE_KERNEL_VERSION) << 32 | tag);
+  h = splitmix64(h ^ static_cast<uint64_t>(static_cast<uint32_t>(mod_order)));
+  h = splitmix64(h ^ static_cast<uint64_t>(static_cast<uint32_t>(code_rate)));
+  h = splitmix64(h ^ snr_bits);
+  return splitmix64(h ^ seed);
+}
+
+bool cache_active() noexcept { return g_cache_active.load(memory_order_acquire); }
+
+std::optional<CacheRecord> cache_find_exact(uint64_t stream_key, long long num_bits) {
+  lock_guard<mutex> g(g_cache_lock);
+  const CacheRecord *r = g_cache.active() ? g_cache.find_exact(stream_key, num_bits) : nullptr;
+  return r ? std::optional<CacheRecord>(*r) : std::nullopt;
+}
+
+std::optional<CacheRecord> cache_find_prefix(uint64_t stream_key, long long max_sym) {
+  lock_guard<mutex> g(g_cache_lock);
+  const CacheRecord *r = g_cache.active() ? g_cache.find_prefix(stream_key, max_sym) : nullptr;
+  return r ? std::optional<CacheRecord>(*r) : std::nullopt;
+}
+
+void cache_append(CacheRecord record) {
+  lock_guard<mutex> g(g_cache_lock);
+  if (g_cache.active())
+    g_cache.append(record);
+}
+
+void cache_note(CacheOutcome outcome) noexcept {
+  switch (outcome) {
+  case CacheOutcome::Hit: g_hits.fetch_add(1, memory_order_relaxed); break;
+  case CacheOutcome::Extended: g_extended.fetch_add(1, memory_order_relaxed); break;
+  case CacheOutcome::Miss: g_misses.fetch_add(1, memory_order_relaxed); break;
+  }
+}
+
+// =============================================================================
+// C API
+// =============================================================================
+
+extern "C" int ber_cache_open(const char *path) {
+  if (!path || !*path)
+    return -1;
+  lock_guard<mutex> g(g_cache_lock);
+  const bool ok = g_cache.open(path);
+  g_cache_active.store(ok, memory_order_release);
+  return ok ? 0 : -1;
+}
+
+extern "C" void ber_cache_close(void) {
+  lock_guard<mutex> g(g_cache_lock);
+  g_cache.close();
+  g_cache_active.store(false, memory_order_release);
+}
+
+extern "C" int ber_cache_stats(ber_cache_stats_t *out) {
+  if (!out)
+    return -1;
+  lock_guard<mutex> g(g_cache_lock);
+  out->hits = g_hits.load(memory_order_relaxed);
+  out->extended = g_extended.load(memory_order_relaxed);
+  out->misses = g_misses.load(memory_order_relaxed);
+  out->records = static_cast<long long>(g_cache.records());
+  return 0;
+}
+
+extern "C" void ber_cache_reset_stats(void) {
+  g_hits.store(0, memory_order_relaxed);
+  g_extended.store(0, memory_order_relaxed);
+  g_misses.store(0, memory_order_relaxed);
+}
@@ -0,0 +1,62 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <cstdint>
+#include <optional>
+
+// =============================================================================
+// PERSISTENT RESULT CACHE
+// =============================================================================
+//
+// An append-only file of fixed-size records, memory-mapped and opened with
+// ber_cache_open. Each record stores the error and bit counts of one seeded
+// run under a 64-bit stream key: a hash of everything that fixes the random
+// streams (mod, SNR, seed, code rate, RNG engine, LLR mode for coded runs)
+// plus CACHE_KERNEL_VERSION. Records are never rewritten; a later result for
+// the same stream is simply appended, and lookups prefer the newest one.
+//
+// Uncoded records also keep the errors of their whole-chunk prefix. Chunk c
+// always draws the same stream, so a later run of the same stream with more
+// bits starts from that prefix instead of from zero.
+
+// Bump whenever a change alters any seeded result, so stale records (and
+// ber_accum_save checkpoints) of older builds stop matching
+constexpr uint32_t CACHE_KERNEL_VERSION = 2;
+
+struct CacheRecord {
+  uint64_t stream_key;
+  uint64_t seed;
+  double snr_db;
+  int32_t mod_order;
+  int32_t code_rate;      // BER_BATCH_UNCODED or BER_RATE_*
+  int64_t num_bits;       // Requested bits after symbol alignment
+  int64_t errors;
+  int64_t bits;           // Bits counted (decoded bits for coded runs)
+  int64_t prefix_sym;     // Whole-chunk prefix (uncoded; 0 for coded)
+  int64_t prefix_errors;  // Errors within that prefix
+  uint64_t check;         // Hash of the fields above (torn-write guard)
+};
+static_assert(sizeof(CacheRecord) == 80, "cache record layout changed");
+
+// Stream key of a run (num_bits excluded); tag folds in engine/mode/version
+uint64_t cache_stream_key(int mod_order, double snr_db, uint64_t seed,
+                          int code_rate, uint32_t tag) noexcept;
+
+// True while a cache file is open
+bool cache_active() noexcept;
+
+// Newest record of the stream with exactly num_bits
+std::optional<CacheRecord> cache_find_exact(uint64_t stream_key,
+                                            long long num_bits);
+
+// Record of the stream with the longest prefix_sym <= max_sym (> 0)
+std::optional<CacheRecord> cache_find_prefix(uint64_t stream_key,
+                                             long long max_sym);
+
+// Append a record (check is filled in); no-op without an open cache
+void cache_append(CacheRecord record);
+
+enum class CacheOutcome { Hit, Extended, Miss };
+void cache_note(CacheOutcome outcome) noexcept;
+
+#endif // CACHE_H
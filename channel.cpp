@@ -0,0 +1,203 @@
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#include "awgn.h"
+#include "ber.h"
+#include "channel.h"
+
+using namespace std;
+
+namespace {
+
+constexpr double TWO_PI = 6.283185307179586;
+constexpr double PI = 3.141592653589793;
+// Separates the channel stream from the payload/noise chunk streams
+constexpr uint64_t CHANNEL_SALT = 0x6368616E6E656C31ULL; // "channel1"
+
+bool valid_channel(const ber_channel_t &c) noexcept {
+  if (!(c.k_factor >= 0.0 && c.k_factor <= 1e6))
+    return false;
+  switch (c.model) {
+  case BER_CHANNEL_AWGN: return true;
+  case BER_CHANNEL_BLOCK: return c.block_symbols >= 1;
+  case BER_CHANNEL_JAKES: return c.doppler > 0.0 && c.doppler <= 0.5;
+  default: return false;
+  }
+}
+
+mutex g_channel_lock;
+ber_channel_t g_channel{BER_CHANNEL_AWGN, 0.0, 1, 0.0};
+
+} // namespace
+
+std::optional<FadingChannel> FadingChannel::make(const ber_channel_t &config,
+                                                 uint64_t seed) {
+  if (config.model != BER_CHANNEL_BLOCK && config.model != BER_CHANNEL_JAKES)
+    return std::nullopt;
+  FadingChannel ch;
+  ch.model_ = config.model;
+  ch.key_ = splitmix64(seed ^ CHANNEL_SALT);
+  Xoshiro256pp gen(ch.key_);
+  auto uniform = [&gen] { return static_cast<double>(gen() >> 11) * 0x1.0p-53; };
+
+  const double k = config.k_factor;
+  const double los = sqrt(k / (k + 1.0));
+  const double los_phase = TWO_PI * uniform();
+  ch.los_re_ = los * cos(los_phase);
+  ch.los_im_ = los * sin(los_phase);
+  ch.scatter_amp_ = sqrt(1.0 / (k + 1.0));
+  if (config.model == BER_CHANNEL_BLOCK) {
+    ch.block_ = static_cast<uint64_t>(config.block_symbols);
+    return ch;
+  }
+
+  // Zheng-Xiao: X_c = sqrt(2/M) sum cos(w_d t cos a_n + phi_n), X_s likewise
+  // with sin a_n, and scatter = (X_c + j X_s) / sqrt(2) x sqrt(1 / (K + 1))
+  ch.scatter_amp_ /= sqrt(static_cast<double>(JAKES_PATHS));
+  const double w_d = TWO_PI * config.doppler;
+  const double theta = TWO_PI * uniform() - PI;
+  for (int n = 1; n <= JAKES_PATHS; ++n) {
+    const double alpha = (TWO_PI * n - PI + theta) / (4.0 * JAKES_PATHS);
+    ch.omega_[n - 1] = w_d * cos(alpha);
+    ch.omega_[JAKES_PATHS + n - 1] = w_d * sin(alpha);
+  }
+  for (int p = 0; p < JAKES_PHASORS; ++p) {
+    ch.phase_[p] = TWO_PI * uniform() - PI;
+    ch.step_re_[p] = cos(ch.omega_[p] * JAKES_LANES);
+    ch.step_im_[p] = sin(ch.omega_[p] * JAKES_LANES);
+  }
+  return ch;
+}
+
+ber_channel_t current_channel() noexcept {
+  lock_guard<mutex> g(g_channel_lock);
+  return g_channel;
+}
+
+// =============================================================================
+// C API
+// =============================================================================
+
+extern "C" int ber_set_channel(const ber_channel_t *channel) {
+  const ber_channel_t c = channel ? *channel : ber_channel_t{BER_CHANNEL_AWGN, 0.0, 1, 0.0};
+  if (!valid_channel(c))
+    return -1;
+  lock_guard<mutex> g(g_channel_lock);
+  g_channel = c;
+  return 0;
+}
+
+extern "C" int ber_get_channel(ber_channel_t *out) {
+  if (!out)
+    return -1;
+  *out = current_channel();
+  return 0;
+}
+
+// =============================================================================
+// GENERATOR TEST
+// =============================================================================
+//
+// Long-run averages of one seeded realization: mean power (2^20 symbols,
+// 1000-symbol blocks or fd = 0.01 Jakes, so ~1000 independent looks, hence
+// the 10% margin), the LOS share of a Rician channel, and the normalized
+// Jakes autocorrelation at a few lags against J0 (0.1 absolute: M = 8 paths
+// and one realization). The rotation recurrence must track direct cosines.
+
+extern "C" int run_channel_test(char *err_msg) {
+  constexpr size_t N = 1 << 20;
+  vector<double> h_re(N), h_im(N);
+  auto collect = [&](const FadingChannel &ch) {
+    for (size_t done = 0; done < N; done += 4096)
+      ch.for_each_coefficient(done, 4096, [&](size_t i, double re, double im) {
+        h_re[done + i] = re;
+        h_im[done + i] = im;
+      });
+  };
+  auto mean_power = [&] {
+    double p = 0.0;
+    for (size_t i = 0; i < N; ++i)
+      p += h_re[i] * h_re[i] + h_im[i] * h_im[i];
+    return p / N;
+  };
+
+  const ber_channel_t configs[] = {{BER_CHANNEL_BLOCK, 0.0, 1000, 0.0},
+                                   {BER_CHANNEL_BLOCK, 0.0, 1000, 4.0},
+                                   {BER_CHANNEL_JAKES, 0.01, 1, 0.0},
+                                   {BER_CHANNEL_JAKES, 0.01, 1, 4.0}};
+  for (const ber_channel_t &cfg : configs) {
+    const auto ch = FadingChannel::make(cfg, 0xFADEULL);
+    collect(*ch);
+    const double power = mean_power();
+    if (fabs(power - 1.0) > 0.1) {
+      snprintf(err_msg, 256, "Channel %d (K=%.0f): mean power %.3f, expected 1", cfg.model,
+               cfg.k_factor, power);
+      return 1;
+    }
+    if (cfg.k_factor > 0.0) {
+      double m_re = 0.0, m_im = 0.0;
+      for (size_t i = 0; i < N; ++i) {
+        m_re += h_re[i];
+        m_im += h_im[i];
+      }
+      const double los_power = (m_re * m_re + m_im * m_im) / (double(N) * N);
+      const double want = cfg.k_factor / (cfg.k_factor + 1.0);
+      if (fabs(los_power - want) > 0.1) {
+        snprintf(err_msg, 256, "Channel %d: LOS power %.3f, expected %.3f", cfg.model,
+                 los_power, want);
+        return 1;
+      }
+    }
+  }
+
+  const ber_channel_t jakes{BER_CHANNEL_JAKES, 0.01, 1, 0.0};
+  const auto ch = FadingChannel::make(jakes, 0xFADEULL);
+  collect(*ch);
+  const double power = mean_power();
+  for (int lag : {10, 25, 40, 60}) {
+    double r = 0.0;
+    for (size_t i = 0; i + lag < N; ++i)
+      r += h_re[i] * h_re[i + lag] + h_im[i] * h_im[i + lag];
+    r /= static_cast<double>(N - lag) * power;
+    const double want = cyl_bessel_j(0.0, TWO_PI * jakes.doppler * lag);
+    if (fabs(r - want) > 0.1) {
+      snprintf(err_msg, 256, "Jakes autocorrelation at lag %d: %.3f, J0 gives %.3f", lag,
+               r, want);
+      return 1;
+    }
+  }
+  // Deep into a long run, across a whole tile of recurrence steps
+  const uint64_t t0 = 1000003ULL;
+  double worst = 0.0;
+  ch->for_each_coefficient(t0, 4096, [&](size_t i, double re, double im) {
+    double want_re, want_im;
+    ch->jakes_scatter(t0 + i, want_re, want_im);
+    worst = std::max({worst, fabs(re - want_re), fabs(im - want_im)});
+  });
+  if (worst > 1e-9) {
+    snprintf(err_msg, 256, "Jakes recurrence drifts %.2e from direct evaluation", worst);
+    return 1;
+  }
+
+  double noise[8] = {0.3, -1.2, 2.0, 0.5, -0.7, -0.1, 1.1, 0.9};
+  double want[8];
+  ch->for_each_coefficient(77, 4, [&](size_t i, double re, double im) {
+    const double den = re * re + im * im;
+    want[2 * i] = (noise[2 * i] * re + noise[2 * i + 1] * im) / den;
+    want[2 * i + 1] = (noise[2 * i + 1] * re - noise[2 * i] * im) / den;
+  });
+  ch->equalize_noise(77, noise, 4);
+  for (int i = 0; i < 8; ++i)
+    if (fabs(noise[i] - want[i]) > 1e-12 * (1.0 + fabs(want[i]))) {
+      snprintf(err_msg, 256, "Equalized noise %d: %.6f, n / h gives %.6f", i, noise[i],
+               want[i]);
+      return 1;
+    }
+
+  snprintf(err_msg, 256, "Block/Jakes fading: unit power, LOS share, J0 autocorrelation, "
+                         "recurrence error %.1e",
+           worst);
+  return 0;
+}
@@ -0,0 +1,166 @@
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "awgn.h"
+#include "ber.h"
+
+// =============================================================================
+// FADING CHANNELS
+// =============================================================================
+//
+// A flat fading channel multiplies symbol t by h(t), then AWGN is added.
+// h(t) = los + scatter(t): los = sqrt(K / (K + 1)) e^(j theta0) and scatter
+// has power 1 / (K + 1), so E|h|^2 = 1 and the configured SNR is the average.
+//   BER_CHANNEL_BLOCK  scatter is CN(0, 1 / (K + 1)), drawn afresh for every
+//                      block of block_symbols symbols
+//   BER_CHANNEL_JAKES  scatter is the Zheng-Xiao sum of sinusoids: M paths per
+//                      quadrature with arrival angles
+//                      alpha_n = (2 pi n - pi + theta) / (4 M), so its
+//                      autocorrelation follows J0(2 pi fd tau)
+// h(t) depends only on the run seed and the absolute symbol time t, so every
+// chunk, tile and thread sees the same channel.
+//
+// The receiver equalizes coherently with the true h: r / h = s + n / h. The
+// simulation applies that in the noise step, replacing each unit noise pair
+// n by n / h (equalize_noise) before the usual scaling by sigma, so the
+// modulate/demodulate kernels and the SNR sweep reuse run unchanged.
+
+// Jakes paths per quadrature
+constexpr int JAKES_PATHS = 8;
+constexpr int JAKES_PHASORS = 2 * JAKES_PATHS;
+// Consecutive symbols generated together (one phasor set per lane)
+constexpr int JAKES_LANES = 8;
+
+class FadingChannel {
+public:
+  // nullopt for BER_CHANNEL_AWGN (the caller keeps the plain noise path)
+  static std::optional<FadingChannel> make(const ber_channel_t &config,
+                                           uint64_t seed);
+
+  // fn(i, h_re, h_im) for the coefficients of symbols t0 .. t0 + n - 1
+  template <typename Fn>
+  void for_each_coefficient(uint64_t t0, size_t n, Fn &&fn) const {
+    if (model_ == BER_CHANNEL_BLOCK)
+      block_coefficients(t0, n, fn);
+    else
+      jakes_coefficients(t0, n, fn);
+  }
+
+  // Replace the unit noise pairs of symbols t0 .. t0 + n - 1 by n / h(t)
+  void equalize_noise(uint64_t t0, double *noise, size_t n) const {
+    for_each_coefficient(t0, n, [noise](size_t i, double h_re, double h_im) {
+      const double inv = 1.0 / std::max(h_re * h_re + h_im * h_im, DBL_MIN);
+      const double a = h_re * inv, b = -h_im * inv; // conj(h) / |h|^2
+      const double n_re = noise[2 * i], n_im = noise[2 * i + 1];
+      noise[2 * i] = n_re * a - n_im * b;
+      noise[2 * i + 1] = n_re * b + n_im * a;
+    });
+  }
+
+  // Scatter coefficient of block b (BER_CHANNEL_BLOCK), before LOS is added
+  void block_scatter(uint64_t b, double &re, double &im) const noexcept {
+    const uint64_t u = splitmix64(key_ ^ b);
+    const uint64_t v = splitmix64(u);
+    constexpr double TWO_PI = 6.283185307179586;
+    const double u1 = (static_cast<double>(u >> 11) + 0.5) * 0x1.0p-53;
+    const double u2 = static_cast<double>(v >> 11) * 0x1.0p-53;
+    // Box-Muller radius sqrt(-2 ln u1), times 1 / sqrt(2) per component
+    const double radius = scatter_amp_ * std::sqrt(-std::log(u1));
+    re = radius * std::cos(TWO_PI * u2);
+    im = radius * std::sin(TWO_PI * u2);
+  }
+
+  // Jakes scatter at time t evaluated directly (reference for the recurrence)
+  void jakes_scatter(uint64_t t, double &re, double &im) const noexcept {
+    double c = 0.0, s = 0.0;
+    for (int p = 0; p < JAKES_PATHS; ++p)
+      c += std::cos(omega_[p] * static_cast<double>(t) + phase_[p]);
+    for (int p = JAKES_PATHS; p < JAKES_PHASORS; ++p)
+      s += std::cos(omega_[p] * static_cast<double>(t) + phase_[p]);
+    re = scatter_amp_ * c;
+    im = scatter_amp_ * s;
+  }
+
+  double los_re() const noexcept { return los_re_; }
+  double los_im() const noexcept { return los_im_; }
+
+private:
+  FadingChannel() = default;
+
+  template <typename Fn>
+  void block_coefficients(uint64_t t0, size_t n, Fn &fn) const {
+    for (size_t i = 0; i < n;) {
+      const uint64_t t = t0 + i;
+      const uint64_t b = t / block_;
+      const size_t run = static_cast<size_t>(std::min<uint64_t>(n - i, (b + 1) * block_ - t));
+      double re, im;
+      block_scatter(b, re, im);
+      re += los_re_;
+      im += los_im_;
+      for (const size_t end = i + run; i < end; ++i)
+        fn(i, re, im);
+    }
+  }
+
+  // Every phasor e^(j (omega t + phase)) is evaluated exactly for the first
+  // JAKES_LANES symbols of the call, then advanced JAKES_LANES symbols at a
+  // time by a fixed rotation; the (phasor, lane) updates are independent, so
+  // the loops vectorize.
+  template <typename Fn>
+  void jakes_coefficients(uint64_t t0, size_t n, Fn &fn) const {
+    constexpr int K = JAKES_PHASORS * JAKES_LANES;
+    alignas(64) double p_re[K], p_im[K], r_re[K], r_im[K];
+    for (int p = 0; p < JAKES_PHASORS; ++p)
+      for (int j = 0; j < JAKES_LANES; ++j) {
+        const double angle = omega_[p] * static_cast<double>(t0 + j) + phase_[p];
+        p_re[p * JAKES_LANES + j] = std::cos(angle);
+        p_im[p * JAKES_LANES + j] = std::sin(angle);
+        r_re[p * JAKES_LANES + j] = step_re_[p];
+        r_im[p * JAKES_LANES + j] = step_im_[p];
+      }
+    for (size_t base = 0; base < n; base += JAKES_LANES) {
+      alignas(64) double h_re[JAKES_LANES] = {}, h_im[JAKES_LANES] = {};
+      for (int p = 0; p < JAKES_PATHS; ++p)
+        for (int j = 0; j < JAKES_LANES; ++j)
+          h_re[j] += p_re[p * JAKES_LANES + j];
+      for (int p = JAKES_PATHS; p < JAKES_PHASORS; ++p)
+        for (int j = 0; j < JAKES_LANES; ++j)
+          h_im[j] += p_re[p * JAKES_LANES + j];
+      const size_t lanes = std::min<size_t>(JAKES_LANES, n - base);
+      for (size_t j = 0; j < lanes; ++j)
+        fn(base + j, los_re_ + scatter_amp_ * h_re[j], los_im_ + scatter_amp_ * h_im[j]);
+      for (int k = 0; k < K; ++k) {
+        const double re = p_re[k] * r_re[k] - p_im[k] * r_im[k];
+        p_im[k] = p_re[k] * r_im[k] + p_im[k] * r_re[k];
+        p_re[k] = re;
+      }
+    }
+  }
+
+  int model_ = BER_CHANNEL_AWGN;
+  uint64_t key_ = 0;
+  uint64_t block_ = 1;
+  double los_re_ = 0.0, los_im_ = 0.0;
+  double scatter_amp_ = 1.0;
+  double omega_[JAKES_PHASORS] = {};
+  double phase_[JAKES_PHASORS] = {};
+  double step_re_[JAKES_PHASORS] = {}; // e^(j omega JAKES_LANES)
+  double step_im_[JAKES_PHASORS] = {};
+};
+
+// Currently selected channel (process-wide, read once per simulation call)
+ber_channel_t current_channel() noexcept;
+
+// FadingChannel of the current channel for a run, nullopt for AWGN
+inline std::optional<FadingChannel> current_fading(uint64_t seed) {
+  return FadingChannel::make(current_channel(), seed);
+}
+
+#endif // CHANNEL_H
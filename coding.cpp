@@ -1,6 +1,21 @@
+#include <algorithm>
 #include <array>
-#include <vector>
 #include <cstdint>  // For uint8_t
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "awgn.h"
+#include "coding.h"
+#include "modem.h"
+#include "stats.h"
+#include "trellis.h"
 
 using namespace std;
 
@@ -8,76 +23,27 @@ using namespace std;
 // CONVOLUTIONAL CODING (K=7, Rate 1/2)
 // =============================================================================
 
-// Generator polynomials for K=7, rate 1/2 convolutional code (industry standard)
-constexpr uint8_t G1 = 0b1011011; // 133 octal - Generator polynomial 1
-constexpr uint8_t G2 = 0b1111001; // 171 octal - Generator polynomial 2
-constexpr int CONSTRAINT_LENGTH = 7;
-constexpr int NUM_STATES = 1 << (CONSTRAINT_LENGTH - 1); // 2^6 = 64 states
+// The (133, 171) code and its trellis come from trellis.h, where every table
+// is built at compile time (no lazy init, so the coder is thread-safe).
+using Code = ConvCodeK7;
+constexpr int CONSTRAINT_LENGTH = Code::constraint_length;
+constexpr int NUM_STATES = Code::num_states; // 2^6 = 64 states
 constexpr int CODE_RATE_NUM = 1;   // Numerator of code rate
 constexpr int CODE_RATE_DEN = 2;   // Denominator of code rate
 
-// Precomputed state transition tables for Viterbi decoder
-struct ConvState {
-    uint8_t next_state[2];    // Next state for input 0 and 1
-    uint8_t output[2];        // Output bits for input 0 and 1
-    uint8_t prev_state[2];    // Previous states that lead to this state
-    uint8_t prev_input[2];    // Input bits from previous states
-};
+// State transition table (next_state/output/prev_state/prev_input)
+constexpr const auto& state_table = Code::trellis;
 
-// Global state transition table (computed at startup)
-static array<ConvState, NUM_STATES> state_table;
-static bool state_table_initialized = false;
+// Catches generator or trellis construction mistakes at compile time
+static_assert(ConvCodeK5::free_distance == 7, "K=5 (23,35) free distance");
+static_assert(ConvCodeK7::free_distance == 10, "K=7 (133,171) free distance");
+static_assert(ConvCodeK9::free_distance == 12, "K=9 (561,753) free distance");
 
 // Helper functions
-constexpr uint8_t convolve(uint8_t data, uint8_t gen) {
-    return __builtin_popcount(data & gen) & 1;
-}
-
 constexpr uint8_t hamming_distance(uint8_t a, uint8_t b) {
     return __builtin_popcount(a ^ b);
 }
 
-// Initialize state transition table
-void init_conv_state_table() {
-    if (state_table_initialized) return;
-    
-    for (int state = 0; state < NUM_STATES; state++) {
-        for (int input = 0; input < 2; input++) {
-            // Shift register: [input, state_bits]
-            uint8_t shift_reg = (input << (CONSTRAINT_LENGTH - 1)) | state;
-            
-            // Compute outputs
-            uint8_t out1 = convolve(shift_reg, G1);
-            uint8_t out2 = convolve(shift_reg, G2);
-            uint8_t output = (out1 << 1) | out2;
-            
-            // Next state (shift right, remove oldest bit)
-            uint8_t next_state = shift_reg >> 1;
-            
-            state_table[state].next_state[input] = next_state;
-            state_table[state].output[input] = output;
-        }
-    }
-    
-    // Compute reverse transitions (for Viterbi decoder)
-    for (int state = 0; state < NUM_STATES; state++) {
-        int count = 0;
-        for (int prev_state = 0; prev_state < NUM_STATES; prev_state++) {
-            for (int input = 0; input < 2; input++) {
-                if (state_table[prev_state].next_state[input] == state) {
-                    state_table[state].prev_state[count] = prev_state;
-                    state_table[state].prev_input[count] = input;
-                    count++;
-                    if (count >= 2) break;
-                }
-            }
-            if (count >= 2) break;
-        }
-    }
-    
-    state_table_initialized = true;
-}
-
 // =============================================================================
 // CONVOLUTIONAL ENCODER
 // =============================================================================
@@ -86,52 +52,491 @@ extern "C" int convolutional_encode(const bool* info_bits, int info_len,
                                    bool* coded_bits, int* coded_len) {
     if (!info_bits || !coded_bits || !coded_len || info_len <= 0) return -1;
     
-    init_conv_state_table();
-    
-    // Add tail bits to terminate trellis (K-1 zeros)
+    // Tail bits (K-1 zeros) terminate the trellis in the zero state
     int total_info_bits = info_len + (CONSTRAINT_LENGTH - 1);
     *coded_len = total_info_bits * CODE_RATE_DEN;
-    
-    uint8_t state = 0; // Start in zero state
-    int coded_idx = 0;
-    
-    // Encode information bits
-    for (int i = 0; i < info_len; i++) {
-        int input = info_bits[i] ? 1 : 0;
-        uint8_t output = state_table[state].output[input];
-        
-        // Output 2 bits (rate 1/2)
-        coded_bits[coded_idx++] = (output >> 1) & 1;
-        coded_bits[coded_idx++] = output & 1;
-        
-        state = state_table[state].next_state[input];
+    BER_STAGE_TIMER(BER_STAGE_ENCODE, *coded_len);
+    conv_encode<Code>(info_bits, info_len, coded_bits);
+    return 0; // Success
+}
+
+void convolutional_encode_packed(const uint64_t* info_words, long long info_len,
+                                 uint64_t* coded_words) {
+    BER_STAGE_TIMER(BER_STAGE_ENCODE, (info_len + CONSTRAINT_LENGTH - 1) / 4);
+    conv_encode_packed<Code>(info_words, info_len, coded_words);
+}
+
+void convolutional_encode_packed_segment(const uint64_t* info_words, long long info_len,
+                                         unsigned& state, bool terminate,
+                                         uint64_t* coded_words) {
+    BER_STAGE_TIMER(BER_STAGE_ENCODE,
+                    (info_len + (terminate ? CONSTRAINT_LENGTH - 1 : 0)) / 4);
+    conv_encode_packed_from<Code>(info_words, info_len, state, terminate, coded_words);
+}
+
+// =============================================================================
+// PUNCTURING
+// =============================================================================
+
+long long punctured_length(const PuncturePattern& pattern, long long coded_len) {
+    long long kept = coded_len / pattern.period * pattern.kept;
+    for (int i = 0; i < coded_len % pattern.period; i++) kept += pattern.keep[i];
+    return kept;
+}
+
+void puncture_packed(const PuncturePattern& pattern, const uint64_t* coded_words,
+                     long long coded_len, uint64_t* out_words) {
+    BER_STAGE_TIMER(BER_STAGE_ENCODE, punctured_length(pattern, coded_len) / 8);
+    uint64_t word = 0;
+    long long out = 0;
+    int phase = 0;
+    for (long long i = 0; i < coded_len; i++) {
+        if (pattern.keep[phase]) {
+            word |= ((coded_words[i >> 6] >> (i & 63)) & 1) << (out & 63);
+            if ((++out & 63) == 0) {
+                out_words[(out - 1) >> 6] = word;
+                word = 0;
+            }
+        }
+        if (++phase == pattern.period) phase = 0;
     }
-    
-    // Add tail bits (force to zero state)
-    for (int i = 0; i < CONSTRAINT_LENGTH - 1; i++) {
-        int input = 0; // Tail bits are always 0
-        uint8_t output = state_table[state].output[input];
-        
-        coded_bits[coded_idx++] = (output >> 1) & 1;
-        coded_bits[coded_idx++] = output & 1;
-        
-        state = state_table[state].next_state[input];
+    if (out & 63) out_words[out >> 6] = word;
+}
+
+long long depuncture_llr(const PuncturePattern& pattern, const double* llr,
+                         long long n, long long& pos, long long end, double* out) {
+    long long written = 0;
+    int phase = static_cast<int>(pos % pattern.period);
+    auto advance = [&](double value) {
+        out[written++] = value;
+        ++pos;
+        if (++phase == pattern.period) phase = 0;
+    };
+    for (long long i = 0; i < n; i++) {
+        while (!pattern.keep[phase]) advance(0.0);
+        advance(llr[i]);
     }
-    
-    return 0; // Success
+    while (pos < end && !pattern.keep[phase]) advance(0.0);
+    return written;
 }
 
 // =============================================================================
 // VITERBI DECODER
 // =============================================================================
+//
+// Trellis structure: next state j = (input << 5) | (prev >> 1), so the two
+// predecessors of j are 2k and 2k+1 with k = j & 31, and the input bit is
+// j >> 5. Butterfly k therefore reads metrics 2k, 2k+1 and writes states k
+// (input 0) and k+32 (input 1).
+//
+// Each stage keeps two rolling 64-entry metric buffers and one 64-bit
+// decision word (bit j set = state j survived from its odd predecessor), so
+// survivor memory is 8 bytes per stage. Add-compare-select runs across the
+// butterflies in AVX-512 / AVX2 double lanes or a scalar loop, chosen by the
+// same run-time ISA level as the modem kernels.
+//
+// Every variant performs exactly the arithmetic of the reference decoder:
+// branch metric = (+/-llr0) + (+/-llr1), candidate = metric + branch, and the
+// odd predecessor wins only if strictly greater. Decoded bits are therefore
+// identical. Metrics are renormalized (best metric subtracted) only once they
+// exceed RENORM_THRESHOLD, far beyond what real LLR streams reach.
+
+namespace {
+
+constexpr int BUTTERFLIES = NUM_STATES / 2;
+constexpr double RENORM_THRESHOLD = VITERBI_RENORM_THRESHOLD;
+constexpr int RENORM_INTERVAL = VITERBI_RENORM_INTERVAL; // Stages between threshold checks
+
+// Per-butterfly branch labels. Index [p][u][k] describes the transition from
+// predecessor 2k+p with input u.
+struct AcsTables {
+    uint8_t out[2][2][BUTTERFLIES];        // Coded output pair (bit1 = first)
+    alignas(64) double sign0[2][2][BUTTERFLIES]; // +0.0 adds llr0, -0.0 subtracts
+    alignas(64) double sign1[2][2][BUTTERFLIES]; // Same for llr1
+
+    constexpr AcsTables() : out{}, sign0{}, sign1{} {
+        for (int p = 0; p < 2; p++) {
+            for (int u = 0; u < 2; u++) {
+                for (int k = 0; k < BUTTERFLIES; k++) {
+                    const uint8_t output = state_table[2 * k + p].output[u];
+                    out[p][u][k] = output;
+                    sign0[p][u][k] = (output & 2) ? 0.0 : -0.0;
+                    sign1[p][u][k] = (output & 1) ? 0.0 : -0.0;
+                }
+            }
+        }
+    }
+};
+
+constexpr AcsTables acs_table_data;
+
+const AcsTables& acs_tables() { return acs_table_data; }
+
+void renormalize_metrics(double* metrics) { viterbi_renormalize<Code>(metrics); }
+
+// Forward pass over num_stages stages. metrics holds the 64 starting metrics
+// on entry and the final ones on exit; decisions receives one word per stage.
+void viterbi_forward_scalar(const double* llr, long long num_stages,
+                            double* metrics, uint64_t* decisions) {
+    viterbi_forward_unrolled<Code>(llr, num_stages, metrics, decisions);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// 4 butterflies per step: deinterleave metrics 2k..2k+7 into even/odd lanes
+__attribute__((target("avx2")))
+void viterbi_forward_avx2(const double* llr, long long num_stages,
+                          double* metrics, uint64_t* decisions) {
+    const AcsTables& t = acs_tables();
+    alignas(32) double buf[2][NUM_STATES];
+    copy(metrics, metrics + NUM_STATES, buf[0]);
+    for (long long stage = 0; stage < num_stages; stage++) {
+        const __m256d llr0 = _mm256_set1_pd(llr[2 * stage]);
+        const __m256d llr1 = _mm256_set1_pd(llr[2 * stage + 1]);
+        const double* cur = buf[stage & 1];
+        double* nxt = buf[(stage & 1) ^ 1];
+        uint64_t word = 0;
+        for (int k = 0; k < BUTTERFLIES; k += 4) {
+            const __m256d lo = _mm256_load_pd(cur + 2 * k);
+            const __m256d hi = _mm256_load_pd(cur + 2 * k + 4);
+            const __m256d even = _mm256_permute4x64_pd(_mm256_unpacklo_pd(lo, hi), 0xD8);
+            const __m256d odd = _mm256_permute4x64_pd(_mm256_unpackhi_pd(lo, hi), 0xD8);
+            for (int u = 0; u < 2; u++) {
+                const __m256d bm_even = _mm256_add_pd(
+                    _mm256_xor_pd(llr0, _mm256_load_pd(&t.sign0[0][u][k])),
+                    _mm256_xor_pd(llr1, _mm256_load_pd(&t.sign1[0][u][k])));
+                const __m256d bm_odd = _mm256_add_pd(
+                    _mm256_xor_pd(llr0, _mm256_load_pd(&t.sign0[1][u][k])),
+                    _mm256_xor_pd(llr1, _mm256_load_pd(&t.sign1[1][u][k])));
+                const __m256d from_even = _mm256_add_pd(even, bm_even);
+                const __m256d from_odd = _mm256_add_pd(odd, bm_odd);
+                const __m256d take_odd = _mm256_cmp_pd(from_odd, from_even, _CMP_GT_OQ);
+                _mm256_store_pd(nxt + k + u * BUTTERFLIES,
+                                _mm256_blendv_pd(from_even, from_odd, take_odd));
+                word |= static_cast<uint64_t>(_mm256_movemask_pd(take_odd))
+                        << (k + u * BUTTERFLIES);
+            }
+        }
+        decisions[stage] = word;
+        if (stage % RENORM_INTERVAL == RENORM_INTERVAL - 1) renormalize_metrics(nxt);
+    }
+    copy(buf[num_stages & 1], buf[num_stages & 1] + NUM_STATES, metrics);
+}
+
+// 8 butterflies per step; selections come straight out of the k-mask
+__attribute__((target("avx512f")))
+void viterbi_forward_avx512(const double* llr, long long num_stages,
+                            double* metrics, uint64_t* decisions) {
+    const AcsTables& t = acs_tables();
+    alignas(64) double buf[2][NUM_STATES];
+    copy(metrics, metrics + NUM_STATES, buf[0]);
+    const __m512i even_idx = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+    const __m512i odd_idx = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+    for (long long stage = 0; stage < num_stages; stage++) {
+        const __m512i llr0 = _mm512_castpd_si512(_mm512_set1_pd(llr[2 * stage]));
+        const __m512i llr1 = _mm512_castpd_si512(_mm512_set1_pd(llr[2 * stage + 1]));
+        const double* cur = buf[stage & 1];
+        double* nxt = buf[(stage & 1) ^ 1];
+        uint64_t word = 0;
+        for (int k = 0; k < BUTTERFLIES; k += 8) {
+            const __m512d lo = _mm512_load_pd(cur + 2 * k);
+            const __m512d hi = _mm512_load_pd(cur + 2 * k + 8);
+            const __m512d even = _mm512_permutex2var_pd(lo, even_idx, hi);
+            const __m512d odd = _mm512_permutex2var_pd(lo, odd_idx, hi);
+            for (int u = 0; u < 2; u++) {
+                // Sign flips as integer XOR (AVX512F has no double XOR)
+                const __m512d bm_even = _mm512_add_pd(
+                    _mm512_castsi512_pd(_mm512_xor_si512(llr0, _mm512_load_si512(&t.sign0[0][u][k]))),
+                    _mm512_castsi512_pd(_mm512_xor_si512(llr1, _mm512_load_si512(&t.sign1[0][u][k]))));
+                const __m512d bm_odd = _mm512_add_pd(
+                    _mm512_castsi512_pd(_mm512_xor_si512(llr0, _mm512_load_si512(&t.sign0[1][u][k]))),
+                    _mm512_castsi512_pd(_mm512_xor_si512(llr1, _mm512_load_si512(&t.sign1[1][u][k]))));
+                const __m512d from_even = _mm512_add_pd(even, bm_even);
+                const __m512d from_odd = _mm512_add_pd(odd, bm_odd);
+                const __mmask8 take_odd = _mm512_cmp_pd_mask(from_odd, from_even, _CMP_GT_OQ);
+                _mm512_store_pd(nxt + k + u * BUTTERFLIES,
+                                _mm512_mask_blend_pd(take_odd, from_even, from_odd));
+                word |= static_cast<uint64_t>(take_odd) << (k + u * BUTTERFLIES);
+            }
+        }
+        decisions[stage] = word;
+        if (stage % RENORM_INTERVAL == RENORM_INTERVAL - 1) renormalize_metrics(nxt);
+    }
+    copy(buf[num_stages & 1], buf[num_stages & 1] + NUM_STATES, metrics);
+}
+
+#endif
+
+void viterbi_forward(int level, const double* llr, long long num_stages,
+                     double* metrics, uint64_t* decisions) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (level == SIMD_LEVEL_AVX512) {
+        viterbi_forward_avx512(llr, num_stages, metrics, decisions);
+        return;
+    }
+    if (level == SIMD_LEVEL_AVX2) {
+        viterbi_forward_avx2(llr, num_stages, metrics, decisions);
+        return;
+    }
+#endif
+    (void)level; // NEON and scalar levels share the scalar ACS loop
+    viterbi_forward_scalar(llr, num_stages, metrics, decisions);
+}
+
+// Decode with an explicit ACS variant (terminated trellis, traceback from 0)
+int viterbi_decode_level(int level, const double* received_llr, int received_len,
+                         bool* decoded_bits, int* decoded_len) {
+    if (!received_llr || !decoded_bits || !decoded_len || received_len <= 0) return -1;
+    if (received_len % 2 != 0) return -2; // Must be even (rate 1/2)
+
+    int num_stages = received_len / 2;
+    int info_len = num_stages - (CONSTRAINT_LENGTH - 1); // Remove tail bits
+    if (info_len <= 0) return -3;
+
+    *decoded_len = info_len;
+
+    // Start in the zero state; -inf marks states not yet reachable
+    array<double, NUM_STATES> metrics;
+    metrics.fill(-numeric_limits<double>::infinity());
+    metrics[0] = 0.0;
+    BER_STATS_ALLOC(8 * num_stages);
+    vector<uint64_t> decisions(num_stages);
+    viterbi_forward(level, received_llr, num_stages, metrics.data(), decisions.data());
+
+    // Traceback from zero state; the input bit of state j is j >> 5
+    unsigned state = 0;
+    for (int stage = num_stages; stage > 0; stage--) {
+        if (stage <= info_len) {
+            decoded_bits[stage - 1] = (state >> (CONSTRAINT_LENGTH - 2)) & 1;
+        }
+        const unsigned from_odd = (decisions[stage - 1] >> state) & 1;
+        state = ((state & (BUTTERFLIES - 1)) << 1) | from_odd;
+    }
+
+    return 0; // Success
+}
+
+} // namespace
 
 extern "C" int viterbi_decode(const double* received_llr, int received_len,
                              bool* decoded_bits, int* decoded_len) {
+    BER_STAGE_TIMER(BER_STAGE_DECODE, received_len > 0 ? 4 * received_len : 0);
+    return viterbi_decode_level(current_simd_level(), received_llr, received_len,
+                                decoded_bits, decoded_len);
+}
+
+// =============================================================================
+// INCREMENTAL BLOCK DECODER
+// =============================================================================
+//
+// Pieces are cut at RENORM_INTERVAL boundaries of the block, and the
+// threshold check that viterbi_forward makes at the end of each interval is
+// repeated here for pieces that started mid-interval. The arithmetic is thus
+// that of one viterbi_decode call over the whole block, whatever the piece
+// sizes. (The check is idempotent, so repeating it is harmless.)
+
+ViterbiBlockDecoder::ViterbiBlockDecoder() { reset(); }
+
+void ViterbiBlockDecoder::reset(long long capacity_stages) {
+    metrics_.fill(-numeric_limits<double>::infinity());
+    metrics_[0] = 0.0;
+    stages_ = 0;
+    level_ = current_simd_level();
+    decisions_.clear();
+    if (capacity_stages > 0) {
+        if (static_cast<size_t>(capacity_stages) > decisions_.capacity())
+            BER_STATS_ALLOC(8 * capacity_stages);
+        decisions_.reserve(static_cast<size_t>(capacity_stages));
+    }
+}
+
+void ViterbiBlockDecoder::push(const double* llr, long long num_stages) {
+    BER_STAGE_TIMER(BER_STAGE_DECODE, 8 * num_stages); // Survivor words
+    const size_t needed = static_cast<size_t>(stages_ + num_stages);
+    if (needed > decisions_.capacity()) BER_STATS_ALLOC(8 * needed);
+    decisions_.resize(needed);
+    while (num_stages > 0) {
+        const long long piece =
+            min(num_stages, RENORM_INTERVAL - stages_ % RENORM_INTERVAL);
+        viterbi_forward(level_, llr, piece, metrics_.data(), &decisions_[stages_]);
+        stages_ += piece;
+        llr += 2 * piece;
+        num_stages -= piece;
+        if (stages_ % RENORM_INTERVAL == 0) renormalize_metrics(metrics_.data());
+    }
+}
+
+long long ViterbiBlockDecoder::finish_packed(uint64_t* info_words) {
+    const long long info_len = stages_ - (CONSTRAINT_LENGTH - 1);
+    if (info_len <= 0) return -3;
+    BER_STAGE_TIMER(BER_STAGE_DECODE, info_len / 8);
+    fill(info_words, info_words + words_for_bits(static_cast<size_t>(info_len)), 0);
+    unsigned state = 0;
+    for (long long stage = stages_; stage > 0; stage--) {
+        if (stage <= info_len) {
+            const uint64_t bit = (state >> (CONSTRAINT_LENGTH - 2)) & 1;
+            info_words[(stage - 1) >> 6] |= bit << ((stage - 1) & 63);
+        }
+        const unsigned from_odd = (decisions_[stage - 1] >> state) & 1;
+        state = ((state & (BUTTERFLIES - 1)) << 1) | from_odd;
+    }
+    return info_len;
+}
+
+// =============================================================================
+// STREAMING (SLIDING-WINDOW) VITERBI DECODER
+// =============================================================================
+//
+// Decisions live in a ring of 2 * traceback_depth stages. Whenever the ring
+// fills, one traceback from the currently best state walks back through all
+// of it: the newest traceback_depth stages only let the survivors merge, and
+// the oldest traceback_depth stages are emitted. Memory is O(traceback_depth)
+// for any stream length, latency is at most 2 * traceback_depth stages, and
+// each output bit costs two traceback steps. flush() finishes the block with
+// an exact traceback from the zero state (the encoder terminates the trellis).
+//
+// Metrics are checked against RENORM_THRESHOLD at fixed stage positions
+// (every RENORM_INTERVAL stages of the block), exactly as viterbi_decode does,
+// so the output does not depend on how the LLRs are split across push calls.
+
+struct viterbi_stream {
+    int depth;                          // Traceback depth D (stages)
+    int level;                          // ACS variant, fixed at init
+    vector<uint64_t> ring;              // Stage s decisions at ring[s % (2D)]
+    array<double, NUM_STATES> metrics;
+    long long stages;                   // Stages processed in this block
+    long long emitted;                  // Leading stages already output
+    double pending_llr;                 // First half of an incomplete pair
+    bool has_pending;
+};
+
+namespace {
+
+void stream_reset(viterbi_stream& st) {
+    st.metrics.fill(-numeric_limits<double>::infinity());
+    st.metrics[0] = 0.0; // Every block starts in the zero state
+    st.stages = 0;
+    st.emitted = 0;
+    st.has_pending = false;
+}
+
+// Trace back from `state` (after the last processed stage) to the first
+// unemitted stage, writing the bits of the oldest `count` stages to out
+void stream_traceback(const viterbi_stream& st, unsigned state, long long count,
+                      bool* out) {
+    const long long ring_size = static_cast<long long>(st.ring.size());
+    for (long long s = st.stages - 1; s >= st.emitted; s--) {
+        if (s < st.emitted + count) {
+            out[s - st.emitted] = (state >> (CONSTRAINT_LENGTH - 2)) & 1;
+        }
+        const unsigned from_odd = (st.ring[s % ring_size] >> state) & 1;
+        state = ((state & (BUTTERFLIES - 1)) << 1) | from_odd;
+    }
+}
+
+// ACS over n LLR pairs, emitting traceback_depth bits each time the ring fills
+void stream_advance(viterbi_stream& st, const double* llr, long long n,
+                    bool* out, int* out_len) {
+    const long long ring_size = static_cast<long long>(st.ring.size());
+    while (n > 0) {
+        const long long room = ring_size - (st.stages - st.emitted);
+        const long long to_wrap = ring_size - st.stages % ring_size;
+        const long long to_renorm = RENORM_INTERVAL - st.stages % RENORM_INTERVAL;
+        const long long piece = min({n, room, to_wrap, to_renorm});
+        viterbi_forward(st.level, llr, piece, st.metrics.data(),
+                        &st.ring[st.stages % ring_size]);
+        st.stages += piece;
+        llr += 2 * piece;
+        n -= piece;
+
+        if (st.stages % RENORM_INTERVAL == 0) renormalize_metrics(st.metrics.data());
+        if (st.stages - st.emitted == ring_size) {
+            const auto best = max_element(st.metrics.begin(), st.metrics.end());
+            stream_traceback(st, static_cast<unsigned>(best - st.metrics.begin()),
+                             st.depth, out + *out_len);
+            *out_len += st.depth;
+            st.emitted += st.depth;
+        }
+    }
+}
+
+} // namespace
+
+extern "C" viterbi_stream_t* viterbi_stream_init(int traceback_depth) {
+    if (traceback_depth == 0) traceback_depth = VITERBI_DEFAULT_TRACEBACK;
+    if (traceback_depth < CONSTRAINT_LENGTH - 1 || traceback_depth > VITERBI_MAX_TRACEBACK) {
+        return nullptr;
+    }
+    viterbi_stream* st = new (nothrow) viterbi_stream{};
+    if (!st) return nullptr;
+    st->depth = traceback_depth;
+    st->level = current_simd_level();
+    st->ring.assign(2 * static_cast<size_t>(traceback_depth), 0);
+    stream_reset(*st);
+    return st;
+}
+
+extern "C" int viterbi_stream_push(viterbi_stream_t* stream, const double* received_llr,
+                                   int received_len, bool* decoded_bits, int* decoded_len) {
+    if (!stream || !decoded_len || received_len < 0) return -1;
+    *decoded_len = 0;
+    if (received_len == 0) return 0;
+    if (!received_llr || !decoded_bits) return -1;
+    BER_STAGE_TIMER(BER_STAGE_DECODE, 4 * static_cast<uint64_t>(received_len));
+
+    if (stream->has_pending) {
+        const double pair[2] = {stream->pending_llr, received_llr[0]};
+        stream->has_pending = false;
+        stream_advance(*stream, pair, 1, decoded_bits, decoded_len);
+        received_llr++;
+        received_len--;
+    }
+    stream_advance(*stream, received_llr, received_len / 2, decoded_bits, decoded_len);
+    if (received_len % 2 != 0) {
+        stream->pending_llr = received_llr[received_len - 1];
+        stream->has_pending = true;
+    }
+    return 0;
+}
+
+extern "C" int viterbi_stream_flush(viterbi_stream_t* stream, bool* decoded_bits,
+                                    int* decoded_len) {
+    if (!stream || !decoded_bits || !decoded_len) return -1;
+    *decoded_len = 0;
+    const bool odd_length = stream->has_pending;
+    const long long tail = CONSTRAINT_LENGTH - 1;
+    if (odd_length || stream->stages <= tail) {
+        stream_reset(*stream);
+        return odd_length ? -2 : -3; // Same codes as viterbi_decode
+    }
+
+    // Terminated trellis: exact traceback from the zero state, minus tail bits
+    const long long count = stream->stages - tail - stream->emitted;
+    BER_STAGE_TIMER(BER_STAGE_DECODE, count);
+    stream_traceback(*stream, 0, count, decoded_bits);
+    *decoded_len = static_cast<int>(count);
+    stream_reset(*stream);
+    return 0;
+}
+
+extern "C" void viterbi_stream_free(viterbi_stream_t* stream) {
+    delete stream;
+}
+
+// =============================================================================
+// REFERENCE VITERBI DECODER
+// =============================================================================
+// The original full-matrix decoder (one heap row of metrics and history per
+// stage). Kept only as the oracle for run_viterbi_equivalence_test.
+
+namespace {
+
+
+int viterbi_decode_reference(const double* received_llr, int received_len,
+                             bool* decoded_bits, int* decoded_len) {
     if (!received_llr || !decoded_bits || !decoded_len || received_len <= 0) return -1;
     if (received_len % 2 != 0) return -2; // Must be even (rate 1/2)
     
-    init_conv_state_table();
-    
     int num_stages = received_len / 2;
     int info_len = num_stages - (CONSTRAINT_LENGTH - 1); // Remove tail bits
     if (info_len <= 0) return -3;
@@ -192,6 +597,8 @@ extern "C" int viterbi_decode(const double* received_llr, int received_len,
     return 0; // Success
 }
 
+} // namespace
+
 // =============================================================================
 // SOFT DECISION HELPER
 // =============================================================================
@@ -220,8 +627,6 @@ extern "C" double estimate_coding_gain_db() {
 // =============================================================================
 
 extern "C" int test_convolutional_coding() {
-    init_conv_state_table();
-    
     // Test with simple pattern
     const int test_len = 10;
     bool info_bits[test_len] = {1, 0, 1, 1, 0, 1, 0, 0, 1, 1};
@@ -253,4 +658,363 @@ extern "C" int test_convolutional_coding() {
     }
     
     return 0; // Success - perfect decode
-}
\ No newline at end of file
+}
+// Decode random LLR corpora with every supported ACS variant and require the
+// same bits as the reference decoder. Corpora: noisy codewords at several
+// SNRs, small-integer LLRs (dense metric ties), pure noise and wide-range
+// magnitudes, over lengths from 1 to 20000 info bits.
+extern "C" int run_viterbi_equivalence_test(char* err_msg) {
+    static const char* const names[] = {"scalar", "avx2", "avx512", "neon"};
+    const int lengths[] = {1, 2, 7, 31, 64, 100, 1023, 20000};
+    Xoshiro256pp gen(0xDECULL);
+    int corpora = 0;
+
+    for (int info_len : lengths) {
+        unique_ptr<bool[]> info(new bool[info_len]);
+        const int coded_len = 2 * (info_len + CONSTRAINT_LENGTH - 1);
+        unique_ptr<bool[]> coded(new bool[coded_len]);
+        vector<double> noise(coded_len), llr(coded_len);
+        unique_ptr<bool[]> ref(new bool[info_len]);
+        unique_ptr<bool[]> got(new bool[info_len]);
+
+        for (int kind = 0; kind < 6; kind++) {
+            for (int i = 0; i < info_len; i++) info[i] = gen() & 1;
+            int len = 0;
+            convolutional_encode(info.get(), info_len, coded.get(), &len);
+            fill_normal_ziggurat(gen, noise.data(), coded_len);
+            for (int i = 0; i < coded_len; i++) {
+                const double x = coded[i] ? 1.0 : -1.0;
+                switch (kind) {
+                case 0: llr[i] = 4.0 * (x + 0.4 * noise[i]); break;  // High SNR
+                case 1: llr[i] = 2.0 * (x + 0.9 * noise[i]); break;  // Near threshold
+                case 2: llr[i] = static_cast<double>(static_cast<int>(gen() % 5) - 2); break;
+                case 3: llr[i] = noise[i]; break;                    // No signal
+                case 4: llr[i] = (x + noise[i]) * 1e6; break;        // Wide range
+                default: llr[i] = x * static_cast<double>(gen() % 3); break; // Erasures
+                }
+            }
+            int ref_len = 0;
+            if (viterbi_decode_reference(llr.data(), coded_len, ref.get(), &ref_len) != 0) {
+                snprintf(err_msg, 256, "Reference decoder failed (len %d)", info_len);
+                return 1;
+            }
+            for (int level : {SIMD_LEVEL_SCALAR, SIMD_LEVEL_AVX2, SIMD_LEVEL_AVX512}) {
+                if (!simd_level_supported(level)) continue;
+                int got_len = 0;
+                if (viterbi_decode_level(level, llr.data(), coded_len, got.get(), &got_len) != 0 ||
+                    got_len != ref_len || !equal(ref.get(), ref.get() + ref_len, got.get())) {
+                    snprintf(err_msg, 256, "%s Viterbi differs from reference (len %d, corpus %d)",
+                             names[level], info_len, kind);
+                    return 1;
+                }
+            }
+            corpora++;
+        }
+    }
+    snprintf(err_msg, 256, "Viterbi matches reference on %d corpora (active: %s)",
+             corpora, names[current_simd_level()]);
+    return 0;
+}
+
+// Decode a whole LLR block through a stream, pushing pieces of random size
+// (max_piece <= 0 pushes everything at once). Returns false on any API error.
+static bool stream_decode_block(viterbi_stream_t* st, int depth, const vector<double>& llr,
+                                int max_piece, Xoshiro256pp& gen, vector<bool>& out) {
+    out.clear();
+    unique_ptr<bool[]> buf(new bool[llr.size() / 2 + 2 * depth + 2]);
+    size_t pos = 0;
+    while (pos < llr.size()) {
+        const size_t left = llr.size() - pos;
+        const size_t piece = max_piece <= 0 ? left : min<size_t>(left, 1 + gen() % max_piece);
+        int n = 0;
+        if (viterbi_stream_push(st, llr.data() + pos, static_cast<int>(piece),
+                                buf.get(), &n) != 0) {
+            return false;
+        }
+        out.insert(out.end(), buf.get(), buf.get() + n);
+        pos += piece;
+    }
+    int n = 0;
+    if (viterbi_stream_flush(st, buf.get(), &n) != 0) return false;
+    out.insert(out.end(), buf.get(), buf.get() + n);
+    return true;
+}
+
+// Streaming decoder checks: (1) with a window covering the block the output
+// equals viterbi_decode; (2) output is independent of push sizes, odd LLR
+// counts included; (3) a short window decodes clean blocks exactly and stays
+// within a few percent of full-block decoding near threshold.
+extern "C" int run_viterbi_stream_test(char* err_msg) {
+    Xoshiro256pp gen(0x57AEULL);
+    const int info_len = 100000;
+    const int coded_len = 2 * (info_len + CONSTRAINT_LENGTH - 1);
+    unique_ptr<bool[]> info(new bool[info_len]);
+    unique_ptr<bool[]> coded(new bool[coded_len]);
+    unique_ptr<bool[]> block(new bool[info_len]);
+    vector<double> noise(coded_len), llr(coded_len);
+    vector<bool> whole, split;
+
+    if (viterbi_stream_init(-1) || viterbi_stream_init(CONSTRAINT_LENGTH - 2)) {
+        snprintf(err_msg, 256, "viterbi_stream_init accepted an invalid depth");
+        return 1;
+    }
+
+    // Corpora: clean, moderate and heavy noise, then tie-heavy quantized LLRs
+    // (equal path metrics, so any extra renormalization rounding shows up)
+    for (int kind = 0; kind < 4; kind++) {
+        for (int i = 0; i < info_len; i++) info[i] = gen() & 1;
+        int len = 0;
+        convolutional_encode(info.get(), info_len, coded.get(), &len);
+        fill_normal_ziggurat(gen, noise.data(), coded_len);
+        const double noise_scale = kind == 0 ? 0.0 : kind == 1 ? 0.5 : 0.8;
+        for (int i = 0; i < coded_len; i++) {
+            llr[i] = kind == 3 ? 0.1 * (static_cast<int>(gen() % 5) - 2)
+                               : 2.0 * ((coded[i] ? 1.0 : -1.0) + noise_scale * noise[i]);
+        }
+        int block_len = 0;
+        viterbi_decode(llr.data(), coded_len, block.get(), &block_len);
+        long long block_errors = 0;
+        for (int i = 0; i < info_len; i++) block_errors += block[i] != info[i];
+
+        // (1) Window covers the block: a single exact traceback at flush
+        const int short_stages = 3000; // Crosses RENORM_INTERVAL twice
+        vector<double> head(llr.begin(), llr.begin() + 2 * short_stages);
+        unique_ptr<bool[]> head_ref(new bool[short_stages]);
+        int head_len = 0;
+        viterbi_decode(head.data(), 2 * short_stages, head_ref.get(), &head_len);
+        viterbi_stream_t* wide = viterbi_stream_init(2 * short_stages);
+        const bool wide_ok = wide && stream_decode_block(wide, 2 * short_stages, head, 37, gen, split);
+        viterbi_stream_free(wide);
+        if (!wide_ok || static_cast<int>(split.size()) != head_len ||
+            !equal(split.begin(), split.end(), head_ref.get())) {
+            snprintf(err_msg, 256, "Full-window stream differs from viterbi_decode (corpus %d)", kind);
+            return 1;
+        }
+
+        for (int depth : {CONSTRAINT_LENGTH - 1, 5 * CONSTRAINT_LENGTH, VITERBI_DEFAULT_TRACEBACK}) {
+            viterbi_stream_t* st = viterbi_stream_init(depth);
+            const bool ok = st && stream_decode_block(st, depth, llr, 0, gen, whole) &&
+                            stream_decode_block(st, depth, llr, 3 * depth, gen, split);
+            viterbi_stream_free(st);
+            // (2) Split invariance (the second run also checks reuse after flush)
+            if (!ok || whole.size() != static_cast<size_t>(info_len) || whole != split) {
+                snprintf(err_msg, 256, "Stream output depends on push sizes (depth %d, corpus %d)",
+                         depth, kind);
+                return 1;
+            }
+            if (depth < 5 * CONSTRAINT_LENGTH || kind == 3) continue; // No BER to track
+            // (3) Windowed decoding quality
+            long long errors = 0;
+            for (int i = 0; i < info_len; i++) errors += whole[i] != info[i];
+            if ((kind == 0 && errors != 0) ||
+                static_cast<double>(errors) > 1.05 * static_cast<double>(block_errors) + 10.0) {
+                snprintf(err_msg, 256, "Depth %d stream: %lld errors vs %lld full-block (corpus %d)",
+                         depth, errors, block_errors, kind);
+                return 1;
+            }
+        }
+    }
+
+    viterbi_stream_t* st = viterbi_stream_init(0);
+    const double odd[3] = {1.0, -1.0, 1.0};
+    bool out[2 * VITERBI_DEFAULT_TRACEBACK];
+    int n = 0;
+    const bool odd_ok = st && viterbi_stream_push(st, odd, 3, out, &n) == 0 &&
+                        viterbi_stream_flush(st, out, &n) == -2 &&
+                        viterbi_stream_flush(st, out, &n) == -3;
+    viterbi_stream_free(st);
+    if (!odd_ok) {
+        snprintf(err_msg, 256, "Stream flush error codes are wrong");
+        return 1;
+    }
+
+    snprintf(err_msg, 256, "Streaming Viterbi matches block decoding (default depth %d)",
+             VITERBI_DEFAULT_TRACEBACK);
+    return 0;
+}
+
+// Packed interfaces against the bool ones: convolutional_encode_packed (also
+// in segments) must emit the same coded bits, and ViterbiBlockDecoder fed in random pieces the
+// same decoded bits as viterbi_decode.
+extern "C" int run_packed_coding_test(char* err_msg) {
+    Xoshiro256pp gen(0xC0DEULL);
+    ViterbiBlockDecoder decoder;
+    for (int info_len : {1, 31, 32, 64, 1000, 5000, 40000}) {
+        const int coded_len = 2 * (info_len + CONSTRAINT_LENGTH - 1);
+        unique_ptr<bool[]> info(new bool[info_len]);
+        unique_ptr<bool[]> coded(new bool[coded_len]);
+        unique_ptr<bool[]> ref(new bool[info_len]);
+        vector<uint64_t> info_words(words_for_bits(info_len), 0);
+        vector<uint64_t> coded_words(words_for_bits(coded_len));
+        vector<uint64_t> decoded_words(words_for_bits(info_len));
+        for (int i = 0; i < info_len; i++) {
+            info[i] = gen() & 1;
+            info_words[i >> 6] |= static_cast<uint64_t>(info[i]) << (i & 63);
+        }
+        int len = 0;
+        convolutional_encode(info.get(), info_len, coded.get(), &len);
+        convolutional_encode_packed(info_words.data(), info_len, coded_words.data());
+        for (int i = 0; i < coded_len; i++) {
+            if (((coded_words[i >> 6] >> (i & 63)) & 1) != static_cast<uint64_t>(coded[i])) {
+                snprintf(err_msg, 256, "Packed encoder differs at bit %d (len %d)", i, info_len);
+                return 1;
+            }
+        }
+
+        // Segments of whole 64-bit words continue the register and concatenate
+        vector<uint64_t> seg_words(coded_words.size());
+        unsigned state = 0;
+        for (int first = 0; first < info_len;) {
+            const int n = min(info_len - first, 64 * static_cast<int>(1 + gen() % 40));
+            convolutional_encode_packed_segment(info_words.data() + first / 64, n, state,
+                                                first + n == info_len,
+                                                seg_words.data() + first / 32);
+            first += n;
+        }
+        if (seg_words != coded_words) {
+            snprintf(err_msg, 256, "Segmented encoder differs (len %d)", info_len);
+            return 1;
+        }
+
+        vector<double> llr(coded_len);
+        fill_normal_ziggurat(gen, llr.data(), coded_len);
+        for (int i = 0; i < coded_len; i++) llr[i] = 2.0 * ((coded[i] ? 1.0 : -1.0) + 0.9 * llr[i]);
+        int ref_len = 0;
+        viterbi_decode(llr.data(), coded_len, ref.get(), &ref_len);
+        decoder.reset(); // Reused across blocks
+        for (long long stage = 0; stage < coded_len / 2;) {
+            const long long piece = min<long long>(coded_len / 2 - stage, 1 + gen() % 1500);
+            decoder.push(llr.data() + 2 * stage, piece);
+            stage += piece;
+        }
+        if (decoder.finish_packed(decoded_words.data()) != ref_len) {
+            snprintf(err_msg, 256, "Block decoder length mismatch (len %d)", info_len);
+            return 1;
+        }
+        for (int i = 0; i < ref_len; i++) {
+            if (((decoded_words[i >> 6] >> (i & 63)) & 1) != static_cast<uint64_t>(ref[i])) {
+                snprintf(err_msg, 256, "Block decoder differs at bit %d (len %d)", i, info_len);
+                return 1;
+            }
+        }
+    }
+
+    // Puncture -> depuncture in pieces of whole periods restores the mother
+    // stream with zeros at punctured positions, and noiseless blocks decode
+    for (const PuncturePattern* p : {&PUNCTURE_2_3, &PUNCTURE_3_4}) {
+        for (int info_len : {1, 2, 3, 100, 4099}) {
+            const long long coded_len = 2LL * (info_len + CONSTRAINT_LENGTH - 1);
+            vector<uint64_t> info_words(words_for_bits(info_len), 0);
+            for (int i = 0; i < info_len; i++)
+                info_words[i >> 6] |= static_cast<uint64_t>(gen() & 1) << (i & 63);
+            vector<uint64_t> coded_words(words_for_bits(coded_len));
+            convolutional_encode_packed(info_words.data(), info_len, coded_words.data());
+            const long long tx_len = punctured_length(*p, coded_len);
+            vector<uint64_t> tx_words(words_for_bits(tx_len));
+            puncture_packed(*p, coded_words.data(), coded_len, tx_words.data());
+
+            vector<double> tx_llr(tx_len), mother(coded_len + p->period);
+            for (long long i = 0; i < tx_len; i++)
+                tx_llr[i] = ((tx_words[i >> 6] >> (i & 63)) & 1) ? 4.0 : -4.0;
+            long long pos = 0, written = 0;
+            for (long long first = 0; first < tx_len;) {
+                const long long piece = min<long long>(tx_len - first, p->kept * (1 + gen() % 50));
+                const long long n = depuncture_llr(*p, tx_llr.data() + first, piece, pos,
+                                                   coded_len, mother.data() + written);
+                if (n % 2 != 0) {
+                    snprintf(err_msg, 256, "Depunctured piece has odd length %lld", n);
+                    return 1;
+                }
+                written += n;
+                first += piece;
+            }
+            bool ok = written == coded_len && pos == coded_len;
+            for (long long i = 0; ok && i < coded_len; i++) {
+                const double bit = ((coded_words[i >> 6] >> (i & 63)) & 1) ? 4.0 : -4.0;
+                ok = mother[i] == (p->keep[i % p->period] ? bit : 0.0);
+            }
+            decoder.reset();
+            decoder.push(mother.data(), coded_len / 2);
+            vector<uint64_t> decoded(words_for_bits(info_len));
+            ok = ok && decoder.finish_packed(decoded.data()) == info_len && decoded == info_words;
+            if (!ok) {
+                snprintf(err_msg, 256, "Rate %d/%d puncturing round trip failed (len %d)",
+                         p->rate_num, p->rate_den, info_len);
+                return 1;
+            }
+        }
+    }
+    snprintf(err_msg, 256, "Packed encoder, puncturing and piecewise decoder match the bool API");
+    return 0;
+}
+
+// Generic templates on K=5/7/9: trellis self-consistency, noiseless round
+// trips, K=7 agreement with the C API, and BER improving with K on the same
+// BPSK channel (rate 1/2, Eb/N0 = 2 dB)
+extern "C" int run_trellis_test(char* err_msg) {
+    constexpr long long info_len = 200000;
+    constexpr double ebno = 1.5848931924611136; // 2 dB
+    const double sigma = sqrt(1.0 / (2.0 * 0.5 * ebno));
+    Xoshiro256pp gen(0x7E111ULL);
+    unique_ptr<bool[]> info(new bool[info_len]);
+    for (long long i = 0; i < info_len; i++) info[i] = gen() & 1;
+    vector<double> noise(2 * (info_len + 8));
+    fill_normal_ziggurat(gen, noise.data(), noise.size());
+
+    double ber[3] = {0.0, 0.0, 0.0};
+    auto check_code = [&]<class C>(C, int slot) {
+        for (int s = 0; s < C::num_states; s++) {
+            for (int p = 0; p < 2; p++) {
+                const auto& from = C::trellis[C::trellis[s].prev_state[p]];
+                if (from.next_state[C::trellis[s].prev_input[p]] != s) return 1;
+            }
+        }
+        const long long stages = info_len + C::tail_bits;
+        unique_ptr<bool[]> coded(new bool[2 * stages]);
+        unique_ptr<bool[]> decoded(new bool[info_len]);
+        vector<uint64_t> decisions(static_cast<size_t>(stages * C::decision_words));
+        vector<double> llr(2 * stages);
+        conv_encode<C>(info.get(), info_len, coded.get());
+
+        for (long long i = 0; i < 2 * stages; i++) llr[i] = coded[i] ? 10.0 : -10.0;
+        if (viterbi_decode_block<C>(llr.data(), stages, decisions.data(), decoded.get()) != info_len)
+            return 2;
+        for (long long i = 0; i < info_len; i++)
+            if (decoded[i] != info[i]) return 3;
+
+        for (long long i = 0; i < 2 * stages; i++)
+            llr[i] = 2.0 * ((coded[i] ? 1.0 : -1.0) + sigma * noise[i]) / (sigma * sigma);
+        viterbi_decode_block<C>(llr.data(), stages, decisions.data(), decoded.get());
+        long long errors = 0;
+        for (long long i = 0; i < info_len; i++) errors += decoded[i] != info[i];
+        ber[slot] = static_cast<double>(errors) / info_len;
+
+        if constexpr (C::constraint_length == CONSTRAINT_LENGTH) {
+            unique_ptr<bool[]> api_coded(new bool[2 * stages]);
+            unique_ptr<bool[]> api_decoded(new bool[info_len]);
+            int len = 0;
+            convolutional_encode(info.get(), static_cast<int>(info_len), api_coded.get(), &len);
+            if (!equal(api_coded.get(), api_coded.get() + len, coded.get())) return 4;
+            viterbi_decode(llr.data(), len, api_decoded.get(), &len);
+            if (!equal(api_decoded.get(), api_decoded.get() + len, decoded.get())) return 5;
+        }
+        return 0;
+    };
+    const char* const names[] = {"K=5", "K=7", "K=9"};
+    const int status[3] = {check_code(ConvCodeK5{}, 0), check_code(ConvCodeK7{}, 1),
+                           check_code(ConvCodeK9{}, 2)};
+    for (int c = 0; c < 3; c++) {
+        if (status[c] != 0) {
+            snprintf(err_msg, 256, "%s template coder check %d failed", names[c], status[c]);
+            return 1;
+        }
+    }
+    if (!(ber[0] > ber[1] && ber[1] > ber[2] && ber[2] > 0.0)) {
+        snprintf(err_msg, 256, "BER not improving with K at 2 dB: %.2e %.2e %.2e",
+                 ber[0], ber[1], ber[2]);
+        return 1;
+    }
+    snprintf(err_msg, 256, "K=5/7/9 templates consistent; BER @ 2 dB %.2e / %.2e / %.2e",
+             ber[0], ber[1], ber[2]);
+    return 0;
+}
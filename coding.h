@@ -27,8 +27,181 @@ int convolutional_encode(const bool* info_bits, int info_len,
 int viterbi_decode(const double* received_llr, int received_len,
                   bool* decoded_bits, int* decoded_len);
 
+/**
+ * Streaming Viterbi decoder with a bounded traceback window
+ *
+ * LLRs are pushed in arbitrary pieces (odd lengths allowed) and decoded bits
+ * come out incrementally, traceback_depth to 2*traceback_depth stages behind
+ * the input. Memory does not grow with the stream length. flush() ends the
+ * block: it assumes the encoder's tail bits terminated the trellis, emits the
+ * remaining bits without the tail and resets the stream for the next block.
+ */
+typedef struct viterbi_stream viterbi_stream_t;
+
+#define VITERBI_DEFAULT_TRACEBACK 64    /* ~9x K for K=7 */
+#define VITERBI_MAX_TRACEBACK (1 << 20)
+
+/**
+ * @param traceback_depth Window in stages (6..VITERBI_MAX_TRACEBACK),
+ *        0 selects VITERBI_DEFAULT_TRACEBACK
+ * @return New stream, or NULL for an invalid depth / allocation failure
+ */
+viterbi_stream_t* viterbi_stream_init(int traceback_depth);
+
+/**
+ * @param received_llr LLRs continuing the block (same convention as viterbi_decode)
+ * @param decoded_bits Output; must hold (received_len + 1) / 2 + traceback_depth bits
+ * @param decoded_len Number of bits written
+ * @return 0 on success, -1 on invalid arguments
+ */
+int viterbi_stream_push(viterbi_stream_t* stream, const double* received_llr,
+                        int received_len, bool* decoded_bits, int* decoded_len);
+
+/**
+ * @param decoded_bits Output; must hold 2 * traceback_depth bits
+ * @return 0 on success, -1 invalid arguments, -2 odd LLR count, -3 block
+ *         shorter than the tail (the stream is reset in every case)
+ */
+int viterbi_stream_flush(viterbi_stream_t* stream, bool* decoded_bits,
+                         int* decoded_len);
+
+void viterbi_stream_free(viterbi_stream_t* stream);
+
+/**
+ * Check the streaming decoder: exact agreement with viterbi_decode when the
+ * window covers the block, split-invariance of push, and windowed BER close
+ * to full-block decoding
+ * @return 0 on pass, 1 on failure (details in err_msg)
+ */
+int run_viterbi_stream_test(char* err_msg);
+
+/**
+ * Check the packed-word encoder and the incremental block decoder against
+ * convolutional_encode / viterbi_decode
+ * @return 0 on pass, 1 on failure (details in err_msg)
+ */
+int run_packed_coding_test(char* err_msg);
+
+/**
+ * Check the compile-time K=5/7/9 code templates (trellis.h): trellis
+ * consistency, round trips, K=7 agreement with convolutional_encode /
+ * viterbi_decode, and BER ordering on a noisy BPSK channel
+ * @return 0 on pass, 1 on failure (details in err_msg)
+ */
+int run_trellis_test(char* err_msg);
+
+/**
+ * Compare every supported Viterbi ACS variant against the reference
+ * full-matrix decoder on random LLR corpora (err_msg holds >= 256 chars)
+ * @return 0 when all decoded bits match, 1 otherwise
+ */
+int run_viterbi_equivalence_test(char* err_msg);
+
 #ifdef __cplusplus
 }
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// =============================================================================
+// PACKED-WORD INTERFACES (C++ only)
+// =============================================================================
+// Used by the fused coded-BER pipeline. Bits are stored 64 per uint64_t word,
+// LSB first, as in modem.h; coded bit 2i is the G1 output of info bit i and
+// 2i+1 the G2 output.
+
+/**
+ * Same code as convolutional_encode on packed bits, tail included
+ * @param info_words info_len packed bits
+ * @param coded_words Output; must hold 2 * (info_len + 6) bits
+ */
+void convolutional_encode_packed(const uint64_t* info_words, long long info_len,
+                                 uint64_t* coded_words);
+
+/**
+ * Encode one segment of a longer stream. state carries the encoder register
+ * between segments (0 before the first); terminate appends the tail, so the
+ * segments of a stream together equal convolutional_encode_packed
+ * @param coded_words Output; must hold 2 * info_len bits (+ 12 with terminate)
+ */
+void convolutional_encode_packed_segment(const uint64_t* info_words, long long info_len,
+                                         unsigned& state, bool terminate,
+                                         uint64_t* coded_words);
+
+// =============================================================================
+// PUNCTURING (C++ only)
+// =============================================================================
+// Periodic masks over the rate-1/2 output in transmission order (G1 then G2
+// of each stage), as used with the (133, 171) code in IEEE 802.11a:
+// 2/3 sends A1 B1 A2 of every two stages, 3/4 sends A1 B1 A2 B3 of three.
+// The receiver puts a zero LLR (no information) at every punctured position
+// and runs the unchanged rate-1/2 decoder.
+
+struct PuncturePattern {
+    int rate_num;               // Code rate after puncturing
+    int rate_den;
+    int period;                 // Mother-code bits per period (even)
+    int kept;                   // Bits transmitted per period
+    std::array<uint8_t, 6> keep; // 1 = transmitted
+};
+
+constexpr PuncturePattern PUNCTURE_NONE{1, 2, 2, 2, {1, 1}};
+constexpr PuncturePattern PUNCTURE_2_3{2, 3, 4, 3, {1, 1, 1, 0}};
+constexpr PuncturePattern PUNCTURE_3_4{3, 4, 6, 4, {1, 1, 1, 0, 0, 1}};
+
+// Number of transmitted bits among the first coded_len mother-code bits
+long long punctured_length(const PuncturePattern& pattern, long long coded_len);
+
+/**
+ * Drop the punctured positions of coded_len packed mother-code bits
+ * @param out_words Output; must hold punctured_length(pattern, coded_len) bits
+ */
+void puncture_packed(const PuncturePattern& pattern, const uint64_t* coded_words,
+                     long long coded_len, uint64_t* out_words);
+
+/**
+ * Expand the LLRs of n transmitted bits back to mother-code order with 0 at
+ * punctured positions. pos is the mother-code position of llr[0]; it is
+ * advanced past every position written, including the punctured ones right
+ * after the last transmitted bit (never beyond end). So pieces holding whole
+ * periods always expand to an even count, ready for the decoder.
+ * @param out Output; must hold n * period / kept + period values
+ * @return Number of LLRs written
+ */
+long long depuncture_llr(const PuncturePattern& pattern, const double* llr,
+                         long long n, long long& pos, long long end, double* out);
+
+/**
+ * Block Viterbi decoder fed in pieces of any size. Decodes exactly like
+ * viterbi_decode (terminated trellis, traceback from the zero state) but
+ * takes LLRs incrementally, so callers only hold one LLR tile at a time.
+ * Survivor memory is 8 bytes per stage and is reused across blocks.
+ */
+class ViterbiBlockDecoder {
+public:
+    ViterbiBlockDecoder();
+
+    // Start a new block; capacity_stages pre-sizes the survivor memory
+    void reset(long long capacity_stages = 0);
+
+    // Add num_stages stages (2 * num_stages LLRs, viterbi_decode convention)
+    void push(const double* llr, long long num_stages);
+
+    long long stages() const { return stages_; }
+
+    /**
+     * Trace back and write the info bits (stages - 6) packed into info_words
+     * @return Number of info bits, or -3 if the block is shorter than the tail
+     */
+    long long finish_packed(uint64_t* info_words);
+
+private:
+    std::vector<uint64_t> decisions_;
+    std::array<double, 64> metrics_;
+    long long stages_;
+    int level_;
+};
 #endif
 
 #endif // CODING_H
\ No newline at end of file
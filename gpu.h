@@ -0,0 +1,25 @@
+#ifndef GPU_H
+#define GPU_H
+
+#include <cstdint>
+
+// =============================================================================
+// OPTIONAL GPU BACKEND (ber_gpu.cu)
+// =============================================================================
+//
+// Built only with `make GPU=cuda` or `make GPU=hip`, which also defines
+// BER_GPU for the host sources. The device simulates the BER_RNG_PHILOX
+// uncoded stream one symbol per thread with philox_symbol_errors, so its error
+// counts are those of the CPU tile loop for the same seed (up to last-ulp
+// differences between the device and host log/sin/cos).
+
+// True if a usable device is present (checked once)
+bool gpu_backend_available() noexcept;
+
+// Bit errors of the first num_sym symbols of the Philox stream of `seed`:
+// symbol g sits in chunk g >> chunk_shift, keyed splitmix64(splitmix64(seed)
+// ^ chunk), as chunk_seed in ber.cpp. Returns false on any device error.
+bool gpu_uncoded_errors(int bits_per_sym, double sigma, long long num_sym,
+                        int chunk_shift, uint64_t seed, long long *errors) noexcept;
+
+#endif // GPU_H
@@ -0,0 +1,100 @@
+#include <algorithm>
+
+#include "job_sched.h"
+
+using namespace std;
+
+// =============================================================================
+// WORK-STEALING THREAD POOL
+// =============================================================================
+
+namespace {
+
+// Identifies the pool worker running on this thread (-1 outside any pool)
+thread_local const WorkStealingPool *tls_pool = nullptr;
+thread_local int tls_worker = -1;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(int threads) {
+  threads = std::max(1, threads);
+  for (int i = 0; i < threads; ++i)
+    queues_.push_back(std::make_unique<Queue>());
+  workers_.reserve(static_cast<size_t>(threads));
+  for (int i = 0; i < threads; ++i)
+    workers_.emplace_back([this, i] { worker_loop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    lock_guard<mutex> g(sleep_lock_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto &t : workers_)
+    t.join();
+}
+
+void WorkStealingPool::submit(Task task) {
+  const int target = tls_pool == this
+                         ? tls_worker
+                         : static_cast<int>(next_queue_.fetch_add(1) % queues_.size());
+  {
+    lock_guard<mutex> g(queues_[target]->lock);
+    queues_[target]->tasks.push_back(std::move(task));
+  }
+  {
+    // Counted under the sleep lock so a worker about to sleep sees it
+    lock_guard<mutex> g(sleep_lock_);
+    queued_.fetch_add(1);
+  }
+  wake_.notify_one();
+}
+
+bool WorkStealingPool::try_pop(int self, Task &task) {
+  {
+    Queue &own = *queues_[self];
+    lock_guard<mutex> g(own.lock);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      queued_.fetch_sub(1);
+      return true;
+    }
+  }
+  const int n = static_cast<int>(queues_.size());
+  for (int k = 1; k < n; ++k) {
+    Queue &victim = *queues_[(self + k) % n];
+    lock_guard<mutex> g(victim.lock);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      queued_.fetch_sub(1);
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingPool::worker_loop(int self) {
+  tls_pool = this;
+  tls_worker = self;
+  Task task;
+  for (;;) {
+    if (try_pop(self, task)) {
+      task();
+      task = nullptr; // Release captures before sleeping
+      continue;
+    }
+    unique_lock<mutex> g(sleep_lock_);
+    wake_.wait(g, [&] { return stopping_ || queued_.load() > 0; });
+    if (stopping_)
+      return;
+  }
+}
+
+WorkStealingPool &ber_thread_pool() {
+  static WorkStealingPool *pool = new WorkStealingPool(
+      static_cast<int>(std::max(1u, thread::hardware_concurrency())));
+  return *pool;
+}
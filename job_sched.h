@@ -0,0 +1,63 @@
+#ifndef JOB_SCHED_H
+#define JOB_SCHED_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// =============================================================================
+// WORK-STEALING THREAD POOL
+// =============================================================================
+//
+// One deque per worker. A worker pushes and pops its own tasks at the back
+// (LIFO, so a task's follow-up runs while its data is still in cache) and,
+// when it runs dry, steals from the front of the other deques (FIFO, the
+// oldest and usually largest pieces of work). Tasks submitted from outside
+// the pool are spread round-robin over the deques. Idle workers sleep on a
+// condition variable until a task is queued.
+//
+// The pool is persistent: threads are created once and reused by every
+// submission, unlike parallel_for_items, which spawns a team per call.
+
+class WorkStealingPool {
+public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingPool(int threads);
+  ~WorkStealingPool();
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  // Queue a task (on the calling worker's own deque when called from a task)
+  void submit(Task task);
+
+  int size() const noexcept { return static_cast<int>(workers_.size()); }
+
+private:
+  struct Queue {
+    std::mutex lock;
+    std::deque<Task> tasks;
+  };
+
+  bool try_pop(int self, Task &task);
+  void worker_loop(int self);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::mutex sleep_lock_;
+  std::condition_variable wake_;
+  std::atomic<long long> queued_{0};
+  std::atomic<unsigned> next_queue_{0};
+  bool stopping_ = false; // Guarded by sleep_lock_
+};
+
+// Process-wide pool with one worker per hardware thread, created on first
+// use and never destroyed (workers may still be parked at exit)
+WorkStealingPool &ber_thread_pool();
+
+#endif // JOB_SCHED_H
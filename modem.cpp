@@ -0,0 +1,1277 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MODEM_HAVE_X86 1
+#define MODEM_TARGET_AVX2 __attribute__((target("avx2")))
+#define MODEM_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MODEM_HAVE_NEON 1
+#endif
+
+#include "awgn.h"
+#include "ber.h"
+#include "modem.h"
+
+using namespace std;
+
+// =============================================================================
+// SHARED SCALAR PIECES
+// =============================================================================
+//
+// The vector kernels handle whole register groups; the scalar helpers below
+// define the reference result and finish any leftover symbols. A group of
+// LANES symbols holds LANES * bits_per_sym <= 64 bits and starts at a multiple
+// of that size, so it always comes from a single word. 64- and 256-QAM
+// (B > 4) instead map through Modulator<M>::points and pack their decisions
+// with demodulate_qam_lut, where each variant only supplies the slicer.
+
+namespace {
+
+// Kernels are templated on the bits per symbol B; ModB<B> is its constellation
+template <int B>
+using ModB = Modulator<1 << B>;
+
+using Qam16 = Modulator<16>;
+constexpr double qam_outer = Qam16::level(0b00) * Qam16::scale; // |level| = 3, scaled
+constexpr double qam_inner = Qam16::level(0b01) * Qam16::scale; // |level| = 1, scaled
+
+// Constellation point of symbol i
+template <int B>
+inline void symbol_point(const uint64_t *words, size_t i, double &re,
+                         double &im) noexcept {
+  ModB<B>::point(symbol_bits<B>(words, i), re, im);
+}
+
+// Bits of one received symbol, right-aligned
+template <int B>
+inline uint64_t symbol_decision(double re, double im) noexcept {
+  return ModB<B>::decide(re, im);
+}
+
+// spread<S>[m] moves bit k of the 8-bit lane mask m to bit k * S, turning
+// per-lane compare masks into interleaved symbol bits
+template <int Stride>
+constexpr array<uint64_t, 256> make_spread_table() {
+  array<uint64_t, 256> table{};
+  for (unsigned m = 0; m < 256; ++m)
+    for (int k = 0; k < 8; ++k)
+      if ((m >> k) & 1u)
+        table[m] |= uint64_t{1} << (k * Stride);
+  return table;
+}
+constexpr auto spread2 = make_spread_table<2>();
+constexpr auto spread4 = make_spread_table<4>();
+
+// Sums of squares use SUM_LANES partial sums (lane j takes elements i with
+// i % SUM_LANES == j), folded pairwise below and then the leftover elements
+// added in order. Every variant keeps exactly these lanes, so all of them
+// return the same bits.
+constexpr size_t SUM_LANES = 8;
+
+inline double finish_sum_squares(const double *acc, const double *tail,
+                                 size_t n) noexcept {
+  const double s0 = acc[0] + acc[4], s1 = acc[1] + acc[5];
+  const double s2 = acc[2] + acc[6], s3 = acc[3] + acc[7];
+  double sum = (s0 + s2) + (s1 + s3);
+  for (size_t i = 0; i < n; ++i)
+    sum += tail[i] * tail[i];
+  return sum;
+}
+
+// =============================================================================
+// SCALAR KERNELS
+// =============================================================================
+
+// The group of Lanes symbols starting at symbol i (a multiple of Lanes),
+// right-aligned; 64/256-QAM groups may straddle two words
+template <int B, size_t Lanes>
+inline uint64_t symbol_group(const uint64_t *words, size_t i) noexcept {
+  static_assert(Lanes * B <= 64, "group must fit a word");
+  const size_t bit = i * B;
+  const unsigned shift = bit & 63;
+  uint64_t g = words[bit >> 6] >> shift;
+  if (shift + Lanes * B > 64)
+    g |= words[(bit >> 6) + 1] << (64 - shift);
+  return g;
+}
+
+struct ScalarKernels {
+  template <int B>
+  static void modulate(const uint64_t *words, size_t num_sym, double *re,
+                       double *im) noexcept {
+    for (size_t i = 0; i < num_sym; ++i)
+      symbol_point<B>(words, i, re[i], im[i]);
+  }
+
+  template <int B>
+  static void demodulate(const double *re, const double *im, size_t num_sym,
+                         uint64_t *words) noexcept {
+    constexpr size_t syms_per_word = 64 / B;
+    const size_t num_words = words_for_bits(num_sym * B);
+    for (size_t w = 0; w < num_words; ++w) {
+      const size_t first = w * syms_per_word;
+      const size_t count = std::min(syms_per_word, num_sym - first);
+      uint64_t word = 0;
+      for (size_t j = 0; j < count; ++j)
+        word |= symbol_decision<B>(re[first + j], im[first + j]) << (B * j);
+      words[w] = word;
+    }
+  }
+
+  // Level indices of n received values (64/256-QAM)
+  template <int B>
+  static void slice(const double *x, size_t n, int32_t *k) noexcept {
+    for (size_t i = 0; i < n; ++i)
+      k[i] = static_cast<int32_t>(ModB<B>::slice_index(x[i] * ModB<B>::inv_scale));
+  }
+
+  // Points of symbols [first, num_sym) from the Modulator<M>::points LUT
+  template <int B>
+  static void lut_modulate(const uint64_t *words, size_t first, size_t num_sym,
+                           double *re, double *im) noexcept {
+    for (size_t i = first; i < num_sym; ++i) {
+      const unsigned b = symbol_bits<B>(words, i);
+      re[i] = ModB<B>::points.re[b];
+      im[i] = ModB<B>::points.im[b];
+    }
+  }
+
+  static double sum_squares(const double *x, size_t n) noexcept {
+    double acc[SUM_LANES] = {};
+    size_t i = 0;
+    for (; i + SUM_LANES <= n; i += SUM_LANES)
+      for (size_t j = 0; j < SUM_LANES; ++j)
+        acc[j] += x[i + j] * x[i + j];
+    return finish_sum_squares(acc, x + i, n - i);
+  }
+};
+
+// =============================================================================
+// AVX2 KERNELS (4 doubles per register)
+// =============================================================================
+
+#ifdef MODEM_HAVE_X86
+
+// g holds the bits of 4 consecutive symbols in every lane; returns all-ones
+// in lane j where bit k of symbol j is set
+template <int B>
+MODEM_TARGET_AVX2 inline __m256d avx2_bit_mask(__m256i g, int k) noexcept {
+  const __m256i bit = _mm256_setr_epi64x(1LL << k, 1LL << (B + k),
+                                         1LL << (2 * B + k), 1LL << (3 * B + k));
+  return _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(g, bit), bit));
+}
+
+// Flip the sign of the lanes selected by mask
+MODEM_TARGET_AVX2 inline __m256d avx2_negate_if(__m256d x,
+                                                __m256d mask) noexcept {
+  return _mm256_xor_pd(x, _mm256_and_pd(mask, _mm256_set1_pd(-0.0)));
+}
+
+// Bits of 4 received symbols
+template <int B>
+MODEM_TARGET_AVX2 inline uint64_t avx2_decide(const double *re,
+                                              const double *im) noexcept {
+  const __m256d zero = _mm256_setzero_pd();
+  __m256d x = _mm256_loadu_pd(re);
+  if constexpr (B == 1) {
+    return static_cast<uint64_t>(
+        _mm256_movemask_pd(_mm256_cmp_pd(x, zero, _CMP_LT_OQ)));
+  } else {
+    __m256d y = _mm256_loadu_pd(im);
+    if constexpr (B == 2) {
+      const int mx = _mm256_movemask_pd(_mm256_cmp_pd(x, zero, _CMP_LT_OQ));
+      const int my = _mm256_movemask_pd(_mm256_cmp_pd(y, zero, _CMP_LT_OQ));
+      return spread2[mx] | spread2[my] << 1;
+    } else {
+      const __m256d inv = _mm256_set1_pd(ModB<B>::inv_scale);
+      const __m256d lo = _mm256_set1_pd(-ModB<B>::threshold);
+      const __m256d hi = _mm256_set1_pd(ModB<B>::threshold);
+      x = _mm256_mul_pd(x, inv);
+      y = _mm256_mul_pd(y, inv);
+      const int sx = _mm256_movemask_pd(_mm256_cmp_pd(x, zero, _CMP_LE_OQ));
+      const int sy = _mm256_movemask_pd(_mm256_cmp_pd(y, zero, _CMP_LE_OQ));
+      const int ix = _mm256_movemask_pd(_mm256_and_pd(
+          _mm256_cmp_pd(x, lo, _CMP_GT_OQ), _mm256_cmp_pd(x, hi, _CMP_LE_OQ)));
+      const int iy = _mm256_movemask_pd(_mm256_and_pd(
+          _mm256_cmp_pd(y, lo, _CMP_GT_OQ), _mm256_cmp_pd(y, hi, _CMP_LE_OQ)));
+      return spread4[sx] | spread4[sy] << 1 | spread4[ix] << 2 |
+             spread4[iy] << 3;
+    }
+  }
+}
+
+struct Avx2Kernels {
+  static constexpr size_t LANES = 4;
+
+  template <int B>
+  MODEM_TARGET_AVX2 static void modulate(const uint64_t *words, size_t num_sym,
+                                         double *re, double *im) noexcept {
+    size_t i = 0;
+    for (; i + LANES <= num_sym; i += LANES) {
+      const size_t bit = i * B;
+      const __m256i g =
+          _mm256_set1_epi64x(static_cast<long long>(words[bit >> 6] >> (bit & 63)));
+      __m256d x, y;
+      if constexpr (B == 1) {
+        x = avx2_negate_if(_mm256_set1_pd(1.0), avx2_bit_mask<B>(g, 0));
+        y = _mm256_setzero_pd();
+      } else if constexpr (B == 2) {
+        const __m256d s = _mm256_set1_pd(ModB<B>::scale);
+        x = avx2_negate_if(s, avx2_bit_mask<B>(g, 0));
+        y = avx2_negate_if(s, avx2_bit_mask<B>(g, 1));
+      } else {
+        const __m256d outer = _mm256_set1_pd(qam_outer);
+        const __m256d inner = _mm256_set1_pd(qam_inner);
+        const __m256d mag_x = _mm256_blendv_pd(outer, inner, avx2_bit_mask<B>(g, 2));
+        const __m256d mag_y = _mm256_blendv_pd(outer, inner, avx2_bit_mask<B>(g, 3));
+        x = avx2_negate_if(mag_x, avx2_bit_mask<B>(g, 0));
+        y = avx2_negate_if(mag_y, avx2_bit_mask<B>(g, 1));
+      }
+      _mm256_storeu_pd(re + i, x);
+      _mm256_storeu_pd(im + i, y);
+    }
+    for (; i < num_sym; ++i)
+      symbol_point<B>(words, i, re[i], im[i]);
+  }
+
+  template <int B>
+  MODEM_TARGET_AVX2 static void demodulate(const double *re, const double *im,
+                                           size_t num_sym,
+                                           uint64_t *words) noexcept {
+    constexpr size_t syms_per_word = 64 / B;
+    const size_t num_words = words_for_bits(num_sym * B);
+    for (size_t w = 0; w < num_words; ++w) {
+      const size_t first = w * syms_per_word;
+      const size_t count = std::min(syms_per_word, num_sym - first);
+      uint64_t word = 0;
+      size_t j = 0;
+      for (; j + LANES <= count; j += LANES)
+        word |= avx2_decide<B>(re + first + j, im + first + j) << (B * j);
+      for (; j < count; ++j)
+        word |= symbol_decision<B>(re[first + j], im[first + j]) << (B * j);
+      words[w] = word;
+    }
+  }
+
+  // Multiply-and-clamp slicer; max/min return their second operand for NaN,
+  // matching the compare-selects of Modulator::slice_index
+  template <int B>
+  MODEM_TARGET_AVX2 static void slice(const double *x, size_t n,
+                                      int32_t *k) noexcept {
+    const __m256d inv = _mm256_set1_pd(ModB<B>::inv_scale);
+    const __m256d levels = _mm256_set1_pd(ModB<B>::axis_levels);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d top = _mm256_set1_pd(ModB<B>::axis_levels - 1.0);
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+      const __m256d v = _mm256_mul_pd(
+          _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(x + i), inv), levels), half);
+      __m256d t = _mm256_sub_pd(
+          _mm256_round_pd(v, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC), one);
+      t = _mm256_min_pd(_mm256_max_pd(t, _mm256_setzero_pd()), top);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(k + i), _mm256_cvttpd_epi32(t));
+    }
+    ScalarKernels::slice<B>(x + i, n - i, k + i);
+  }
+
+  // Each lane shifts its symbol out of the group and gathers its point;
+  // full-mask gathers, as the unmasked ones start from _mm256_undefined_pd,
+  // which GCC 12 reports as maybe-uninitialized
+  template <int B>
+  MODEM_TARGET_AVX2 static void lut_modulate(const uint64_t *words, size_t first,
+                                             size_t num_sym, double *re,
+                                             double *im) noexcept {
+    const __m256i shifts = _mm256_setr_epi64x(0, B, 2 * B, 3 * B);
+    const __m256i field = _mm256_set1_epi64x((1 << B) - 1);
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    const __m256d zero = _mm256_setzero_pd();
+    size_t i = first;
+    for (; i + LANES <= num_sym; i += LANES) {
+      const __m256i g = _mm256_set1_epi64x(
+          static_cast<long long>(symbol_group<B, LANES>(words, i)));
+      const __m256i b = _mm256_and_si256(_mm256_srlv_epi64(g, shifts), field);
+      _mm256_storeu_pd(re + i, _mm256_mask_i64gather_pd(
+                                   zero, ModB<B>::points.re.data(), b, all, 8));
+      _mm256_storeu_pd(im + i, _mm256_mask_i64gather_pd(
+                                   zero, ModB<B>::points.im.data(), b, all, 8));
+    }
+    ScalarKernels::lut_modulate<B>(words, i, num_sym, re, im);
+  }
+
+  MODEM_TARGET_AVX2 static double sum_squares(const double *x,
+                                              size_t n) noexcept {
+    __m256d lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + SUM_LANES <= n; i += SUM_LANES) {
+      const __m256d a = _mm256_loadu_pd(x + i);
+      const __m256d b = _mm256_loadu_pd(x + i + 4);
+      lo = _mm256_add_pd(lo, _mm256_mul_pd(a, a));
+      hi = _mm256_add_pd(hi, _mm256_mul_pd(b, b));
+    }
+    alignas(32) double acc[SUM_LANES];
+    _mm256_store_pd(acc, lo);
+    _mm256_store_pd(acc + 4, hi);
+    return finish_sum_squares(acc, x + i, n - i);
+  }
+};
+
+// =============================================================================
+// AVX-512 KERNELS (8 doubles per register, compare results in k-masks)
+// =============================================================================
+
+MODEM_TARGET_AVX512 inline __m512d avx512_negate_if(__m512d x,
+                                                    __mmask8 mask) noexcept {
+  const __m512i bits = _mm512_castpd_si512(x);
+  return _mm512_castsi512_pd(_mm512_mask_xor_epi64(
+      bits, mask, bits, _mm512_set1_epi64(static_cast<long long>(1ULL << 63))));
+}
+
+// Same as avx2_bit_mask for 8 symbols, as a k-mask
+template <int B>
+MODEM_TARGET_AVX512 inline __mmask8 avx512_bit_mask(__m512i g, int k) noexcept {
+  const __m512i bit = _mm512_set_epi64(
+      1LL << (7 * B + k), 1LL << (6 * B + k), 1LL << (5 * B + k),
+      1LL << (4 * B + k), 1LL << (3 * B + k), 1LL << (2 * B + k),
+      1LL << (B + k), 1LL << k);
+  return _mm512_test_epi64_mask(g, bit);
+}
+
+// Bits of 8 received symbols
+template <int B>
+MODEM_TARGET_AVX512 inline uint64_t avx512_decide(const double *re,
+                                                  const double *im) noexcept {
+  const __m512d zero = _mm512_setzero_pd();
+  __m512d x = _mm512_loadu_pd(re);
+  if constexpr (B == 1) {
+    return _mm512_cmp_pd_mask(x, zero, _CMP_LT_OQ);
+  } else {
+    __m512d y = _mm512_loadu_pd(im);
+    if constexpr (B == 2) {
+      const __mmask8 mx = _mm512_cmp_pd_mask(x, zero, _CMP_LT_OQ);
+      const __mmask8 my = _mm512_cmp_pd_mask(y, zero, _CMP_LT_OQ);
+      return spread2[mx] | spread2[my] << 1;
+    } else {
+      const __m512d inv = _mm512_set1_pd(ModB<B>::inv_scale);
+      const __m512d lo = _mm512_set1_pd(-ModB<B>::threshold);
+      const __m512d hi = _mm512_set1_pd(ModB<B>::threshold);
+      x = _mm512_mul_pd(x, inv);
+      y = _mm512_mul_pd(y, inv);
+      const __mmask8 sx = _mm512_cmp_pd_mask(x, zero, _CMP_LE_OQ);
+      const __mmask8 sy = _mm512_cmp_pd_mask(y, zero, _CMP_LE_OQ);
+      const __mmask8 ix = _mm512_mask_cmp_pd_mask(
+          _mm512_cmp_pd_mask(x, lo, _CMP_GT_OQ), x, hi, _CMP_LE_OQ);
+      const __mmask8 iy = _mm512_mask_cmp_pd_mask(
+          _mm512_cmp_pd_mask(y, lo, _CMP_GT_OQ), y, hi, _CMP_LE_OQ);
+      return spread4[sx] | spread4[sy] << 1 | spread4[ix] << 2 |
+             spread4[iy] << 3;
+    }
+  }
+}
+
+struct Avx512Kernels {
+  static constexpr size_t LANES = 8;
+
+  template <int B>
+  MODEM_TARGET_AVX512 static void modulate(const uint64_t *words,
+                                           size_t num_sym, double *re,
+                                           double *im) noexcept {
+    size_t i = 0;
+    for (; i + LANES <= num_sym; i += LANES) {
+      const size_t bit = i * B;
+      const __m512i g =
+          _mm512_set1_epi64(static_cast<long long>(words[bit >> 6] >> (bit & 63)));
+      __m512d x, y;
+      if constexpr (B == 1) {
+        x = avx512_negate_if(_mm512_set1_pd(1.0), avx512_bit_mask<B>(g, 0));
+        y = _mm512_setzero_pd();
+      } else if constexpr (B == 2) {
+        const __m512d s = _mm512_set1_pd(ModB<B>::scale);
+        x = avx512_negate_if(s, avx512_bit_mask<B>(g, 0));
+        y = avx512_negate_if(s, avx512_bit_mask<B>(g, 1));
+      } else {
+        const __m512d outer = _mm512_set1_pd(qam_outer);
+        const __m512d inner = _mm512_set1_pd(qam_inner);
+        x = avx512_negate_if(
+            _mm512_mask_blend_pd(avx512_bit_mask<B>(g, 2), outer, inner),
+            avx512_bit_mask<B>(g, 0));
+        y = avx512_negate_if(
+            _mm512_mask_blend_pd(avx512_bit_mask<B>(g, 3), outer, inner),
+            avx512_bit_mask<B>(g, 1));
+      }
+      _mm512_storeu_pd(re + i, x);
+      _mm512_storeu_pd(im + i, y);
+    }
+    for (; i < num_sym; ++i)
+      symbol_point<B>(words, i, re[i], im[i]);
+  }
+
+  template <int B>
+  MODEM_TARGET_AVX512 static void demodulate(const double *re,
+                                             const double *im, size_t num_sym,
+                                             uint64_t *words) noexcept {
+    constexpr size_t syms_per_word = 64 / B;
+    const size_t num_words = words_for_bits(num_sym * B);
+    for (size_t w = 0; w < num_words; ++w) {
+      const size_t first = w * syms_per_word;
+      const size_t count = std::min(syms_per_word, num_sym - first);
+      uint64_t word = 0;
+      size_t j = 0;
+      for (; j + LANES <= count; j += LANES)
+        word |= avx512_decide<B>(re + first + j, im + first + j) << (B * j);
+      for (; j < count; ++j)
+        word |= symbol_decision<B>(re[first + j], im[first + j]) << (B * j);
+      words[w] = word;
+    }
+  }
+
+  template <int B>
+  MODEM_TARGET_AVX512 static void slice(const double *x, size_t n,
+                                        int32_t *k) noexcept {
+    const __m512d inv = _mm512_set1_pd(ModB<B>::inv_scale);
+    const __m512d levels = _mm512_set1_pd(ModB<B>::axis_levels);
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d top = _mm512_set1_pd(ModB<B>::axis_levels - 1.0);
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+      const __m512d v = _mm512_mul_pd(
+          _mm512_add_pd(_mm512_mul_pd(_mm512_loadu_pd(x + i), inv), levels), half);
+      // Full-mask forms: the unmasked ones start from _mm512_undefined_pd,
+      // which GCC 12 reports as maybe-uninitialized
+      constexpr __mmask8 all = 0xFF;
+      __m512d t = _mm512_sub_pd(
+          _mm512_mask_roundscale_pd(v, all, v, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC), one);
+      t = _mm512_mask_max_pd(t, all, t, _mm512_setzero_pd());
+      t = _mm512_mask_min_pd(t, all, t, top);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(k + i),
+                          _mm512_mask_cvttpd_epi32(_mm256_setzero_si256(), all, t));
+    }
+    ScalarKernels::slice<B>(x + i, n - i, k + i);
+  }
+
+  template <int B>
+  MODEM_TARGET_AVX512 static void lut_modulate(const uint64_t *words, size_t first,
+                                               size_t num_sym, double *re,
+                                               double *im) noexcept {
+    const __m512i shifts = _mm512_setr_epi64(0, B, 2 * B, 3 * B, 4 * B, 5 * B, 6 * B, 7 * B);
+    const __m512i field = _mm512_set1_epi64((1 << B) - 1);
+    constexpr __mmask8 all = 0xFF; // Full-mask forms, as in slice
+    size_t i = first;
+    for (; i + LANES <= num_sym; i += LANES) {
+      const __m512i g = _mm512_set1_epi64(
+          static_cast<long long>(symbol_group<B, LANES>(words, i)));
+      const __m512i b = _mm512_and_si512(_mm512_maskz_srlv_epi64(all, g, shifts), field);
+      _mm512_storeu_pd(re + i, _mm512_mask_i64gather_pd(_mm512_setzero_pd(), all, b,
+                                                        ModB<B>::points.re.data(), 8));
+      _mm512_storeu_pd(im + i, _mm512_mask_i64gather_pd(_mm512_setzero_pd(), all, b,
+                                                        ModB<B>::points.im.data(), 8));
+    }
+    ScalarKernels::lut_modulate<B>(words, i, num_sym, re, im);
+  }
+
+  MODEM_TARGET_AVX512 static double sum_squares(const double *x,
+                                                size_t n) noexcept {
+    __m512d sum = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + SUM_LANES <= n; i += SUM_LANES) {
+      const __m512d a = _mm512_loadu_pd(x + i);
+      sum = _mm512_add_pd(sum, _mm512_mul_pd(a, a));
+    }
+    alignas(64) double acc[SUM_LANES];
+    _mm512_store_pd(acc, sum);
+    return finish_sum_squares(acc, x + i, n - i);
+  }
+};
+
+#endif // MODEM_HAVE_X86
+
+// =============================================================================
+// NEON KERNELS (2 doubles per register, AArch64)
+// =============================================================================
+
+#ifdef MODEM_HAVE_NEON
+
+inline float64x2_t neon_negate_if(float64x2_t x, uint64x2_t mask) noexcept {
+  const uint64x2_t sign = vdupq_n_u64(1ULL << 63);
+  return vreinterpretq_f64_u64(
+      veorq_u64(vreinterpretq_u64_f64(x), vandq_u64(mask, sign)));
+}
+
+// Same as avx2_bit_mask for 2 symbols
+template <int B>
+inline uint64x2_t neon_bit_mask(uint64x2_t g, int k) noexcept {
+  const uint64x2_t bit = {1ULL << k, 1ULL << (B + k)};
+  return vtstq_u64(g, bit);
+}
+
+// Two-lane compare mask -> 2-bit integer
+inline unsigned neon_movemask(uint64x2_t m) noexcept {
+  return static_cast<unsigned>((vgetq_lane_u64(m, 0) & 1u) |
+                               (vgetq_lane_u64(m, 1) & 2u));
+}
+
+template <int B>
+inline uint64_t neon_decide(const double *re, const double *im) noexcept {
+  const float64x2_t zero = vdupq_n_f64(0.0);
+  float64x2_t x = vld1q_f64(re);
+  if constexpr (B == 1) {
+    return neon_movemask(vcltq_f64(x, zero));
+  } else {
+    float64x2_t y = vld1q_f64(im);
+    if constexpr (B == 2) {
+      return spread2[neon_movemask(vcltq_f64(x, zero))] |
+             spread2[neon_movemask(vcltq_f64(y, zero))] << 1;
+    } else {
+      const float64x2_t lo = vdupq_n_f64(-ModB<B>::threshold);
+      const float64x2_t hi = vdupq_n_f64(ModB<B>::threshold);
+      x = vmulq_n_f64(x, ModB<B>::inv_scale);
+      y = vmulq_n_f64(y, ModB<B>::inv_scale);
+      const unsigned sx = neon_movemask(vcleq_f64(x, zero));
+      const unsigned sy = neon_movemask(vcleq_f64(y, zero));
+      const unsigned ix =
+          neon_movemask(vandq_u64(vcgtq_f64(x, lo), vcleq_f64(x, hi)));
+      const unsigned iy =
+          neon_movemask(vandq_u64(vcgtq_f64(y, lo), vcleq_f64(y, hi)));
+      return spread4[sx] | spread4[sy] << 1 | spread4[ix] << 2 |
+             spread4[iy] << 3;
+    }
+  }
+}
+
+struct NeonKernels {
+  static constexpr size_t LANES = 2;
+
+  template <int B>
+  static void modulate(const uint64_t *words, size_t num_sym, double *re,
+                       double *im) noexcept {
+    size_t i = 0;
+    for (; i + LANES <= num_sym; i += LANES) {
+      const size_t bit = i * B;
+      const uint64x2_t g = vdupq_n_u64(words[bit >> 6] >> (bit & 63));
+      float64x2_t x, y;
+      if constexpr (B == 1) {
+        x = neon_negate_if(vdupq_n_f64(1.0), neon_bit_mask<B>(g, 0));
+        y = vdupq_n_f64(0.0);
+      } else if constexpr (B == 2) {
+        const float64x2_t s = vdupq_n_f64(ModB<B>::scale);
+        x = neon_negate_if(s, neon_bit_mask<B>(g, 0));
+        y = neon_negate_if(s, neon_bit_mask<B>(g, 1));
+      } else {
+        const float64x2_t outer = vdupq_n_f64(qam_outer);
+        const float64x2_t inner = vdupq_n_f64(qam_inner);
+        x = neon_negate_if(vbslq_f64(neon_bit_mask<B>(g, 2), inner, outer),
+                           neon_bit_mask<B>(g, 0));
+        y = neon_negate_if(vbslq_f64(neon_bit_mask<B>(g, 3), inner, outer),
+                           neon_bit_mask<B>(g, 1));
+      }
+      vst1q_f64(re + i, x);
+      vst1q_f64(im + i, y);
+    }
+    for (; i < num_sym; ++i)
+      symbol_point<B>(words, i, re[i], im[i]);
+  }
+
+  template <int B>
+  static void demodulate(const double *re, const double *im, size_t num_sym,
+                         uint64_t *words) noexcept {
+    constexpr size_t syms_per_word = 64 / B;
+    const size_t num_words = words_for_bits(num_sym * B);
+    for (size_t w = 0; w < num_words; ++w) {
+      const size_t first = w * syms_per_word;
+      const size_t count = std::min(syms_per_word, num_sym - first);
+      uint64_t word = 0;
+      size_t j = 0;
+      for (; j + LANES <= count; j += LANES)
+        word |= neon_decide<B>(re + first + j, im + first + j) << (B * j);
+      for (; j < count; ++j)
+        word |= symbol_decision<B>(re[first + j], im[first + j]) << (B * j);
+      words[w] = word;
+    }
+  }
+
+  // Clamps as compare-selects in the order of Modulator::slice_index
+  template <int B>
+  static void slice(const double *x, size_t n, int32_t *k) noexcept {
+    const float64x2_t zero = vdupq_n_f64(0.0);
+    const float64x2_t top = vdupq_n_f64(ModB<B>::axis_levels - 1.0);
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+      const float64x2_t v = vmulq_n_f64(
+          vaddq_f64(vmulq_n_f64(vld1q_f64(x + i), ModB<B>::inv_scale),
+                    vdupq_n_f64(ModB<B>::axis_levels)),
+          0.5);
+      float64x2_t t = vsubq_f64(vrndpq_f64(v), vdupq_n_f64(1.0));
+      t = vbslq_f64(vcgtq_f64(t, zero), t, zero);
+      t = vbslq_f64(vcltq_f64(t, top), t, top);
+      vst1_s32(k + i, vmovn_s64(vcvtq_s64_f64(t)));
+    }
+    ScalarKernels::slice<B>(x + i, n - i, k + i);
+  }
+
+  // NEON has no gather, so the points come from the scalar LUT loop
+  template <int B>
+  static void lut_modulate(const uint64_t *words, size_t first, size_t num_sym,
+                           double *re, double *im) noexcept {
+    ScalarKernels::lut_modulate<B>(words, first, num_sym, re, im);
+  }
+
+  static double sum_squares(const double *x, size_t n) noexcept {
+    float64x2_t sum[SUM_LANES / 2];
+    for (auto &s : sum)
+      s = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + SUM_LANES <= n; i += SUM_LANES)
+      for (size_t j = 0; j < SUM_LANES / 2; ++j) {
+        const float64x2_t a = vld1q_f64(x + i + 2 * j);
+        sum[j] = vaddq_f64(sum[j], vmulq_f64(a, a));
+      }
+    double acc[SUM_LANES];
+    for (size_t j = 0; j < SUM_LANES / 2; ++j)
+      vst1q_f64(acc + 2 * j, sum[j]);
+    return finish_sum_squares(acc, x + i, n - i);
+  }
+};
+
+#endif // MODEM_HAVE_NEON
+
+// =============================================================================
+// 64/256-QAM KERNELS
+// =============================================================================
+//
+// Points are gathered from the Modulator<M>::points LUT, a register of
+// symbols at a time (Kernels::lut_modulate). Decisions slice each axis to a
+// level index with Kernels::slice (the vectorised part), look the symbol
+// bits up in Modulator<M>::slice_bits and pack them back to back, since
+// 6-bit symbols do not divide a word.
+
+template <typename Kernels>
+struct QamLutKernels {
+  static constexpr size_t BLOCK = 64; // Symbols sliced per call
+
+  template <int B>
+  static void modulate(const uint64_t *words, size_t num_sym, double *re,
+                       double *im) noexcept {
+    Kernels::template lut_modulate<B>(words, 0, num_sym, re, im);
+  }
+
+  template <int B>
+  static void demodulate(const double *re, const double *im, size_t num_sym,
+                         uint64_t *words) noexcept {
+    int32_t kx[BLOCK], ky[BLOCK];
+    uint64_t acc = 0;
+    unsigned fill = 0; // Bits pending in acc
+    size_t w = 0;
+    for (size_t first = 0; first < num_sym; first += BLOCK) {
+      const size_t n = std::min(BLOCK, num_sym - first);
+      Kernels::template slice<B>(re + first, n, kx);
+      Kernels::template slice<B>(im + first, n, ky);
+      for (size_t j = 0; j < n; ++j) {
+        const uint64_t s = ModB<B>::slice_bits[static_cast<size_t>(kx[j])] |
+                           ModB<B>::slice_bits[static_cast<size_t>(ky[j])] << 1;
+        acc |= s << fill;
+        fill += B;
+        if (fill >= 64) {
+          words[w++] = acc;
+          fill -= 64;
+          acc = s >> (B - fill);
+        }
+      }
+    }
+    if (fill)
+      words[w] = acc;
+  }
+};
+
+// =============================================================================
+// RUNTIME DISPATCH
+// =============================================================================
+
+int detect_simd_level() noexcept {
+#ifdef MODEM_HAVE_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return SIMD_LEVEL_AVX512;
+  if (__builtin_cpu_supports("avx2"))
+    return SIMD_LEVEL_AVX2;
+#endif
+#ifdef MODEM_HAVE_NEON
+  return SIMD_LEVEL_NEON;
+#endif
+  return SIMD_LEVEL_SCALAR;
+}
+
+atomic<int> g_simd_level{detect_simd_level()};
+
+// One row per SIMD level, one entry per modulation_orders entry. Levels not
+// compiled in fall back to the scalar row.
+struct ModemOps {
+  void (*modulate)(const uint64_t *words, size_t num_sym, double *re,
+                   double *im) noexcept;
+  void (*demodulate)(const double *re, const double *im, size_t num_sym,
+                     uint64_t *words) noexcept;
+};
+using ModemRow = array<ModemOps, modulation_orders.size()>;
+
+template <typename Kernels, int B>
+constexpr ModemOps modem_entry() noexcept {
+  if constexpr (B > 4)
+    return {&QamLutKernels<Kernels>::template modulate<B>,
+            &QamLutKernels<Kernels>::template demodulate<B>};
+  else
+    return {&Kernels::template modulate<B>, &Kernels::template demodulate<B>};
+}
+
+template <typename Kernels, size_t... K>
+constexpr ModemRow make_modem_row(index_sequence<K...>) noexcept {
+  return {{modem_entry<Kernels, Modulator<modulation_orders[K]>::bits_per_sym>()...}};
+}
+
+template <typename Kernels>
+constexpr ModemRow modem_row() noexcept {
+  return make_modem_row<Kernels>(make_index_sequence<modulation_orders.size()>{});
+}
+
+constexpr array<ModemRow, 4> modem_ops = {
+    modem_row<ScalarKernels>(),
+#ifdef MODEM_HAVE_X86
+    modem_row<Avx2Kernels>(),
+    modem_row<Avx512Kernels>(),
+#else
+    modem_row<ScalarKernels>(),
+    modem_row<ScalarKernels>(),
+#endif
+#ifdef MODEM_HAVE_NEON
+    modem_row<NeonKernels>(),
+#else
+    modem_row<ScalarKernels>(),
+#endif
+};
+static_assert(SIMD_LEVEL_SCALAR == 0 && SIMD_LEVEL_AVX2 == 1 && SIMD_LEVEL_AVX512 == 2 &&
+                  SIMD_LEVEL_NEON == 3,
+              "modem_ops rows follow the SIMD_LEVEL_* values");
+
+// Kernels of (level, mod_order); nullptr for an unsupported order
+inline const ModemOps *modem_kernels(int level, int mod_order) noexcept {
+  const int k = modulation_index(mod_order);
+  if (k < 0)
+    return nullptr;
+  const size_t row = static_cast<unsigned>(level) < modem_ops.size()
+                         ? static_cast<size_t>(level)
+                         : static_cast<size_t>(SIMD_LEVEL_SCALAR);
+  return &modem_ops[row][static_cast<size_t>(k)];
+}
+
+} // namespace
+
+int current_simd_level() noexcept {
+  return g_simd_level.load(memory_order_relaxed);
+}
+
+bool simd_level_supported(int level) noexcept {
+  switch (level) {
+  case SIMD_LEVEL_SCALAR:
+    return true;
+#ifdef MODEM_HAVE_X86
+  case SIMD_LEVEL_AVX2:
+    return __builtin_cpu_supports("avx2");
+  case SIMD_LEVEL_AVX512:
+    return __builtin_cpu_supports("avx512f");
+#endif
+#ifdef MODEM_HAVE_NEON
+  case SIMD_LEVEL_NEON:
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+void modulate_soa_level(int level, const uint64_t *words, size_t num_sym,
+                        int mod_order, double *re, double *im) noexcept {
+  if (const ModemOps *ops = modem_kernels(level, mod_order))
+    ops->modulate(words, num_sym, re, im);
+}
+
+void demodulate_soa_level(int level, const double *re, const double *im,
+                          size_t num_sym, int mod_order,
+                          uint64_t *words) noexcept {
+  if (const ModemOps *ops = modem_kernels(level, mod_order))
+    ops->demodulate(re, im, num_sym, words);
+}
+
+double sum_squares_level(int level, const double *x, size_t n) noexcept {
+  switch (level) {
+#ifdef MODEM_HAVE_X86
+  case SIMD_LEVEL_AVX512:
+    return Avx512Kernels::sum_squares(x, n);
+  case SIMD_LEVEL_AVX2:
+    return Avx2Kernels::sum_squares(x, n);
+#endif
+#ifdef MODEM_HAVE_NEON
+  case SIMD_LEVEL_NEON:
+    return NeonKernels::sum_squares(x, n);
+#endif
+  default:
+    return ScalarKernels::sum_squares(x, n);
+  }
+}
+
+double sum_squares(const double *x, size_t n) noexcept {
+  return sum_squares_level(current_simd_level(), x, n);
+}
+
+void modulate_soa(const uint64_t *words, size_t num_sym, int mod_order,
+                  double *re, double *im) noexcept {
+  modulate_soa_level(current_simd_level(), words, num_sym, mod_order, re, im);
+}
+
+void demodulate_soa(const double *re, const double *im, size_t num_sym,
+                    int mod_order, uint64_t *words) noexcept {
+  demodulate_soa_level(current_simd_level(), re, im, num_sym, mod_order,
+                       words);
+}
+
+extern "C" int ber_set_simd_level(int level) {
+  if (level == BER_SIMD_AUTO)
+    level = detect_simd_level();
+  if (!simd_level_supported(level))
+    return -1;
+  g_simd_level.store(level, memory_order_relaxed);
+  return 0;
+}
+
+extern "C" int ber_get_simd_level() { return current_simd_level(); }
+
+// =============================================================================
+// SOFT DEMAPPERS
+// =============================================================================
+//
+// LLRs follow the decoder convention (positive favours bit 1). BPSK/QPSK LLRs
+// are linear and identical in every mode. For 16-QAM each axis is a Gray
+// 4-PAM with levels {+3,+1,-3,-1} (index (msb<<1)|lsb):
+//   exact   log-sum-exp over the four levels (reference)
+//   max-log nearest level per hypothesis, which for Gray 4-PAM with
+//           x = r / scale and c = 4 / N0 reduces to
+//             msb = -c * (x + max(x - 2, 0) + min(x + 2, 0))
+//             lsb =  c * (2 - |x|)
+//   f32     the max-log formulas in float, four symbols per SSE/AVX step
+// 64- and 256-QAM always use max-log in double, whatever the mode: per axis
+// and field bit, the nearest of the 8 or 16 Modulator<M>::levels with the bit
+// clear minus the nearest with it set, in the same level units as 16-QAM.
+
+namespace {
+
+atomic<int> g_llr_mode{LLR_MODE_EXACT};
+
+inline void exact_axis_llrs(double x, double two_sigma2, double &llr_msb,
+                            double &llr_lsb) {
+  double metric[4];
+  for (int k = 0; k < 4; ++k) {
+    double d = x - Qam16::levels[k];
+    metric[k] = -(d * d) / two_sigma2; // log-likelihood up to constant
+  }
+  auto lse2 = [](double a, double b) {
+    double m = max(a, b);
+    return m + log(exp(a - m) + exp(b - m));
+  };
+  // msb=0: indices 0,1; msb=1: 2,3. lsb=0: 0,2; lsb=1: 1,3
+  llr_msb = -(lse2(metric[0], metric[1]) - lse2(metric[2], metric[3]));
+  llr_lsb = -(lse2(metric[0], metric[2]) - lse2(metric[1], metric[3]));
+}
+
+template <typename T>
+inline void maxlog_axis_llrs(T x, T c, T &llr_msb, T &llr_lsb) noexcept {
+  llr_msb = -c * ((x + max(x - T{2}, T{0})) + min(x + T{2}, T{0}));
+  llr_lsb = c * (T{2} - std::abs(x));
+}
+
+// Symbol bits (b0,b1,b2,b3) = (I msb, Q msb, I lsb, Q lsb)
+void qam16_llrs_exact(const double *re, const double *im, size_t num_sym,
+                      double n0, double *llr) {
+  for (size_t i = 0; i < num_sym; ++i) {
+    exact_axis_llrs(re[i] / Qam16::scale, n0, llr[4 * i], llr[4 * i + 2]);
+    exact_axis_llrs(im[i] / Qam16::scale, n0, llr[4 * i + 1], llr[4 * i + 3]);
+  }
+}
+
+void qam16_llrs_maxlog(const double *re, const double *im, size_t num_sym,
+                       double n0, double *llr) noexcept {
+  const double c = 4.0 / n0;
+  for (size_t i = 0; i < num_sym; ++i) {
+    maxlog_axis_llrs(re[i] * Qam16::inv_scale, c, llr[4 * i], llr[4 * i + 2]);
+    maxlog_axis_llrs(im[i] * Qam16::inv_scale, c, llr[4 * i + 1], llr[4 * i + 3]);
+  }
+}
+
+void qam16_llrs_f32_scalar(const double *re, const double *im, size_t first,
+                           size_t num_sym, float c, double *llr) noexcept {
+  constexpr float inv_scale = static_cast<float>(Qam16::inv_scale);
+  for (size_t i = first; i < num_sym; ++i) {
+    float m_i, l_i, m_q, l_q;
+    maxlog_axis_llrs(static_cast<float>(re[i]) * inv_scale, c, m_i, l_i);
+    maxlog_axis_llrs(static_cast<float>(im[i]) * inv_scale, c, m_q, l_q);
+    llr[4 * i] = m_i;
+    llr[4 * i + 1] = m_q;
+    llr[4 * i + 2] = l_i;
+    llr[4 * i + 3] = l_q;
+  }
+}
+
+// Max-log LLRs of the higher-order square QAMs (field bit j of axis q is
+// symbol bit 2j + q)
+template <int M>
+void square_qam_llrs_maxlog(const double *re, const double *im, size_t num_sym,
+                            double n0, double *llr) noexcept {
+  using Mod = Modulator<M>;
+  constexpr int A = Mod::axis_bits;
+  const double inv_n0 = 1.0 / n0;
+  for (size_t i = 0; i < num_sym; ++i)
+    for (int q = 0; q < 2; ++q) {
+      const double x = (q ? im[i] : re[i]) * Mod::inv_scale;
+      double best[A][2];
+      for (auto &b : best)
+        b[0] = b[1] = INFINITY;
+      for (unsigned f = 0; f < static_cast<unsigned>(Mod::axis_levels); ++f) {
+        const double d = x - Mod::levels[f];
+        const double d2 = d * d;
+        for (int j = 0; j < A; ++j) {
+          double &slot = best[j][(f >> (A - 1 - j)) & 1u];
+          slot = min(slot, d2);
+        }
+      }
+      for (int j = 0; j < A; ++j)
+        llr[Mod::bits_per_sym * i + 2 * j + q] = (best[j][0] - best[j][1]) * inv_n0;
+    }
+}
+
+#ifdef MODEM_HAVE_X86
+
+// Same operation order as maxlog_axis_llrs<float>
+MODEM_TARGET_AVX2 inline void sse_maxlog_axis(__m128 x, __m128 c, __m128 &msb,
+                                              __m128 &lsb) noexcept {
+  const __m128 two = _mm_set1_ps(2.0f);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 sum = _mm_add_ps(_mm_add_ps(x, _mm_max_ps(_mm_sub_ps(x, two), zero)),
+                                _mm_min_ps(_mm_add_ps(x, two), zero));
+  msb = _mm_mul_ps(_mm_xor_ps(c, _mm_set1_ps(-0.0f)), sum);
+  lsb = _mm_mul_ps(c, _mm_sub_ps(two, _mm_andnot_ps(_mm_set1_ps(-0.0f), x)));
+}
+
+MODEM_TARGET_AVX2
+void qam16_llrs_f32_avx2(const double *re, const double *im, size_t num_sym,
+                         float c, double *llr) noexcept {
+  const __m128 vc = _mm_set1_ps(c);
+  const __m128 inv_scale = _mm_set1_ps(static_cast<float>(Qam16::inv_scale));
+  size_t i = 0;
+  for (; i + 4 <= num_sym; i += 4) {
+    const __m128 x = _mm_mul_ps(_mm256_cvtpd_ps(_mm256_loadu_pd(re + i)), inv_scale);
+    const __m128 y = _mm_mul_ps(_mm256_cvtpd_ps(_mm256_loadu_pd(im + i)), inv_scale);
+    __m128 m_i, l_i, m_q, l_q;
+    sse_maxlog_axis(x, vc, m_i, l_i);
+    sse_maxlog_axis(y, vc, m_q, l_q);
+    // Per symbol: I msb, Q msb, I lsb, Q lsb
+    const __m128 m_lo = _mm_unpacklo_ps(m_i, m_q), m_hi = _mm_unpackhi_ps(m_i, m_q);
+    const __m128 l_lo = _mm_unpacklo_ps(l_i, l_q), l_hi = _mm_unpackhi_ps(l_i, l_q);
+    double *out = llr + 4 * i;
+    _mm256_storeu_pd(out, _mm256_cvtps_pd(_mm_movelh_ps(m_lo, l_lo)));
+    _mm256_storeu_pd(out + 4, _mm256_cvtps_pd(_mm_movehl_ps(l_lo, m_lo)));
+    _mm256_storeu_pd(out + 8, _mm256_cvtps_pd(_mm_movelh_ps(m_hi, l_hi)));
+    _mm256_storeu_pd(out + 12, _mm256_cvtps_pd(_mm_movehl_ps(l_hi, m_hi)));
+  }
+  qam16_llrs_f32_scalar(re, im, i, num_sym, c, llr);
+}
+
+#endif
+
+void qam16_llrs_f32(int level, const double *re, const double *im,
+                    size_t num_sym, double n0, double *llr) noexcept {
+  const float c = static_cast<float>(4.0 / n0);
+#ifdef MODEM_HAVE_X86
+  if (level == SIMD_LEVEL_AVX2 || level == SIMD_LEVEL_AVX512)
+    return qam16_llrs_f32_avx2(re, im, num_sym, c, llr);
+#endif
+  (void)level; // NEON and scalar levels share the scalar float loop
+  qam16_llrs_f32_scalar(re, im, 0, num_sym, c, llr);
+}
+
+} // namespace
+
+int current_llr_mode() noexcept {
+  return g_llr_mode.load(memory_order_relaxed);
+}
+
+void llr_soa_level(int level, int mode, const double *re, const double *im,
+                   size_t num_sym, int mod_order, double n0, double *llr) {
+  const double llr_scale = 2.0 / n0; // Linear LLR scale for BPSK/QPSK
+  if (mod_order == 2) {
+    for (size_t i = 0; i < num_sym; ++i)
+      llr[i] = -re[i] * llr_scale;
+  } else if (mod_order == 4) {
+    for (size_t i = 0; i < num_sym; ++i) {
+      llr[2 * i] = -re[i] * llr_scale;
+      llr[2 * i + 1] = -im[i] * llr_scale;
+    }
+  } else if (mod_order == 64) {
+    square_qam_llrs_maxlog<64>(re, im, num_sym, n0, llr);
+  } else if (mod_order == 256) {
+    square_qam_llrs_maxlog<256>(re, im, num_sym, n0, llr);
+  } else if (mode == LLR_MODE_MAXLOG) {
+    qam16_llrs_maxlog(re, im, num_sym, n0, llr);
+  } else if (mode == LLR_MODE_MAXLOG_F32) {
+    qam16_llrs_f32(level, re, im, num_sym, n0, llr);
+  } else {
+    qam16_llrs_exact(re, im, num_sym, n0, llr);
+  }
+}
+
+void llr_soa(int mode, const double *re, const double *im, size_t num_sym,
+             int mod_order, double n0, double *llr) {
+  llr_soa_level(current_simd_level(), mode, re, im, num_sym, mod_order, n0, llr);
+}
+
+extern "C" int ber_set_llr_mode(int mode) {
+  if (mode != BER_LLR_EXACT && mode != BER_LLR_MAXLOG && mode != BER_LLR_MAXLOG_F32)
+    return -1;
+  g_llr_mode.store(mode, memory_order_relaxed);
+  return 0;
+}
+
+extern "C" int ber_get_llr_mode() { return current_llr_mode(); }
+
+// =============================================================================
+// SELF-TEST
+// =============================================================================
+//
+// Every supported vector variant must reproduce the scalar kernels bit for bit
+// (including signed zeros) for all modulations and for lengths that exercise
+// partial register groups and partial words. Received samples include the
+// exact decision thresholds, signed zeros, infinities and NaN.
+
+extern "C" int run_simd_kernel_test(char *err_msg) {
+  static const char *const names[] = {"scalar", "avx2", "avx512", "neon"};
+  constexpr size_t MAX_SYM = 1000;
+  constexpr size_t MAX_WORDS = (MAX_SYM * MAX_BITS_PER_SYMBOL + 63) / 64;
+
+  Xoshiro256pp gen(0x51D0ULL);
+  vector<uint64_t> tx(MAX_WORDS);
+  for (uint64_t &w : tx)
+    w = gen();
+  vector<double> rx_re(MAX_SYM), rx_im(MAX_SYM);
+  fill_normal_ziggurat(gen, rx_re.data(), MAX_SYM);
+  fill_normal_ziggurat(gen, rx_im.data(), MAX_SYM);
+  vector<double> noise(MAX_SYM);
+  fill_normal_ziggurat(gen, noise.data(), MAX_SYM);
+  const double t = 2.0 * scale_16qam;
+  const double specials[] = {0.0,
+                             -0.0,
+                             t,
+                             -t,
+                             std::nextafter(t, 0.0),
+                             std::nextafter(t, 1.0),
+                             std::nextafter(-t, 0.0),
+                             std::nextafter(-t, -1.0),
+                             -6.0 * M_SQRT42_INV,
+                             14.0 * M_SQRT170_INV,
+                             NAN,
+                             INFINITY,
+                             -INFINITY};
+  constexpr size_t NS = sizeof(specials) / sizeof(specials[0]);
+  for (size_t i = 0; i < NS * NS; ++i) {
+    rx_re[i] = specials[i % NS];
+    rx_im[i] = specials[i / NS];
+  }
+
+  vector<double> ref_re(MAX_SYM), ref_im(MAX_SYM), got_re(MAX_SYM),
+      got_im(MAX_SYM);
+  vector<uint64_t> ref_words(MAX_WORDS), got_words(MAX_WORDS);
+  const size_t lengths[] = {1, 2, 3, 5, 7, 8, 9, 15, 16, 17, 63, 64, 65, MAX_SYM};
+
+  // The dispatch table must route every order to its Modulator<M>: each
+  // point as Modulator<M>::point, unit mean energy, clean points sliced back
+  for (int m : modulation_orders) {
+    const int failed = with_modulator(m, [&](auto mod) {
+      using Mod = decltype(mod);
+      if (Mod::order != m || bits_per_symbol(m) != Mod::bits_per_sym || symbol_scale(m) != Mod::scale)
+        return 1;
+      double energy = 0.0;
+      for (unsigned b = 0; b < static_cast<unsigned>(m); ++b) {
+        const uint64_t word = b;
+        double re, im, want_re, want_im;
+        uint64_t back = ~uint64_t{0};
+        modulate_soa_level(SIMD_LEVEL_SCALAR, &word, 1, m, &re, &im);
+        demodulate_soa_level(SIMD_LEVEL_SCALAR, &re, &im, 1, m, &back);
+        Mod::point(b, want_re, want_im);
+        if (re != want_re || im != want_im || back != b)
+          return 1;
+        energy += re * re + im * im;
+      }
+      return std::abs(energy / m - 1.0) < 1e-12 ? 0 : 1;
+    });
+    if (failed) {
+      snprintf(err_msg, 256, "Modulator<%d> does not match the dispatched kernels", m);
+      return 1;
+    }
+  }
+
+  char tested[64] = "";
+  for (int level : {SIMD_LEVEL_AVX2, SIMD_LEVEL_AVX512, SIMD_LEVEL_NEON}) {
+    if (!simd_level_supported(level))
+      continue;
+    for (int m : modulation_orders) {
+      const size_t bits_per_sym = static_cast<size_t>(bits_per_symbol(m));
+      for (size_t n : lengths) {
+        modulate_soa_level(SIMD_LEVEL_SCALAR, tx.data(), n, m, ref_re.data(),
+                           ref_im.data());
+        modulate_soa_level(level, tx.data(), n, m, got_re.data(),
+                           got_im.data());
+        if (memcmp(ref_re.data(), got_re.data(), n * sizeof(double)) != 0 ||
+            memcmp(ref_im.data(), got_im.data(), n * sizeof(double)) != 0) {
+          snprintf(err_msg, 256, "%s modulate mismatch (mod %d, %zu symbols)",
+                   names[level], m, n);
+          return 1;
+        }
+        const size_t num_words = words_for_bits(n * bits_per_sym);
+        std::fill(got_words.begin(), got_words.end(), ~uint64_t{0});
+        demodulate_soa_level(SIMD_LEVEL_SCALAR, rx_re.data(), rx_im.data(), n,
+                             m, ref_words.data());
+        demodulate_soa_level(level, rx_re.data(), rx_im.data(), n, m,
+                             got_words.data());
+        if (!std::equal(ref_words.begin(), ref_words.begin() + num_words,
+                        got_words.begin())) {
+          snprintf(err_msg, 256,
+                   "%s demodulate mismatch (mod %d, %zu symbols)",
+                   names[level], m, n);
+          return 1;
+        }
+      }
+    }
+    for (size_t n : lengths) {
+      const double ref = sum_squares_level(SIMD_LEVEL_SCALAR, noise.data(), n);
+      const double got = sum_squares_level(level, noise.data(), n);
+      if (memcmp(&ref, &got, sizeof(double)) != 0) {
+        snprintf(err_msg, 256, "%s sum_squares mismatch (%zu values)",
+                 names[level], n);
+        return 1;
+      }
+    }
+    strcat(tested, " ");
+    strcat(tested, names[level]);
+  }
+
+  if (tested[0] == '\0')
+    snprintf(err_msg, 256, "No vector kernels on this CPU (scalar only)");
+  else
+    snprintf(err_msg, 256, "Vector kernels match scalar:%s (active: %s)",
+             tested, names[current_simd_level()]);
+  return 0;
+}
+
+// Max-log 16-QAM LLRs must equal the nearest-level metric difference computed
+// by brute force, track the exact LLRs where one level dominates, and the
+// float variants must agree with each other bit for bit and with the double
+// max-log to float precision.
+extern "C" int run_llr_engine_test(char *err_msg) {
+  constexpr size_t N = 1003; // Not a multiple of the vector width
+  Xoshiro256pp gen(0x11E5ULL);
+  vector<double> re(N), im(N);
+  fill_normal_ziggurat(gen, re.data(), N);
+  fill_normal_ziggurat(gen, im.data(), N);
+  for (size_t i = 0; i < N; ++i) { // Spread over (and past) the constellation
+    re[i] *= 4.0 * scale_16qam;
+    im[i] *= 4.0 * scale_16qam;
+  }
+  re[0] = 2.0 * scale_16qam; // Piece boundaries
+  re[1] = -2.0 * scale_16qam;
+  im[2] = 0.0;
+  const double n0 = 0.37;
+
+  vector<double> exact(4 * N), maxlog(4 * N), f32(4 * N), f32_ref(4 * N);
+  llr_soa_level(SIMD_LEVEL_SCALAR, LLR_MODE_EXACT, re.data(), im.data(), N, 16, n0, exact.data());
+  llr_soa_level(SIMD_LEVEL_SCALAR, LLR_MODE_MAXLOG, re.data(), im.data(), N, 16, n0, maxlog.data());
+  llr_soa_level(SIMD_LEVEL_SCALAR, LLR_MODE_MAXLOG_F32, re.data(), im.data(), N, 16, n0, f32_ref.data());
+
+  for (size_t i = 0; i < 4 * N; ++i) {
+    const double r = (i % 2 == 0 ? re[i / 4] : im[i / 4]) / scale_16qam;
+    const bool lsb = (i % 4) >= 2;
+    // Nearest level with bit = 0 vs bit = 1 (levels by index (msb<<1)|lsb)
+    double best[2] = {-1e300, -1e300};
+    for (int k = 0; k < 4; ++k) {
+      const int bit = lsb ? (k & 1) : (k >> 1);
+      const double d = r - qam_levels[k];
+      best[bit] = max(best[bit], -(d * d) / n0);
+    }
+    const double brute = best[1] - best[0];
+    if (abs(maxlog[i] - brute) > 1e-9 * (1.0 + abs(brute))) {
+      snprintf(err_msg, 256, "Max-log LLR %zu: %g vs brute force %g", i, maxlog[i], brute);
+      return 1;
+    }
+    // Max-log never overstates confidence and stays within ln 2 of exact
+    if (abs(maxlog[i]) > abs(exact[i]) + 1e-9 ||
+        abs(maxlog[i] - exact[i]) > log(2.0) + 1e-9) {
+      snprintf(err_msg, 256, "Max-log LLR %zu: %g too far from exact %g", i, maxlog[i], exact[i]);
+      return 1;
+    }
+    if (abs(f32_ref[i] - maxlog[i]) > 1e-5 * (1.0 + abs(maxlog[i])) * 4.0 / n0) {
+      snprintf(err_msg, 256, "Float LLR %zu: %g vs double %g", i, f32_ref[i], maxlog[i]);
+      return 1;
+    }
+  }
+
+  // 64/256-QAM: max-log in every mode, equal to the nearest-point metric
+  // difference over the whole 2-D constellation
+  for (int m : {64, 256}) {
+    const int failed = with_modulator(m, [&](auto mod) {
+      using Mod = decltype(mod);
+      constexpr int B = Mod::bits_per_sym;
+      vector<double> got(B * N);
+      for (int mode : {LLR_MODE_EXACT, LLR_MODE_MAXLOG, LLR_MODE_MAXLOG_F32}) {
+        llr_soa_level(SIMD_LEVEL_SCALAR, mode, re.data(), im.data(), N, m, n0, got.data());
+        for (size_t i = 0; i < N; ++i) {
+          double best[B][2];
+          for (auto &b : best)
+            b[0] = b[1] = INFINITY;
+          for (unsigned b = 0; b < static_cast<unsigned>(m); ++b) {
+            double pr, pi;
+            Mod::point(b, pr, pi);
+            const double dr = (re[i] - pr) * Mod::inv_scale, di = (im[i] - pi) * Mod::inv_scale;
+            for (int k = 0; k < B; ++k)
+              best[k][(b >> k) & 1u] = min(best[k][(b >> k) & 1u], dr * dr + di * di);
+          }
+          for (int k = 0; k < B; ++k) {
+            const double brute = (best[k][0] - best[k][1]) / n0;
+            if (abs(got[B * i + k] - brute) > 1e-6 * (1.0 + abs(brute)))
+              return 1;
+          }
+        }
+      }
+      return 0;
+    });
+    if (failed) {
+      snprintf(err_msg, 256, "%d-QAM max-log LLRs differ from brute force", m);
+      return 1;
+    }
+  }
+
+  for (int level : {SIMD_LEVEL_AVX2, SIMD_LEVEL_AVX512, SIMD_LEVEL_NEON}) {
+    if (!simd_level_supported(level))
+      continue;
+    llr_soa_level(level, LLR_MODE_MAXLOG_F32, re.data(), im.data(), N, 16, n0, f32.data());
+    if (f32 != f32_ref) {
+      snprintf(err_msg, 256, "Vector float LLRs differ from scalar (level %d)", level);
+      return 1;
+    }
+  }
+  snprintf(err_msg, 256, "Max-log and float LLR engines consistent with exact demapper");
+  return 0;
+}
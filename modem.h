@@ -0,0 +1,377 @@
+#ifndef MODEM_H
+#define MODEM_H
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// =============================================================================
+// CONSTELLATIONS
+// =============================================================================
+
+// Use mathematical constants (C++20 style but with fallback)
+constexpr double M_SQRT2_INV = 0.7071067811865476;   // 1.0 / sqrt(2.0)
+constexpr double M_SQRT10_INV = 0.31622776601683794; // 1.0 / sqrt(10.0)
+constexpr double scale_qpsk = M_SQRT2_INV;
+constexpr double scale_16qam = M_SQRT10_INV;
+
+// 16-QAM Gray mapping (per component, treated as a 4-PAM with Gray code)
+// Adjacent amplitude levels must differ by exactly one bit to minimize the
+// bit error impact of small symbol decision errors.
+// Conventional Gray-ordered amplitude sequence (from +3 to -3) is:
+//   +3   +1   -1   -3
+//  bits: 00   01   11   10   (each neighbor differs by 1 bit)
+// Our lookup uses the bit-pair (msb, lsb) combined as index = (msb<<1)|lsb.
+// Index enumeration order is therefore: 00, 01, 10, 11
+// To preserve the Gray relationships we intentionally store the table in this
+// index order (NOT in amplitude order). That means:
+//   index 0 (00) -> +3
+//   index 1 (01) -> +1
+//   index 2 (10) -> -3  (note: amplitude order would expect -1 here; this is
+//                        why the array looks "unsorted")
+//   index 3 (11) -> -1
+// This still implements the correct Gray mapping because demodulation maps the
+// quantized amplitude levels back to the same bit pairs:
+//   +3 -> 00, +1 -> 01, -1 -> 11, -3 -> 10
+// The apparent “out of order” placement of -3 and -1 in the lookup array is
+// deliberate and NOT a bug.
+constexpr std::array<double, 4> qam_levels = {3.0, 1.0, -3.0, -1.0};
+
+constexpr double get_level(bool msb, bool lsb) noexcept {
+  // Convert bool pair to index: 00->0, 01->1, 10->2, 11->3
+  const size_t index =
+      (static_cast<size_t>(msb) << 1) | static_cast<size_t>(lsb);
+  return qam_levels[index];
+}
+
+// Compile-time validation of Gray mapping
+static_assert(get_level(false, false) == 3.0, "16QAM Gray mapping error (00)");
+static_assert(get_level(false, true) == 1.0, "16QAM Gray mapping error (01)");
+static_assert(get_level(true, false) == -3.0, "16QAM Gray mapping error (10)");
+static_assert(get_level(true, true) == -1.0, "16QAM Gray mapping error (11)");
+
+constexpr double demod_level(double val) noexcept {
+  return (val > 2.0) ? 3.0 : (val > 0.0) ? 1.0 : (val > -2.0) ? -1.0 : -3.0;
+}
+
+// Host/device marker for code shared with the CUDA/HIP kernels (ber_gpu.cu)
+#if defined(__CUDACC__) || defined(__HIPCC__)
+#define BER_HD __host__ __device__
+#else
+#define BER_HD
+#endif
+
+// =============================================================================
+// MODULATOR TRAITS
+// =============================================================================
+//
+// Modulator<M> holds everything the kernels need to know about one
+// constellation as compile-time constants: bits per symbol, the Gray level of
+// each axis field, the unit-energy scale and the slicer thresholds. Every
+// kernel (scalar, SIMD, soft demapper, Philox) is instantiated once per order
+// from these, so the mapping is written down only here.
+//
+// Square M-QAM is an N-PAM per axis (N = sqrt(M); BPSK is a 2-PAM on I).
+// Symbol bits alternate between the axes: bit 2j is field bit j of I and bit
+// 2j + 1 field bit j of Q. Field bit 0 is the msb and gives the sign; the
+// remaining bits Gray-code the magnitude from the outermost level inwards, so
+// for 16-QAM the fields reproduce get_level and for 64/256-QAM the same rule
+// generates the 8- and 16-PAM tables. Levels are odd integers (level index
+// k holds 2k - (N - 1)), scaled to unit mean energy.
+
+// 1 / sqrt(42) and 1 / sqrt(170): unit-energy scales of 64- and 256-QAM
+constexpr double M_SQRT42_INV = 0.1543033499620919;
+constexpr double M_SQRT170_INV = 0.07669649888473704;
+
+template <int M> struct Modulator {
+  static_assert(M == 2 || M == 4 || M == 16 || M == 64 || M == 256,
+                "unsupported modulation order");
+  static constexpr int order = M;
+  static constexpr int bits_per_sym = std::countr_zero(static_cast<unsigned>(M));
+  static constexpr bool has_q = M != 2;
+  static constexpr int axis_bits = has_q ? bits_per_sym / 2 : 1;
+  static constexpr int axis_levels = 1 << axis_bits; // N
+  static constexpr double scale = M == 2    ? 1.0
+                                  : M == 4  ? scale_qpsk
+                                  : M == 16 ? scale_16qam
+                                  : M == 64 ? M_SQRT42_INV
+                                            : M_SQRT170_INV;
+  static constexpr double inv_scale = 1.0 / scale;
+  // Inner/outer slicer threshold of 16-QAM, in level units
+  static constexpr double threshold = 2.0;
+  // |level| * scale below which a level has a decision boundary on both sides
+  static constexpr double inner_limit = (axis_levels - 2) * scale;
+
+  // Symbol bits fed by the I axis
+  static constexpr unsigned make_i_mask() noexcept {
+    unsigned mask = 0;
+    for (int j = 0; j < axis_bits; ++j)
+      mask |= 1u << (has_q ? 2 * j : j);
+    return mask;
+  }
+  static constexpr unsigned i_mask = make_i_mask();
+
+  // Field of axis q (0 = I, 1 = Q) in symbol bits b, msb first
+  BER_HD static constexpr unsigned axis_field(unsigned b, int q) noexcept {
+    unsigned field = 0;
+    for (int j = 0; j < axis_bits; ++j)
+      field = field << 1 | ((b >> (has_q ? 2 * j + q : j)) & 1u);
+    return field;
+  }
+
+  // Symbol bits of an I field (shift left by one for Q)
+  BER_HD static constexpr unsigned field_symbol_bits(unsigned field) noexcept {
+    unsigned b = 0;
+    for (int j = 0; j < axis_bits; ++j)
+      b |= ((field >> (axis_bits - 1 - j)) & 1u) << (has_q ? 2 * j : j);
+    return b;
+  }
+
+  // Unscaled Gray level of a field
+  BER_HD static constexpr double level(unsigned field) noexcept {
+    if constexpr (axis_bits == 1) {
+      return field ? -1.0 : 1.0;
+    } else {
+      constexpr unsigned half = 1u << (axis_bits - 1); // Magnitudes per sign
+      unsigned rank = field & (half - 1u);             // Gray -> binary
+      for (unsigned shift = rank >> 1; shift; shift >>= 1)
+        rank ^= shift;
+      const double magnitude = 2.0 * static_cast<double>(half - 1u - rank) + 1.0;
+      return (field >> (axis_bits - 1)) ? -magnitude : magnitude;
+    }
+  }
+
+  // Field of level index k (level 2k - (N - 1)); inverse of level
+  BER_HD static constexpr unsigned index_field(unsigned k) noexcept {
+    if constexpr (axis_bits == 1) {
+      return k ? 0u : 1u;
+    } else {
+      constexpr unsigned half = 1u << (axis_bits - 1);
+      const bool negative = k < half;
+      const unsigned rank = half - 1u - (negative ? half - 1u - k : k - half);
+      return static_cast<unsigned>(negative) << (axis_bits - 1) | (rank ^ (rank >> 1));
+    }
+  }
+
+  // Multiply-and-clamp slicer: level index of x = r / scale, with the ties
+  // x = 2k - N going to the lower level. Written as compare-selects in this
+  // order so every SIMD variant (max/min/blend) and NaN (-> 0) agree bit for bit.
+  BER_HD static constexpr double slice_index(double x) noexcept {
+    double k = std::ceil((x + axis_levels) * 0.5) - 1.0;
+    k = k > 0.0 ? k : 0.0;
+    return k < axis_levels - 1.0 ? k : axis_levels - 1.0;
+  }
+
+  // Unit-energy constellation point of symbol bits b
+  BER_HD static constexpr void point(unsigned b, double &re, double &im) noexcept {
+    re = level(axis_field(b, 0)) * scale;
+    im = has_q ? level(axis_field(b, 1)) * scale : 0.0;
+  }
+
+  // Hard decision, right-aligned symbol bits. BPSK/QPSK slice at the axes
+  // (no de-scaling needed); 16-QAM slices x = r / scale with the same
+  // thresholds and tie rules as demod_level; 64/256-QAM use slice_index.
+  BER_HD static constexpr unsigned decide(double re, double im) noexcept {
+    if constexpr (M == 2) {
+      return static_cast<unsigned>(re < 0.0);
+    } else if constexpr (M == 4) {
+      return static_cast<unsigned>(re < 0.0) | static_cast<unsigned>(im < 0.0) << 1;
+    } else if constexpr (M == 16) {
+      const double x = re * inv_scale, y = im * inv_scale;
+      return static_cast<unsigned>(x <= 0.0) | static_cast<unsigned>(y <= 0.0) << 1 |
+             static_cast<unsigned>(x > -threshold && x <= threshold) << 2 |
+             static_cast<unsigned>(y > -threshold && y <= threshold) << 3;
+    } else {
+      const unsigned kx = static_cast<unsigned>(slice_index(re * inv_scale));
+      const unsigned ky = static_cast<unsigned>(slice_index(im * inv_scale));
+      return field_symbol_bits(index_field(kx)) | field_symbol_bits(index_field(ky)) << 1;
+    }
+  }
+
+  // Unscaled levels by field (the LUT of the soft demappers)
+  static constexpr std::array<double, axis_levels> make_levels() noexcept {
+    std::array<double, axis_levels> table{};
+    for (unsigned f = 0; f < axis_levels; ++f)
+      table[f] = level(f);
+    return table;
+  }
+  static constexpr std::array<double, axis_levels> levels = make_levels();
+
+  // I-axis symbol bits by level index (the slicer LUT)
+  static constexpr std::array<uint32_t, axis_levels> make_slice_bits() noexcept {
+    std::array<uint32_t, axis_levels> table{};
+    for (unsigned k = 0; k < axis_levels; ++k)
+      table[k] = field_symbol_bits(index_field(k));
+    return table;
+  }
+  static constexpr std::array<uint32_t, axis_levels> slice_bits = make_slice_bits();
+
+  // Scaled point by symbol bits (the mapper LUT)
+  struct PointTable {
+    std::array<double, M> re, im;
+  };
+  static constexpr PointTable make_points() noexcept {
+    PointTable table{};
+    for (unsigned b = 0; b < static_cast<unsigned>(M); ++b)
+      point(b, table.re[b], table.im[b]);
+    return table;
+  }
+  static constexpr PointTable points = make_points();
+};
+
+static_assert(Modulator<16>::levels == qam_levels, "16QAM field levels must match qam_levels");
+static_assert(Modulator<64>::levels == std::array<double, 8>{7, 5, 1, 3, -7, -5, -1, -3},
+              "8-PAM fields must Gray-code the magnitude");
+
+// Supported orders, in the order of the kernel dispatch tables
+constexpr std::array<int, 5> modulation_orders = {2, 4, 16, 64, 256};
+constexpr int MAX_BITS_PER_SYMBOL = Modulator<256>::bits_per_sym;
+
+// Dispatch-table index of mod_order, -1 if unsupported
+constexpr int modulation_index(int mod_order) noexcept {
+  for (size_t k = 0; k < modulation_orders.size(); ++k)
+    if (modulation_orders[k] == mod_order)
+      return static_cast<int>(k);
+  return -1;
+}
+
+// log2(mod_order), 0 for an unsupported order
+constexpr int bits_per_symbol(int mod_order) noexcept {
+  return modulation_index(mod_order) < 0
+             ? 0
+             : std::countr_zero(static_cast<unsigned>(mod_order));
+}
+
+// fn(Modulator<mod_order>{}) for a supported order
+template <typename Fn>
+constexpr decltype(auto) with_modulator(int mod_order, Fn &&fn) {
+  switch (mod_order) {
+  case 4:
+    return fn(Modulator<4>{});
+  case 16:
+    return fn(Modulator<16>{});
+  case 64:
+    return fn(Modulator<64>{});
+  case 256:
+    return fn(Modulator<256>{});
+  default:
+    return fn(Modulator<2>{});
+  }
+}
+
+// Unit-energy scale of a supported order (half the minimum distance)
+constexpr double symbol_scale(int mod_order) noexcept {
+  return with_modulator(mod_order, [](auto mod) { return decltype(mod)::scale; });
+}
+
+// =============================================================================
+// PACKED BIT KERNELS
+// =============================================================================
+// Bits are stored 64 per uint64_t word, LSB first: bit i lives in word i / 64
+// at position i % 64. Symbols are packed back to back: 1, 2, 4 and 8 bits
+// divide 64, but a 6-bit 64-QAM symbol may straddle two words.
+//
+// Symbols are kept as split real/imag (SoA) arrays so the kernels can work on
+// whole vector registers. Each kernel has a scalar, AVX2, AVX-512 and NEON
+// variant producing bit-identical output; the variant is chosen at run time
+// (best supported ISA by default, overridable with ber_set_simd_level).
+
+constexpr size_t words_for_bits(size_t num_bits) noexcept {
+  return (num_bits + 63) / 64;
+}
+
+// Number of differing bits among the first num_bits of two packed buffers
+[[nodiscard]] inline long long count_bit_errors(const uint64_t *a,
+                                                const uint64_t *b,
+                                                size_t num_bits) noexcept {
+  const size_t full = num_bits / 64;
+  long long errors = 0;
+  for (size_t w = 0; w < full; ++w)
+    errors += std::popcount(a[w] ^ b[w]);
+  if (const size_t tail = num_bits % 64) {
+    const uint64_t mask = (uint64_t{1} << tail) - 1;
+    errors += std::popcount((a[full] ^ b[full]) & mask);
+  }
+  return errors;
+}
+
+// Bits of symbol i, right-aligned
+template <int BitsPerSym>
+constexpr unsigned symbol_bits(const uint64_t *words, size_t i) noexcept {
+  const size_t bit = i * BitsPerSym;
+  const unsigned off = static_cast<unsigned>(bit & 63);
+  uint64_t v = words[bit >> 6] >> off;
+  if constexpr (64 % BitsPerSym != 0)
+    if (off > 64 - BitsPerSym)
+      v |= words[(bit >> 6) + 1] << (64 - off);
+  return static_cast<unsigned>(v) & ((1u << BitsPerSym) - 1u);
+}
+
+// Bits [bit, bit + width) of a packed buffer, right-aligned (width < 64)
+inline uint64_t packed_field(const uint64_t *words, size_t bit, int width) noexcept {
+  const unsigned off = static_cast<unsigned>(bit & 63);
+  uint64_t v = words[bit >> 6] >> off;
+  if (off + static_cast<unsigned>(width) > 64)
+    v |= words[(bit >> 6) + 1] << (64 - off);
+  return v & ((uint64_t{1} << width) - 1);
+}
+
+// Kernel variants (mirrored by the BER_SIMD_* constants in ber.h)
+constexpr int SIMD_LEVEL_SCALAR = 0;
+constexpr int SIMD_LEVEL_AVX2 = 1;
+constexpr int SIMD_LEVEL_AVX512 = 2;
+constexpr int SIMD_LEVEL_NEON = 3;
+
+// Variant used by modulate_soa / demodulate_soa
+int current_simd_level() noexcept;
+
+// True if this build and CPU can run the variant
+bool simd_level_supported(int level) noexcept;
+
+// Map the first num_sym symbols' bits to unit-energy constellation points
+void modulate_soa(const uint64_t *words, size_t num_sym, int mod_order,
+                  double *re, double *im) noexcept;
+
+// Hard-decision demodulation into packed words. Whole words are written; bits
+// past num_sym * bits_per_sym in the last word are zero.
+void demodulate_soa(const double *re, const double *im, size_t num_sym,
+                    int mod_order, uint64_t *words) noexcept;
+
+// Sum of x[i]^2 over n values, bit-identical across variants (fixed lane
+// order, no FMA)
+double sum_squares(const double *x, size_t n) noexcept;
+
+// Same, with an explicit variant (must be supported)
+void modulate_soa_level(int level, const uint64_t *words, size_t num_sym,
+                        int mod_order, double *re, double *im) noexcept;
+void demodulate_soa_level(int level, const double *re, const double *im,
+                          size_t num_sym, int mod_order,
+                          uint64_t *words) noexcept;
+double sum_squares_level(int level, const double *x, size_t n) noexcept;
+
+// =============================================================================
+// SOFT DEMAPPERS
+// =============================================================================
+
+// LLR engines (mirrored by the BER_LLR_* constants in ber.h)
+constexpr int LLR_MODE_EXACT = 0;      // 16-QAM log-sum-exp (reference)
+constexpr int LLR_MODE_MAXLOG = 1;     // 16-QAM closed-form max-log
+constexpr int LLR_MODE_MAXLOG_F32 = 2; // Max-log in float SIMD lanes
+
+// Mode selected with ber_set_llr_mode
+int current_llr_mode() noexcept;
+
+// Coded-bit LLRs of num_sym received symbols, bits_per_sym per symbol in
+// modulate_soa bit order; positive values favour bit 1. n0 is the noise power
+// per complex symbol. Only 16-QAM depends on the mode. For BPSK im may be
+// NULL.
+void llr_soa(int mode, const double *re, const double *im, size_t num_sym,
+             int mod_order, double n0, double *llr);
+
+// Same, with an explicit kernel variant (must be supported)
+void llr_soa_level(int level, int mode, const double *re, const double *im,
+                   size_t num_sym, int mod_order, double n0, double *llr);
+
+#endif // MODEM_H
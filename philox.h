@@ -0,0 +1,124 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+#include "modem.h"
+
+// =============================================================================
+// PHILOX4x32-10 COUNTER-BASED STREAMS
+// =============================================================================
+//
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+// 3") maps a 128-bit counter and a 64-bit key to 128 random bits with no
+// state, so any element of a stream can be computed on its own. The
+// BER_RNG_PHILOX engine uses it to make the uncoded chunk streams
+// addressable per symbol: with key = chunk seed,
+//   payload word w  -> half (w % 2) of philox({w / 2, stream 0}, key)
+//   normal pair p   -> Box-Muller on philox({p, stream 1}, key)
+// Tile layout does not matter, so a GPU thread can simulate symbol s of a
+// chunk directly (philox_symbol_errors) and get what the CPU tile loop gets.
+//
+// Everything here is header-only and marked BER_HD (modem.h) so the same
+// code compiles for the host and for CUDA/HIP devices (ber_gpu.cu).
+
+struct Philox4x32 {
+  uint32_t v[4];
+};
+
+// Ten rounds on a 128-bit counter with a 64-bit key (k0 = low word), as in
+// Random123's philox4x32_10
+BER_HD inline Philox4x32 philox4x32_10(Philox4x32 ctr, uint32_t k0,
+                                       uint32_t k1) noexcept {
+  constexpr uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+  constexpr uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+  for (int round = 0; round < 10; ++round) {
+    const uint64_t p0 = static_cast<uint64_t>(M0) * ctr.v[0];
+    const uint64_t p1 = static_cast<uint64_t>(M1) * ctr.v[2];
+    ctr = {{static_cast<uint32_t>(p1 >> 32) ^ ctr.v[1] ^ k0, static_cast<uint32_t>(p1),
+            static_cast<uint32_t>(p0 >> 32) ^ ctr.v[3] ^ k1, static_cast<uint32_t>(p0)}};
+    k0 += W0;
+    k1 += W1;
+  }
+  return ctr;
+}
+
+// Block `index` of sub-stream `stream` under `key`
+BER_HD inline Philox4x32 philox_block(uint64_t index, uint32_t stream,
+                                      uint64_t key) noexcept {
+  return philox4x32_10({{static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32),
+                         stream, 0u}},
+                       static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32));
+}
+
+constexpr uint32_t PHILOX_STREAM_BITS = 0;
+constexpr uint32_t PHILOX_STREAM_NOISE = 1;
+
+// Payload word w of the stream keyed by key
+BER_HD inline uint64_t philox_word(uint64_t key, uint64_t w) noexcept {
+  const Philox4x32 r = philox_block(w >> 1, PHILOX_STREAM_BITS, key);
+  return (w & 1) ? (r.v[2] | static_cast<uint64_t>(r.v[3]) << 32)
+                 : (r.v[0] | static_cast<uint64_t>(r.v[1]) << 32);
+}
+
+// Normals 2p and 2p + 1 of the stream (Box-Muller; u1 in (0, 1) with 53
+// bits, so |z| reaches ~8.6 and the 1e-12 tails are covered)
+BER_HD inline void philox_normal_pair(uint64_t key, uint64_t p, double &z0,
+                                      double &z1) noexcept {
+  const Philox4x32 r = philox_block(p, PHILOX_STREAM_NOISE, key);
+  const uint64_t a = r.v[0] | static_cast<uint64_t>(r.v[1]) << 32;
+  const uint64_t b = r.v[2] | static_cast<uint64_t>(r.v[3]) << 32;
+  constexpr double TWO_PI = 6.283185307179586;
+  const double u1 = (static_cast<double>(a >> 11) + 0.5) * 0x1.0p-53;
+  const double u2 = static_cast<double>(b >> 11) * 0x1.0p-53;
+  const double radius = sqrt(-2.0 * log(u1));
+  const double angle = TWO_PI * u2;
+  z0 = radius * cos(angle);
+  z1 = radius * sin(angle);
+}
+
+// Bit errors of symbol s of a chunk stream: the fused modulate + AWGN +
+// hard decision + popcount of one symbol, with the Modulator<M> mapping and
+// slicer modulate_soa/demodulate_soa use, in the same arithmetic order (so it
+// needs -ffp-contract=off / --fmad=false, as the CPU build uses)
+template <int M>
+BER_HD inline int philox_symbol_errors(uint64_t key, uint64_t s, double sigma) noexcept {
+  using Mod = Modulator<M>;
+  const uint64_t bit = s * static_cast<uint64_t>(Mod::bits_per_sym);
+  const unsigned off = static_cast<unsigned>(bit & 63);
+  uint64_t word = philox_word(key, bit >> 6) >> off;
+  if (off > 64 - Mod::bits_per_sym) // 64-QAM symbols may straddle two words
+    word |= philox_word(key, (bit >> 6) + 1) << (64 - off);
+  const unsigned b = static_cast<unsigned>(word) & ((1u << Mod::bits_per_sym) - 1u);
+  double z0, z1;
+  philox_normal_pair(key, s, z0, z1);
+  double re, im;
+  Mod::point(b, re, im);
+  const unsigned decision = Mod::decide(re + sigma * z0, im + sigma * z1);
+#if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__)
+  return __popc(b ^ decision);
+#else
+  return std::popcount(b ^ decision);
+#endif
+}
+
+// Same, for a runtime bits per symbol (1, 2, 4, 6 or 8)
+BER_HD inline int philox_symbol_errors(uint64_t key, uint64_t s, int bits_per_sym,
+                                       double sigma) noexcept {
+  switch (bits_per_sym) {
+  case 1:
+    return philox_symbol_errors<2>(key, s, sigma);
+  case 2:
+    return philox_symbol_errors<4>(key, s, sigma);
+  case 6:
+    return philox_symbol_errors<64>(key, s, sigma);
+  case 8:
+    return philox_symbol_errors<256>(key, s, sigma);
+  default:
+    return philox_symbol_errors<16>(key, s, sigma);
+  }
+}
+
+#endif // PHILOX_H
@@ -1,6 +1,8 @@
 import ctypes
 import argparse
 import csv
+import math
+import random
 import sys
 import time
 from pathlib import Path
@@ -21,6 +23,121 @@ if _seeded_func is not None:
     HAS_SEEDED = True
 else:
     HAS_SEEDED = False
+# Multithreaded deterministic version (may not exist in older builds)
+_parallel_func = getattr(lib, 'compute_ber_parallel', None)
+if _parallel_func is not None:
+    _parallel_func.argtypes = [ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_ulonglong, ctypes.c_int]
+    _parallel_func.restype = ctypes.c_double
+    HAS_PARALLEL = True
+else:
+    HAS_PARALLEL = False
+# Whole-curve sweep (may not exist in older builds)
+_sweep_func = getattr(lib, 'compute_ber_sweep', None)
+if _sweep_func is not None:
+    _sweep_func.argtypes = [ctypes.c_int, ctypes.POINTER(ctypes.c_double), ctypes.c_int, ctypes.c_longlong,
+                            ctypes.c_ulonglong, ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_longlong)]
+    _sweep_func.restype = ctypes.c_int
+    HAS_SWEEP = True
+else:
+    HAS_SWEEP = False
+# Early-terminating BER (may not exist in older builds)
+class BerUntilStats(ctypes.Structure):
+    _fields_ = [('ber', ctypes.c_double), ('ci_low', ctypes.c_double), ('ci_high', ctypes.c_double),
+                ('errors', ctypes.c_longlong), ('bits', ctypes.c_longlong), ('stop_reason', ctypes.c_int)]
+
+_until_func = getattr(lib, 'compute_ber_until', None)
+if _until_func is not None:
+    _until_func.argtypes = [ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_longlong,
+                            ctypes.c_double, ctypes.c_ulonglong, ctypes.POINTER(BerUntilStats)]
+    _until_func.restype = ctypes.c_int
+    HAS_UNTIL = True
+else:
+    HAS_UNTIL = False
+# Native AMC threshold search (may not exist in older builds)
+_thresh_func = getattr(lib, 'find_amc_thresholds', None)
+if _thresh_func is not None:
+    _thresh_func.argtypes = [ctypes.c_double, ctypes.c_longlong, ctypes.c_double, ctypes.c_ulonglong,
+                             ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double),
+                             ctypes.POINTER(ctypes.c_longlong)]
+    _thresh_func.restype = ctypes.c_int
+    HAS_THRESH = True
+else:
+    HAS_THRESH = False
+# Native AMC link loop (may not exist in older builds)
+AMC_MODES = ('NONE', 'QPSK', '16QAM')
+class BerLinkStats(ctypes.Structure):
+    _fields_ = [('frames', ctypes.c_longlong), ('mode_frames', ctypes.c_longlong * len(AMC_MODES)),
+                ('bits', ctypes.c_longlong), ('errors', ctypes.c_longlong), ('ber', ctypes.c_double),
+                ('spectral_efficiency', ctypes.c_double), ('goodput', ctypes.c_double),
+                ('mean_est_error_db', ctypes.c_double)]
+
+_link_func = getattr(lib, 'run_amc_link', None)
+if _link_func is not None:
+    _link_func.argtypes = [ctypes.c_longlong, ctypes.c_longlong, ctypes.c_longlong,
+                           ctypes.POINTER(ctypes.c_double), ctypes.c_longlong, ctypes.c_double,
+                           ctypes.c_double, ctypes.c_ulonglong, ctypes.c_int, ctypes.POINTER(BerLinkStats)]
+    _link_func.restype = ctypes.c_int
+    HAS_LINK = True
+else:
+    HAS_LINK = False
+# Importance-sampling BER (may not exist in older builds)
+class BerIsStats(ctypes.Structure):
+    _fields_ = [('ber', ctypes.c_double), ('std_err', ctypes.c_double), ('ci_low', ctypes.c_double),
+                ('ci_high', ctypes.c_double), ('symbols', ctypes.c_longlong), ('hits', ctypes.c_longlong)]
+
+_is_func = getattr(lib, 'compute_ber_is', None)
+if _is_func is not None:
+    _is_func.argtypes = [ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_ulonglong,
+                         ctypes.POINTER(BerIsStats)]
+    _is_func.restype = ctypes.c_int
+    HAS_IS = True
+else:
+    HAS_IS = False
+# Noise engine selection (may not exist in older builds)
+_set_rng_func = getattr(lib, 'ber_set_rng_engine', None)
+if _set_rng_func is not None:
+    _set_rng_func.argtypes = [ctypes.c_int]
+    _set_rng_func.restype = ctypes.c_int
+RNG_ENGINES = {'std': 0, 'fast': 1, 'philox': 2}
+# Execution backend (may not exist in older builds; GPU needs make shared GPU=cuda|hip)
+_set_backend_func = getattr(lib, 'ber_set_backend', None)
+if _set_backend_func is not None:
+    _set_backend_func.argtypes = [ctypes.c_int]
+    _set_backend_func.restype = ctypes.c_int
+BER_BACKEND_CPU, BER_BACKEND_GPU = 0, 1
+# Fading channel of the uncoded paths (may not exist in older builds)
+class BerChannel(ctypes.Structure):
+    _fields_ = [('model', ctypes.c_int), ('doppler', ctypes.c_double),
+                ('block_symbols', ctypes.c_longlong), ('k_factor', ctypes.c_double)]
+
+_set_channel_func = getattr(lib, 'ber_set_channel', None)
+if _set_channel_func is not None:
+    _set_channel_func.argtypes = [ctypes.POINTER(BerChannel)]
+    _set_channel_func.restype = ctypes.c_int
+CHANNELS = {'awgn': 0, 'block': 1, 'jakes': 2}
+
+# Hot-path instrumentation (may not exist in older builds; counters stay
+# zero unless ber.so was built with STATS=1)
+BER_STAGE_COUNT = 9
+class BerStageStats(ctypes.Structure):
+    _fields_ = [('ns', ctypes.c_ulonglong), ('cycles', ctypes.c_ulonglong), ('calls', ctypes.c_ulonglong),
+                ('bytes', ctypes.c_ulonglong)]
+
+class BerStats(ctypes.Structure):
+    _fields_ = [('stage', BerStageStats * BER_STAGE_COUNT), ('allocs', ctypes.c_ulonglong),
+                ('alloc_bytes', ctypes.c_ulonglong), ('enabled', ctypes.c_int)]
+
+_stats_func = getattr(lib, 'ber_stats_snapshot', None)
+if _stats_func is not None:
+    _stats_func.argtypes = [ctypes.POINTER(BerStats)]
+    _stats_func.restype = ctypes.c_int
+    lib.ber_stats_reset.argtypes = []
+    lib.ber_stats_reset.restype = None
+    lib.ber_stats_stage_name.argtypes = [ctypes.c_int]
+    lib.ber_stats_stage_name.restype = ctypes.c_char_p
+    HAS_STATS = True
+else:
+    HAS_STATS = False
 
 lib.estimate_snr.argtypes = [ctypes.c_double, ctypes.c_longlong]
 lib.estimate_snr.restype = ctypes.c_double
@@ -28,6 +145,120 @@ lib.estimate_snr.restype = ctypes.c_double
 # Setup coding functions
 lib.compute_ber_coded.argtypes = [ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_int]
 lib.compute_ber_coded.restype = ctypes.c_double
+# Punctured code rates (may not exist in older builds)
+CODE_RATES = {'1/2': 0, '2/3': 1, '3/4': 2}
+_rate_func = getattr(lib, 'compute_ber_coded_rate', None)
+if _rate_func is not None:
+    _rate_func.argtypes = [ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_int, ctypes.c_int]
+    _rate_func.restype = ctypes.c_double
+    HAS_RATES = True
+else:
+    HAS_RATES = False
+# Batch API over caller-owned arrays (may not exist in older builds)
+BER_BATCH_UNCODED = -1
+_batch_func = getattr(lib, 'compute_ber_batch', None)
+if _batch_func is not None:
+    _batch_func.argtypes = [ctypes.c_int, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p,
+                            ctypes.c_int, ctypes.c_int, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p]
+    _batch_func.restype = ctypes.c_int
+    HAS_BATCH = True
+else:
+    HAS_BATCH = False
+# Persistent result cache behind the batch API (may not exist in older builds)
+class BerCacheStats(ctypes.Structure):
+    _fields_ = [('hits', ctypes.c_longlong), ('extended', ctypes.c_longlong),
+                ('misses', ctypes.c_longlong), ('records', ctypes.c_longlong)]
+
+_cache_open_func = getattr(lib, 'ber_cache_open', None)
+if _cache_open_func is not None:
+    _cache_open_func.argtypes = [ctypes.c_char_p]
+    _cache_open_func.restype = ctypes.c_int
+    lib.ber_cache_stats.argtypes = [ctypes.POINTER(BerCacheStats)]
+    lib.ber_cache_stats.restype = ctypes.c_int
+    HAS_CACHE = True
+else:
+    HAS_CACHE = False
+# Work-stealing job API for early-terminating grids (may not exist in older builds)
+class BerPoint(ctypes.Structure):
+    _fields_ = [('mod_order', ctypes.c_int), ('snr_db', ctypes.c_double), ('max_bits', ctypes.c_longlong),
+                ('min_errors', ctypes.c_longlong), ('rel_ci', ctypes.c_double), ('seed', ctypes.c_ulonglong)]
+
+_submit_func = getattr(lib, 'ber_submit_jobs', None)
+if _submit_func is not None:
+    _submit_func.argtypes = [ctypes.POINTER(BerPoint), ctypes.c_int]
+    _submit_func.restype = ctypes.c_void_p
+    lib.ber_wait.argtypes = [ctypes.c_void_p, ctypes.POINTER(BerUntilStats)]
+    lib.ber_wait.restype = ctypes.c_int
+    HAS_JOBS = True
+else:
+    HAS_JOBS = False
+# Asynchronous single-point jobs with progress and cancellation (may not exist in older builds)
+class BerJobParams(ctypes.Structure):
+    _fields_ = [('mod_order', ctypes.c_int), ('snr_db', ctypes.c_double), ('num_bits', ctypes.c_longlong),
+                ('seed', ctypes.c_ulonglong), ('code_rate', ctypes.c_int)]
+
+class BerJobProgress(ctypes.Structure):
+    _fields_ = [('bits_done', ctypes.c_longlong), ('bits_total', ctypes.c_longlong),
+                ('errors', ctypes.c_longlong)]
+
+BER_JOB_RUNNING, BER_JOB_DONE, BER_JOB_CANCELLED, BER_JOB_FAILED = 0, 1, 2, 3
+_job_start_func = getattr(lib, 'ber_job_start', None)
+if _job_start_func is not None:
+    _job_start_func.argtypes = [ctypes.POINTER(BerJobParams), ctypes.c_void_p, ctypes.c_void_p]
+    _job_start_func.restype = ctypes.c_void_p
+    lib.ber_job_poll.argtypes = [ctypes.c_void_p, ctypes.POINTER(BerJobProgress)]
+    lib.ber_job_poll.restype = ctypes.c_int
+    lib.ber_job_cancel.argtypes = [ctypes.c_void_p]
+    lib.ber_job_cancel.restype = ctypes.c_int
+    lib.ber_job_result.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_double),
+                                   ctypes.POINTER(ctypes.c_longlong), ctypes.POINTER(ctypes.c_longlong)]
+    lib.ber_job_result.restype = ctypes.c_int
+    HAS_ASYNC = True
+else:
+    HAS_ASYNC = False
+# Checkpointable accumulators for long sweeps (may not exist in older builds)
+class BerAccum(ctypes.Structure):
+    _fields_ = [('mod_order', ctypes.c_int), ('rng_engine', ctypes.c_int), ('snr_db', ctypes.c_double),
+                ('seed', ctypes.c_ulonglong), ('num_bits', ctypes.c_longlong), ('chunk_begin', ctypes.c_longlong),
+                ('chunk_end', ctypes.c_longlong), ('next_chunk', ctypes.c_longlong),
+                ('errors', ctypes.c_longlong), ('bits', ctypes.c_longlong)]
+
+BER_ACCUM_BLOB_BYTES = 96
+_accum_init_func = getattr(lib, 'ber_accum_init', None)
+if _accum_init_func is not None:
+    _accum_init_func.argtypes = [ctypes.POINTER(BerAccum), ctypes.c_int, ctypes.c_double, ctypes.c_longlong,
+                                 ctypes.c_ulonglong]
+    _accum_init_func.restype = ctypes.c_int
+    lib.ber_accum_advance.argtypes = [ctypes.POINTER(BerAccum), ctypes.c_longlong, ctypes.c_int]
+    lib.ber_accum_advance.restype = ctypes.c_longlong
+    lib.ber_accum_ber.argtypes = [ctypes.POINTER(BerAccum)]
+    lib.ber_accum_ber.restype = ctypes.c_double
+    lib.ber_accum_save.argtypes = [ctypes.POINTER(BerAccum), ctypes.c_void_p, ctypes.c_int]
+    lib.ber_accum_save.restype = ctypes.c_int
+    lib.ber_accum_load.argtypes = [ctypes.POINTER(BerAccum), ctypes.c_void_p, ctypes.c_int]
+    lib.ber_accum_load.restype = ctypes.c_int
+    HAS_ACCUM = True
+else:
+    HAS_ACCUM = False
+# Batched pilot SNR estimator (may not exist in older builds)
+_snr_batch_func = getattr(lib, 'estimate_snr_batch', None)
+if _snr_batch_func is not None:
+    _snr_batch_func.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_longlong, ctypes.c_longlong,
+                                ctypes.c_ulonglong, ctypes.c_void_p, ctypes.c_void_p]
+    _snr_batch_func.restype = ctypes.c_int
+    HAS_SNR_BATCH = True
+else:
+    HAS_SNR_BATCH = False
+# Reusable workspace arena (may not exist in older builds)
+_ws_create = getattr(lib, 'ber_workspace_create', None)
+if _ws_create is not None:
+    _ws_create.argtypes = []
+    _ws_create.restype = ctypes.c_void_p
+    lib.estimate_snr_ws.argtypes = [ctypes.c_void_p, ctypes.c_double, ctypes.c_longlong]
+    lib.estimate_snr_ws.restype = ctypes.c_double
+    _workspace = _ws_create()  # Lives as long as the process
+else:
+    _workspace = None
 lib.test_convolutional_coding.argtypes = []
 lib.test_convolutional_coding.restype = ctypes.c_int
 lib.estimate_coding_gain_db.argtypes = []
@@ -46,16 +277,168 @@ def theor_ber_16qam(ebno_db):
     # Correct 16-QAM BER formula matching our simulation
     return 0.375 * sp.erfc(np.sqrt(0.4 * ebno_lin))
 
-THEOR_FUN = {2: theor_ber_bpsk_qpsk, 4: theor_ber_bpsk_qpsk, 16: theor_ber_16qam}
+def theor_ber_square_qam(mod_order):
+    """Exact Gray square M-QAM BER: per-axis N-PAM, enumerated over the sent
+    level and the decision cell it lands in (weighted by Hamming distance)"""
+    k = int(math.log2(mod_order))
+    n = math.isqrt(mod_order)
+    gray = [i ^ (i >> 1) for i in range(n)]
+
+    def theor(ebno_db):
+        x = np.sqrt(3 * k * 10 ** (ebno_db / 10) / (mod_order - 1))
+        errors = 0.0
+        for i in range(n):
+            level = 2 * i - (n - 1)
+            for j in range(n):
+                if j == i:
+                    continue
+                lo = 1.0 if j == 0 else qfunc((2 * j - n - level) * x)
+                hi = 0.0 if j == n - 1 else qfunc((2 * j - n + 2 - level) * x)
+                errors = errors + (lo - hi) * bin(gray[i] ^ gray[j]).count('1')
+        return errors / (n * k / 2)
+    return theor
+
+THEOR_FUN = {2: theor_ber_bpsk_qpsk, 4: theor_ber_bpsk_qpsk, 16: theor_ber_16qam,
+             64: theor_ber_square_qam(64), 256: theor_ber_square_qam(256)}
 
 # Simulation wrappers
-def simulate_ber(mod, snr_db, bits, runs=1, seed=None, coding=False):
+def simulate_ber_batch(mods, snrs, bits, seeds, code_rate=None, threads=0):
+    """One library call for a whole set of (mod, snr, bits, seed) jobs.
+
+    Inputs are anything NumPy can broadcast to a common 1-D shape; arrays that
+    already have the right dtype are passed without copying. code_rate is None
+    for uncoded jobs or a CODE_RATES key. Returns (ber, errors, bits) arrays,
+    negative BERs being the scalar call's error codes, or None if the library
+    has no batch API or rejects the arguments.
+    """
+    if not HAS_BATCH:
+        return None
+    mods, snrs, bits, seeds = np.broadcast_arrays(np.asarray(mods, dtype=np.int32), np.asarray(snrs, dtype=np.float64),
+                                                  np.asarray(bits, dtype=np.int64), np.asarray(seeds, dtype=np.uint64))
+    mods, snrs, bits, seeds = (np.ascontiguousarray(a.ravel()) for a in (mods, snrs, bits, seeds))
+    n = mods.size
+    out_ber = np.empty(n, dtype=np.float64)
+    out_errors = np.empty(n, dtype=np.int64)
+    out_bits = np.empty(n, dtype=np.int64)
+    rate = BER_BATCH_UNCODED if code_rate is None else CODE_RATES[code_rate]
+    if lib.compute_ber_batch(n, mods.ctypes.data, snrs.ctypes.data, bits.ctypes.data, seeds.ctypes.data, rate,
+                             threads, out_ber.ctypes.data, out_errors.ctypes.data, out_bits.ctypes.data) < 0:
+        return None
+    return out_ber, out_errors, out_bits
+
+def simulate_ber_points(mod, snrs, bits, runs=1, seed=None, coding=False, threads=0, code_rate='1/2'):
+    """simulate_ber for every SNR point with a single batch call.
+
+    Per-run seeds follow simulate_ber (coded runs keep seed 1), so seeded
+    results are identical to the per-point path. A point whose runs fail gets
+    the first error code. Returns None if the batch API is unavailable.
+    """
+    if not HAS_BATCH:
+        return None
+    n_pts = len(snrs)
     if coding:
-        # Use coded BER function
-        vals = [lib.compute_ber_coded(mod, snr_db, bits, 1) for _ in range(runs)]
+        seeds = [1] * runs
+    else:
+        base = (seed if seed is not None else random.getrandbits(64)) & 0xFFFFFFFFFFFFFFFF
+        seeds = [(base + i * 997) & 0xFFFFFFFFFFFFFFFF for i in range(runs)]
+    # Job p * runs + i is run i of point p
+    result = simulate_ber_batch(mod, np.repeat(np.asarray(snrs, dtype=np.float64), runs), bits,
+                                np.tile(np.array(seeds, dtype=np.uint64), n_pts),
+                                code_rate=code_rate if coding else None, threads=threads)
+    if result is None:
+        return None
+    out = []
+    for p in range(n_pts):
+        vals = result[0][p * runs:(p + 1) * runs].tolist()
+        errs = [v for v in vals if v < 0]
+        out.append(errs[0] if errs else sum(vals) / len(vals))
+    return out
+
+def simulate_ber_async(mods, snrs, bits, runs=1, seed=None, coding=False, code_rate='1/2', quiet=False,
+                       poll_s=0.1):
+    """simulate_ber_points for several modulations, as asynchronous library jobs.
+
+    Every (mod, snr, run) job is in flight at once on the library's pool while
+    Python polls them and prints a progress line. Ctrl-C cancels the jobs
+    still running; points that did not finish come back as NaN. Seeds follow
+    simulate_ber_points, so finished points are identical to it. Returns
+    {mod: curve}, or None if the library has no job API.
+    """
+    if not HAS_ASYNC:
+        return None
+    if coding:
+        seeds = [1] * runs
+        rate = CODE_RATES[code_rate] if HAS_RATES else CODE_RATES['1/2']
+    else:
+        base = (seed if seed is not None else random.getrandbits(64)) & 0xFFFFFFFFFFFFFFFF
+        seeds = [(base + i * 997) & 0xFFFFFFFFFFFFFFFF for i in range(runs)]
+        rate = BER_BATCH_UNCODED
+    keys = [(m, p) for m in mods for p in range(len(snrs))]
+    jobs = [lib.ber_job_start(ctypes.byref(BerJobParams(m, float(snrs[p]), bits, s, rate)), None, None)
+            for m, p in keys for s in seeds]
+    progress = BerJobProgress()
+    try:
+        while True:
+            running = done = total = 0
+            for job in jobs:
+                if job:
+                    running += lib.ber_job_poll(job, ctypes.byref(progress)) == BER_JOB_RUNNING
+                    done += progress.bits_done
+                    total += progress.bits_total
+            if not quiet:
+                print(f"\r{'Coded' if coding else 'Uncoded'} jobs: {len(jobs) - running}/{len(jobs)} done, "
+                      f"{100.0 * done / max(total, 1):5.1f}% of bits", end='', flush=True)
+            if not running:
+                break
+            time.sleep(poll_s)
+    except KeyboardInterrupt:
+        for job in jobs:
+            if job:
+                lib.ber_job_cancel(job)
+        if not quiet:
+            print("\nInterrupted: cancelling the jobs still running", end='')
+    if not quiet:
+        print()
+    ber = ctypes.c_double()
+    curves = {m: [] for m in mods}
+    for k, (m, p) in enumerate(keys):
+        vals = []
+        for job in jobs[k * runs:(k + 1) * runs]:
+            if not job:  # Rejected parameters
+                vals.append(-1.0)
+                continue
+            state = lib.ber_job_result(job, ctypes.byref(ber), None, None)
+            vals.append(math.nan if state == BER_JOB_CANCELLED else ber.value)
+        errs = [v for v in vals if v < 0]
+        curves[m].append(errs[0] if errs else sum(vals) / len(vals))
+    return curves
+
+def simulate_ber(mod, snr_db, bits, runs=1, seed=None, coding=False, threads=1, code_rate='1/2'):
+    # All runs in one call when the library has the batch API
+    points = simulate_ber_points(mod, [snr_db], bits, runs=runs, seed=seed, coding=coding,
+                                 threads=threads, code_rate=code_rate)
+    if points is not None:
+        return points[0]
+    if coding:
+        # Use coded BER function (punctured rates need compute_ber_coded_rate)
+        if code_rate != '1/2' and HAS_RATES:
+            vals = [lib.compute_ber_coded_rate(mod, snr_db, bits, 1, CODE_RATES[code_rate]) for _ in range(runs)]
+        else:
+            vals = [lib.compute_ber_coded(mod, snr_db, bits, 1) for _ in range(runs)]
         if any(v < 0 for v in vals):
             return vals[0]  # Return error code
         return sum(vals) / len(vals)
+    elif threads != 1 and HAS_PARALLEL:
+        # Chunked multithreaded kernel; unseeded runs draw a fresh base seed
+        base = (seed if seed is not None else random.getrandbits(64)) & 0xFFFFFFFFFFFFFFFF
+        vals = []
+        for i in range(runs):
+            run_seed = (base + i * 997) & 0xFFFFFFFFFFFFFFFF
+            val = lib.compute_ber_parallel(mod, snr_db, bits, run_seed, threads)
+            if val < 0:
+                return val  # Error
+            vals.append(val)
+        return sum(vals) / len(vals)
     elif seed is not None and HAS_SEEDED:
         # Derive per-run seeds for reproducibility but variation
         base = seed & 0xFFFFFFFFFFFFFFFF
@@ -73,20 +456,216 @@ def simulate_ber(mod, snr_db, bits, runs=1, seed=None, coding=False):
             return vals[0]  # Return error code
         return sum(vals) / len(vals)
 
+def simulate_ber_curve(mod, snrs, bits, runs=1, seed=None):
+    """Uncoded BER for every SNR point in one C++ call per run.
+
+    Per-run seeds follow simulate_ber, so seeded curves match the per-point
+    path exactly. Returns None if the library has no sweep or rejects the input.
+    """
+    if not HAS_SWEEP:
+        return None
+    n = len(snrs)
+    snr_arr = (ctypes.c_double * n)(*[float(s) for s in snrs])
+    out = (ctypes.c_double * n)()
+    base = (seed if seed is not None else random.getrandbits(64)) & 0xFFFFFFFFFFFFFFFF
+    totals = [0.0] * n
+    for i in range(runs):
+        run_seed = (base + i * 997) & 0xFFFFFFFFFFFFFFFF
+        if lib.compute_ber_sweep(mod, snr_arr, n, bits, run_seed, out, None) != 0:
+            return None
+        totals = [t + v for t, v in zip(totals, out)]
+    return [t / runs for t in totals]
+
+def stats_snapshot():
+    """Library stage counters (BerStats), or None if the library has none."""
+    if not HAS_STATS:
+        return None
+    stats = BerStats()
+    lib.ber_stats_snapshot(ctypes.byref(stats))
+    return stats
+
+def print_profile(stats, elapsed):
+    """Per-stage time table from a stats_snapshot(); stage times are summed over threads."""
+    if stats is None or not stats.enabled:
+        print("Profile unavailable: rebuild with 'make shared STATS=1'")
+        return
+    total_ns = sum(st.ns for st in stats.stage) or 1
+    print(f"\nStage profile (wall {elapsed:.2f} s; stage times summed over threads)")
+    print(f"{'stage':>12} {'calls':>9} {'time_ms':>10} {'share':>7} {'cyc/call':>10} {'MB_out':>9}")
+    for k, st in enumerate(stats.stage):
+        if st.calls == 0:
+            continue
+        name = lib.ber_stats_stage_name(k).decode()
+        print(f"{name:>12} {st.calls:9d} {st.ns / 1e6:10.1f} {100.0 * st.ns / total_ns:6.1f}% "
+              f"{st.cycles / st.calls:10.0f} {st.bytes / 1e6:9.1f}")
+    print(f"{'allocations':>12} {stats.allocs:9d} {'':>10} {'':>7} {'':>10} {stats.alloc_bytes / 1e6:9.1f}")
+
+def simulate_snr_curve(snrs, pilots, runs=5, seed=None):
+    """Mean pilot SNR estimate per point from one estimate_snr_batch call.
+
+    Returns (mean, std) arrays in dB, or None if the library has no batch
+    estimator or rejects the arguments.
+    """
+    if not HAS_SNR_BATCH:
+        return None
+    snrs = np.ascontiguousarray(np.asarray(snrs, dtype=np.float64).ravel())
+    mean = np.empty(snrs.size, dtype=np.float64)
+    std = np.empty(snrs.size, dtype=np.float64)
+    run_seed = (seed if seed is not None else random.getrandbits(64)) & 0xFFFFFFFFFFFFFFFF
+    if lib.estimate_snr_batch(snrs.ctypes.data, snrs.size, pilots, runs, run_seed,
+                              mean.ctypes.data, std.ctypes.data) != 0:
+        return None
+    return mean, std
+
 def simulate_snr(true_snr_db, pilots, runs=5):
+    # The workspace keeps the pilot buffers between calls
+    if _workspace:
+        return float(np.mean([lib.estimate_snr_ws(_workspace, true_snr_db, pilots) for _ in range(runs)]))
     return float(np.mean([lib.estimate_snr(true_snr_db, pilots) for _ in range(runs)]))
 
+def simulate_ber_until(mod, snr_db, max_bits, min_errors=100, rel_ci=0.0, seed=None):
+    """Native early-terminating BER; returns BerUntilStats or None if unavailable."""
+    if not HAS_UNTIL:
+        return None
+    stats = BerUntilStats()
+    run_seed = (seed if seed is not None else random.getrandbits(64)) & 0xFFFFFFFFFFFFFFFF
+    if lib.compute_ber_until(mod, snr_db, min_errors, max_bits, rel_ci, run_seed, ctypes.byref(stats)) != 0:
+        return None
+    return stats
+
+def simulate_ber_grid(mods, snrs, max_bits, runs=1, min_errors=100, rel_ci=0.0, seed=None):
+    """Early-terminating BER for the whole mods x SNR x runs grid in one job.
+
+    The library schedules every point's chunks on its work-stealing pool, so
+    cheap low-SNR points do not hold workers hostage. Run i uses seed
+    base + i * 997 as in simulate_ber. Returns {mod: [mean BER per SNR]} or
+    None if the job API is unavailable or rejects a point.
+    """
+    if not HAS_JOBS:
+        return None
+    base = (seed if seed is not None else random.getrandbits(64)) & 0xFFFFFFFFFFFFFFFF
+    grid = [(m, float(s), i) for m in mods for s in snrs for i in range(runs)]
+    points = (BerPoint * len(grid))(*[BerPoint(m, s, max_bits, min_errors, rel_ci, (base + i * 997) & 0xFFFFFFFFFFFFFFFF)
+                                      for m, s, i in grid])
+    job = lib.ber_submit_jobs(points, len(grid))
+    if not job:
+        return None
+    stats = (BerUntilStats * len(grid))()
+    if lib.ber_wait(job, stats) != 0:
+        return None
+    out = {m: [] for m in mods}
+    for k in range(0, len(grid), runs):
+        out[grid[k][0]].append(sum(st.ber for st in stats[k:k + runs]) / runs)
+    return out
+
+def simulate_ber_checkpointed(mods, snrs, bits, path, runs=1, seed=None, threads=0, every=32):
+    """Uncoded mods x SNR x runs grid that survives being killed.
+
+    Every point is a ber_accum_t; their blobs are kept in path (grid order)
+    and rewritten atomically after each `every` chunks of work, so rerunning
+    the same command resumes from the last checkpoint. Run i uses seed
+    base + i * 997 as in simulate_ber (a resumed file keeps its own seeds), and
+    every point equals its uninterrupted compute_ber_seeded run. Returns
+    {mod: [mean BER per SNR]}, or None if the accumulator API is unavailable.
+    Raises ValueError for a checkpoint written for a different grid.
+    """
+    if not HAS_ACCUM:
+        return None
+    grid = [(m, float(s), i) for m in mods for s in snrs for i in range(runs)]
+    accs = (BerAccum * len(grid))()
+    path = Path(path)
+    blobs = (ctypes.c_ubyte * (BER_ACCUM_BLOB_BYTES * len(grid)))()
+    if path.exists():
+        data = path.read_bytes()
+        if len(data) != len(blobs):
+            raise ValueError(f"{path}: checkpoint holds {len(data) // BER_ACCUM_BLOB_BYTES} points, grid has {len(grid)}")
+        ctypes.memmove(blobs, data, len(data))
+        for k, (m, s, _) in enumerate(grid):
+            acc = accs[k]
+            if (lib.ber_accum_load(ctypes.byref(acc), ctypes.addressof(blobs) + k * BER_ACCUM_BLOB_BYTES,
+                                   BER_ACCUM_BLOB_BYTES) != 0
+                    or (acc.mod_order, acc.snr_db) != (m, s) or acc.num_bits != bits - bits % int(math.log2(m))
+                    or (seed is not None and acc.seed != (seed + grid[k][2] * 997) & 0xFFFFFFFFFFFFFFFF)):
+                raise ValueError(f"{path}: point {k} does not match this sweep")
+    else:
+        base = (seed if seed is not None else random.getrandbits(64)) & 0xFFFFFFFFFFFFFFFF
+        for k, (m, s, i) in enumerate(grid):
+            if lib.ber_accum_init(ctypes.byref(accs[k]), m, s, bits, (base + i * 997) & 0xFFFFFFFFFFFFFFFF) != 0:
+                return None
+
+    def save(*points):
+        for k in points:
+            lib.ber_accum_save(ctypes.byref(accs[k]), ctypes.addressof(blobs) + k * BER_ACCUM_BLOB_BYTES,
+                               BER_ACCUM_BLOB_BYTES)
+        tmp = path.with_name(path.name + '.tmp')
+        tmp.write_bytes(bytes(blobs))
+        tmp.replace(path)  # Atomic, so a kill never leaves a torn checkpoint
+
+    if not path.exists():
+        save(*range(len(grid)))
+    for k in range(len(grid)):
+        while accs[k].next_chunk < accs[k].chunk_end:
+            if lib.ber_accum_advance(ctypes.byref(accs[k]), every, threads) < 0:
+                return None
+            save(k)
+    out = {m: [] for m in mods}
+    for k in range(0, len(grid), runs):
+        out[grid[k][0]].append(sum(lib.ber_accum_ber(ctypes.byref(a)) for a in accs[k:k + runs]) / runs)
+    return out
+
+def simulate_ber_is(mod, snr_db, symbols, seed=None):
+    """Importance-sampled uncoded BER; returns BerIsStats or None if unavailable."""
+    if not HAS_IS:
+        return None
+    stats = BerIsStats()
+    run_seed = (seed if seed is not None else random.getrandbits(64)) & 0xFFFFFFFFFFFFFFFF
+    if lib.compute_ber_is(mod, snr_db, symbols, run_seed, ctypes.byref(stats)) != 0:
+        return None
+    return stats
+
 # Adaptive threshold finder
 def find_min_snr_for_ber(mod, target_ber, bits, runs=2, low=0.0, high=30.0, tol=0.1, seed=None):
     while high - low > tol:
         mid = 0.5 * (low + high)
-        ber = simulate_ber(mod, mid, bits, runs=runs, seed=seed)
+        # Points far from the target stop after ~100 errors instead of the full budget
+        stats = simulate_ber_until(mod, mid, bits * runs, seed=seed)
+        ber = stats.ber if stats is not None else simulate_ber(mod, mid, bits, runs=runs, seed=seed)
         if ber <= target_ber:
             high = mid
         else:
             low = mid
     return high
 
+def find_amc_thresholds(target_ber, bits, tol=0.1, seed=None):
+    """QPSK/16-QAM switching points from one native call; falls back to Python bisection.
+
+    Returns (thresh_qpsk, thresh_16qam, bits_spent); bits_spent is None on the fallback path.
+    """
+    if HAS_THRESH:
+        qpsk, qam16, spent = ctypes.c_double(), ctypes.c_double(), ctypes.c_longlong()
+        run_seed = (seed if seed is not None else random.getrandbits(64)) & 0xFFFFFFFFFFFFFFFF
+        if lib.find_amc_thresholds(target_ber, bits, tol, run_seed, ctypes.byref(qpsk),
+                                   ctypes.byref(qam16), ctypes.byref(spent)) == 0:
+            return qpsk.value, qam16.value, spent.value
+    return (find_min_snr_for_ber(4, target_ber, bits, tol=tol, seed=seed),
+            find_min_snr_for_ber(16, target_ber, bits, tol=tol, seed=seed), None)
+
+def simulate_amc_link(snr_trace, frames, frame_symbols, pilots, thresh_qpsk, thresh_16qam,
+                      seed=None, threads=0):
+    """Whole AMC frame loop in one native call; frame f sees snr_trace[f % len].
+
+    Returns BerLinkStats (mode usage, BER, spectral efficiency) or None if unavailable.
+    """
+    if not HAS_LINK:
+        return None
+    trace = (ctypes.c_double * len(snr_trace))(*[float(s) for s in snr_trace])
+    stats = BerLinkStats()
+    run_seed = (seed if seed is not None else random.getrandbits(64)) & 0xFFFFFFFFFFFFFFFF
+    if lib.run_amc_link(frames, frame_symbols, pilots, trace, len(snr_trace), thresh_qpsk,
+                        thresh_16qam, run_seed, threads, ctypes.byref(stats)) != 0:
+        return None
+    return stats
+
 # AMC decision logic
 def choose_mod(est_snr_db, thresh_qpsk, thresh_16qam):
     if est_snr_db < thresh_qpsk:
@@ -100,7 +679,7 @@ def choose_mod(est_snr_db, thresh_qpsk, thresh_16qam):
 def plot_ber(snrs, sim_map, mods, show_theor=True, save=None, num_bits=None, coded_sim_map=None):
     plt.figure(figsize=(10, 6))
     for m in mods:
-        label = {2: 'BPSK', 4: 'QPSK', 16: '16QAM'}[m]
+        label = {2: 'BPSK', 4: 'QPSK', 16: '16QAM', 64: '64QAM', 256: '256QAM'}[m]
         
         # Plot uncoded if available
         if sim_map and m in sim_map and sim_map[m]:
@@ -186,7 +765,7 @@ def write_csv(path, snrs, mods, sim_map, coded_sim_map=None):
 # Main CLI
 def main():
     parser = argparse.ArgumentParser(description='Adaptive Modulation BER/SNR Simulation CLI')
-    parser.add_argument('--mods', type=str, default='2,4,16', help='Comma list of modulation orders (2,4,16)')
+    parser.add_argument('--mods', type=str, default='2,4,16', help='Comma list of modulation orders (2,4,16,64,256)')
     parser.add_argument('--snr-start', type=float, default=0.0)
     parser.add_argument('--snr-stop', type=float, default=20.0)
     parser.add_argument('--snr-step', type=float, default=1.0)
@@ -195,6 +774,8 @@ def main():
     parser.add_argument('--pilots', type=int, default=200, help='Pilot symbols for SNR estimation')
     parser.add_argument('--find-thresholds', action='store_true', help='Estimate AMC thresholds for QPSK/16QAM @ target BER')
     parser.add_argument('--target-ber', type=float, default=1e-5)
+    parser.add_argument('--link-frames', type=int, default=1000, help='Frames per sample SNR in the native AMC link simulation (with --find-thresholds; 0 = legacy per-frame Python loop)')
+    parser.add_argument('--frame-symbols', type=int, default=256, help='Symbol slots per AMC frame')
     parser.add_argument('--thresh-bits', type=int, default=1_000_000)
     parser.add_argument('--seed', type=int, default=None, help='Deterministic seed (enables seeded BER if available)')
     parser.add_argument('--csv', type=str, default=None, help='Write BER results to CSV file')
@@ -203,13 +784,48 @@ def main():
     parser.add_argument('--quiet', action='store_true')
     parser.add_argument('--coding', action='store_true', help='Enable convolutional coding (K=7, rate 1/2)')
     parser.add_argument('--coded-only', action='store_true', help='Show only coded results (no uncoded)')
+    parser.add_argument('--code-rate', choices=sorted(CODE_RATES), default='1/2', help='Coded path rate (2/3 and 3/4 puncture the K=7 rate-1/2 code)')
+    parser.add_argument('--threads', type=int, default=1, help='Worker threads for uncoded BER (0 = all cores, 1 = legacy single-thread)')
+    parser.add_argument('--is-symbols', type=int, default=0, help='Estimate uncoded BER by importance sampling with this many symbols per point (reaches 1e-12; 0 = plain Monte Carlo)')
+    parser.add_argument('--min-errors', type=int, default=0, help='Stop each uncoded point after this many bit errors (--bits becomes the budget cap; whole grid scheduled as one library job)')
+    parser.add_argument('--rel-ci', type=float, default=0.0, help='Stop each uncoded point once the 95%% CI half-width is below this fraction of the BER (used with or instead of --min-errors)')
+    parser.add_argument('--profile', action='store_true', help='Print per-stage time/bytes from the library counters (needs make shared STATS=1)')
+    parser.add_argument('--async', dest='use_async', action='store_true', help='Run every SNR point as an asynchronous library job (all points of all modulations in flight at once, live progress, Ctrl-C keeps finished points)')
+    parser.add_argument('--checkpoint', type=str, default=None, help='Save uncoded sweep progress to this file and resume from it when rerun with the same arguments')
+    parser.add_argument('--cache', type=str, default=None, help='Persistent result cache file: seeded points already simulated are reused, longer runs extend shorter ones (use with --seed)')
+    parser.add_argument('--rng', choices=sorted(RNG_ENGINES), default='fast', help='Noise engine: fast (xoshiro256++/ziggurat), std (mt19937_64, reproduces older builds) or philox (counter-based, runs on --gpu)')
+    parser.add_argument('--gpu', action='store_true', help='Run seeded uncoded points on the GPU backend (needs --rng philox and a GPU build of ber.so)')
+    parser.add_argument('--channel', choices=sorted(CHANNELS), default='awgn', help='Uncoded channel: awgn, block (block fading) or jakes (time-varying Doppler fading); coded runs stay AWGN')
+    parser.add_argument('--doppler', type=float, default=0.01, help='Jakes max Doppler shift x symbol time, in (0, 0.5]')
+    parser.add_argument('--block-symbols', type=int, default=1000, help='Block fading coherence length in symbols')
+    parser.add_argument('--k-factor', type=float, default=0.0, help='Rician K factor of the fading channel (0 = Rayleigh)')
 
     args = parser.parse_args()
+    if _set_rng_func is not None:
+        _set_rng_func(RNG_ENGINES[args.rng])
+    elif args.rng != 'fast':
+        print("Warning: library has no ber_set_rng_engine; --rng ignored")
+    if args.gpu:
+        if args.rng != 'philox':
+            print("Warning: --gpu only applies to --rng philox; running on the CPU")
+        elif _set_backend_func is None or _set_backend_func(BER_BACKEND_GPU) != 0:
+            print("Warning: no GPU backend in this ber.so (or no device); running on the CPU")
+    if args.channel != 'awgn':
+        if _set_channel_func is None:
+            print("Error: library has no ber_set_channel; --channel needs a newer ber.so")
+            return 2
+        channel = BerChannel(CHANNELS[args.channel], args.doppler, args.block_symbols, args.k_factor)
+        if _set_channel_func(ctypes.byref(channel)) != 0:
+            print("Error: invalid fading parameters (need 0 < --doppler <= 0.5, --block-symbols >= 1, --k-factor >= 0)")
+            return 2
+        if args.checkpoint or args.is_symbols > 0:
+            print("Error: --checkpoint and --is-symbols only support --channel awgn")
+            return 2
 
     mods = [int(x) for x in args.mods.split(',') if x.strip()]
     for m in mods:
-        if m not in (2,4,16):
-            print(f"Error: Unsupported modulation order: {m}. Supported: 2, 4, 16")
+        if m not in (2,4,16,64,256):
+            print(f"Error: Unsupported modulation order: {m}. Supported: 2, 4, 16, 64, 256")
             return 2
     
     # Validate parameters
@@ -225,6 +841,21 @@ def main():
     if args.snr_step <= 0:
         print("Error: SNR step must be positive")
         return 2
+    if args.min_errors < 0 or args.rel_ci < 0:
+        print("Error: --min-errors and --rel-ci must be non-negative")
+        return 2
+
+    use_cache = False
+    if args.cache:
+        if not HAS_CACHE:
+            print("Warning: library has no ber_cache_open; --cache ignored")
+        elif lib.ber_cache_open(args.cache.encode()) != 0:
+            print(f"Error: cannot open result cache {args.cache}")
+            return 2
+        else:
+            use_cache = True
+            if args.seed is None and not args.quiet:
+                print("Warning: --cache without --seed only reuses coded points")
 
     snrs = np.arange(args.snr_start, args.snr_stop + 1e-9, args.snr_step)
     sim_map = {m: [] for m in mods}
@@ -238,14 +869,61 @@ def main():
         else:
             if not args.quiet:
                 coding_gain = lib.estimate_coding_gain_db()
-                print(f"Convolutional coding enabled (K=7, rate 1/2, ~{coding_gain:.1f} dB gain)")
+                print(f"Convolutional coding enabled (K=7, rate {args.code_rate}, ~{coding_gain:.1f} dB gain at rate 1/2)")
+        if args.code_rate != '1/2' and not HAS_RATES:
+            print("Warning: library has no compute_ber_coded_rate; using rate 1/2")
 
+    if args.profile and HAS_STATS:
+        lib.ber_stats_reset()
     t0 = time.time()
+    grid = None
+    if (args.min_errors > 0 or args.rel_ci > 0) and not args.coded_only and args.is_symbols <= 0:
+        grid = simulate_ber_grid(mods, snrs, args.bits, runs=args.runs, min_errors=args.min_errors,
+                                 rel_ci=args.rel_ci, seed=args.seed)
+        if grid is None:
+            print("Warning: library has no ber_submit_jobs; --min-errors/--rel-ci ignored")
+    elif args.checkpoint and not args.coded_only and args.is_symbols <= 0:
+        try:
+            grid = simulate_ber_checkpointed(mods, snrs, args.bits, args.checkpoint, runs=args.runs,
+                                             seed=args.seed, threads=args.threads)
+        except ValueError as e:
+            print(f"Error: {e}")
+            return 2
+        if grid is None:
+            print("Warning: library has no ber_accum_init; --checkpoint ignored")
+    async_grid = async_coded = None
+    if args.use_async:
+        if not HAS_ASYNC:
+            print("Warning: library has no ber_job_start; --async ignored")
+        else:
+            if grid is None and not args.coded_only and args.is_symbols <= 0 and not use_cache:
+                async_grid = simulate_ber_async(mods, snrs, args.bits, runs=args.runs, seed=args.seed,
+                                                quiet=args.quiet)
+            interrupted = async_grid is not None and any(math.isnan(b) for c in async_grid.values() for b in c)
+            if args.coding and not use_cache and not interrupted:
+                async_coded = simulate_ber_async(mods, snrs, args.bits, runs=args.runs, coding=True,
+                                                 code_rate=args.code_rate, quiet=args.quiet)
     for m in mods:
-        for snr in snrs:
+        curve = grid[m] if grid is not None else async_grid[m] if async_grid is not None else None
+        if not args.coded_only and args.is_symbols > 0 and HAS_IS:
+            stats = [simulate_ber_is(m, float(snr), args.is_symbols, seed=args.seed) for snr in snrs]
+            curve = None if None in stats else [st.ber for st in stats]
+        if curve is None and not args.coded_only and not use_cache:
+            # The sweep kernel shares streams across SNRs, so it bypasses the cache
+            curve = simulate_ber_curve(m, snrs, args.bits, runs=args.runs, seed=args.seed)
+        if curve is None and not args.coded_only:
+            curve = simulate_ber_points(m, snrs, args.bits, runs=args.runs, seed=args.seed, threads=args.threads)
+        coded_curve = async_coded[m] if async_coded is not None else None
+        if args.coding and coded_curve is None:
+            coded_curve = simulate_ber_points(m, snrs, args.bits, runs=args.runs, coding=True,
+                                              threads=args.threads, code_rate=args.code_rate)
+        for idx, snr in enumerate(snrs):
             # Uncoded simulation
             if not args.coded_only:
-                ber = simulate_ber(m, float(snr), args.bits, runs=args.runs, seed=args.seed, coding=False)
+                if curve is not None:
+                    ber = curve[idx]
+                else:
+                    ber = simulate_ber(m, float(snr), args.bits, runs=args.runs, seed=args.seed, coding=False, threads=args.threads)
                 # Handle zero BER gracefully for log plots
                 if ber == 0.0:
                     min_ber = 0.5 / args.bits  # Minimum detectable BER
@@ -255,7 +933,10 @@ def main():
             
             # Coded simulation
             if args.coding:
-                coded_ber = simulate_ber(m, float(snr), args.bits, runs=args.runs, seed=args.seed, coding=True)
+                if coded_curve is not None:
+                    coded_ber = coded_curve[idx]
+                else:
+                    coded_ber = simulate_ber(m, float(snr), args.bits, runs=args.runs, seed=args.seed, coding=True, code_rate=args.code_rate)
                 if coded_ber == 0.0:
                     min_ber = 0.5 / args.bits  # Minimum detectable BER
                     coded_sim_map[m].append(min_ber)
@@ -265,6 +946,11 @@ def main():
         if not args.quiet:
             print(f"Completed modulation {m}")
     elapsed = time.time() - t0
+    if use_cache and not args.quiet:
+        cs = BerCacheStats()
+        lib.ber_cache_stats(ctypes.byref(cs))
+        print(f"Result cache: {cs.hits} hits, {cs.extended} extended, {cs.misses} misses "
+              f"({cs.records} records in {args.cache})")
 
     if args.csv:
         try:
@@ -276,26 +962,45 @@ def main():
             return 3
 
     # SNR estimation curve
-    est_snrs = [simulate_snr(float(s), args.pilots) for s in snrs]
+    est_curve = simulate_snr_curve(snrs, args.pilots, seed=args.seed)
+    if est_curve is not None:
+        est_snrs = est_curve[0].tolist()
+    else:
+        est_snrs = [simulate_snr(float(s), args.pilots) for s in snrs]
 
     # Threshold finding
     thresh_qpsk = thresh_16qam = None
     if args.find_thresholds and 4 in mods and 16 in mods:
         if not args.quiet:
             print("Finding AMC thresholds...")
-        thresh_qpsk = find_min_snr_for_ber(4, args.target_ber, args.thresh_bits, seed=args.seed)
-        thresh_16qam = find_min_snr_for_ber(16, args.target_ber, args.thresh_bits, seed=args.seed)
+        thresh_qpsk, thresh_16qam, thresh_spent = find_amc_thresholds(args.target_ber, args.thresh_bits, seed=args.seed)
+        if not args.quiet and thresh_spent is not None:
+            print(f"Threshold search simulated {thresh_spent} bits")
         if not args.quiet:
             print(f"Threshold QPSK: {thresh_qpsk:.2f} dB | 16QAM: {thresh_16qam:.2f} dB")
 
     # Decide modulation for a few sample estimated SNRs (demonstration)
-    if thresh_qpsk is not None and thresh_16qam is not None:
+    link_done = False
+    if thresh_qpsk is not None and thresh_16qam is not None and args.link_frames > 0:
+        for true_snr in [5,10,15,20]:
+            st = simulate_amc_link([true_snr], args.link_frames, args.frame_symbols, args.pilots,
+                                   thresh_qpsk, thresh_16qam, seed=args.seed, threads=args.threads)
+            if st is None:
+                break
+            link_done = True
+            if not args.quiet:
+                usage = ' / '.join(f"{name} {100.0 * n / st.frames:.1f}%" for name, n in zip(AMC_MODES, st.mode_frames))
+                print(f"True SNR {true_snr:.1f} dB -> {usage} | {st.spectral_efficiency:.3f} b/s/Hz, BER {st.ber:.2e} ({st.frames} frames)")
+    if thresh_qpsk is not None and thresh_16qam is not None and not link_done:
         for true_snr in [5,10,15,20]:
             est = simulate_snr(true_snr, args.pilots)
             mod_choice = choose_mod(est, thresh_qpsk, thresh_16qam)
             if not args.quiet:
                 print(f"True SNR {true_snr:.1f} dB -> est {est:.2f} dB => {mod_choice}")
 
+    if args.profile:
+        print_profile(stats_snapshot(), time.time() - t0)
+
     if not args.no_plot:
         try:
             save_prefix = args.save_prefix
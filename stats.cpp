@@ -0,0 +1,175 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#if defined(BER_STATS) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+#include "ber.h"
+#include "stats.h"
+
+using namespace std;
+
+// =============================================================================
+// PER-THREAD COUNTERS
+// =============================================================================
+
+#ifdef BER_STATS
+
+namespace {
+
+struct StageCounters {
+  atomic<uint64_t> ns{0};
+  atomic<uint64_t> cycles{0};
+  atomic<uint64_t> calls{0};
+  atomic<uint64_t> bytes{0};
+};
+
+struct ThreadCounters {
+  array<StageCounters, BER_STAGE_COUNT> stage;
+  atomic<uint64_t> allocs{0};
+  atomic<uint64_t> alloc_bytes{0};
+};
+
+// Only the owning thread writes, so load + store is enough (no locked RMW on
+// the hot path); readers may see a counter one update behind
+inline void bump(atomic<uint64_t> &counter, uint64_t delta) noexcept {
+  counter.store(counter.load(memory_order_relaxed) + delta, memory_order_relaxed);
+}
+
+void add_into(ber_stats_t &out, const ThreadCounters &c) {
+  for (int s = 0; s < BER_STAGE_COUNT; ++s) {
+    out.stage[s].ns += c.stage[s].ns.load(memory_order_relaxed);
+    out.stage[s].cycles += c.stage[s].cycles.load(memory_order_relaxed);
+    out.stage[s].calls += c.stage[s].calls.load(memory_order_relaxed);
+    out.stage[s].bytes += c.stage[s].bytes.load(memory_order_relaxed);
+  }
+  out.allocs += c.allocs.load(memory_order_relaxed);
+  out.alloc_bytes += c.alloc_bytes.load(memory_order_relaxed);
+}
+
+// Live threads plus the totals of threads that have exited. Never destroyed:
+// thread_local counters may unregister during static destruction.
+struct Registry {
+  mutex lock;
+  vector<ThreadCounters *> live;
+  ber_stats_t retired{};
+};
+
+Registry &registry() {
+  static Registry *r = new Registry;
+  return *r;
+}
+
+struct ThreadSlot {
+  ThreadCounters counters;
+  ThreadSlot() {
+    Registry &r = registry();
+    lock_guard<mutex> g(r.lock);
+    r.live.push_back(&counters);
+  }
+  ~ThreadSlot() {
+    Registry &r = registry();
+    lock_guard<mutex> g(r.lock);
+    add_into(r.retired, counters);
+    erase(r.live, &counters);
+  }
+};
+
+ThreadCounters &thread_counters() {
+  thread_local ThreadSlot slot;
+  return slot.counters;
+}
+
+inline uint64_t now_ns() noexcept {
+  return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+                                   chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+}
+
+inline uint64_t now_cycles() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0; // No portable cycle counter; ns is still reported
+#endif
+}
+
+} // namespace
+
+StageTimer::StageTimer(int stage, uint64_t bytes) noexcept
+    : stage_(stage), bytes_(bytes), start_ns_(now_ns()),
+      start_cycles_(now_cycles()) {}
+
+StageTimer::~StageTimer() {
+  const uint64_t cycles = now_cycles() - start_cycles_;
+  const uint64_t ns = now_ns() - start_ns_;
+  StageCounters &c = thread_counters().stage[stage_];
+  bump(c.ns, ns);
+  bump(c.cycles, cycles);
+  bump(c.calls, 1);
+  bump(c.bytes, bytes_);
+}
+
+void stats_note_alloc(uint64_t bytes) noexcept {
+  ThreadCounters &c = thread_counters();
+  bump(c.allocs, 1);
+  bump(c.alloc_bytes, bytes);
+}
+
+#endif // BER_STATS
+
+// =============================================================================
+// C API
+// =============================================================================
+
+extern "C" int ber_stats_enabled(void) {
+#ifdef BER_STATS
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+extern "C" int ber_stats_snapshot(ber_stats_t *out) {
+  if (!out)
+    return -1;
+  *out = ber_stats_t{};
+#ifdef BER_STATS
+  Registry &r = registry();
+  lock_guard<mutex> g(r.lock);
+  *out = r.retired;
+  for (const ThreadCounters *c : r.live)
+    add_into(*out, *c);
+#endif
+  out->enabled = ber_stats_enabled();
+  return 0;
+}
+
+extern "C" void ber_stats_reset(void) {
+#ifdef BER_STATS
+  Registry &r = registry();
+  lock_guard<mutex> g(r.lock);
+  r.retired = ber_stats_t{};
+  for (ThreadCounters *c : r.live) {
+    for (StageCounters &s : c->stage) {
+      s.ns.store(0, memory_order_relaxed);
+      s.cycles.store(0, memory_order_relaxed);
+      s.calls.store(0, memory_order_relaxed);
+      s.bytes.store(0, memory_order_relaxed);
+    }
+    c->allocs.store(0, memory_order_relaxed);
+    c->alloc_bytes.store(0, memory_order_relaxed);
+  }
+#endif
+}
+
+extern "C" const char *ber_stats_stage_name(int stage) {
+  static constexpr const char *names[BER_STAGE_COUNT] = {
+      "rng", "modulate", "awgn", "demodulate", "error_count",
+      "llr", "encode", "decode", "snr_estimate"};
+  return stage >= 0 && stage < BER_STAGE_COUNT ? names[stage] : nullptr;
+}
@@ -0,0 +1,55 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstdint>
+
+#include "ber.h"
+
+// =============================================================================
+// HOT-PATH INSTRUMENTATION
+// =============================================================================
+//
+// Built only with -DBER_STATS (make ... STATS=1). Each pipeline stage wraps
+// its work in BER_STAGE_TIMER(stage, bytes), which adds elapsed ns, TSC
+// cycles, one call and the bytes produced to per-thread counters. Counters
+// belong to the writing thread (relaxed atomics), so timers never contend;
+// ber_stats_snapshot sums all live threads plus those that have exited.
+//
+// Without BER_STATS the macros expand to nothing and their arguments are not
+// evaluated, so the hot paths compile exactly as before.
+
+#ifdef BER_STATS
+
+// RAII timer for one stage; nested timers each count their own span
+class StageTimer {
+public:
+  StageTimer(int stage, uint64_t bytes) noexcept;
+  ~StageTimer();
+  StageTimer(const StageTimer &) = delete;
+  StageTimer &operator=(const StageTimer &) = delete;
+
+private:
+  int stage_;
+  uint64_t bytes_;
+  uint64_t start_ns_;
+  uint64_t start_cycles_;
+};
+
+// Heap allocation (or growth) of `bytes` on a simulation path
+void stats_note_alloc(uint64_t bytes) noexcept;
+
+#define BER_STATS_CAT_(a, b) a##b
+#define BER_STATS_CAT(a, b) BER_STATS_CAT_(a, b)
+#define BER_STAGE_TIMER(stage, bytes)                                          \
+  StageTimer BER_STATS_CAT(ber_stage_timer_, __LINE__)(                        \
+      (stage), static_cast<uint64_t>(bytes))
+#define BER_STATS_ALLOC(bytes) stats_note_alloc(static_cast<uint64_t>(bytes))
+
+#else
+
+#define BER_STAGE_TIMER(stage, bytes) ((void)0)
+#define BER_STATS_ALLOC(bytes) ((void)0)
+
+#endif // BER_STATS
+
+#endif // STATS_H
@@ -4,7 +4,9 @@ import numpy as np
 import os
 import sys
 import argparse
+import math
 import time
+import random
 
 # Load library with error handling
 try:
@@ -18,13 +20,229 @@ lib.compute_ber.restype = ctypes.c_double
 lib.estimate_snr.argtypes = [ctypes.c_double, ctypes.c_longlong]
 lib.estimate_snr.restype = ctypes.c_double
 
+lib.compute_ber_parallel.argtypes = [ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_ulonglong, ctypes.c_int]
+lib.compute_ber_parallel.restype = ctypes.c_double
+lib.compute_ber_seeded.argtypes = [ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_ulonglong]
+lib.compute_ber_seeded.restype = ctypes.c_double
+lib.ber_set_rng_engine.argtypes = [ctypes.c_int]
+lib.ber_set_rng_engine.restype = ctypes.c_int
+lib.ber_get_rng_engine.argtypes = []
+lib.ber_get_rng_engine.restype = ctypes.c_int
+lib.run_awgn_quality_test.argtypes = [ctypes.c_int, ctypes.c_char_p]
+lib.run_awgn_quality_test.restype = ctypes.c_int
+BER_RNG_STD, BER_RNG_FAST, BER_RNG_PHILOX = 0, 1, 2
+lib.ber_set_backend.argtypes = [ctypes.c_int]
+lib.ber_set_backend.restype = ctypes.c_int
+lib.ber_get_backend.argtypes = []
+lib.ber_get_backend.restype = ctypes.c_int
+lib.ber_gpu_available.argtypes = []
+lib.ber_gpu_available.restype = ctypes.c_int
+lib.run_philox_kernel_test.argtypes = [ctypes.c_char_p]
+lib.run_philox_kernel_test.restype = ctypes.c_int
+BER_BACKEND_CPU, BER_BACKEND_GPU = 0, 1
+lib.ber_set_simd_level.argtypes = [ctypes.c_int]
+lib.ber_set_simd_level.restype = ctypes.c_int
+lib.ber_get_simd_level.argtypes = []
+lib.ber_get_simd_level.restype = ctypes.c_int
+lib.run_simd_kernel_test.argtypes = [ctypes.c_char_p]
+lib.run_simd_kernel_test.restype = ctypes.c_int
+BER_SIMD_AUTO, BER_SIMD_SCALAR = -1, 0
+lib.ber_set_llr_mode.argtypes = [ctypes.c_int]
+lib.ber_set_llr_mode.restype = ctypes.c_int
+lib.ber_get_llr_mode.argtypes = []
+lib.ber_get_llr_mode.restype = ctypes.c_int
+lib.run_llr_engine_test.argtypes = [ctypes.c_char_p]
+lib.run_llr_engine_test.restype = ctypes.c_int
+BER_LLR_EXACT, BER_LLR_MAXLOG, BER_LLR_MAXLOG_F32 = 0, 1, 2
+LLR_MODE_NAMES = {BER_LLR_EXACT: 'exact', BER_LLR_MAXLOG: 'max-log', BER_LLR_MAXLOG_F32: 'max-log f32'}
+
 # Coding function signatures
 lib.compute_ber_coded.argtypes = [ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_int]
 lib.compute_ber_coded.restype = ctypes.c_double
+lib.compute_ber_coded_rate.argtypes = [ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_int, ctypes.c_int]
+lib.compute_ber_coded_rate.restype = ctypes.c_double
+BER_RATE_1_2, BER_RATE_2_3, BER_RATE_3_4 = 0, 1, 2
+CODE_RATE_NAMES = {BER_RATE_1_2: '1/2', BER_RATE_2_3: '2/3', BER_RATE_3_4: '3/4'}
+lib.compute_ber_batch.argtypes = [ctypes.c_int, ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_double),
+                                  ctypes.POINTER(ctypes.c_longlong), ctypes.POINTER(ctypes.c_ulonglong),
+                                  ctypes.c_int, ctypes.c_int, ctypes.POINTER(ctypes.c_double),
+                                  ctypes.POINTER(ctypes.c_longlong), ctypes.POINTER(ctypes.c_longlong)]
+lib.compute_ber_batch.restype = ctypes.c_int
+BER_BATCH_UNCODED = -1
+
+def ber_batch(mods, snrs, bits, seeds, code_rate=BER_BATCH_UNCODED, threads=0):
+    """compute_ber_batch over plain lists; returns (status, ber, errors, bits)"""
+    n = len(mods)
+    out_ber, out_err, out_bits = (ctypes.c_double * n)(), (ctypes.c_longlong * n)(), (ctypes.c_longlong * n)()
+    status = lib.compute_ber_batch(n, (ctypes.c_int * n)(*mods), (ctypes.c_double * n)(*snrs),
+                                   (ctypes.c_longlong * n)(*bits), (ctypes.c_ulonglong * n)(*seeds),
+                                   code_rate, threads, out_ber, out_err, out_bits)
+    return status, list(out_ber), list(out_err), list(out_bits)
+BER_STAGE_COUNT = 9
+class BerStageStats(ctypes.Structure):
+    _fields_ = [('ns', ctypes.c_ulonglong), ('cycles', ctypes.c_ulonglong), ('calls', ctypes.c_ulonglong),
+                ('bytes', ctypes.c_ulonglong)]
+
+class BerStats(ctypes.Structure):
+    _fields_ = [('stage', BerStageStats * BER_STAGE_COUNT), ('allocs', ctypes.c_ulonglong),
+                ('alloc_bytes', ctypes.c_ulonglong), ('enabled', ctypes.c_int)]
+
+lib.ber_stats_snapshot.argtypes = [ctypes.POINTER(BerStats)]
+lib.ber_stats_snapshot.restype = ctypes.c_int
+lib.ber_stats_reset.argtypes = []
+lib.ber_stats_reset.restype = None
+lib.ber_stats_enabled.argtypes = []
+lib.ber_stats_enabled.restype = ctypes.c_int
+lib.ber_stats_stage_name.argtypes = [ctypes.c_int]
+lib.ber_stats_stage_name.restype = ctypes.c_char_p
 lib.test_convolutional_coding.argtypes = []
 lib.test_convolutional_coding.restype = ctypes.c_int
 lib.estimate_coding_gain_db.argtypes = []
 lib.estimate_coding_gain_db.restype = ctypes.c_double
+lib.run_viterbi_equivalence_test.argtypes = [ctypes.c_char_p]
+lib.run_viterbi_equivalence_test.restype = ctypes.c_int
+lib.compute_ber_sweep.argtypes = [ctypes.c_int, ctypes.POINTER(ctypes.c_double), ctypes.c_int,
+                                  ctypes.c_longlong, ctypes.c_ulonglong,
+                                  ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_longlong)]
+lib.compute_ber_sweep.restype = ctypes.c_int
+class BerUntilStats(ctypes.Structure):
+    _fields_ = [('ber', ctypes.c_double), ('ci_low', ctypes.c_double), ('ci_high', ctypes.c_double),
+                ('errors', ctypes.c_longlong), ('bits', ctypes.c_longlong), ('stop_reason', ctypes.c_int)]
+
+lib.compute_ber_until.argtypes = [ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_longlong,
+                                  ctypes.c_double, ctypes.c_ulonglong, ctypes.POINTER(BerUntilStats)]
+lib.compute_ber_until.restype = ctypes.c_int
+BER_STOP_MIN_ERRORS, BER_STOP_CI, BER_STOP_MAX_BITS = 1, 2, 3
+class BerPoint(ctypes.Structure):
+    _fields_ = [('mod_order', ctypes.c_int), ('snr_db', ctypes.c_double), ('max_bits', ctypes.c_longlong),
+                ('min_errors', ctypes.c_longlong), ('rel_ci', ctypes.c_double), ('seed', ctypes.c_ulonglong)]
+
+lib.ber_submit_jobs.argtypes = [ctypes.POINTER(BerPoint), ctypes.c_int]
+lib.ber_submit_jobs.restype = ctypes.c_void_p
+lib.ber_wait.argtypes = [ctypes.c_void_p, ctypes.POINTER(BerUntilStats)]
+lib.ber_wait.restype = ctypes.c_int
+lib.estimate_snr_batch.argtypes = [ctypes.POINTER(ctypes.c_double), ctypes.c_int, ctypes.c_longlong, ctypes.c_longlong,
+                                   ctypes.c_ulonglong, ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double)]
+lib.estimate_snr_batch.restype = ctypes.c_int
+lib.ber_workspace_create.argtypes = []
+lib.ber_workspace_create.restype = ctypes.c_void_p
+lib.ber_workspace_destroy.argtypes = [ctypes.c_void_p]
+lib.ber_workspace_destroy.restype = None
+lib.compute_ber_seeded_ws.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_ulonglong]
+lib.compute_ber_seeded_ws.restype = ctypes.c_double
+lib.estimate_snr_ws.argtypes = [ctypes.c_void_p, ctypes.c_double, ctypes.c_longlong]
+lib.estimate_snr_ws.restype = ctypes.c_double
+lib.compute_ber_coded_rate_ws.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_double, ctypes.c_longlong,
+                                          ctypes.c_int, ctypes.c_int]
+lib.compute_ber_coded_rate_ws.restype = ctypes.c_double
+class BerAccum(ctypes.Structure):
+    _fields_ = [('mod_order', ctypes.c_int), ('rng_engine', ctypes.c_int), ('snr_db', ctypes.c_double),
+                ('seed', ctypes.c_ulonglong), ('num_bits', ctypes.c_longlong), ('chunk_begin', ctypes.c_longlong),
+                ('chunk_end', ctypes.c_longlong), ('next_chunk', ctypes.c_longlong),
+                ('errors', ctypes.c_longlong), ('bits', ctypes.c_longlong)]
+BER_ACCUM_BLOB_BYTES = 96
+lib.ber_accum_init.argtypes = [ctypes.POINTER(BerAccum), ctypes.c_int, ctypes.c_double, ctypes.c_longlong,
+                               ctypes.c_ulonglong]
+lib.ber_accum_init.restype = ctypes.c_int
+lib.ber_accum_advance.argtypes = [ctypes.POINTER(BerAccum), ctypes.c_longlong, ctypes.c_int]
+lib.ber_accum_advance.restype = ctypes.c_longlong
+lib.ber_accum_split.argtypes = [ctypes.POINTER(BerAccum), ctypes.c_int, ctypes.POINTER(BerAccum)]
+lib.ber_accum_split.restype = ctypes.c_int
+lib.ber_accum_merge.argtypes = [ctypes.POINTER(BerAccum), ctypes.POINTER(BerAccum)]
+lib.ber_accum_merge.restype = ctypes.c_int
+lib.ber_accum_ber.argtypes = [ctypes.POINTER(BerAccum)]
+lib.ber_accum_ber.restype = ctypes.c_double
+lib.ber_accum_save.argtypes = [ctypes.POINTER(BerAccum), ctypes.c_char_p, ctypes.c_int]
+lib.ber_accum_save.restype = ctypes.c_int
+lib.ber_accum_load.argtypes = [ctypes.POINTER(BerAccum), ctypes.c_char_p, ctypes.c_int]
+lib.ber_accum_load.restype = ctypes.c_int
+class BerCacheStats(ctypes.Structure):
+    _fields_ = [('hits', ctypes.c_longlong), ('extended', ctypes.c_longlong),
+                ('misses', ctypes.c_longlong), ('records', ctypes.c_longlong)]
+lib.ber_cache_open.argtypes = [ctypes.c_char_p]
+lib.ber_cache_open.restype = ctypes.c_int
+lib.ber_cache_close.argtypes = []
+lib.ber_cache_close.restype = None
+lib.ber_cache_stats.argtypes = [ctypes.POINTER(BerCacheStats)]
+lib.ber_cache_stats.restype = ctypes.c_int
+lib.ber_cache_reset_stats.argtypes = []
+lib.ber_cache_reset_stats.restype = None
+lib.compute_ber_cached.argtypes = [ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_ulonglong,
+                                   ctypes.c_int, ctypes.c_int, ctypes.POINTER(ctypes.c_longlong),
+                                   ctypes.POINTER(ctypes.c_longlong)]
+lib.compute_ber_cached.restype = ctypes.c_double
+lib.find_amc_thresholds.argtypes = [ctypes.c_double, ctypes.c_longlong, ctypes.c_double, ctypes.c_ulonglong,
+                                    ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double),
+                                    ctypes.POINTER(ctypes.c_longlong)]
+lib.find_amc_thresholds.restype = ctypes.c_int
+class BerLinkStats(ctypes.Structure):
+    _fields_ = [('frames', ctypes.c_longlong), ('mode_frames', ctypes.c_longlong * 3),
+                ('bits', ctypes.c_longlong), ('errors', ctypes.c_longlong), ('ber', ctypes.c_double),
+                ('spectral_efficiency', ctypes.c_double), ('goodput', ctypes.c_double),
+                ('mean_est_error_db', ctypes.c_double)]
+lib.run_amc_link.argtypes = [ctypes.c_longlong, ctypes.c_longlong, ctypes.c_longlong,
+                             ctypes.POINTER(ctypes.c_double), ctypes.c_longlong, ctypes.c_double,
+                             ctypes.c_double, ctypes.c_ulonglong, ctypes.c_int, ctypes.POINTER(BerLinkStats)]
+lib.run_amc_link.restype = ctypes.c_int
+BER_AMC_NONE, BER_AMC_QPSK, BER_AMC_16QAM = 0, 1, 2
+class BerChannel(ctypes.Structure):
+    _fields_ = [('model', ctypes.c_int), ('doppler', ctypes.c_double),
+                ('block_symbols', ctypes.c_longlong), ('k_factor', ctypes.c_double)]
+lib.ber_set_channel.argtypes = [ctypes.POINTER(BerChannel)]
+lib.ber_set_channel.restype = ctypes.c_int
+lib.ber_get_channel.argtypes = [ctypes.POINTER(BerChannel)]
+lib.ber_get_channel.restype = ctypes.c_int
+lib.run_channel_test.argtypes = [ctypes.c_char_p]
+lib.run_channel_test.restype = ctypes.c_int
+BER_CHANNEL_AWGN, BER_CHANNEL_BLOCK, BER_CHANNEL_JAKES = 0, 1, 2
+class BerIsStats(ctypes.Structure):
+    _fields_ = [('ber', ctypes.c_double), ('std_err', ctypes.c_double), ('ci_low', ctypes.c_double),
+                ('ci_high', ctypes.c_double), ('symbols', ctypes.c_longlong), ('hits', ctypes.c_longlong)]
+lib.compute_ber_is.argtypes = [ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_ulonglong,
+                               ctypes.POINTER(BerIsStats)]
+lib.compute_ber_is.restype = ctypes.c_int
+lib.ber_coded_workspace_create.argtypes = []
+lib.ber_coded_workspace_create.restype = ctypes.c_void_p
+lib.ber_coded_workspace_free.argtypes = [ctypes.c_void_p]
+lib.ber_coded_workspace_free.restype = None
+lib.compute_ber_coded_ws.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_double, ctypes.c_longlong, ctypes.c_int]
+lib.compute_ber_coded_ws.restype = ctypes.c_double
+lib.run_packed_coding_test.argtypes = [ctypes.c_char_p]
+lib.run_packed_coding_test.restype = ctypes.c_int
+lib.run_trellis_test.argtypes = [ctypes.c_char_p]
+lib.run_trellis_test.restype = ctypes.c_int
+lib.run_viterbi_stream_test.argtypes = [ctypes.c_char_p]
+lib.run_viterbi_stream_test.restype = ctypes.c_int
+lib.viterbi_stream_init.argtypes = [ctypes.c_int]
+lib.viterbi_stream_init.restype = ctypes.c_void_p
+lib.viterbi_stream_push.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_double), ctypes.c_int,
+                                    ctypes.POINTER(ctypes.c_bool), ctypes.POINTER(ctypes.c_int)]
+lib.viterbi_stream_push.restype = ctypes.c_int
+lib.viterbi_stream_flush.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_bool),
+                                     ctypes.POINTER(ctypes.c_int)]
+lib.viterbi_stream_flush.restype = ctypes.c_int
+lib.viterbi_stream_free.argtypes = [ctypes.c_void_p]
+lib.viterbi_stream_free.restype = None
+class BerJobParams(ctypes.Structure):
+    _fields_ = [('mod_order', ctypes.c_int), ('snr_db', ctypes.c_double), ('num_bits', ctypes.c_longlong),
+                ('seed', ctypes.c_ulonglong), ('code_rate', ctypes.c_int)]
+class BerJobProgress(ctypes.Structure):
+    _fields_ = [('bits_done', ctypes.c_longlong), ('bits_total', ctypes.c_longlong),
+                ('errors', ctypes.c_longlong)]
+BER_JOB_CALLBACK = ctypes.CFUNCTYPE(None, ctypes.POINTER(BerJobProgress), ctypes.c_void_p)
+lib.ber_job_start.argtypes = [ctypes.POINTER(BerJobParams), BER_JOB_CALLBACK, ctypes.c_void_p]
+lib.ber_job_start.restype = ctypes.c_void_p
+lib.ber_job_poll.argtypes = [ctypes.c_void_p, ctypes.POINTER(BerJobProgress)]
+lib.ber_job_poll.restype = ctypes.c_int
+lib.ber_job_cancel.argtypes = [ctypes.c_void_p]
+lib.ber_job_cancel.restype = ctypes.c_int
+lib.ber_job_result.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_double),
+                               ctypes.POINTER(ctypes.c_longlong), ctypes.POINTER(ctypes.c_longlong)]
+lib.ber_job_result.restype = ctypes.c_int
+BER_JOB_RUNNING, BER_JOB_DONE, BER_JOB_CANCELLED, BER_JOB_FAILED = 0, 1, 2, 3
+lib.convolutional_encode.argtypes = [ctypes.POINTER(ctypes.c_bool), ctypes.c_int,
+                                     ctypes.POINTER(ctypes.c_bool), ctypes.POINTER(ctypes.c_int)]
+lib.convolutional_encode.restype = ctypes.c_int
 
 # Test function signatures (corrected)
 lib.run_mod_demod_test.argtypes = [ctypes.c_char_p]
@@ -169,11 +387,16 @@ class TestAMC(unittest.TestCase):
         
         print(f"BER monotonicity test: {[f'{b:.2e}' for b in bers]}")
 
-    def test_edge_max_bits_limit(self):
-        """Ensure overly large bit requests are rejected ( > 100,000,000 )"""
-        # Using a value just above the enforced cap
-        ber = lib.compute_ber(2, 5.0, 150_000_000)
-        self.assertEqual(ber, -1.0, "Should reject excessive number of bits")
+    def test_edge_large_bits_streaming(self):
+        """Budgets above the old 100,000,000-bit cap stream in flat memory"""
+        import resource
+        rss_before = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+        ber = lib.compute_ber(16, 5.0, 150_000_000)
+        rss_after = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+        self.assertGreater(ber, 0.0, "Large bit requests should simulate, not error")
+        self.assertLess(ber, 0.5)
+        # ru_maxrss is in KiB; materializing the symbols alone would need ~600 MB
+        self.assertLess(rss_after - rss_before, 64 * 1024, "Streaming kernel should not grow memory")
 
     def test_edge_zero_bits(self):
         """Zero bits should return BER=0 and not error"""
@@ -225,6 +448,122 @@ class TestAMC(unittest.TestCase):
                 ratio = max(ber_bpsk, ber_qpsk) / min(ber_bpsk, ber_qpsk)
                 self.assertLess(ratio, 2.5, f"BPSK vs QPSK BER diverged too much at {snr} dB (ratio={ratio:.2f})")
 
+    def test_parallel_thread_count_invariance(self):
+        """Parallel BER depends only on the seed, not on the thread count"""
+        ref = lib.compute_ber_parallel(4, 6.0, 500000, 2024, 1)
+        self.assertGreater(ref, 0.0)
+        for threads in (2, 4, 0):
+            self.assertEqual(lib.compute_ber_parallel(4, 6.0, 500000, 2024, threads), ref,
+                             f"threads={threads} changed the result")
+        self.assertEqual(lib.compute_ber_parallel(3, 6.0, 1000, 1, 2), -1.0)
+
+    def test_ber_sweep_matches_seeded(self):
+        """One sweep call reproduces compute_ber_seeded at every SNR point"""
+        snrs = [0.0, 2.0, 4.0, 6.0, 8.0]
+        snr_arr = (ctypes.c_double * len(snrs))(*snrs)
+        ber = (ctypes.c_double * len(snrs))()
+        errors = (ctypes.c_longlong * len(snrs))()
+        for mod in (2, 4, 16):
+            self.assertEqual(lib.compute_ber_sweep(mod, snr_arr, len(snrs), 200000, 31, ber, errors), 0)
+            for k, snr in enumerate(snrs):
+                self.assertEqual(ber[k], lib.compute_ber_seeded(mod, snr, 200000, 31))
+                self.assertEqual(errors[k], round(ber[k] * 200000))
+            self.assertEqual(list(ber), sorted(ber, reverse=True))
+        self.assertEqual(lib.compute_ber_sweep(3, snr_arr, len(snrs), 1000, 1, ber, None), -1)
+
+    def test_ber_until_early_termination(self):
+        """compute_ber_until stops on errors / CI / budget and matches the seeded stream"""
+        st = BerUntilStats()
+        # Low SNR: a few thousand bits are enough for 200 errors
+        self.assertEqual(lib.compute_ber_until(2, 0.0, 200, 50_000_000, 0.0, 9, ctypes.byref(st)), 0)
+        self.assertEqual(st.stop_reason, BER_STOP_MIN_ERRORS)
+        self.assertGreaterEqual(st.errors, 200)
+        self.assertLess(st.bits, 10_000)
+        self.assertEqual(st.ber, lib.compute_ber_seeded(2, 0.0, st.bits, 9))
+        self.assertTrue(st.ci_low < st.ber < st.ci_high)
+        # Relative CI target
+        self.assertEqual(lib.compute_ber_until(4, 4.0, 0, 50_000_000, 0.1, 9, ctypes.byref(st)), 0)
+        self.assertEqual(st.stop_reason, BER_STOP_CI)
+        self.assertLessEqual((st.ci_high - st.ci_low) / 2, 0.1 * st.ber)
+        # High SNR: the budget caps the run
+        self.assertEqual(lib.compute_ber_until(16, 30.0, 100, 100_000, 0.0, 9, ctypes.byref(st)), 0)
+        self.assertEqual((st.stop_reason, st.errors, st.bits), (BER_STOP_MAX_BITS, 0, 100_000))
+        self.assertEqual(lib.compute_ber_until(3, 4.0, 100, 1000, 0.0, 9, ctypes.byref(st)), -1)
+
+    def test_amc_threshold_search(self):
+        """Native threshold search lands near theory and is consistent with seeded BER"""
+        qpsk, qam16, spent = ctypes.c_double(), ctypes.c_double(), ctypes.c_longlong()
+        self.assertEqual(lib.find_amc_thresholds(1e-3, 300000, 0.1, 17, ctypes.byref(qpsk),
+                                                 ctypes.byref(qam16), ctypes.byref(spent)), 0)
+        self.assertAlmostEqual(qpsk.value, 6.79, delta=0.35)
+        self.assertAlmostEqual(qam16.value, 10.52, delta=0.35)
+        self.assertLess(qpsk.value, qam16.value)
+        self.assertGreater(spent.value, 0)
+        for mod, thr in ((4, qpsk.value), (16, qam16.value)):
+            self.assertLessEqual(lib.compute_ber_seeded(mod, thr, 300000, 17), 1e-3)
+        self.assertEqual(lib.find_amc_thresholds(0.7, 300000, 0.1, 17, ctypes.byref(qpsk),
+                                                 ctypes.byref(qam16), None), -1)
+
+    def test_importance_sampling_deep_ber(self):
+        """IS reaches BER ~1e-10 with 1e6 symbols and matches exact theory"""
+        st = BerIsStats()
+        self.assertEqual(lib.compute_ber_is(2, 13.06, 1_000_000, 42, ctypes.byref(st)), 0)
+        theor = 0.5 * math.erfc(math.sqrt(10 ** 1.306))  # Q(sqrt(2 Eb/N0))
+        self.assertLess(st.std_err, 0.05 * st.ber)
+        self.assertLess(abs(st.ber - theor), 4 * st.std_err)
+        self.assertLessEqual(st.ci_low, st.ber)
+        self.assertEqual(lib.compute_ber_is(2, 13.06, 1, 42, ctypes.byref(st)), -1)
+        self.assertEqual(lib.compute_ber_is(8, 13.06, 1000, 42, ctypes.byref(st)), -1)
+
+    def test_awgn_engines(self):
+        """Both noise engines pass the quality test and agree on BER"""
+        saved = lib.ber_get_rng_engine()
+        try:
+            bers = {}
+            for engine in (BER_RNG_STD, BER_RNG_FAST):
+                buf = ctypes.create_string_buffer(256)
+                self.assertEqual(lib.run_awgn_quality_test(engine, buf), 0, buf.value.decode())
+                self.assertEqual(lib.ber_set_rng_engine(engine), 0)
+                bers[engine] = lib.compute_ber_seeded(4, 4.0, 1_000_000, 5)
+                self.assertEqual(lib.compute_ber_seeded(4, 4.0, 1_000_000, 5), bers[engine])
+            self.assertLess(abs(bers[BER_RNG_STD] - bers[BER_RNG_FAST]) / bers[BER_RNG_STD], 0.08)
+            self.assertEqual(lib.ber_set_rng_engine(5), -1)
+        finally:
+            lib.ber_set_rng_engine(saved)
+
+    def test_simd_kernel_variants(self):
+        """Vector modulate/demodulate kernels match the scalar reference"""
+        buf = ctypes.create_string_buffer(256)
+        self.assertEqual(lib.run_simd_kernel_test(buf), 0, buf.value.decode())
+        saved = lib.ber_get_simd_level()
+        try:
+            self.assertEqual(lib.ber_set_simd_level(BER_SIMD_SCALAR), 0)
+            ref = lib.compute_ber_seeded(16, 6.0, 400000, 3)
+            self.assertEqual(lib.ber_set_simd_level(BER_SIMD_AUTO), 0)
+            self.assertEqual(lib.compute_ber_seeded(16, 6.0, 400000, 3), ref)
+            self.assertEqual(lib.ber_set_simd_level(99), -1)
+        finally:
+            lib.ber_set_simd_level(saved)
+
+    def test_llr_engines(self):
+        """Max-log / float LLR engines: consistency and small coded 16-QAM penalty"""
+        buf = ctypes.create_string_buffer(256)
+        self.assertEqual(lib.run_llr_engine_test(buf), 0, buf.value.decode())
+        saved = lib.ber_get_llr_mode()
+        try:
+            self.assertEqual(lib.ber_set_llr_mode(7), -1)
+            self.assertEqual(lib.ber_get_llr_mode(), saved)
+            bers, qpsk = {}, set()
+            for mode in LLR_MODE_NAMES:
+                self.assertEqual(lib.ber_set_llr_mode(mode), 0)
+                bers[mode] = lib.compute_ber_coded(16, 4.0, 100000, 11)
+                qpsk.add(lib.compute_ber_coded(4, 2.0, 20000, 11))
+            self.assertEqual(len(qpsk), 1)  # QPSK LLRs are linear in every mode
+            for mode in (BER_LLR_MAXLOG, BER_LLR_MAXLOG_F32):
+                self.assertLessEqual(bers[mode], 1.5 * bers[BER_LLR_EXACT] + 50 / 100000)
+        finally:
+            lib.ber_set_llr_mode(saved)
+
     # ========================================================================
     # CODING TESTS
     # ========================================================================
@@ -235,6 +574,321 @@ class TestAMC(unittest.TestCase):
         self.assertEqual(result, 0, f"Convolutional coding self-test failed with code: {result}")
         print("✅ Convolutional coding self-test passed")
         
+    def test_viterbi_matches_reference(self):
+        """Packed-survivor Viterbi decodes exactly like the reference decoder"""
+        buf = ctypes.create_string_buffer(256)
+        self.assertEqual(lib.run_viterbi_equivalence_test(buf), 0, buf.value.decode())
+
+    def test_trellis_templates(self):
+        """Compile-time K=5/7/9 codes: consistent trellis, BER improves with K"""
+        buf = ctypes.create_string_buffer(256)
+        self.assertEqual(lib.run_trellis_test(buf), 0, buf.value.decode())
+
+    def test_viterbi_stream(self):
+        """Streaming decoder: self-test plus a noise-free round trip in odd-sized pieces"""
+        buf = ctypes.create_string_buffer(256)
+        self.assertEqual(lib.run_viterbi_stream_test(buf), 0, buf.value.decode())
+
+        rng = random.Random(7)
+        info = [rng.random() < 0.5 for _ in range(5000)]
+        coded = (ctypes.c_bool * (2 * len(info) + 12))()
+        coded_len = ctypes.c_int()
+        self.assertEqual(lib.convolutional_encode((ctypes.c_bool * len(info))(*info), len(info),
+                                                  coded, ctypes.byref(coded_len)), 0)
+        llr = (ctypes.c_double * coded_len.value)(*[4.0 if b else -4.0 for b in coded])
+
+        depth = 48
+        stream = lib.viterbi_stream_init(depth)
+        self.assertTrue(stream)
+        out = (ctypes.c_bool * (1000 + depth))()
+        n = ctypes.c_int()
+        decoded = []
+        try:
+            pos = 0
+            while pos < coded_len.value:
+                piece = min(777, coded_len.value - pos)
+                ptr = ctypes.cast(ctypes.byref(llr, pos * ctypes.sizeof(ctypes.c_double)),
+                                  ctypes.POINTER(ctypes.c_double))
+                self.assertEqual(lib.viterbi_stream_push(stream, ptr, piece, out, ctypes.byref(n)), 0)
+                decoded.extend(out[:n.value])
+                pos += piece
+            self.assertEqual(lib.viterbi_stream_flush(stream, out, ctypes.byref(n)), 0)
+            decoded.extend(out[:n.value])
+        finally:
+            lib.viterbi_stream_free(stream)
+        self.assertEqual(decoded, info)
+
+    def test_coded_workspace_reuse(self):
+        """A reused coded workspace gives the same BER as one-shot compute_ber_coded"""
+        buf = ctypes.create_string_buffer(256)
+        self.assertEqual(lib.run_packed_coding_test(buf), 0, buf.value.decode())
+        ws = lib.ber_coded_workspace_create()
+        self.assertTrue(ws)
+        try:
+            for mod in (2, 4, 16):
+                for bits in (50000, 3001):
+                    self.assertEqual(lib.compute_ber_coded_ws(ws, mod, 2.5, bits, 21),
+                                     lib.compute_ber_coded(mod, 2.5, bits, 21))
+        finally:
+            lib.ber_coded_workspace_free(ws)
+        self.assertEqual(lib.compute_ber_coded_ws(None, 2, 2.5, 1000, 21), -1.0)
+
+    def test_punctured_code_rates(self):
+        """Rates 2/3 and 3/4: same path as 1/2, error-free at high SNR, weaker at low SNR"""
+        for mod in (2, 4, 16):
+            self.assertEqual(lib.compute_ber_coded_rate(mod, 3.0, 20001, 5, BER_RATE_1_2),
+                             lib.compute_ber_coded(mod, 3.0, 20001, 5))
+            for rate in (BER_RATE_2_3, BER_RATE_3_4):
+                self.assertEqual(lib.compute_ber_coded_rate(mod, 12.0, 20001, 5, rate), 0.0)
+        bers = [lib.compute_ber_coded_rate(2, 3.0, 100000, 5, r) for r in CODE_RATE_NAMES]
+        self.assertLess(bers[0], bers[1])
+        self.assertLess(bers[1], bers[2])
+        self.assertEqual(lib.compute_ber_coded_rate(2, 3.0, 1000, 5, 9), -1.0)
+
+    def test_batch_matches_scalar(self):
+        """compute_ber_batch: each job equals its scalar call; failures are per job"""
+        mods = [2, 4, 16, 4, 8]
+        snrs = [1.0, 3.0, 7.0, 0.0, 3.0]
+        bits = [40000, 5001, 20000, 0, 1000]
+        seeds = [11, 12, 2**63 + 5, 14, 15]
+        status, ber, errors, counted = ber_batch(mods, snrs, bits, seeds)
+        self.assertEqual(status, 1)
+        for k in range(4):
+            self.assertEqual(ber[k], lib.compute_ber_seeded(mods[k], snrs[k], bits[k], seeds[k]))
+            if counted[k]:
+                self.assertEqual(ber[k], errors[k] / counted[k])
+        self.assertEqual((ber[4], errors[4], counted[4]), (-1.0, 0, 0))
+        status, ber, _, _ = ber_batch(mods[:3], snrs[:3], bits[:3], seeds[:3], code_rate=BER_RATE_2_3, threads=2)
+        self.assertEqual(status, 0)
+        for k in range(3):
+            seed32 = ctypes.c_int(seeds[k] & 0xFFFFFFFF).value  # Coded jobs take (int)seed
+            self.assertEqual(ber[k], lib.compute_ber_coded_rate(mods[k], snrs[k], bits[k], seed32, BER_RATE_2_3))
+        self.assertEqual(ber_batch([2], [3.0], [1000], [1], code_rate=7)[0], -1)
+
+    def test_stats_snapshot(self):
+        """Stage counters: zero when compiled out, populated in a STATS=1 build"""
+        self.assertEqual(lib.ber_stats_snapshot(None), -1)
+        self.assertEqual(lib.ber_stats_stage_name(0), b'rng')
+        self.assertIsNone(lib.ber_stats_stage_name(BER_STAGE_COUNT))
+        lib.ber_stats_reset()
+        lib.compute_ber_seeded(4, 4.0, 100000, 1)
+        stats = BerStats()
+        self.assertEqual(lib.ber_stats_snapshot(ctypes.byref(stats)), 0)
+        self.assertEqual(stats.enabled, lib.ber_stats_enabled())
+        calls = [st.calls for st in stats.stage]
+        if stats.enabled:
+            self.assertTrue(all(c > 0 for c in calls[:5]))  # rng .. error_count
+        else:
+            self.assertEqual(sum(calls), 0)
+
+    def test_snr_estimate_batch(self):
+        """estimate_snr_batch: unbiased to ~0.01 dB, chi-square spread, no 1e6-pilot cap"""
+        snrs = [0.0, 10.0, 25.0]
+        mean, std = (ctypes.c_double * 3)(), (ctypes.c_double * 3)()
+        self.assertEqual(lib.estimate_snr_batch((ctypes.c_double * 3)(*snrs), 3, 400, 10000, 21, mean, std), 0)
+        want_std = 10 / math.log(10) / math.sqrt(400)
+        for k, snr in enumerate(snrs):
+            self.assertAlmostEqual(mean[k], snr, delta=0.03)
+            self.assertAlmostEqual(std[k], want_std, delta=0.05 * want_std)
+        one = (ctypes.c_double * 1)(8.0)
+        self.assertEqual(lib.estimate_snr_batch(one, 1, 2_000_000, 2, 3, mean, None), 0)
+        self.assertAlmostEqual(mean[0], 8.0, delta=0.02)
+        self.assertEqual(lib.estimate_snr_batch(one, 1, 0, 2, 3, mean, None), -1)
+
+    def test_workspace_matches_plain_calls(self):
+        """ber_workspace_t entry points: identical seeded results, sane SNR estimates"""
+        ws = lib.ber_workspace_create()
+        self.assertTrue(ws)
+        try:
+            for mod in (2, 4, 16):
+                for snr in (1.0, 5.0):
+                    self.assertEqual(lib.compute_ber_seeded_ws(ws, mod, snr, 80001, 4),
+                                     lib.compute_ber_seeded(mod, snr, 80001, 4))
+                    self.assertEqual(lib.compute_ber_coded_rate_ws(ws, mod, snr, 6000, 4, BER_RATE_2_3),
+                                     lib.compute_ber_coded_rate(mod, snr, 6000, 4, BER_RATE_2_3))
+            self.assertAlmostEqual(lib.estimate_snr_ws(ws, 10.0, 20000), 10.0, delta=0.3)
+            self.assertEqual(lib.estimate_snr_ws(ws, 10.0, 0), -999.0)
+            self.assertEqual(lib.compute_ber_seeded_ws(None, 2, 3.0, 1000, 1), -1.0)
+        finally:
+            lib.ber_workspace_destroy(ws)
+
+    def test_job_scheduler_matches_until(self):
+        """ber_submit_jobs/ber_wait: every grid point equals its compute_ber_until call"""
+        grid = [(m, s, 2_000_000, 150, ci, 31 + i * 997) for m in (2, 4, 16) for s in (0.0, 4.0, 8.0)
+                for i, ci in enumerate((0.0, 0.15))]
+        points = (BerPoint * len(grid))(*[BerPoint(*p) for p in grid])
+        job = lib.ber_submit_jobs(points, len(grid))
+        self.assertTrue(job)
+        stats = (BerUntilStats * len(grid))()
+        self.assertEqual(lib.ber_wait(job, stats), 0)
+        want = BerUntilStats()
+        for (m, s, max_bits, min_errors, ci, seed), st in zip(grid, stats):
+            self.assertEqual(lib.compute_ber_until(m, s, min_errors, max_bits, ci, seed, ctypes.byref(want)), 0)
+            self.assertEqual((st.ber, st.errors, st.bits, st.stop_reason),
+                             (want.ber, want.errors, want.bits, want.stop_reason))
+        points[0].mod_order = 3
+        self.assertIsNone(lib.ber_submit_jobs(points, len(grid)))
+        self.assertEqual(lib.ber_wait(None, None), -1)
+
+    def test_result_cache_reuses_runs(self):
+        """ber_cache_open: exact hits, longer runs extend shorter ones, results unchanged"""
+        import tempfile
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, 'ber.cache').encode()
+            self.assertEqual(lib.ber_cache_open(path), 0)
+            try:
+                lib.ber_cache_reset_stats()
+                for bits in (300_000, 300_000, 900_000):
+                    self.assertEqual(lib.compute_ber_cached(16, 8.0, bits, 5, BER_BATCH_UNCODED, 0, None, None),
+                                     lib.compute_ber_seeded(16, 8.0, bits, 5))
+                self.assertEqual(lib.compute_ber_cached(4, 2.0, 8000, 9, BER_RATE_3_4, 0, None, None),
+                                 lib.compute_ber_coded_rate(4, 2.0, 8000, 9, BER_RATE_3_4))
+                st = BerCacheStats()
+                self.assertEqual(lib.ber_cache_stats(ctypes.byref(st)), 0)
+                self.assertEqual((st.hits, st.extended, st.misses, st.records), (1, 1, 2, 3))
+            finally:
+                lib.ber_cache_close()
+            self.assertEqual(lib.ber_cache_open(tmp.encode()), -1)
+
+    def test_accumulator_checkpoint_resume(self):
+        """ber_accum_t: save/load between steps and split/merge reproduce compute_ber_seeded"""
+        bits, want = 1_000_001, lib.compute_ber_seeded(4, 5.0, 1_000_001, 123)
+        acc = BerAccum()
+        self.assertEqual(lib.ber_accum_init(ctypes.byref(acc), 4, 5.0, bits, 123), 0)
+        buf = ctypes.create_string_buffer(BER_ACCUM_BLOB_BYTES)
+        while lib.ber_accum_advance(ctypes.byref(acc), 2, 0) > 0:
+            self.assertEqual(lib.ber_accum_save(ctypes.byref(acc), buf, len(buf)), BER_ACCUM_BLOB_BYTES)
+            acc = BerAccum()  # Simulated restart
+            self.assertEqual(lib.ber_accum_load(ctypes.byref(acc), buf.raw, len(buf)), 0)
+        self.assertEqual(lib.ber_accum_ber(ctypes.byref(acc)), want)
+        fresh = BerAccum()
+        lib.ber_accum_init(ctypes.byref(fresh), 4, 5.0, bits, 123)
+        parts = (BerAccum * 3)()
+        self.assertEqual(lib.ber_accum_split(ctypes.byref(fresh), 3, parts), 0)
+        for p in parts:
+            self.assertEqual(lib.ber_accum_advance(ctypes.byref(p), 1000, 1), 0)
+        for p in parts[1:]:
+            self.assertEqual(lib.ber_accum_merge(ctypes.byref(parts[0]), ctypes.byref(p)), 0)
+        self.assertEqual((parts[0].errors, parts[0].bits), (acc.errors, acc.bits))
+        corrupt = bytearray(buf.raw)
+        corrupt[50] ^= 0x10
+        self.assertEqual(lib.ber_accum_load(ctypes.byref(acc), bytes(corrupt), len(corrupt)), -1)
+
+    def test_philox_engine_and_backend(self):
+        """Philox engine: reference kernels pass, seeded runs repeat, GPU backend only when present"""
+        buf = ctypes.create_string_buffer(256)
+        self.assertEqual(lib.run_philox_kernel_test(buf), 0, buf.value.decode())
+        saved = lib.ber_get_rng_engine()
+        try:
+            self.assertEqual(lib.ber_set_rng_engine(BER_RNG_PHILOX), 0)
+            ber = lib.compute_ber_seeded(16, 6.0, 1_000_000, 9)
+            self.assertEqual(lib.compute_ber_parallel(16, 6.0, 1_000_000, 9, 0), ber)
+            self.assertEqual(lib.ber_set_backend(3), -1)
+            if lib.ber_gpu_available():
+                self.assertEqual(lib.ber_set_backend(BER_BACKEND_GPU), 0)
+                self.assertEqual(lib.compute_ber_seeded(16, 6.0, 1_000_000, 9), ber)
+            else:
+                self.assertEqual(lib.ber_set_backend(BER_BACKEND_GPU), -1)
+            self.assertEqual(lib.ber_set_backend(BER_BACKEND_CPU), 0)
+        finally:
+            lib.ber_set_backend(BER_BACKEND_CPU)
+            lib.ber_set_rng_engine(saved)
+
+    def test_amc_link_simulation(self):
+        """run_amc_link: modes follow the SNR trace, results independent of threads"""
+        trace = (ctypes.c_double * 3)(3.0, 11.0, 25.0)
+        one, many = BerLinkStats(), BerLinkStats()
+        self.assertEqual(lib.run_amc_link(20000, 128, 100, trace, 3, 9.6, 13.4, 7, 1, ctypes.byref(one)), 0)
+        self.assertEqual(lib.run_amc_link(20000, 128, 100, trace, 3, 9.6, 13.4, 7, 0, ctypes.byref(many)), 0)
+        self.assertEqual(bytes(one), bytes(many))
+        self.assertEqual(sum(one.mode_frames), 20000)
+        self.assertGreaterEqual(one.mode_frames[BER_AMC_NONE], 6600)
+        self.assertGreaterEqual(one.mode_frames[BER_AMC_16QAM], 6600)
+        self.assertGreater(one.mode_frames[BER_AMC_QPSK], 5000)
+        self.assertAlmostEqual(one.spectral_efficiency, one.bits / (20000 * 128))
+        self.assertLessEqual(one.goodput, one.spectral_efficiency)
+        self.assertEqual(lib.run_amc_link(10, 128, 100, trace, 3, 13.4, 9.6, 7, 0, ctypes.byref(one)), -1)
+
+    def test_fading_channel(self):
+        """Block/Jakes fading: channel statistics, Rayleigh BPSK BER, seeded paths agree"""
+        buf = ctypes.create_string_buffer(256)
+        self.assertEqual(lib.run_channel_test(buf), 0, buf.value.decode())
+        self.assertEqual(lib.ber_set_channel(ctypes.byref(BerChannel(BER_CHANNEL_BLOCK, 0.0, 1, 0.0))), 0)
+        try:
+            ber = lib.compute_ber_parallel(2, 10.0, 1000000, 3, 0)
+            gamma = 10.0
+            self.assertAlmostEqual(ber, 0.5 * (1 - math.sqrt(gamma / (1 + gamma))), delta=0.002)
+            self.assertEqual(lib.ber_set_channel(ctypes.byref(BerChannel(BER_CHANNEL_JAKES, 0.02, 0, 2.0))), 0)
+            seeded = lib.compute_ber_seeded(16, 12.0, 400000, 9)
+            self.assertEqual(lib.compute_ber_parallel(16, 12.0, 400000, 9, 0), seeded)
+            self.assertEqual(lib.ber_set_channel(ctypes.byref(BerChannel(BER_CHANNEL_JAKES, 0.9, 0, 0.0))), -1)
+            current = BerChannel()
+            self.assertEqual(lib.ber_get_channel(ctypes.byref(current)), 0)
+            self.assertEqual((current.model, current.doppler), (BER_CHANNEL_JAKES, 0.02))
+        finally:
+            lib.ber_set_channel(None)
+
+    def test_high_order_qam(self):
+        """64/256-QAM: uncoded BER on the exact Gray curve, seeded paths agree, coded path works"""
+        def theory(m, ebno_db):
+            k, n = int(math.log2(m)), math.isqrt(m)
+            x = math.sqrt(3 * k * 10 ** (ebno_db / 10) / (m - 1))
+            q = lambda t: 0.5 * math.erfc(t / math.sqrt(2))
+            errors = 0.0
+            for i in range(n):
+                for j in range(n):
+                    if i != j:
+                        lo = 1.0 if j == 0 else q((2 * j - n - (2 * i - n + 1)) * x)
+                        hi = 0.0 if j == n - 1 else q((2 * j - n + 2 - (2 * i - n + 1)) * x)
+                        errors += (lo - hi) * bin((i ^ i >> 1) ^ (j ^ j >> 1)).count('1')
+            return errors / (n * k / 2)
+
+        for m, snr in ((64, 14.0), (256, 18.0)):
+            ber = lib.compute_ber_parallel(m, snr, 2_400_000, 5, 0)
+            self.assertAlmostEqual(ber, theory(m, snr), delta=0.06 * theory(m, snr))
+            bits = (6 if m == 64 else 8) * 70001
+            seeded = lib.compute_ber_seeded(m, snr, bits, 8)
+            self.assertEqual(lib.compute_ber_parallel(m, snr, bits, 8, 0), seeded)
+            coded = lib.compute_ber_coded_rate(m, snr - 2.0, 30000, 2, 1)
+            self.assertGreaterEqual(coded, 0.0)
+            self.assertLess(coded, theory(m, snr - 2.0))
+        self.assertEqual(lib.compute_ber(64 * 2, 10.0, 1000), -1.0)
+
+    def test_async_jobs(self):
+        """Asynchronous jobs: pipelined points match the blocking calls, progress and cancel work"""
+        snrs = (0.0, 3.0, 6.0)
+        points = [BerJobParams(m, snr, 200_000, 3, BER_BATCH_UNCODED) for m in (4, 16) for snr in snrs]
+        points.append(BerJobParams(4, 2.0, 20_000, 3, BER_RATE_1_2))
+        jobs = [lib.ber_job_start(p, BER_JOB_CALLBACK(), None) for p in points]
+        for p, job in zip(points, jobs):
+            self.assertTrue(job)
+            self.assertIn(lib.ber_job_poll(job, None), (BER_JOB_RUNNING, BER_JOB_DONE))
+            ber = ctypes.c_double()
+            self.assertEqual(lib.ber_job_result(job, ctypes.byref(ber), None, None), BER_JOB_DONE)
+            if p.code_rate == BER_BATCH_UNCODED:
+                expected = lib.compute_ber_seeded(p.mod_order, p.snr_db, p.num_bits, p.seed)
+            else:
+                expected = lib.compute_ber_coded_rate(p.mod_order, p.snr_db, p.num_bits, p.seed, p.code_rate)
+            self.assertEqual(ber.value, expected)
+
+        # A Python callback sees growing progress and can cancel its own job
+        seen, handle = [], []
+        def on_progress(progress, _user):
+            seen.append(progress.contents.bits_done)
+            if progress.contents.bits_done >= 4 * 65536 * 2:
+                lib.ber_job_cancel(handle[0])
+        callback = BER_JOB_CALLBACK(on_progress)
+        handle.append(lib.ber_job_start(BerJobParams(4, 4.0, 1 << 34, 5, BER_BATCH_UNCODED), callback, None))
+        ber, errors, bits = ctypes.c_double(), ctypes.c_longlong(), ctypes.c_longlong()
+        state = lib.ber_job_result(handle[0], ctypes.byref(ber), ctypes.byref(errors), ctypes.byref(bits))
+        self.assertEqual(state, BER_JOB_CANCELLED)
+        self.assertEqual(seen, sorted(seen))
+        self.assertEqual(seen[-1], bits.value)
+        self.assertGreaterEqual(bits.value, 4 * 65536 * 2)
+        self.assertAlmostEqual(ber.value, errors.value / bits.value)
+        self.assertFalse(lib.ber_job_start(BerJobParams(8, 4.0, 1000, 1, BER_BATCH_UNCODED), BER_JOB_CALLBACK(), None))
+        self.assertEqual(lib.ber_job_result(None, None, None, None), -1)
+
     def test_coding_gain_estimate(self):
         """Test coding gain estimation function"""
         gain_db = lib.estimate_coding_gain_db()
@@ -402,8 +1056,81 @@ if __name__ == '__main__':
     parser.add_argument('--bench-max-bits', type=int, default=10_000_000, help='Maximum bits to use in adaptive mode')
     parser.add_argument('--bench-gain', action='store_true', help='Compute coding gain (dB) when coded BER > 0')
     parser.add_argument('--bench-csv', type=str, default=None, help='Optional CSV output for benchmark results')
+    parser.add_argument('--bench-llr', action='store_true', help='Compare coded 16-QAM BER and time per LLR engine')
+    parser.add_argument('--bench-llr-snrs', type=str, default='3,4,5', help='Comma list of SNRs (dB) for --bench-llr')
+    parser.add_argument('--bench-llr-bits', type=int, default=400_000, help='Info bits per point for --bench-llr')
+    parser.add_argument('--bench-rates', action='store_true', help='Compare coded BER and info throughput per code rate (1/2, 2/3, 3/4)')
+    parser.add_argument('--bench-rates-bits', type=int, default=400_000, help='Info bits per point for --bench-rates')
+    parser.add_argument('--bench-batch', action='store_true', help='Per-call ctypes loop vs one compute_ber_batch call (uses --bench-sizes/--bench-snr)')
+    parser.add_argument('--bench-batch-jobs', type=int, default=256, help='Jobs per point for --bench-batch')
     args, remaining = parser.parse_known_args()
 
+    if args.bench_batch:
+        # Identical jobs both ways; the single-thread batch isolates the FFI
+        # overhead, the all-core batch adds job-level parallelism
+        print('Batch API Benchmark')
+        print('===================')
+        n = args.bench_batch_jobs
+        print(f'SNR={args.bench_snr} dB, {n} jobs per point, results checked equal')
+        print(f"{'mod':>4} {'bits':>8} {'loop_us':>9} {'batch1_us':>9} {'batchN_us':>9} {'x1':>6} {'xN':>6}")
+        for mod in [int(m) for m in args.bench_mods.split(',') if m.strip()]:
+            for n_bits in [int(b) for b in args.bench_sizes.split(',') if b.strip()]:
+                seeds = list(range(1, n + 1))
+                t0 = time.perf_counter()
+                loop = [lib.compute_ber_seeded(mod, args.bench_snr, n_bits, sd) for sd in seeds]
+                t_loop = time.perf_counter() - t0
+                times = []
+                for threads in (1, 0):
+                    t0 = time.perf_counter()
+                    status, ber, _, _ = ber_batch([mod] * n, [args.bench_snr] * n, [n_bits] * n, seeds, threads=threads)
+                    times.append(time.perf_counter() - t0)
+                    if status != 0 or ber != loop:
+                        print(f'Batch mismatch for mod {mod}, bits {n_bits}')
+                        raise SystemExit(1)
+                us = [t / n * 1e6 for t in (t_loop, *times)]
+                print(f'{mod:4d} {n_bits:8d} {us[0]:9.1f} {us[1]:9.1f} {us[2]:9.1f} '
+                      f'{us[0] / us[1]:5.2f}x {us[0] / us[2]:5.2f}x')
+        raise SystemExit(0)
+
+    if args.bench_rates:
+        # Same seed per point, so rates differ only by puncturing
+        print('Punctured Code Rate Benchmark')
+        print('=============================')
+        print(f'bits={args.bench_rates_bits} per point')
+        print(f"{'mod':>4} {'SNR_dB':>6} {'rate':>5} {'BER':>11} {'time_ms':>9} {'info_Mb_s':>10}")
+        points = {2: (2.0, 3.0, 4.0), 4: (2.0, 3.0, 4.0), 16: (4.0, 5.0, 6.0)}
+        for mod, snrs in points.items():
+            for snr in snrs:
+                for rate, name in CODE_RATE_NAMES.items():
+                    t0 = time.perf_counter()
+                    ber = lib.compute_ber_coded_rate(mod, snr, args.bench_rates_bits, 1234, rate)
+                    dt = time.perf_counter() - t0
+                    print(f'{mod:4d} {snr:6.1f} {name:>5} {ber:11.3e} {dt * 1000.0:9.1f} '
+                          f'{args.bench_rates_bits / dt / 1e6:10.2f}')
+        raise SystemExit(0)
+
+    if args.bench_llr:
+        # Same seed for every engine (common random numbers), so BER
+        # differences are the demapper penalty rather than Monte-Carlo noise
+        print('Coded 16-QAM LLR Engine Benchmark')
+        print('=================================')
+        print(f'bits={args.bench_llr_bits} per point')
+        print(f"{'SNR_dB':>6} {'engine':>12} {'BER':>11} {'vs_exact':>9} {'time_ms':>9} {'speedup':>8}")
+        saved = lib.ber_get_llr_mode()
+        for snr in [float(x) for x in args.bench_llr_snrs.split(',') if x.strip()]:
+            ref_ber = ref_ms = None
+            for mode, name in LLR_MODE_NAMES.items():
+                lib.ber_set_llr_mode(mode)
+                t0 = time.perf_counter()
+                ber = lib.compute_ber_coded(16, snr, args.bench_llr_bits, 1234)
+                dt_ms = (time.perf_counter() - t0) * 1000.0
+                if ref_ber is None:
+                    ref_ber, ref_ms = ber, dt_ms
+                ratio = f'{ber / ref_ber:9.3f}' if ref_ber > 0 else f"{'-':>9}"
+                print(f'{snr:6.1f} {name:>12} {ber:11.3e} {ratio} {dt_ms:9.1f} {ref_ms / dt_ms:7.2f}x')
+        lib.ber_set_llr_mode(saved)
+        raise SystemExit(0)
+
     if args.bench:
         # Determine mod list
         if args.bench_mod is not None:
@@ -460,47 +1187,46 @@ if __name__ == '__main__':
         for mod in mods:
             last_bits = None
             if args.bench_adaptive:
-                guess = 5000
-                total_bits = 0
-                total_errors = 0
-                step_scale = 2.5
-                while total_bits < args.bench_max_bits and total_errors < args.bench_min_errors:
-                    ber_u, ber_c, dt_ms, thr = run_once(mod, guess)
-                    est_errors = max(1, int(ber_u * guess))
-                    total_bits += guess
-                    total_errors += est_errors
-                    gain_db = ''
-                    ber_c_display = ''
-                    if args.bench_coded:
-                        if ber_c is not None:
-                            if ber_c == 0.0:
-                                ber_c_display = f"{0.5/guess:.2e}"
-                            else:
-                                ber_c_display = f"{ber_c:.2e}"
-                            if args.bench_gain and ber_c > 0 and ber_u > 0:
-                                gain_db = f"{10*np.log10(ber_u/ber_c):.2f}"
-                    row_print = [f"{mod:12d}", f"{total_bits:12d}", f"{ber_u:12.2e}"]
+                # Native early termination: one call accumulates until min_errors or max_bits
+                st = BerUntilStats()
+                t0 = time.perf_counter()
+                lib.compute_ber_until(mod, args.bench_snr, args.bench_min_errors, args.bench_max_bits,
+                                      0.0, random.getrandbits(64), ctypes.byref(st))
+                ber_c = None
+                if args.bench_coded:
+                    ber_c = lib.compute_ber_coded(mod, args.bench_snr, st.bits, 1234)
+                dt_ms = (time.perf_counter() - t0) * 1000.0
+                thr = st.bits / (dt_ms / 1000.0) / 1e6
+                ber_u = st.ber
+                gain_db = ''
+                ber_c_display = ''
+                if args.bench_coded:
+                    if ber_c is not None:
+                        if ber_c == 0.0:
+                            ber_c_display = f"{0.5/st.bits:.2e}"
+                        else:
+                            ber_c_display = f"{ber_c:.2e}"
+                        if args.bench_gain and ber_c > 0 and ber_u > 0:
+                            gain_db = f"{10*np.log10(ber_u/ber_c):.2f}"
+                row_print = [f"{mod:12d}", f"{st.bits:12d}", f"{ber_u:12.2e}"]
+                if args.bench_coded:
+                    row_print.append(f"{ber_c_display:>12}")
+                if args.bench_gain:
+                    row_print.append(f"{gain_db:>12}")
+                row_print += [f"{dt_ms:12.2f}", f"{thr:12.2f}"]
+                print('  '.join(row_print))
+                if args.bench_csv:
+                    csv_row = [mod, st.bits, ber_u]
                     if args.bench_coded:
-                        row_print.append(f"{ber_c_display:>12}")
-                    if args.bench_gain:
-                        row_print.append(f"{gain_db:>12}")
-                    row_print += [f"{dt_ms:12.2f}", f"{thr:12.2f}"]
-                    print('  '.join(row_print))
-                    if args.bench_csv:
-                        csv_row = [mod, total_bits, ber_u]
-                        if args.bench_coded:
-                            csv_row.append(0.5/guess if ber_c == 0.0 else ber_c)
-                        if args.bench_gain and gain_db:
-                            csv_row.append(float(gain_db))
-                        elif args.bench_gain:
-                            csv_row.append('')
-                        csv_row += [dt_ms, thr]
-                        csv_rows.append(csv_row)
-                    if est_errors < 5:
-                        guess = int(guess * step_scale)
-                    else:
-                        guess = int(guess * 1.5)
-                print(f"--> Mod {mod}: stopping total_bits={total_bits}, est_errors≈{total_errors}")
+                        csv_row.append(0.5/st.bits if ber_c == 0.0 else ber_c)
+                    if args.bench_gain and gain_db:
+                        csv_row.append(float(gain_db))
+                    elif args.bench_gain:
+                        csv_row.append('')
+                    csv_row += [dt_ms, thr]
+                    csv_rows.append(csv_row)
+                print(f"--> Mod {mod}: stopping total_bits={st.bits}, errors={st.errors}, "
+                      f"95% CI=[{st.ci_low:.2e}, {st.ci_high:.2e}]")
             else:
                 sizes = [int(s) for s in args.bench_sizes.split(',') if s.strip()]
                 for n in sizes:
@@ -223,6 +223,23 @@ int main() {
     test_small_encoding();
     test_medium_encoding(); 
     test_large_encoding();
+
+    char msg[256] = {0};
+    int status = run_viterbi_equivalence_test(msg);
+    cout << "=== Viterbi vs Reference Decoder ===" << endl;
+    cout << (status == 0 ? "PASS: " : "FAIL: ") << msg << endl << endl;
+
+    status = run_packed_coding_test(msg);
+    cout << "=== Packed Encoder / Piecewise Decoder ===" << endl;
+    cout << (status == 0 ? "PASS: " : "FAIL: ") << msg << endl << endl;
+
+    status = run_trellis_test(msg);
+    cout << "=== Compile-Time K=5/7/9 Code Templates ===" << endl;
+    cout << (status == 0 ? "PASS: " : "FAIL: ") << msg << endl << endl;
+
+    status = run_viterbi_stream_test(msg);
+    cout << "=== Streaming Viterbi vs Block Decoder ===" << endl;
+    cout << (status == 0 ? "PASS: " : "FAIL: ") << msg << endl << endl;
     
     cout << "All tests completed." << endl;
     return 0;
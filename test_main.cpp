@@ -1,20 +1,33 @@
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
 #include <vector>
 
-// Declarations of extern "C" functions from ber.cpp
-extern "C" {
-double compute_ber(int mod_order, double snr_db, long long num_bits);
-double estimate_snr(double true_snr_db, long long num_pilots);
-int run_mod_demod_test(char *err_msg);
-int run_ber_edge_test(char *err_msg);
-int run_ber_accuracy_test(double *out_avg_ber, double *out_theor,
-                          char *err_msg);
-int run_snr_estimation_test(double *out_avg_est, double *out_std_est,
-                            char *err_msg);
-int run_all_tests(char *overall_msg);
+#include "ber.h"
+#include "coding.h"
+
+// Heap allocations made anywhere in the process (workspace arena test)
+static std::atomic<long long> g_heap_allocs{0};
+
+void *operator new(std::size_t size) {
+  g_heap_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
 }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
 
 namespace {
 struct SweepResult {
@@ -32,6 +45,15 @@ bool ber_close(double a, double b, double tolerance = 0.2) {
   return std::abs(a - b) / std::max(a, b) < tolerance;
 }
 
+// Prints one [PASS]/[FAIL] line per check and keeps the test's verdict
+struct Report {
+  bool all_passed = true;
+  void operator()(bool ok, const std::string &what) {
+    std::cout << (ok ? "[PASS] " : "[FAIL] ") << what << std::endl;
+    all_passed &= ok;
+  }
+};
+
 // Test boundary conditions and stress tests
 bool test_boundary_conditions() {
   std::cout << "\n==== Boundary Condition Tests ====" << std::endl;
@@ -215,6 +237,1348 @@ bool test_repeatability() {
 
   return all_passed;
 }
+
+// Parallel chunked BER must not depend on the number of worker threads
+bool test_parallel_determinism() {
+  std::cout << "\n==== Parallel Determinism Tests ====" << std::endl;
+  bool all_passed = true;
+
+  const unsigned long long seed = 12345ULL;
+  const long long bits = 600000; // several chunks for every modulation
+  for (int m : {2, 4, 16}) {
+    double ref = compute_ber_parallel(m, 6.0, bits, seed, 1);
+    bool same = ref >= 0;
+    for (int threads : {2, 3, 8}) {
+      same &= compute_ber_parallel(m, 6.0, bits, seed, threads) == ref;
+    }
+    same &= compute_ber_parallel(m, 6.0, bits, seed, 0) == ref;
+    same &= compute_ber_seeded(m, 6.0, bits, seed) == ref;
+    if (!same) {
+      std::cout << "[FAIL] Mod " << m << ": BER differs across thread counts"
+                << std::endl;
+      all_passed = false;
+    } else {
+      std::cout << "[PASS] Mod " << m << ": BER=" << std::scientific << ref
+                << std::defaultfloat << " identical for 1/2/3/8/auto threads and seeded"
+                << std::endl;
+    }
+  }
+
+  // A different seed must give a different (but statistically equal) result
+  double a = compute_ber_parallel(2, 4.0, 400000, 1ULL, 4);
+  double b = compute_ber_parallel(2, 4.0, 400000, 2ULL, 4);
+  if (a == b || !ber_close(a, b, 0.2)) {
+    std::cout << "[FAIL] Seed variation: " << a << " vs " << b << std::endl;
+    all_passed = false;
+  } else {
+    std::cout << "[PASS] Seed variation: " << std::scientific << a << " vs "
+              << b << std::defaultfloat << std::endl;
+  }
+
+  if (compute_ber_parallel(3, 6.0, 1000, seed, 2) != -1.0 ||
+      compute_ber_parallel(2, 6.0, 0, seed, 2) != 0.0) {
+    std::cout << "[FAIL] Parallel input validation" << std::endl;
+    all_passed = false;
+  } else {
+    std::cout << "[PASS] Parallel input validation" << std::endl;
+  }
+
+  return all_passed;
+}
+
+// A sweep must reproduce compute_ber_seeded point by point
+bool test_ber_sweep() {
+  std::cout << "\n==== SNR Sweep Tests ====" << std::endl;
+  bool all_passed = true;
+
+  const unsigned long long seed = 4242ULL;
+  const double snrs[] = {-2.0, 0.0, 2.5, 4.0, 6.0, 8.0, 10.0, 50.0};
+  constexpr int n_snr = sizeof(snrs) / sizeof(snrs[0]);
+  for (int m : {2, 4, 16}) {
+    // One partial chunk (SNR groups in parallel) and several chunks
+    for (long long bits : {30001LL, 700000LL}) {
+      double ber[n_snr];
+      long long errors[n_snr];
+      bool same = compute_ber_sweep(m, snrs, n_snr, bits, seed, ber, errors) == 0;
+      const long long used = bits - bits % static_cast<int>(std::log2(m));
+      for (int k = 0; same && k < n_snr; ++k) {
+        same &= ber[k] == compute_ber_seeded(m, snrs[k], bits, seed);
+        same &= ber[k] == static_cast<double>(errors[k]) / static_cast<double>(used);
+      }
+      if (!same) {
+        std::cout << "[FAIL] Mod " << m << ", " << bits
+                  << " bits: sweep differs from per-point seeded BER" << std::endl;
+        all_passed = false;
+      } else {
+        std::cout << "[PASS] Mod " << m << ", " << bits << " bits: " << n_snr
+                  << " points match compute_ber_seeded" << std::endl;
+      }
+    }
+  }
+
+  double ber[2] = {-5.0, -5.0};
+  const double bad_snr[2] = {0.0, 60.0};
+  const bool rejected =
+      compute_ber_sweep(3, snrs, 2, 1000, seed, ber, nullptr) == -1 &&
+      compute_ber_sweep(2, bad_snr, 2, 1000, seed, ber, nullptr) == -1 &&
+      compute_ber_sweep(2, snrs, 0, 1000, seed, ber, nullptr) == -1 &&
+      compute_ber_sweep(2, nullptr, 2, 1000, seed, ber, nullptr) == -1 &&
+      ber[0] == -5.0;
+  const bool empty = compute_ber_sweep(4, snrs, 2, 1, seed, ber, nullptr) == 0 &&
+                     ber[0] == 0.0 && ber[1] == 0.0;
+  if (!rejected || !empty) {
+    std::cout << "[FAIL] Sweep input validation" << std::endl;
+    all_passed = false;
+  } else {
+    std::cout << "[PASS] Sweep input validation" << std::endl;
+  }
+  return all_passed;
+}
+
+// Early termination must stop at the right tile of the seeded stream
+bool test_ber_until() {
+  std::cout << "\n==== Early-Termination BER Tests ====" << std::endl;
+  Report report;
+  const unsigned long long seed = 555ULL;
+  ber_until_stats_t st{};
+
+  // No stop criterion: the whole budget, same as the seeded call
+  bool ok = compute_ber_until(4, 3.0, 0, 300002, 0.0, seed, &st) == 0 &&
+            st.stop_reason == BER_STOP_MAX_BITS && st.bits == 300002 &&
+            st.ber == compute_ber_seeded(4, 3.0, 300002, seed) &&
+            st.ci_low <= st.ber && st.ber <= st.ci_high;
+  report(ok, "Full budget equals compute_ber_seeded");
+
+  // Error target: the first tile boundary at or past min_errors
+  const long long tile_bits = 4096;
+  for (int engine : {BER_RNG_STD, BER_RNG_FAST}) {
+    ber_set_rng_engine(engine);
+    ok = compute_ber_until(2, 4.0, 500, 100000000, 0.0, seed, &st) == 0 &&
+         st.stop_reason == BER_STOP_MIN_ERRORS && st.errors >= 500 &&
+         st.bits % tile_bits == 0 && st.bits < 1000000 &&
+         st.ber == compute_ber_seeded(2, 4.0, st.bits, seed) &&
+         compute_ber_seeded(2, 4.0, st.bits - tile_bits, seed) *
+                 static_cast<double>(st.bits - tile_bits) < 500.0;
+    report(ok, "Engine " + std::to_string(engine) + ": stopped at " +
+                   std::to_string(st.errors) + " errors after " +
+                   std::to_string(st.bits) + " bits");
+  }
+  ber_set_rng_engine(BER_RNG_FAST);
+
+  // CI target across several chunks
+  ok = compute_ber_until(16, 8.0, 0, 100000000, 0.05, seed, &st) == 0 &&
+       st.stop_reason == BER_STOP_CI &&
+       (st.ci_high - st.ci_low) / 2.0 <= 0.05 * st.ber &&
+       st.ber == compute_ber_seeded(16, 8.0, st.bits, seed);
+  report(ok, "CI target reached after " + std::to_string(st.bits) + " bits");
+
+  // No errors at all: budget exhausted, finite upper bound (~3.84 / bits)
+  ok = compute_ber_until(2, 40.0, 10, 2000000, 0.1, seed, &st) == 0 &&
+       st.stop_reason == BER_STOP_MAX_BITS && st.errors == 0 &&
+       st.ci_low == 0.0 && st.ci_high > 3.0 / 2e6 && st.ci_high < 4.0 / 2e6;
+  report(ok, "Zero-error upper bound " + std::to_string(st.ci_high));
+
+  ok = compute_ber_until(3, 4.0, 10, 1000, 0.0, seed, &st) == -1 &&
+       compute_ber_until(2, 60.0, 10, 1000, 0.0, seed, &st) == -1 &&
+       compute_ber_until(2, 4.0, -1, 1000, 0.0, seed, &st) == -1 &&
+       compute_ber_until(2, 4.0, 10, 0, 0.0, seed, &st) == -1 &&
+       compute_ber_until(2, 4.0, 10, 1000, -0.1, seed, &st) == -1 &&
+       compute_ber_until(2, 4.0, 10, 1000, 0.0, seed, nullptr) == -1;
+  report(ok, "Early-termination input validation");
+  return report.all_passed;
+}
+
+// Threshold search: deterministic, consistent with seeded BER at the bracket
+// ends, close to theory, and identical when run concurrently
+bool test_threshold_search() {
+  std::cout << "\n==== AMC Threshold Search Tests ====" << std::endl;
+  bool all_passed = true;
+  const unsigned long long seed = 2024ULL;
+  const double target = 1e-3, tol = 0.05;
+  const long long bits = 400000;
+  // Theoretical crossings at BER 1e-3: QPSK 6.79 dB, 16-QAM 10.52 dB
+  const double theory[2] = {6.79, 10.52};
+  double found[2] = {0.0, 0.0};
+  long long spent[2] = {0, 0};
+
+  for (int i = 0; i < 2; ++i) {
+    const int m = i == 0 ? 4 : 16;
+    double again = 0.0;
+    const bool ok =
+        find_snr_threshold(m, target, bits, tol, seed, &found[i], &spent[i]) == 0 &&
+        find_snr_threshold(m, target, bits, tol, seed, &again, nullptr) == 0 &&
+        again == found[i] && std::abs(found[i] - theory[i]) < 0.3 &&
+        compute_ber_seeded(m, found[i], bits, seed) <= target &&
+        compute_ber_seeded(m, found[i] - tol, bits, seed) > target;
+    std::cout << (ok ? "[PASS] " : "[FAIL] ") << "Mod " << m << ": threshold "
+              << std::fixed << std::setprecision(3) << found[i]
+              << std::defaultfloat << " dB after " << spent[i] << " bits" << std::endl;
+    all_passed &= ok;
+  }
+
+  double qpsk = 0.0, qam16 = 0.0;
+  long long total = 0;
+  const bool joint =
+      find_amc_thresholds(target, bits, tol, seed, &qpsk, &qam16, &total) == 0 &&
+      qpsk == found[0] && qam16 == found[1] && total == spent[0] + spent[1];
+  std::cout << (joint ? "[PASS] " : "[FAIL] ")
+            << "Concurrent QPSK/16-QAM search matches separate searches" << std::endl;
+  all_passed &= joint;
+
+  double out = 0.0;
+  const bool rejected =
+      find_snr_threshold(3, target, bits, tol, seed, &out, nullptr) == -1 &&
+      find_snr_threshold(4, 0.0, bits, tol, seed, &out, nullptr) == -1 &&
+      find_snr_threshold(4, target, bits, 0.0, seed, &out, nullptr) == -1 &&
+      find_snr_threshold(4, target, 0, tol, seed, &out, nullptr) == -1 &&
+      find_amc_thresholds(target, bits, tol, seed, nullptr, &out, nullptr) == -1;
+  std::cout << (rejected ? "[PASS] " : "[FAIL] ")
+            << "Threshold search input validation" << std::endl;
+  return all_passed && rejected;
+}
+
+// Importance sampling: unbiased against exact theory deep in the waterfall,
+// consistent with plain Monte Carlo where both work, deterministic
+bool test_importance_sampling() {
+  std::cout << "\n==== Importance Sampling Tests ====" << std::endl;
+  bool all_passed = true;
+  auto q = [](double x) { return 0.5 * std::erfc(x / std::sqrt(2.0)); };
+  auto theory = [&](int m, double ebno_db) {
+    const double ebno = std::pow(10.0, ebno_db / 10.0);
+    if (m != 16)
+      return q(std::sqrt(2.0 * ebno));
+    const double x = std::sqrt(0.8 * ebno);
+    return 0.25 * (3.0 * q(x) + 2.0 * q(3.0 * x) - q(5.0 * x));
+  };
+
+  // Eb/N0 giving BER ~1e-10: 1e6 symbols instead of ~1e11 bits
+  const struct { int mod; double snr; } deep[] = {{2, 13.06}, {4, 13.06}, {16, 16.98}};
+  ber_is_stats_t st{};
+  for (const auto &p : deep) {
+    const double ref = theory(p.mod, p.snr);
+    const bool ok = compute_ber_is(p.mod, p.snr, 1000000, 42, &st) == 0 &&
+                    std::abs(st.ber - ref) <= 4.0 * st.std_err &&
+                    st.std_err <= 0.05 * st.ber && st.ci_low <= st.ber &&
+                    st.ber <= st.ci_high && st.symbols == 1000000;
+    std::cout << (ok ? "[PASS] " : "[FAIL] ") << "Mod " << p.mod << " @ "
+              << p.snr << " dB: IS=" << std::scientific << st.ber << " +- "
+              << st.std_err << ", theory=" << ref << std::defaultfloat
+              << std::endl;
+    all_passed &= ok;
+  }
+
+  // Where plain Monte Carlo has plenty of errors the two must agree
+  for (int m : {2, 4, 16}) {
+    const double mc = compute_ber_seeded(m, 4.0, 2000000, 8);
+    const bool ok = compute_ber_is(m, 4.0, 200000, 8, &st) == 0 &&
+                    std::abs(st.ber - mc) <= 4.0 * st.std_err + 4.0 * std::sqrt(mc / 2000000.0);
+    std::cout << (ok ? "[PASS] " : "[FAIL] ") << "Mod " << m
+              << " @ 4 dB: IS=" << std::scientific << st.ber << ", MC=" << mc
+              << std::defaultfloat << std::endl;
+    all_passed &= ok;
+  }
+
+  ber_is_stats_t again{};
+  const bool same = compute_ber_is(16, 12.0, 300001, 5, &st) == 0 &&
+                    compute_ber_is(16, 12.0, 300001, 5, &again) == 0 &&
+                    st.ber == again.ber && st.std_err == again.std_err &&
+                    st.hits == again.hits;
+  std::cout << (same ? "[PASS] " : "[FAIL] ") << "Seeded IS estimate is reproducible"
+            << std::endl;
+
+  const bool rejected = compute_ber_is(3, 10.0, 1000, 1, &st) == -1 &&
+                        compute_ber_is(2, 10.0, 1, 1, &st) == -1 &&
+                        compute_ber_is(2, 60.0, 1000, 1, &st) == -1 &&
+                        compute_ber_is(2, 10.0, 1000, 1, nullptr) == -1;
+  std::cout << (rejected ? "[PASS] " : "[FAIL] ") << "IS input validation"
+            << std::endl;
+  return all_passed && same && rejected;
+}
+
+// Both AWGN engines must be statistically sound and agree on BER; engine
+// selection must be validated and keep seeded results reproducible
+bool test_awgn_engines() {
+  std::cout << "\n==== AWGN Engine Tests ====" << std::endl;
+  bool all_passed = true;
+  char msg[256] = {0};
+
+  for (int engine : {BER_RNG_STD, BER_RNG_FAST}) {
+    if (run_awgn_quality_test(engine, msg) != 0) {
+      std::cout << "[FAIL] " << msg << std::endl;
+      all_passed = false;
+    } else {
+      std::cout << "[PASS] " << msg << std::endl;
+    }
+  }
+
+  const int saved = ber_get_rng_engine();
+  if (ber_set_rng_engine(7) != -1 || ber_get_rng_engine() != saved) {
+    std::cout << "[FAIL] Invalid engine id accepted" << std::endl;
+    all_passed = false;
+  }
+
+  const long long bits = 2000000;
+  double ber_by_engine[2] = {0.0, 0.0};
+  for (int engine : {BER_RNG_STD, BER_RNG_FAST}) {
+    ber_set_rng_engine(engine);
+    double a = compute_ber_seeded(2, 4.0, bits, 99ULL);
+    double b = compute_ber_parallel(2, 4.0, bits, 99ULL, 3);
+    if (ber_get_rng_engine() != engine || a != b) {
+      std::cout << "[FAIL] Engine " << engine << ": seeded result not reproducible"
+                << std::endl;
+      all_passed = false;
+    }
+    ber_by_engine[engine] = a;
+  }
+  ber_set_rng_engine(saved);
+
+  if (!ber_close(ber_by_engine[0], ber_by_engine[1], 0.05)) {
+    std::cout << "[FAIL] Engine BER mismatch: " << ber_by_engine[0] << " vs "
+              << ber_by_engine[1] << std::endl;
+    all_passed = false;
+  } else {
+    std::cout << "[PASS] BPSK 4 dB: std=" << std::scientific << ber_by_engine[0]
+              << " fast=" << ber_by_engine[1] << std::defaultfloat << std::endl;
+  }
+
+  return all_passed;
+}
+
+// Every kernel variant must give the same BER as the scalar reference
+bool test_simd_kernels() {
+  std::cout << "\n==== SIMD Kernel Tests ====" << std::endl;
+  bool all_passed = true;
+  char msg[256] = {0};
+
+  if (run_simd_kernel_test(msg) != 0) {
+    std::cout << "[FAIL] " << msg << std::endl;
+    all_passed = false;
+  } else {
+    std::cout << "[PASS] " << msg << std::endl;
+  }
+
+  const int saved = ber_get_simd_level();
+  if (ber_set_simd_level(42) != -1 || ber_get_simd_level() != saved) {
+    std::cout << "[FAIL] Invalid SIMD level accepted" << std::endl;
+    all_passed = false;
+  }
+
+  for (int m : {2, 4, 16}) {
+    ber_set_simd_level(BER_SIMD_SCALAR);
+    const double ref = compute_ber_seeded(m, 5.0, 300001, 77ULL);
+    bool same = true;
+    for (int level : {BER_SIMD_AVX2, BER_SIMD_AVX512, BER_SIMD_NEON}) {
+      if (ber_set_simd_level(level) == 0)
+        same &= compute_ber_seeded(m, 5.0, 300001, 77ULL) == ref;
+    }
+    if (!same) {
+      std::cout << "[FAIL] Mod " << m << ": BER differs between kernel variants"
+                << std::endl;
+      all_passed = false;
+    } else {
+      std::cout << "[PASS] Mod " << m << ": BER=" << std::scientific << ref
+                << std::defaultfloat << " identical for all kernel variants"
+                << std::endl;
+    }
+  }
+  ber_set_simd_level(saved);
+
+  return all_passed;
+}
+
+// The packed-survivor Viterbi must decode exactly like the reference decoder
+bool test_viterbi_equivalence() {
+  std::cout << "\n==== Viterbi Equivalence Tests ====" << std::endl;
+  char msg[256] = {0};
+  if (run_viterbi_equivalence_test(msg) != 0) {
+    std::cout << "[FAIL] " << msg << std::endl;
+    return false;
+  }
+  std::cout << "[PASS] " << msg << std::endl;
+
+  // Seeded coded BER must not depend on the ACS variant either
+  const int saved = ber_get_simd_level();
+  ber_set_simd_level(BER_SIMD_SCALAR);
+  const double ref = compute_ber_coded(4, 2.0, 50000, 5);
+  bool same = true;
+  for (int level : {BER_SIMD_AVX2, BER_SIMD_AVX512}) {
+    if (ber_set_simd_level(level) == 0)
+      same &= compute_ber_coded(4, 2.0, 50000, 5) == ref;
+  }
+  ber_set_simd_level(saved);
+  if (!same) {
+    std::cout << "[FAIL] Coded BER differs between ACS variants" << std::endl;
+    return false;
+  }
+  std::cout << "[PASS] Coded QPSK 2 dB: BER=" << std::scientific << ref
+            << std::defaultfloat << " identical for all ACS variants"
+            << std::endl;
+  return true;
+}
+
+// Compile-time code templates (K=5/7/9) and their unrolled decoders
+bool test_trellis_codes() {
+  std::cout << "\n==== Trellis Template Tests ====" << std::endl;
+  char msg[256] = {0};
+  const bool passed = run_trellis_test(msg) == 0;
+  std::cout << (passed ? "[PASS] " : "[FAIL] ") << msg << std::endl;
+  return passed;
+}
+
+// Sliding-window streaming decoder against block decoding
+bool test_viterbi_stream() {
+  std::cout << "\n==== Streaming Viterbi Tests ====" << std::endl;
+  char msg[256] = {0};
+  const bool passed = run_viterbi_stream_test(msg) == 0;
+  std::cout << (passed ? "[PASS] " : "[FAIL] ") << msg << std::endl;
+  return passed;
+}
+
+// Fused coded pipeline: packed coding primitives and workspace reuse
+bool test_coded_workspace() {
+  std::cout << "\n==== Coded Pipeline Tests ====" << std::endl;
+  char msg[256] = {0};
+  bool all_passed = run_packed_coding_test(msg) == 0;
+  std::cout << (all_passed ? "[PASS] " : "[FAIL] ") << msg << std::endl;
+
+  // One workspace reused across sizes (large first, then smaller) and
+  // engines must reproduce the one-shot results
+  ber_coded_workspace_t *ws = ber_coded_workspace_create();
+  bool same = ws != nullptr;
+  for (int engine : {BER_RNG_STD, BER_RNG_FAST}) {
+    ber_set_rng_engine(engine);
+    for (int m : {2, 4, 16}) {
+      for (long long bits : {60001LL, 4097LL, 7LL}) {
+        same &= compute_ber_coded_ws(ws, m, 2.0, bits, 9) ==
+                compute_ber_coded(m, 2.0, bits, 9);
+      }
+    }
+  }
+  ber_set_rng_engine(BER_RNG_FAST);
+  same &= compute_ber_coded_ws(nullptr, 2, 2.0, 1000, 9) == -1.0;
+  same &= compute_ber_coded_ws(ws, 2, 2.0, 0, 9) == compute_ber_coded(2, 2.0, 0, 9);
+  std::cout << (same ? "[PASS] " : "[FAIL] ")
+            << "Reused workspace matches compute_ber_coded" << std::endl;
+
+  // Budgets beyond the 2^24-bit block stream through viterbi_stream: every
+  // (trimmed) bit is counted, the BER agrees with a block run of the same
+  // point, and the workspace still reproduces the one-shot call
+  const long long long_bits = (1LL << 24) + 4099;
+  long long block_errors = 0, block_bits = 0, errors = 0, bits = 0;
+  const double block = compute_ber_cached(4, 2.5, 1LL << 22, 5, BER_RATE_2_3, 1,
+                                          &block_errors, &block_bits);
+  const double streamed = compute_ber_cached(4, 2.5, long_bits, 5, BER_RATE_2_3, 1,
+                                             &errors, &bits);
+  const bool stream_ok = block > 0.0 && streamed > 0.0 && bits == long_bits &&
+                         std::abs(streamed - block) < 0.15 * block &&
+                         compute_ber_coded_ws(ws, 2, 4.0, long_bits, 9) ==
+                             compute_ber_coded(2, 4.0, long_bits, 9);
+  ber_coded_workspace_free(ws);
+  std::cout << (stream_ok ? "[PASS] " : "[FAIL] ") << "Streamed coded run (" << bits
+            << " bits, BER " << streamed << " vs block " << block << ")" << std::endl;
+  return all_passed && same && stream_ok;
+}
+
+// Soft demapper engines: kernel consistency and coded 16-QAM penalty
+bool test_llr_engines() {
+  std::cout << "\n==== LLR Engine Tests ====" << std::endl;
+  char msg[256] = {0};
+  bool all_passed = run_llr_engine_test(msg) == 0;
+  std::cout << (all_passed ? "[PASS] " : "[FAIL] ") << msg << std::endl;
+
+  const int saved = ber_get_llr_mode();
+  if (ber_set_llr_mode(3) != -1 || ber_set_llr_mode(-1) != -1 ||
+      ber_get_llr_mode() != saved) {
+    std::cout << "[FAIL] Invalid LLR mode accepted" << std::endl;
+    all_passed = false;
+  }
+
+  // BPSK/QPSK LLRs are linear, so the mode must not change their BER
+  bool linear_same = true;
+  for (int m : {2, 4}) {
+    ber_set_llr_mode(BER_LLR_EXACT);
+    const double ref = compute_ber_coded(m, 2.0, 30000, 3);
+    for (int mode : {BER_LLR_MAXLOG, BER_LLR_MAXLOG_F32}) {
+      ber_set_llr_mode(mode);
+      linear_same &= compute_ber_coded(m, 2.0, 30000, 3) == ref;
+    }
+  }
+  std::cout << (linear_same ? "[PASS] " : "[FAIL] ")
+            << "BPSK/QPSK coded BER independent of LLR mode" << std::endl;
+  all_passed &= linear_same;
+
+  // Same seed (common random numbers): max-log costs a fraction of a dB
+  const long long bits = 200000;
+  ber_set_llr_mode(BER_LLR_EXACT);
+  const double exact = compute_ber_coded(16, 4.0, bits, 21);
+  for (int mode : {BER_LLR_MAXLOG, BER_LLR_MAXLOG_F32}) {
+    ber_set_llr_mode(mode);
+    const double ber = compute_ber_coded(16, 4.0, bits, 21);
+    const bool ok = ber >= 0.0 && ber <= 1.5 * exact + 50.0 / bits;
+    std::cout << (ok ? "[PASS] " : "[FAIL] ") << "16-QAM coded 4 dB mode "
+              << mode << ": BER=" << std::scientific << ber << " (exact "
+              << exact << ")" << std::defaultfloat << std::endl;
+    all_passed &= ok;
+  }
+  ber_set_llr_mode(saved);
+  return all_passed;
+}
+
+// Punctured rates: 1/2 is the plain coded path, higher rates cost Eb/N0
+bool test_punctured_rates() {
+  std::cout << "\n==== Punctured Code Rate Tests ====" << std::endl;
+  Report report;
+
+  bool same = true;
+  for (int m : {2, 4, 16})
+    same &= compute_ber_coded_rate(m, 3.0, 50001, 4, BER_RATE_1_2) ==
+            compute_ber_coded(m, 3.0, 50001, 4);
+  report(same, "BER_RATE_1_2 equals compute_ber_coded");
+
+  for (int m : {2, 16}) {
+    const double snr = m == 2 ? 3.0 : 5.0;
+    double ber[3];
+    for (int r : {BER_RATE_1_2, BER_RATE_2_3, BER_RATE_3_4})
+      ber[r] = compute_ber_coded_rate(m, snr, 200000, 11, r);
+    report(ber[0] < ber[1] && ber[1] < ber[2] && ber[2] < 0.5,
+           "Mod " + std::to_string(m) + ": BER rises with rate (" +
+               std::to_string(ber[0]) + " / " + std::to_string(ber[1]) + " / " +
+               std::to_string(ber[2]) + ")");
+  }
+
+  bool clean = true;
+  for (int r : {BER_RATE_2_3, BER_RATE_3_4})
+    for (int m : {2, 4, 16})
+      for (long long bits : {3LL, 1000LL, 8191LL, 30001LL})
+        clean &= compute_ber_coded_rate(m, 12.0, bits, 2, r) == 0.0;
+  report(clean, "Error-free at 12 dB for all rates, mods and lengths");
+
+  report(compute_ber_coded_rate(2, 3.0, 1000, 1, 3) == -1.0 &&
+             compute_ber_coded_rate(2, 3.0, 1000, 1, -1) == -1.0,
+         "Unknown rate id rejected");
+  return report.all_passed;
+}
+
+// Batch API: every job equals its scalar call, whatever the thread count
+bool test_ber_batch() {
+  std::cout << "\n==== Batch API Tests ====" << std::endl;
+  Report report;
+
+  const int mods[] = {2, 4, 16, 2, 16, 4};
+  const double snrs[] = {2.0, 4.0, 6.0, 0.0, 10.0, 1.5};
+  const long long bits[] = {100000, 5001, 70003, 300000, 64, 0};
+  const unsigned long long seeds[] = {1, 2, 3, 1ULL << 40, 5, 6};
+  constexpr int N = 6;
+
+  double ber[N];
+  long long errors[N], counted[N];
+  bool uncoded_same = true;
+  for (int threads : {1, 3, 0}) {
+    if (compute_ber_batch(N, mods, snrs, bits, seeds, BER_BATCH_UNCODED, threads,
+                          ber, errors, counted) != 0) {
+      uncoded_same = false;
+      continue;
+    }
+    for (int k = 0; k < N; ++k) {
+      uncoded_same &= ber[k] == compute_ber_seeded(mods[k], snrs[k], bits[k], seeds[k]);
+      uncoded_same &= counted[k] == bits[k] - bits[k] % static_cast<int>(std::log2(mods[k]));
+      uncoded_same &= counted[k] == 0 ? errors[k] == 0
+                                      : ber[k] == static_cast<double>(errors[k]) / counted[k];
+    }
+  }
+  report(uncoded_same, "Uncoded jobs equal compute_ber_seeded for 1, 3 and all threads");
+
+  bool coded_same = true;
+  for (int rate : {BER_RATE_1_2, BER_RATE_3_4}) {
+    if (compute_ber_batch(N - 1, mods, snrs, bits, seeds, rate, 0, ber, errors,
+                          nullptr) != 0) {
+      coded_same = false;
+      continue;
+    }
+    for (int k = 0; k < N - 1; ++k) {
+      const double ref = compute_ber_coded_rate(mods[k], snrs[k], bits[k],
+                                                static_cast<int>(seeds[k]), rate);
+      coded_same &= ber[k] == ref && (errors[k] > 0) == (ref > 0.0);
+    }
+  }
+  report(coded_same, "Coded jobs equal compute_ber_coded_rate at rates 1/2 and 3/4");
+
+  const int bad_mods[] = {2, 8, 4};
+  const double bad_snrs[] = {3.0, 3.0, 99.0};
+  const long long bad_bits[] = {1000, 1000, 1000};
+  const unsigned long long bad_seeds[] = {1, 1, 1};
+  const int failed = compute_ber_batch(3, bad_mods, bad_snrs, bad_bits, bad_seeds,
+                                       BER_BATCH_UNCODED, 2, ber, errors, counted);
+  report(failed == 2 && ber[0] >= 0.0 && ber[1] == -1.0 && ber[2] == -1.0 &&
+             errors[1] == 0 && counted[2] == 0,
+         "Failed jobs report their error code and are counted");
+
+  ber[0] = 7.0;
+  report(compute_ber_batch(1, mods, snrs, bits, seeds, 5, 1, ber, nullptr, nullptr) == -1 &&
+             compute_ber_batch(1, mods, nullptr, bits, seeds, BER_BATCH_UNCODED, 1, ber,
+                               nullptr, nullptr) == -1 &&
+             compute_ber_batch(-1, mods, snrs, bits, seeds, BER_BATCH_UNCODED, 1, ber,
+                               nullptr, nullptr) == -1 &&
+             compute_ber_batch(0, nullptr, nullptr, nullptr, nullptr, BER_BATCH_UNCODED,
+                               1, nullptr, nullptr, nullptr) == 0 &&
+             ber[0] == 7.0,
+         "Invalid arguments rejected, outputs untouched");
+  return report.all_passed;
+}
+
+// Instrumentation counters: zero when compiled out, per-stage totals with
+// -DBER_STATS (make test-stats)
+bool test_stats_counters() {
+  std::cout << "\n==== Instrumentation Tests ====" << std::endl;
+  Report report;
+
+  ber_stats_t st;
+  report(ber_stats_snapshot(nullptr) == -1 && ber_stats_stage_name(BER_STAGE_COUNT) == nullptr &&
+             std::string(ber_stats_stage_name(BER_STAGE_DECODE)) == "decode",
+         "Invalid snapshot/stage arguments rejected");
+
+  ber_stats_reset();
+  compute_ber_parallel(16, 6.0, 400000, 3, 2);
+  compute_ber_coded(4, 3.0, 20000, 2);
+  estimate_snr(5.0, 1000);
+  ber_stats_snapshot(&st);
+  if (!ber_stats_enabled()) {
+    bool zero = st.enabled == 0 && st.allocs == 0;
+    for (const auto &s : st.stage)
+      zero &= s.ns == 0 && s.calls == 0 && s.bytes == 0;
+    report(zero, "Built without BER_STATS: counters stay zero");
+    return report.all_passed;
+  }
+
+  bool counted = st.enabled == 1;
+  for (int s = 0; s < BER_STAGE_COUNT; ++s)
+    counted &= st.stage[s].calls > 0 && st.stage[s].ns > 0;
+  report(counted, "Every stage timed by a BER + coded BER + SNR estimate run");
+  // 400000 16-QAM bits in 4096-symbol tiles on 2 threads: 25 tiles, 50000 bytes
+  report(st.stage[BER_STAGE_DEMODULATE].bytes == 50000 &&
+             st.stage[BER_STAGE_DEMODULATE].calls == 25,
+         "Demodulate bytes/calls match the tile count (" +
+             std::to_string(st.stage[BER_STAGE_DEMODULATE].calls) + " calls)");
+  report(st.allocs > 0 && st.alloc_bytes > 0, "Workspace and pilot allocations counted");
+
+  ber_stats_reset();
+  ber_stats_snapshot(&st);
+  bool reset = st.allocs == 0;
+  for (const auto &s : st.stage)
+    reset &= s.ns == 0 && s.calls == 0;
+  report(reset, "Reset zeroes all counters");
+  return report.all_passed;
+}
+
+// Scheduled grid points must match compute_ber_until exactly
+bool test_job_scheduler() {
+  std::cout << "\n==== Job Scheduler Tests ====" << std::endl;
+  Report report;
+
+  // Mixed grid: fast low-SNR stops, CI stops, tiny and multi-chunk budgets
+  std::vector<ber_point_t> points;
+  for (int mod : {2, 4, 16})
+    for (double snr = 0.0; snr <= 10.0; snr += 2.5)
+      for (unsigned long long run = 0; run < 2; ++run)
+        points.push_back({mod, snr, 3000000, 200, run == 0 ? 0.0 : 0.1, 42 + run * 997});
+  points.push_back({2, 20.0, 1000002, 10, 0.0, 7}); // Budget exhausted, odd tail
+  points.push_back({16, 4.0, 6000, 0, 0.0, 9});     // Shorter than one tile
+
+  std::vector<ber_until_stats_t> got(points.size()), want(points.size());
+  ber_jobs_t *job = ber_submit_jobs(points.data(), static_cast<int>(points.size()));
+  bool ok = job != nullptr && ber_wait(job, got.data()) == 0;
+  size_t mismatches = 0;
+  for (size_t i = 0; ok && i < points.size(); ++i) {
+    const ber_point_t &p = points[i];
+    ok &= compute_ber_until(p.mod_order, p.snr_db, p.min_errors, p.max_bits,
+                            p.rel_ci, p.seed, &want[i]) == 0;
+    mismatches += got[i].errors != want[i].errors || got[i].bits != want[i].bits ||
+                  got[i].ber != want[i].ber || got[i].ci_low != want[i].ci_low ||
+                  got[i].ci_high != want[i].ci_high ||
+                  got[i].stop_reason != want[i].stop_reason;
+  }
+  report(ok && mismatches == 0,
+         std::to_string(points.size()) + " scheduled points equal compute_ber_until (" +
+             std::to_string(mismatches) + " mismatches)");
+
+  // Several jobs in flight at once, results discarded for one of them
+  ber_jobs_t *a = ber_submit_jobs(points.data(), 6);
+  ber_jobs_t *b = ber_submit_jobs(points.data() + 6, 6);
+  std::vector<ber_until_stats_t> rb(6);
+  ok = a && b && ber_wait(a, nullptr) == 0 && ber_wait(b, rb.data()) == 0;
+  for (size_t i = 0; ok && i < rb.size(); ++i)
+    ok &= rb[i].bits == got[6 + i].bits && rb[i].errors == got[6 + i].errors;
+  report(ok, "Concurrent jobs are independent");
+
+  ber_point_t bad = points[0];
+  bad.mod_order = 8;
+  std::vector<ber_point_t> with_bad = {points[0], bad};
+  ok = ber_submit_jobs(nullptr, 1) == nullptr &&
+       ber_submit_jobs(points.data(), 0) == nullptr &&
+       ber_submit_jobs(with_bad.data(), 2) == nullptr && ber_wait(nullptr, nullptr) == -1;
+  report(ok, "Job scheduler input validation");
+  return report.all_passed;
+}
+
+// Workspace entry points: same results as the plain calls, and a repeated
+// sweep allocates nothing once the workspace has grown
+bool test_workspace_arena() {
+  std::cout << "\n==== Workspace Arena Tests ====" << std::endl;
+  Report report;
+
+  ber_workspace_t *ws = ber_workspace_create();
+  if (!ws) {
+    report(false, "ber_workspace_create");
+    return report.all_passed;
+  }
+  bool same = true;
+  for (int mod : {2, 4, 16})
+    for (double snr : {2.0, 6.0}) {
+      same &= compute_ber_seeded_ws(ws, mod, snr, 150001, 77) ==
+              compute_ber_seeded(mod, snr, 150001, 77);
+      for (int rate : {BER_RATE_1_2, BER_RATE_3_4})
+        same &= compute_ber_coded_rate_ws(ws, mod, snr, 9000, 5, rate) ==
+                compute_ber_coded_rate(mod, snr, 9000, 5, rate);
+    }
+  report(same, "Seeded uncoded and coded *_ws calls equal the plain calls");
+
+  // Noisy codeword through both decoders
+  const int info_len = 700;
+  std::unique_ptr<bool[]> info_bits(new bool[info_len]), coded(new bool[2 * info_len + 12]);
+  for (int i = 0; i < info_len; ++i)
+    info_bits[i] = ((i * 7) ^ (i >> 3)) & 1;
+  int coded_len = 0;
+  convolutional_encode(info_bits.get(), info_len, coded.get(), &coded_len);
+  std::vector<double> llr(static_cast<size_t>(coded_len));
+  for (int i = 0; i < coded_len; ++i)
+    llr[i] = (coded[i] ? -1.0 : 1.0) * (1.0 + 0.5 * std::sin(i)) + (i % 37 == 0 ? -1.8 : 0.0);
+  std::unique_ptr<bool[]> a(new bool[info_len]), b(new bool[info_len]);
+  int a_len = 0, b_len = 0;
+  bool decodes = viterbi_decode(llr.data(), coded_len, a.get(), &a_len) == 0 &&
+                 viterbi_decode_ws(ws, llr.data(), coded_len, b.get(), &b_len) == 0 &&
+                 a_len == b_len && std::equal(a.get(), a.get() + a_len, b.get());
+  decodes &= viterbi_decode_ws(ws, llr.data(), 7, b.get(), &b_len) == -2 &&
+             viterbi_decode_ws(ws, llr.data(), 12, b.get(), &b_len) == -3 &&
+             viterbi_decode_ws(nullptr, llr.data(), coded_len, b.get(), &b_len) == -1;
+  report(decodes, "viterbi_decode_ws matches viterbi_decode");
+
+  // Warm up at the largest point, then a full sweep must not allocate
+  auto sweep = [&] {
+    double acc = 0.0;
+    for (double snr = 0.0; snr <= 8.0; snr += 0.5) {
+      acc += compute_ber_seeded_ws(ws, 16, snr, 200000, 3);
+      acc += compute_ber_ws(ws, 4, snr, 50000);
+      acc += compute_ber_coded_rate_ws(ws, 16, snr, 20000, 3, BER_RATE_2_3);
+      acc += estimate_snr_ws(ws, snr, 5000);
+      viterbi_decode_ws(ws, llr.data(), coded_len, b.get(), &b_len);
+    }
+    return acc;
+  };
+  sweep();
+  const long long before = g_heap_allocs.load();
+  const double acc = sweep();
+  const long long allocs = g_heap_allocs.load() - before;
+  report(allocs == 0 && std::isfinite(acc),
+         "Steady-state workspace sweep: " + std::to_string(allocs) + " heap allocations");
+
+  report(compute_ber_seeded_ws(nullptr, 2, 3.0, 1000, 1) == -1.0 &&
+             estimate_snr_ws(nullptr, 3.0, 100) == -999.0 &&
+             compute_ber_coded_rate_ws(ws, 2, 3.0, 1000, 1, 9) == -1.0 &&
+             estimate_snr_ws(ws, 3.0, 0) == -999.0,
+         "Workspace input validation");
+  ber_workspace_destroy(ws);
+  ber_workspace_destroy(nullptr);
+  return report.all_passed;
+}
+
+// Batched estimator: chi-square spread, no pilot cap, repeatable
+bool test_snr_estimate_batch() {
+  std::cout << "\n==== Batched SNR Estimation Tests ====" << std::endl;
+  Report report;
+
+  // 2P squared unit normals: std of the dB estimate ~ (10 / ln 10) / sqrt(P)
+  const std::vector<double> snrs = {0.0, 7.5, 20.0};
+  const long long pilots = 200;
+  std::vector<double> mean(snrs.size()), stdev(snrs.size());
+  bool ok = estimate_snr_batch(snrs.data(), 3, pilots, 20000, 5, mean.data(),
+                               stdev.data()) == 0;
+  const double want_std = 10.0 / std::log(10.0) / std::sqrt(static_cast<double>(pilots));
+  for (size_t k = 0; ok && k < snrs.size(); ++k)
+    ok &= std::abs(mean[k] - snrs[k]) < 0.03 && std::abs(stdev[k] / want_std - 1.0) < 0.05;
+  report(ok, "200 pilots x 20000 trials: bias " + std::to_string(mean[1] - snrs[1]) +
+                 " dB, std " + std::to_string(stdev[1]) + " dB (theory " +
+                 std::to_string(want_std) + ")");
+
+  // Same statistic as repeated estimate_snr calls
+  double single = 0.0;
+  for (int t = 0; t < 2000; ++t)
+    single += estimate_snr(7.5, pilots);
+  single /= 2000.0;
+  report(std::abs(single - mean[1]) < 4.0 * want_std / std::sqrt(2000.0) + 0.01,
+         "Matches the mean of 2000 estimate_snr calls (" + std::to_string(single) + " dB)");
+
+  std::vector<double> again(snrs.size()), again_std(snrs.size());
+  estimate_snr_batch(snrs.data(), 3, pilots, 20000, 5, again.data(), again_std.data());
+  report(again == mean && again_std == stdev, "Seeded batch is repeatable");
+
+  // Past estimate_snr's 1e6-pilot cap
+  double big_mean = 0.0, big_std = 0.0;
+  const double snr = 12.0;
+  ok = estimate_snr(snr, 5000000) == -999.0 &&
+       estimate_snr_batch(&snr, 1, 5000000, 3, 9, &big_mean, &big_std) == 0 &&
+       std::abs(big_mean - snr) < 0.01 && big_std > 0.0 && big_std < 0.01;
+  report(ok, "5e6 pilots streamed: " + std::to_string(big_mean) + " dB");
+
+  const double bad_snr = 60.0;
+  ok = estimate_snr_batch(nullptr, 1, 100, 10, 1, mean.data(), nullptr) == -1 &&
+       estimate_snr_batch(snrs.data(), 0, 100, 10, 1, mean.data(), nullptr) == -1 &&
+       estimate_snr_batch(snrs.data(), 1, 0, 10, 1, mean.data(), nullptr) == -1 &&
+       estimate_snr_batch(snrs.data(), 1, 100, 0, 1, mean.data(), nullptr) == -1 &&
+       estimate_snr_batch(&bad_snr, 1, 100, 10, 1, mean.data(), nullptr) == -1 &&
+       estimate_snr_batch(snrs.data(), 1, 100, 10, 1, nullptr, nullptr) == -1;
+  report(ok, "Batched SNR estimation input validation");
+  return report.all_passed;
+}
+
+// Persistent result cache: hits, prefix extension, coded runs, reopen
+bool test_result_cache() {
+  std::cout << "\n==== Result Cache Tests ====" << std::endl;
+  Report report;
+  namespace fs = std::filesystem;
+  const fs::path path = fs::temp_directory_path() / "ber_tests_result_cache.bin";
+  fs::remove(path);
+  auto stats = [] {
+    ber_cache_stats_t st{};
+    ber_cache_stats(&st);
+    return st;
+  };
+
+  // 3 whole chunks plus a partial one, then 5 whole chunks plus a partial one
+  const long long short_bits = 2 * (3 * 65536LL + 1000);
+  const long long long_bits = 2 * (5 * 65536LL + 17);
+  long long e0 = 0, b0 = 0, e1 = 0, b1 = 0;
+  const double plain = compute_ber_cached(4, 4.0, short_bits, 11, BER_BATCH_UNCODED, 0, &e0, &b0);
+  report(plain == compute_ber_seeded(4, 4.0, short_bits, 11) && stats().records == 0,
+         "Without a cache compute_ber_cached is the plain seeded run");
+
+  report(ber_cache_open(path.c_str()) == 0, "Cache file created");
+  ber_cache_reset_stats();
+  const double miss = compute_ber_cached(4, 4.0, short_bits, 11, BER_BATCH_UNCODED, 0, &e1, &b1);
+  const double hit = compute_ber_cached(4, 4.0, short_bits, 11, BER_BATCH_UNCODED, 0, &e0, &b0);
+  ber_cache_stats_t st = stats();
+  report(miss == plain && hit == plain && e0 == e1 && b0 == b1 && st.misses == 1 &&
+             st.hits == 1 && st.records == 1,
+         "Miss then exact hit (" + std::to_string(e0) + " errors)");
+
+  const double extended = compute_ber_cached(4, 4.0, long_bits, 11, BER_BATCH_UNCODED, 2, &e1, &b1);
+  st = stats();
+  report(extended == compute_ber_seeded(4, 4.0, long_bits, 11) && b1 == long_bits &&
+             st.extended == 1 && st.records == 2,
+         "Longer run extends the 3-chunk prefix and equals compute_ber_seeded");
+
+  const int saved_engine = ber_get_rng_engine();
+  ber_set_rng_engine(BER_RNG_STD);
+  const double std_engine = compute_ber_cached(4, 4.0, short_bits, 11, BER_BATCH_UNCODED, 0, nullptr, nullptr);
+  ber_set_rng_engine(saved_engine);
+  report(std_engine != plain && stats().misses == 2, "Records are keyed by RNG engine");
+
+  const double coded = compute_ber_coded_rate(16, 6.0, 20000, 3, BER_RATE_2_3);
+  const double coded_miss = compute_ber_cached(16, 6.0, 20000, 3, BER_RATE_2_3, 0, nullptr, nullptr);
+  const long long hits_before = stats().hits;
+  const double coded_hit = compute_ber_cached(16, 6.0, 20000, 3, BER_RATE_2_3, 0, &e0, &b0);
+  report(coded_miss == coded && coded_hit == coded && stats().hits == hits_before + 1 && b0 > 0,
+         "Coded run is answered from the cache");
+  const long long huge = (1LL << 32) + 1000; // Wraps to 1000 as an int
+  const long long records_before = stats().records;
+  report(compute_ber_cached(16, 3.0, huge, 4, BER_RATE_1_2, 0, &e0, &b0) == -0.25 &&
+             compute_ber_coded_rate(16, 3.0, huge, 4, BER_RATE_1_2) == -0.25 &&
+             stats().records == records_before,
+         "Oversized coded run is rejected, not wrapped or cached");
+  const long long negative = -(1LL << 32) + 1000; // Also wraps to 1000
+  report(compute_ber_cached(2, 3.0, negative, 4, BER_RATE_1_2, 0, &e0, &b0) == -0.1 &&
+             compute_ber_coded_rate(2, 3.0, negative, 4, BER_RATE_1_2) == -0.1 &&
+             stats().records == records_before,
+         "Negative coded run is rejected, not wrapped or cached");
+
+  // Batch jobs go through the same cache; a second process would see the file
+  ber_cache_close();
+  report(compute_ber_cached(4, 4.0, short_bits, 11, BER_BATCH_UNCODED, 0, nullptr, nullptr) == plain &&
+             stats().records == 0,
+         "Closed cache is bypassed");
+  report(ber_cache_open(path.c_str()) == 0 && stats().records == 4, "Reopened file keeps its records");
+  ber_cache_reset_stats();
+  const int mods[2] = {4, 4};
+  const double snrs[2] = {4.0, 4.0};
+  const long long bits[2] = {short_bits, long_bits};
+  const unsigned long long seeds[2] = {11, 11};
+  double out[2] = {0.0, 0.0};
+  report(compute_ber_batch(2, mods, snrs, bits, seeds, BER_BATCH_UNCODED, 0, out, nullptr, nullptr) == 0 &&
+             out[0] == plain && out[1] == extended && stats().hits == 2,
+         "compute_ber_batch jobs hit the reopened cache");
+  ber_cache_close();
+
+  {
+    std::ofstream bad(path, std::ios::trunc);
+    bad << "not a result cache file, just some text that is long enough to map";
+  }
+  bool ok = ber_cache_open(path.c_str()) == -1 && ber_cache_open(nullptr) == -1 &&
+            ber_cache_open("") == -1 && ber_cache_stats(nullptr) == -1 &&
+            compute_ber_cached(4, 4.0, 1000, 1, 7, 0, nullptr, nullptr) == -1.0 &&
+            compute_ber_cached(5, 4.0, 1000, 1, BER_BATCH_UNCODED, 0, nullptr, nullptr) == -1.0;
+  report(ok, "Result cache input validation");
+  fs::remove(path);
+  return report.all_passed;
+}
+
+// Checkpoint/resume accumulators: chunked, serialized, split and merged
+bool test_accumulator() {
+  std::cout << "\n==== Accumulator Checkpoint Tests ====" << std::endl;
+  Report report;
+
+  // 16-QAM: 10 whole chunks plus a partial one. No cache is open, so
+  // compute_ber_cached is the plain seeded run with its counts
+  const long long num_bits = 4 * (10 * 65536LL + 4321) + 3;
+  long long want_errors = 0, want_bits = 0;
+  const double want = compute_ber_cached(16, 7.0, num_bits, 77, BER_BATCH_UNCODED, 1,
+                                         &want_errors, &want_bits);
+
+  // Advance in uneven steps, round-tripping through a blob between steps
+  ber_accum_t acc;
+  bool ok = ber_accum_init(&acc, 16, 7.0, num_bits, 77) == 0 && acc.chunk_end == 11;
+  unsigned char blob[BER_ACCUM_BLOB_BYTES];
+  long long left = 0, steps = 0;
+  const long long step_chunks[] = {3, 1, 4, 100};
+  do {
+    left = ber_accum_advance(&acc, step_chunks[steps % 4], static_cast<int>(1 + steps % 3));
+    ber_accum_t restored;
+    ok &= left >= 0 && ber_accum_save(&acc, blob, sizeof(blob)) == BER_ACCUM_BLOB_BYTES &&
+          ber_accum_load(&restored, blob, sizeof(blob)) == 0 &&
+          std::memcmp(&restored, &acc, sizeof(acc)) == 0;
+    acc = restored;
+    ++steps;
+  } while (ok && left > 0);
+  report(ok && acc.errors == want_errors && acc.bits == want_bits &&
+             ber_accum_ber(&acc) == want && ber_accum_advance(&acc, 5, 1) == 0,
+         "Checkpointed in " + std::to_string(steps) +
+             " steps, equals compute_ber_seeded (" + std::to_string(acc.errors) + " errors)");
+
+  // Split into 4 preemptible parts (one empty), run out of order, merge
+  ber_accum_t head;
+  ber_accum_init(&head, 16, 7.0, num_bits, 77);
+  ber_accum_advance(&head, 2, 1);
+  ber_accum_t parts[12];
+  ok = ber_accum_split(&head, 12, parts) == 0 && parts[0].errors == head.errors &&
+       parts[11].chunk_begin == parts[11].chunk_end;
+  for (int k = 11; k >= 0; --k)
+    ok &= ber_accum_advance(&parts[k], 1000, 1) == 0;
+  ok &= ber_accum_merge(&parts[2], &parts[1]) == -1; // Out of order
+  for (int k = 1; k < 12; ++k)
+    ok &= ber_accum_merge(&parts[0], &parts[k]) == 0;
+  report(ok && parts[0].errors == want_errors && parts[0].bits == want_bits &&
+             parts[0].chunk_begin == 0 && parts[0].chunk_end == 11,
+         "Split into 12 parts and merged back");
+
+  // The engine is fixed at init
+  const int saved_engine = ber_get_rng_engine();
+  ber_set_rng_engine(BER_RNG_STD);
+  ber_accum_t std_acc;
+  ber_accum_init(&std_acc, 4, 3.0, 300000, 5);
+  const double std_want = compute_ber_seeded(4, 3.0, 300000, 5);
+  ber_set_rng_engine(BER_RNG_FAST);
+  ber_accum_advance(&std_acc, 1000, 0);
+  ber_set_rng_engine(saved_engine);
+  report(std_acc.rng_engine == BER_RNG_STD && ber_accum_ber(&std_acc) == std_want,
+         "Accumulator keeps the engine it was started with");
+
+  // Corrupt, truncated and inconsistent state is rejected
+  ber_accum_t other;
+  ok = ber_accum_save(&acc, blob, sizeof(blob)) == BER_ACCUM_BLOB_BYTES &&
+       ber_accum_load(&other, blob, BER_ACCUM_BLOB_BYTES - 1) == -1;
+  blob[40] ^= 1;
+  ok &= ber_accum_load(&other, blob, sizeof(blob)) == -1;
+  blob[40] ^= 1;
+  ok &= ber_accum_load(&other, blob, sizeof(blob)) == 0;
+  ber_accum_t bad = acc;
+  bad.errors = bad.bits + 1;
+  ber_accum_init(&other, 16, 7.5, num_bits, 77);
+  ok &= ber_accum_save(&bad, blob, sizeof(blob)) == -1 &&
+        ber_accum_advance(&bad, 1, 1) == -1 && ber_accum_merge(&acc, &other) == -1 &&
+        ber_accum_save(&acc, blob, BER_ACCUM_BLOB_BYTES - 1) == -1 &&
+        ber_accum_init(&other, 3, 7.0, 1000, 1) == -1 &&
+        ber_accum_init(&other, 4, 60.0, 1000, 1) == -1 &&
+        ber_accum_advance(&acc, -1, 1) == -1 && ber_accum_split(&acc, 0, parts) == -1 &&
+        ber_accum_ber(nullptr) == -1.0;
+  report(ok, "Accumulator input validation");
+  return report.all_passed;
+}
+
+// Philox engine: reference kernels, stream quality, reproducibility and the
+// backend switch (the GPU leg only runs in GPU builds with a device)
+bool test_philox_backend() {
+  std::cout << "\n==== Philox Engine / Backend Tests ====" << std::endl;
+  Report report;
+  char msg[256] = {0};
+  bool ok = run_philox_kernel_test(msg) == 0;
+  report(ok, msg);
+  ok = run_awgn_quality_test(BER_RNG_PHILOX, msg) == 0;
+  report(ok, msg);
+
+  const int saved = ber_get_rng_engine();
+  ber_set_rng_engine(BER_RNG_FAST);
+  const double fast = compute_ber_seeded(2, 4.0, 2000000, 99ULL);
+  ok = ber_set_rng_engine(BER_RNG_PHILOX) == 0 &&
+            ber_get_rng_engine() == BER_RNG_PHILOX;
+  const double philox = compute_ber_seeded(2, 4.0, 2000000, 99ULL);
+  ok &= philox == compute_ber_parallel(2, 4.0, 2000000, 99ULL, 3) &&
+        compute_ber_coded(16, 4.0, 40000, 5) == compute_ber_coded(16, 4.0, 40000, 5);
+  report(ok, "Philox seeded uncoded and coded runs reproducible");
+  report(ber_close(philox, fast, 0.05), "BPSK 4 dB: philox=" + std::to_string(philox) +
+                                            " fast=" + std::to_string(fast));
+
+  // Checkpointed accumulation follows the selected engine
+  const long long num_bits = 4 * (2 * 65536LL + 99);
+  long long want_errors = 0, got = 0;
+  compute_ber_cached(16, 6.0, num_bits, 8, BER_BATCH_UNCODED, 1, &want_errors, nullptr);
+  ber_accum_t acc;
+  ok = ber_accum_init(&acc, 16, 6.0, num_bits, 8) == 0 && acc.rng_engine == BER_RNG_PHILOX;
+  while (ok && (got = ber_accum_advance(&acc, 1, 1)) > 0) {
+  }
+  report(ok && got == 0 && acc.errors == want_errors, "Philox accumulator matches seeded run");
+
+  const double cpu = compute_ber_seeded(16, 6.0, 1000000, 4ULL);
+  ok = ber_set_backend(9) == -1 && ber_get_backend() == BER_BACKEND_CPU;
+  if (ber_gpu_available()) {
+    ok &= ber_set_backend(BER_BACKEND_GPU) == 0 &&
+          compute_ber_seeded(16, 6.0, 1000000, 4ULL) == cpu;
+    report(ok, "GPU backend matches CPU counts");
+  } else {
+    ok &= ber_set_backend(BER_BACKEND_GPU) == -1 && ber_get_backend() == BER_BACKEND_CPU;
+    report(ok, "GPU backend refused without a device; CPU kept");
+  }
+  ber_set_backend(BER_BACKEND_CPU);
+  ber_set_rng_engine(saved);
+  return report.all_passed;
+}
+
+// Native AMC frame loop: mode decisions, BER and thread independence
+bool test_amc_link() {
+  std::cout << "\n==== AMC Link Simulation Tests ====" << std::endl;
+  Report report;
+
+  // Far above/below both thresholds every frame takes the obvious mode
+  ber_link_stats_t st;
+  const double high = 40.0, low = -20.0;
+  bool ok = run_amc_link(600, 128, 64, &high, 1, 8.0, 14.0, 1, 0, &st) == 0 &&
+            st.mode_frames[BER_AMC_16QAM] == 600 && st.errors == 0 &&
+            st.bits == 600 * 128 * 4 && st.spectral_efficiency == 4.0;
+  ok &= run_amc_link(600, 128, 64, &low, 1, 8.0, 14.0, 1, 0, &st) == 0 &&
+        st.mode_frames[BER_AMC_NONE] == 600 && st.bits == 0 && st.ber == 0.0 &&
+        st.goodput == 0.0;
+  report(ok, "Clear-channel and outage traces pick 16QAM / NONE");
+
+  // Thresholds that force QPSK: BER must match the seeded uncoded run
+  const double snr = 7.0;
+  ok = run_amc_link(4000, 512, 200, &snr, 1, -100.0, 100.0, 5, 0, &st) == 0 &&
+       st.mode_frames[BER_AMC_QPSK] == 4000;
+  const double ref = compute_ber_seeded(4, snr, st.bits, 5ULL);
+  report(ok && ber_close(st.ber, ref, 0.1) && std::abs(st.mean_est_error_db) < 0.1,
+         "Forced QPSK BER " + std::to_string(st.ber) + " vs seeded " +
+             std::to_string(ref) + ", estimate bias " +
+             std::to_string(st.mean_est_error_db) + " dB");
+
+  // Mixed trace: the split follows the estimates, threads change nothing
+  const double trace[] = {4.0, 9.0, 11.0, 16.0, 20.0};
+  ber_link_stats_t one, many;
+  ok = run_amc_link(3001, 256, 100, trace, 5, 9.6, 13.4, 11, 1, &one) == 0 &&
+       run_amc_link(3001, 256, 100, trace, 5, 9.6, 13.4, 11, 3, &many) == 0 &&
+       std::memcmp(&one, &many, sizeof(one)) == 0;
+  const long long modes =
+      one.mode_frames[0] + one.mode_frames[1] + one.mode_frames[2];
+  ok &= modes == 3001 && one.mode_frames[BER_AMC_NONE] >= 600 &&
+        one.mode_frames[BER_AMC_16QAM] >= 1200 && one.goodput <= one.spectral_efficiency;
+  report(ok, "Mixed trace: NONE/QPSK/16QAM = " + std::to_string(one.mode_frames[0]) + "/" +
+                 std::to_string(one.mode_frames[1]) + "/" +
+                 std::to_string(one.mode_frames[2]) + ", identical for 1 and 3 threads");
+
+  ok = run_amc_link(0, 128, 64, trace, 5, 9.6, 13.4, 1, 0, &st) == -1 &&
+       run_amc_link(10, 0, 64, trace, 5, 9.6, 13.4, 1, 0, &st) == -1 &&
+       run_amc_link(10, 128, 0, trace, 5, 9.6, 13.4, 1, 0, &st) == -1 &&
+       run_amc_link(10, 128, 64, nullptr, 5, 9.6, 13.4, 1, 0, &st) == -1 &&
+       run_amc_link(10, 128, 64, trace, 0, 9.6, 13.4, 1, 0, &st) == -1 &&
+       run_amc_link(10, 128, 64, trace, 5, 13.4, 9.6, 1, 0, &st) == -1 &&
+       run_amc_link(10, 128, 64, trace, 5, 9.6, 13.4, 1, 0, nullptr) == -1 &&
+       run_amc_link(10, 128, 64, &high, 1, NAN, 13.4, 1, 0, &st) == -1;
+  const double bad = 60.0;
+  ok &= run_amc_link(10, 128, 64, &bad, 1, 9.6, 13.4, 1, 0, &st) == -1;
+  report(ok, "run_amc_link input validation");
+  return report.all_passed;
+}
+
+// Fading channels: statistics, closed-form Rayleigh BER, seeded invariants
+bool test_fading_channels() {
+  std::cout << "\n==== Fading Channel Tests ====" << std::endl;
+  Report report;
+  char msg[256] = {0};
+  const bool stats_ok = run_channel_test(msg) == 0;
+  report(stats_ok, msg);
+
+  // BPSK over fast Rayleigh fading: 0.5 (1 - sqrt(g / (1 + g)))
+  const double snr = 10.0, g = std::pow(10.0, snr / 10.0);
+  const double rayleigh = 0.5 * (1.0 - std::sqrt(g / (1.0 + g)));
+  ber_channel_t ch{BER_CHANNEL_BLOCK, 0.0, 1, 0.0};
+  bool ok = ber_set_channel(&ch) == 0;
+  const double block = compute_ber_parallel(2, snr, 2000000, 7, 0);
+  report(ok && ber_close(block, rayleigh, 0.05),
+         "Block Rayleigh (B = 1) BPSK at 10 dB: " + std::to_string(block) +
+             " vs theory " + std::to_string(rayleigh));
+
+  ch = {BER_CHANNEL_JAKES, 0.05, 0, 0.0};
+  ok = ber_set_channel(&ch) == 0;
+  const double jakes = compute_ber_parallel(2, snr, 2000000, 7, 0);
+  report(ok && ber_close(jakes, rayleigh, 0.1),
+         "Jakes (fd = 0.05) BPSK at 10 dB: " + std::to_string(jakes) + " vs theory " +
+             std::to_string(rayleigh));
+
+  // A strong LOS component brings the BER back towards AWGN
+  ch = {BER_CHANNEL_BLOCK, 0.0, 64, 4.0};
+  ok = ber_set_channel(&ch) == 0;
+  const double rician = compute_ber_parallel(2, snr, 2000000, 7, 0);
+  report(ok && rician < 0.5 * rayleigh && rician > 0.5 * std::erfc(std::sqrt(g)),
+         "Rician K = 4 BER " + std::to_string(rician) + " between AWGN and Rayleigh");
+
+  // Seeded paths agree with each other under fading, for any thread count
+  ch = {BER_CHANNEL_JAKES, 0.01, 0, 1.0};
+  ber_set_channel(&ch);
+  const long long bits = 3 * (1LL << 17) + 5000;
+  const double seeded = compute_ber_seeded(4, 6.0, bits, 21);
+  ok = compute_ber_parallel(4, 6.0, bits, 21, 3) == seeded;
+  const double sweep_snrs[] = {2.0, 6.0};
+  double sweep[2];
+  ok &= compute_ber_sweep(4, sweep_snrs, 2, bits, 21, sweep, nullptr) == 0 &&
+        sweep[1] == seeded;
+  ber_until_stats_t until;
+  ok &= compute_ber_until(16, 8.0, 2000, 4000000, 0.0, 21, &until) == 0 &&
+        until.ber == compute_ber_seeded(16, 8.0, until.bits, 21);
+  const ber_point_t point{16, 8.0, 4000000, 2000, 0.0, 21};
+  ber_until_stats_t queued;
+  ok &= ber_wait(ber_submit_jobs(&point, 1), &queued) == 0 && queued.bits == until.bits &&
+        queued.errors == until.errors;
+  ok &= seeded != compute_ber_seeded(4, 6.0, bits, 22);
+  report(ok, "Seeded, parallel, sweep, until and queued runs agree under Jakes fading");
+
+  // Invalid parameters are rejected and leave the channel unchanged
+  ber_channel_t bad[] = {{BER_CHANNEL_JAKES, 0.0, 0, 0.0},
+                         {BER_CHANNEL_JAKES, 0.6, 0, 0.0},
+                         {BER_CHANNEL_BLOCK, 0.0, 0, 0.0},
+                         {BER_CHANNEL_BLOCK, 0.0, 8, -1.0},
+                         {BER_CHANNEL_BLOCK, 0.0, 8, NAN},
+                         {7, 0.0, 8, 0.0}};
+  ok = true;
+  for (const ber_channel_t &b : bad)
+    ok &= ber_set_channel(&b) == -1;
+  ber_channel_t now{};
+  ok &= ber_get_channel(&now) == 0 && now.model == BER_CHANNEL_JAKES &&
+        now.doppler == 0.01 && ber_get_channel(nullptr) == -1;
+  ber_accum_t acc;
+  ber_is_stats_t is;
+  ok &= ber_accum_init(&acc, 4, 6.0, 100000, 1) == -1 &&
+        compute_ber_is(4, 6.0, 10000, 1, &is) == -1;
+  report(ok, "Channel validation; accumulators and IS refuse fading");
+
+  // AMC over block fading: deep fades push frames to NONE, estimates track h
+  ch = {BER_CHANNEL_BLOCK, 0.0, 320, 0.0};
+  ber_set_channel(&ch);
+  const double link_snr = 15.0;
+  ber_link_stats_t one, many;
+  ok = run_amc_link(2000, 256, 64, &link_snr, 1, 9.6, 13.4, 3, 1, &one) == 0 &&
+       run_amc_link(2000, 256, 64, &link_snr, 1, 9.6, 13.4, 3, 3, &many) == 0 &&
+       std::memcmp(&one, &many, sizeof(one)) == 0 &&
+       run_amc_link(10, 256, 1, &link_snr, 1, 9.6, 13.4, 3, 0, &one) == -1;
+  ok &= many.mode_frames[BER_AMC_NONE] > 200 && many.mode_frames[BER_AMC_16QAM] > 600 &&
+        many.mean_est_error_db < -1.0;
+  report(ok, "Faded AMC link: NONE/QPSK/16QAM = " + std::to_string(many.mode_frames[0]) + "/" +
+                 std::to_string(many.mode_frames[1]) + "/" +
+                 std::to_string(many.mode_frames[2]) + ", estimate vs average " +
+                 std::to_string(many.mean_est_error_db) + " dB");
+
+  ok = ber_set_channel(nullptr) == 0 && ber_get_channel(&now) == 0 &&
+       now.model == BER_CHANNEL_AWGN && ber_accum_init(&acc, 4, 6.0, 100000, 1) == 0;
+  report(ok, "NULL restores AWGN");
+  return report.all_passed;
+}
+
+// 64/256-QAM: uncoded BER on the exact Gray curve, every seeded path and
+// engine consistent, IS deep in the waterfall and the coded path working
+bool test_high_order_qam() {
+  std::cout << "\n==== 64/256-QAM Tests ====" << std::endl;
+  Report report;
+  // Per-axis Gray N-PAM, enumerated over sent level and decision cell
+  auto q = [](double x) { return 0.5 * std::erfc(x / std::sqrt(2.0)); };
+  auto theory = [&](int m, double ebno_db) {
+    const int k = m == 64 ? 6 : 8, n = m == 64 ? 8 : 16;
+    const double x = std::sqrt(3.0 * k * std::pow(10.0, ebno_db / 10.0) / (m - 1.0));
+    double errors = 0.0;
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j) {
+        if (i == j) continue;
+        const double l = 2.0 * i - (n - 1);
+        const double lo = j == 0 ? 1.0 : q((2.0 * j - n - l) * x);
+        const double hi = j == n - 1 ? 0.0 : q((2.0 * j - n + 2.0 - l) * x);
+        errors += (lo - hi) * __builtin_popcount((i ^ (i >> 1)) ^ (j ^ (j >> 1)));
+      }
+    return errors / (n * k / 2);
+  };
+
+  const struct { int mod; double snr; } points[] = {{64, 12.0}, {64, 16.0}, {256, 14.0}, {256, 18.0}};
+  for (const auto &p : points) {
+    const double ber = compute_ber_parallel(p.mod, p.snr, 4800000, 7, 0);
+    const double ref = theory(p.mod, p.snr);
+    report(ber_close(ber, ref, 0.05), std::to_string(p.mod) + "-QAM at " +
+                                          std::to_string(p.snr).substr(0, 4) + " dB: " +
+                                          std::to_string(ber) + " vs theory " + std::to_string(ref));
+  }
+
+  // Seeded, parallel and sweep agree for every engine; the lengths straddle
+  // chunks and (for 64-QAM) words
+  const int engine = ber_get_rng_engine();
+  bool ok = true;
+  for (int e : {BER_RNG_STD, BER_RNG_FAST, BER_RNG_PHILOX}) {
+    ber_set_rng_engine(e);
+    for (int m : {64, 256}) {
+      const long long bits = (m == 64 ? 6 : 8) * ((1LL << 17) + 1001);
+      const double seeded = compute_ber_seeded(m, 12.0, bits, 31);
+      const double snrs[] = {8.0, 12.0};
+      double sweep[2];
+      ok &= seeded > 0.0 && compute_ber_parallel(m, 12.0, bits, 31, 3) == seeded &&
+            compute_ber_sweep(m, snrs, 2, bits, 31, sweep, nullptr) == 0 && sweep[1] == seeded &&
+            sweep[0] > seeded;
+    }
+  }
+  ber_set_rng_engine(engine);
+  report(ok, "Seeded, parallel and sweep runs agree for all engines");
+
+  ber_is_stats_t st{};
+  for (const auto &p : {std::pair{64, 20.0}, std::pair{256, 24.0}}) {
+    const double ref = theory(p.first, p.second);
+    ok = compute_ber_is(p.first, p.second, 1000000, 42, &st) == 0 &&
+         std::abs(st.ber - ref) <= 4.0 * st.std_err && st.std_err <= 0.05 * st.ber;
+    std::ostringstream line;
+    line << p.first << "-QAM IS at " << p.second << " dB: " << std::scientific << st.ber
+         << " +- " << st.std_err << ", theory=" << ref;
+    report(ok, line.str());
+  }
+
+  // Coded runs at every rate; the soft demapper is max-log in every LLR mode
+  const int llr_mode = ber_get_llr_mode();
+  ok = true;
+  for (int m : {64, 256})
+    for (int rate : {BER_RATE_1_2, BER_RATE_2_3, BER_RATE_3_4})
+      ok &= compute_ber_coded_rate(m, 14.0, 60000, 3, rate) >= 0.0;
+  const double coded = compute_ber_coded(256, 12.0, 100000, 5);
+  ber_set_llr_mode(BER_LLR_MAXLOG_F32);
+  ok &= coded >= 0.0 && coded < 0.1 * theory(256, 12.0) &&
+        compute_ber_coded(256, 12.0, 100000, 5) == coded;
+  ber_set_llr_mode(llr_mode);
+  report(ok, "Coded 64/256-QAM at all rates; 256-QAM at 12 dB " + std::to_string(coded) +
+                 " vs uncoded " + std::to_string(theory(256, 12.0)));
+
+  report(compute_ber(32, 10.0, 1000) == -1.0 && compute_ber(128, 10.0, 1000) == -1.0,
+         "Non-square orders rejected");
+  return report.all_passed;
+}
+
+// Asynchronous jobs: blocking-call results, progress, pipelining, cancel
+bool test_async_jobs() {
+  std::cout << "\n==== Asynchronous Job Tests ====" << std::endl;
+  Report report;
+  struct Seen {
+    std::atomic<int> calls{0};
+    std::atomic<bool> monotonic{true};
+    long long last = 0, final_done = -1, final_total = 0;
+    long long cancel_after = 0; // Cancel from the callback once past this
+    ber_job_t *job = nullptr;
+  };
+  auto on_progress = [](const ber_job_progress_t *p, void *user) {
+    auto *seen = static_cast<Seen *>(user);
+    seen->calls.fetch_add(1);
+    if (p->bits_done < seen->last || p->errors < 0)
+      seen->monotonic = false;
+    seen->last = seen->final_done = p->bits_done;
+    seen->final_total = p->bits_total;
+    if (seen->cancel_after > 0 && p->bits_done > seen->cancel_after)
+      ber_job_cancel(seen->job);
+  };
+
+  // Uncoded: same counts as the blocking call, progress per chunk
+  Seen seen;
+  const ber_job_params_t uncoded{16, 6.0, 1000003, 21, BER_BATCH_UNCODED};
+  ber_job_t *job = ber_job_start(&uncoded, on_progress, &seen);
+  double ber = -1.0;
+  long long errors = 0, bits = 0;
+  int state = ber_job_result(job, &ber, &errors, &bits);
+  report(job && state == BER_JOB_DONE && ber == compute_ber_seeded(16, 6.0, 1000003, 21) &&
+             bits == 1000000,
+         "Uncoded job matches compute_ber_seeded (" + std::to_string(ber) + ")");
+  report(seen.monotonic && seen.calls == 4 + 1 && seen.final_done == seen.final_total &&
+             seen.final_total == 1000000,
+         "Progress after every chunk and at the end (" + std::to_string(seen.calls.load()) +
+             " calls)");
+
+  // Coded: same as compute_ber_coded_rate
+  const ber_job_params_t coded{4, 3.0, 50001, 4, BER_RATE_2_3};
+  Seen coded_seen;
+  job = ber_job_start(&coded, on_progress, &coded_seen);
+  state = ber_job_result(job, &ber, &errors, &bits);
+  report(state == BER_JOB_DONE && ber == compute_ber_coded_rate(4, 3.0, 50001, 4, BER_RATE_2_3) &&
+             coded_seen.final_done == bits && bits > 0,
+         "Coded job matches compute_ber_coded_rate");
+
+  // Many points in flight at once, collected in reverse order
+  const double snrs[] = {0.0, 2.0, 4.0, 6.0, 8.0};
+  std::vector<ber_job_t *> jobs;
+  for (int m : {2, 64})
+    for (double snr : snrs) {
+      const ber_job_params_t p{m, snr, 300000, 9, BER_BATCH_UNCODED};
+      jobs.push_back(ber_job_start(&p, nullptr, nullptr));
+    }
+  bool same = true;
+  for (size_t i = jobs.size(); i-- > 0;) {
+    const int m = i < 5 ? 2 : 64;
+    ber_job_progress_t progress{};
+    same &= ber_job_poll(jobs[i], &progress) >= BER_JOB_RUNNING && progress.bits_total > 0;
+    same &= ber_job_result(jobs[i], &ber, nullptr, nullptr) == BER_JOB_DONE &&
+            ber == compute_ber_seeded(m, snrs[i % 5], 300000, 9);
+  }
+  report(same, "10 pipelined jobs match their blocking results");
+
+  // Cancelling stops at a chunk boundary and keeps the completed chunks
+  Seen cancel_seen;
+  cancel_seen.cancel_after = 2 * 65536 * 2;
+  const ber_job_params_t big{4, 4.0, 1LL << 34, 5, BER_BATCH_UNCODED};
+  job = cancel_seen.job = ber_job_start(&big, on_progress, &cancel_seen);
+  state = ber_job_result(job, &ber, &errors, &bits);
+  report(state == BER_JOB_CANCELLED && bits > cancel_seen.cancel_after && bits < (1LL << 34) &&
+             bits % (65536 * 2) == 0 && ber == static_cast<double>(errors) / bits &&
+             cancel_seen.final_done == bits,
+         "Cancelled uncoded job keeps " + std::to_string(bits) + " bits");
+  const ber_job_params_t big_coded{16, 2.0, 1LL << 24, 1, BER_RATE_1_2};
+  job = ber_job_start(&big_coded, nullptr, nullptr);
+  ber_job_cancel(job);
+  state = ber_job_result(job, &ber, &errors, &bits);
+  report(state == BER_JOB_CANCELLED && ber == 0.0 && errors == 0 && bits == 0,
+         "Cancelled coded job reports nothing");
+
+  // Invalid parameters and handles
+  const ber_job_params_t bad_mod{8, 5.0, 1000, 1, BER_BATCH_UNCODED};
+  const ber_job_params_t bad_rate{4, 5.0, 1000, 1, 99};
+  const ber_job_params_t bad_bits{4, 5.0, 1, 1, BER_BATCH_UNCODED};
+  report(!ber_job_start(nullptr, nullptr, nullptr) && !ber_job_start(&bad_mod, nullptr, nullptr) &&
+             !ber_job_start(&bad_rate, nullptr, nullptr) &&
+             !ber_job_start(&bad_bits, nullptr, nullptr) && ber_job_poll(nullptr, nullptr) == -1 &&
+             ber_job_cancel(nullptr) == -1 && ber_job_result(nullptr, &ber, nullptr, nullptr) == -1,
+         "Invalid parameters and NULL handles are rejected");
+  return report.all_passed;
+}
 } // namespace
 
 int main() {
@@ -294,6 +1658,31 @@ int main() {
   all_additional_passed &= test_modulation_consistency();
   all_additional_passed &= test_snr_estimation_accuracy();
   all_additional_passed &= test_repeatability();
+  all_additional_passed &= test_parallel_determinism();
+  all_additional_passed &= test_ber_sweep();
+  all_additional_passed &= test_ber_until();
+  all_additional_passed &= test_threshold_search();
+  all_additional_passed &= test_importance_sampling();
+  all_additional_passed &= test_awgn_engines();
+  all_additional_passed &= test_simd_kernels();
+  all_additional_passed &= test_viterbi_equivalence();
+  all_additional_passed &= test_trellis_codes();
+  all_additional_passed &= test_viterbi_stream();
+  all_additional_passed &= test_coded_workspace();
+  all_additional_passed &= test_llr_engines();
+  all_additional_passed &= test_punctured_rates();
+  all_additional_passed &= test_ber_batch();
+  all_additional_passed &= test_stats_counters();
+  all_additional_passed &= test_job_scheduler();
+  all_additional_passed &= test_workspace_arena();
+  all_additional_passed &= test_snr_estimate_batch();
+  all_additional_passed &= test_result_cache();
+  all_additional_passed &= test_accumulator();
+  all_additional_passed &= test_philox_backend();
+  all_additional_passed &= test_amc_link();
+  all_additional_passed &= test_fading_channels();
+  all_additional_passed &= test_high_order_qam();
+  all_additional_passed &= test_async_jobs();
 
   std::cout << "\n==== Final Summary ====" << std::endl;
   if (all_additional_passed) {
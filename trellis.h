@@ -0,0 +1,272 @@
+#ifndef TRELLIS_H
+#define TRELLIS_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+// =============================================================================
+// COMPILE-TIME CONVOLUTIONAL CODES (C++ only)
+// =============================================================================
+//
+// ConvCode<K, G1, G2> is a rate-1/2 feedforward code with a (K-1)-bit state.
+// The shift register is [input, state] with the input in bit K-1; the next
+// state is register >> 1 and the output pair is (G1 parity, G2 parity),
+// stored with the G1 bit in bit 1 and transmitted first. Generators are
+// written in the usual octal form (0133 = 1011011b, MSB = current input).
+//
+// With this layout the predecessors of state j are 2k and 2k+1, k = j mod
+// num_states/2, and the input bit that led to j is j >> (K-2). Butterfly k
+// therefore reads metrics 2k, 2k+1 and writes states k (input 0) and
+// k + num_states/2 (input 1).
+//
+// All tables are constexpr: nothing is initialized at run time, so encoders
+// and decoders are safe to call from any number of threads.
+
+// Metric renormalization shared by every decoder (see coding.cpp)
+constexpr double VITERBI_RENORM_THRESHOLD = 1e200;
+constexpr int VITERBI_RENORM_INTERVAL = 1024; // Stages between threshold checks
+
+struct ConvTransition {
+    uint16_t next_state[2]; // Next state for input 0 and 1
+    uint8_t output[2];      // Output pair for input 0 and 1 (bit 1 = G1)
+    uint16_t prev_state[2]; // The two states leading here
+    uint8_t prev_input[2];  // Input bit on those branches
+};
+
+template <int K>
+constexpr std::array<ConvTransition, (1 << (K - 1))> make_conv_trellis(unsigned g1,
+                                                                         unsigned g2) {
+    constexpr int num_states = 1 << (K - 1);
+    std::array<ConvTransition, num_states> t{};
+    for (int state = 0; state < num_states; state++) {
+        for (int input = 0; input < 2; input++) {
+            const unsigned reg = (static_cast<unsigned>(input) << (K - 1)) | state;
+            t[state].next_state[input] = static_cast<uint16_t>(reg >> 1);
+            t[state].output[input] = static_cast<uint8_t>(
+                ((std::popcount(reg & g1) & 1) << 1) | (std::popcount(reg & g2) & 1));
+        }
+    }
+    for (int state = 0; state < num_states; state++) {
+        for (int p = 0; p < 2; p++) {
+            t[state].prev_state[p] =
+                static_cast<uint16_t>(((state & (num_states / 2 - 1)) << 1) | p);
+            t[state].prev_input[p] = static_cast<uint8_t>(state >> (K - 2));
+        }
+    }
+    return t;
+}
+
+// Minimum output weight over paths that leave state 0 and first return to it
+// (Bellman-Ford over the trellis, edges out of state 0 excluded after the
+// first branch)
+template <std::size_t N>
+constexpr int conv_free_distance(const std::array<ConvTransition, N>& t) {
+    constexpr int INF = std::numeric_limits<int>::max() / 2;
+    std::array<int, N> dist{};
+    for (auto& d : dist) d = INF;
+    const uint8_t first = t[0].output[1];
+    dist[t[0].next_state[1]] = (first >> 1) + (first & 1);
+    for (std::size_t iter = 0; iter < N; iter++) {
+        for (std::size_t s = 1; s < N; s++) {
+            if (dist[s] == INF) continue;
+            for (int u = 0; u < 2; u++) {
+                const uint16_t next = t[s].next_state[u];
+                const int w = dist[s] + (t[s].output[u] >> 1) + (t[s].output[u] & 1);
+                if (w < dist[next]) dist[next] = w;
+            }
+        }
+    }
+    return dist[0];
+}
+
+template <int K, unsigned G1, unsigned G2>
+struct ConvCode {
+    static_assert(K >= 3 && K <= 9, "Supported constraint lengths: 3..9");
+    static_assert(G1 < (1u << K) && G2 < (1u << K), "Generator wider than K");
+
+    static constexpr int constraint_length = K;
+    static constexpr int tail_bits = K - 1;
+    static constexpr int num_states = 1 << (K - 1);
+    static constexpr int butterflies = num_states / 2;
+    static constexpr int decision_words = (num_states + 63) / 64; // Per stage
+
+    static constexpr auto trellis = make_conv_trellis<K>(G1, G2);
+    static constexpr int free_distance = conv_free_distance(trellis);
+};
+
+using ConvCodeK5 = ConvCode<5, 023, 035>;   // d_free 7
+using ConvCodeK7 = ConvCode<7, 0133, 0171>; // NASA / CCSDS, d_free 10
+using ConvCodeK9 = ConvCode<9, 0561, 0753>; // IS-95 / CDMA2000, d_free 12
+
+// =============================================================================
+// ENCODER
+// =============================================================================
+
+/**
+ * Encode info_len bits followed by the K-1 zero tail bits
+ * @param coded Output; must hold 2 * (info_len + K - 1) bits
+ */
+template <class Code>
+void conv_encode(const bool* info, long long info_len, bool* coded) {
+    unsigned state = 0;
+    const long long total = info_len + Code::tail_bits;
+    for (long long i = 0; i < total; i++) {
+        const int input = i < info_len && info[i] ? 1 : 0;
+        const uint8_t output = Code::trellis[state].output[input];
+        coded[2 * i] = (output >> 1) & 1;
+        coded[2 * i + 1] = output & 1;
+        state = Code::trellis[state].next_state[input];
+    }
+}
+
+// Output pair of every shift register [input, state], G1 in bit 0 and G2 in
+// bit 1 so it can be OR-ed into LSB-first packed words directly
+template <class Code>
+constexpr std::array<uint8_t, 2 * Code::num_states> make_packed_outputs() {
+    std::array<uint8_t, 2 * Code::num_states> out{};
+    for (int reg = 0; reg < 2 * Code::num_states; reg++) {
+        const int state = reg & (Code::num_states - 1);
+        const uint8_t o = Code::trellis[state].output[reg >> (Code::constraint_length - 1)];
+        out[reg] = static_cast<uint8_t>(((o >> 1) & 1) | ((o & 1) << 1));
+    }
+    return out;
+}
+
+/**
+ * conv_encode on packed bits (64 per word, LSB first) continuing from state,
+ * which is updated; terminate appends the tail
+ * @param coded_words Output; must hold 2 * info_len bits (+ 2 * (K - 1) with
+ *        terminate)
+ */
+template <class Code>
+void conv_encode_packed_from(const uint64_t* info_words, long long info_len,
+                             unsigned& state, bool terminate, uint64_t* coded_words) {
+    static constexpr auto outputs = make_packed_outputs<Code>();
+    constexpr int K = Code::constraint_length;
+    const long long total = info_len + (terminate ? Code::tail_bits : 0);
+    uint64_t word = 0;
+    for (long long i = 0; i < total; i++) {
+        const unsigned input = i < info_len ? (info_words[i >> 6] >> (i & 63)) & 1 : 0;
+        const unsigned reg = (input << (K - 1)) | state;
+        word |= static_cast<uint64_t>(outputs[reg]) << (2 * (i & 31));
+        state = reg >> 1;
+        if ((i & 31) == 31) {
+            coded_words[i >> 5] = word;
+            word = 0;
+        }
+    }
+    if (total & 31) coded_words[total >> 5] = word;
+}
+
+/**
+ * conv_encode on packed bits, tail included
+ * @param coded_words Output; must hold 2 * (info_len + K - 1) bits
+ */
+template <class Code>
+void conv_encode_packed(const uint64_t* info_words, long long info_len,
+                        uint64_t* coded_words) {
+    unsigned state = 0;
+    conv_encode_packed_from<Code>(info_words, info_len, state, true, coded_words);
+}
+
+// =============================================================================
+// UNROLLED SCALAR VITERBI
+// =============================================================================
+//
+// Every butterfly is expanded at compile time, so branch labels are
+// immediates rather than table loads. Branch metric = (+/-llr0) + (+/-llr1),
+// candidate = metric + branch, and the odd predecessor wins only if strictly
+// greater, exactly like the K=7 SIMD decoders in coding.cpp. Decisions are
+// decision_words words per stage (bit j set = state j came from its odd
+// predecessor).
+
+template <class Code, int k>
+inline void viterbi_butterfly(const double* cur, double* nxt, const double (&bm)[4],
+                              uint64_t* word) {
+    constexpr int B = Code::butterflies;
+    const double even = cur[2 * k];
+    const double odd = cur[2 * k + 1];
+    [&]<int... u>(std::integer_sequence<int, u...>) {
+        ([&] {
+            constexpr uint8_t out_even = Code::trellis[2 * k].output[u];
+            constexpr uint8_t out_odd = Code::trellis[2 * k + 1].output[u];
+            constexpr int j = k + u * B;
+            const double from_even = even + bm[out_even];
+            const double from_odd = odd + bm[out_odd];
+            const bool take_odd = from_odd > from_even;
+            nxt[j] = take_odd ? from_odd : from_even;
+            word[j >> 6] |= static_cast<uint64_t>(take_odd) << (j & 63);
+        }(), ...);
+    }(std::integer_sequence<int, 0, 1>{});
+}
+
+template <class Code>
+void viterbi_renormalize(double* metrics) {
+    double best = metrics[0];
+    for (int s = 1; s < Code::num_states; s++)
+        if (metrics[s] > best) best = metrics[s];
+    if (best > VITERBI_RENORM_THRESHOLD) {
+        for (int s = 0; s < Code::num_states; s++) metrics[s] -= best;
+    }
+}
+
+// Forward pass over num_stages stages. metrics holds the starting metrics on
+// entry and the final ones on exit; decisions receives decision_words words
+// per stage.
+template <class Code>
+void viterbi_forward_unrolled(const double* llr, long long num_stages,
+                              double* metrics, uint64_t* decisions) {
+    constexpr int S = Code::num_states;
+    double buf[2][S];
+    std::copy(metrics, metrics + S, buf[0]);
+    for (long long stage = 0; stage < num_stages; stage++) {
+        const double llr0 = llr[2 * stage];
+        const double llr1 = llr[2 * stage + 1];
+        const double bm[4] = {-llr0 + -llr1, -llr0 + llr1, llr0 + -llr1, llr0 + llr1};
+        const double* cur = buf[stage & 1];
+        double* nxt = buf[(stage & 1) ^ 1];
+        uint64_t* word = decisions + stage * Code::decision_words;
+        for (int w = 0; w < Code::decision_words; w++) word[w] = 0;
+        [&]<int... k>(std::integer_sequence<int, k...>) {
+            (viterbi_butterfly<Code, k>(cur, nxt, bm, word), ...);
+        }(std::make_integer_sequence<int, Code::butterflies>{});
+        if (stage % VITERBI_RENORM_INTERVAL == VITERBI_RENORM_INTERVAL - 1)
+            viterbi_renormalize<Code>(nxt);
+    }
+    std::copy(buf[num_stages & 1], buf[num_stages & 1] + S, metrics);
+}
+
+/**
+ * Decode a terminated block (num_stages = info bits + K - 1, 2 LLRs per
+ * stage, positive LLR favours bit 1) with traceback from the zero state
+ * @param decisions Scratch; must hold num_stages * decision_words words
+ * @return Number of info bits written to decoded, or -3 if the block is
+ *         shorter than the tail
+ */
+template <class Code>
+long long viterbi_decode_block(const double* llr, long long num_stages,
+                               uint64_t* decisions, bool* decoded) {
+    const long long info_len = num_stages - Code::tail_bits;
+    if (info_len <= 0) return -3;
+    std::array<double, Code::num_states> metrics;
+    metrics.fill(-std::numeric_limits<double>::infinity());
+    metrics[0] = 0.0;
+    viterbi_forward_unrolled<Code>(llr, num_stages, metrics.data(), decisions);
+
+    unsigned state = 0;
+    for (long long stage = num_stages; stage > 0; stage--) {
+        if (stage <= info_len)
+            decoded[stage - 1] = (state >> (Code::constraint_length - 2)) & 1;
+        const uint64_t* word = decisions + (stage - 1) * Code::decision_words;
+        const unsigned from_odd = (word[state >> 6] >> (state & 63)) & 1;
+        state = ((state & (Code::butterflies - 1)) << 1) | from_odd;
+    }
+    return info_len;
+}
+
+#endif // TRELLIS_H